@@ -44,6 +44,12 @@ class DomainMetas : public Serializable {
   inline void SetNodeValue(std::string node_value) { node_value_ = node_value; }
   inline void SetChildrenCount(uint64_t children_count) { children_count_ = children_count; }
   inline void AddChild(const DomainMetas& meta) { children_.emplace_back(meta); }
+  // only set on root node, node statistics of the whole page
+  inline void SetNodeStatistics(uint32_t total_count, uint32_t layout_only_count) {
+    has_node_statistics_ = true;
+    total_node_count_ = total_count;
+    layout_only_node_count_ = layout_only_count;
+  }
   std::string Serialize() const override;
 
  private:
@@ -63,5 +69,8 @@ class DomainMetas : public Serializable {
   std::vector<DomainMetas> children_;
   // It is used to expand logic. It must be assigned a value and cannot be used from children_ read
   uint64_t children_count_;
+  bool has_node_statistics_ = false;
+  uint32_t total_node_count_ = 0;
+  uint32_t layout_only_node_count_ = 0;
 };
 }  // namespace hippy::devtools
@@ -48,6 +48,14 @@ class TdfPerformanceDomain : public BaseDomain, public std::enable_shared_from_t
   void V8Tracing(const BaseRequest& request);
   void FrameTimings(const BaseRequest& request);
   void Timeline(const BaseRequest& request);
+
+  /**
+   * @brief task runner scheduling latency, run time, queue depth and long tasks recorded since Start
+   */
+  void TaskRunnerStatistics(const BaseRequest& request);
+
+  // statistics is enabled by Start only when it was not enabled by native code
+  bool is_statistics_enabled_by_domain_ = false;
 };
 
 }  // namespace hippy::devtools
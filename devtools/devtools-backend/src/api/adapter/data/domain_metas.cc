@@ -35,6 +35,10 @@ constexpr char kAttributes[] = "attributes";
 constexpr char kLayoutX[] = "x";
 constexpr char kLayoutY[] = "y";
 constexpr char kStyle[] = "style";
+constexpr char kNodeStatistics[] = "nodeStatistics";
+constexpr char kTotalCount[] = "totalCount";
+constexpr char kLayoutOnlyCount[] = "layoutOnlyCount";
+constexpr char kRenderedCount[] = "renderedCount";
 
 std::string DomainMetas::Serialize() const {
   std::string node_str = "{\"";
@@ -97,6 +101,23 @@ std::string DomainMetas::Serialize() const {
   node_str += kChildNodeCount;
   node_str += "\":";
   node_str += std::to_string(static_cast<int>(children_count_));
+  if (has_node_statistics_) {
+    node_str += ",\"";
+    node_str += kNodeStatistics;
+    node_str += "\":{\"";
+    node_str += kTotalCount;
+    node_str += "\":";
+    node_str += std::to_string(total_node_count_);
+    node_str += ",\"";
+    node_str += kLayoutOnlyCount;
+    node_str += "\":";
+    node_str += std::to_string(layout_only_node_count_);
+    node_str += ",\"";
+    node_str += kRenderedCount;
+    node_str += "\":";
+    node_str += std::to_string(total_node_count_ - layout_only_node_count_);
+    node_str += "}";
+  }
   if (!children_.empty()) {
     node_str += ",\"children\": [";
     for (auto& child : children_) {
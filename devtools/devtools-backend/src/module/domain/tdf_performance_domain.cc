@@ -22,11 +22,42 @@
 #include "api/devtools_backend_service.h"
 #include "footstone/macros.h"
 #include "footstone/logging.h"
+#include "footstone/task_runner_statistics.h"
 #include "module/domain_register.h"
 
 namespace hippy::devtools {
 
 constexpr char kParamsTraceEvent[] = "traceEvents";
+constexpr char kTaskRunnerStatisticsEnabled[] = "enabled";
+constexpr char kTaskRunnerStatisticsLongTaskThreshold[] = "longTaskThreshold";
+constexpr char kTaskRunnerStatisticsRunners[] = "runners";
+constexpr char kTaskRunnerStatisticsName[] = "name";
+constexpr char kTaskRunnerStatisticsMaxQueueDepth[] = "maxQueueDepth";
+constexpr char kTaskRunnerStatisticsWait[] = "wait";
+constexpr char kTaskRunnerStatisticsRun[] = "run";
+constexpr char kTaskRunnerStatisticsLongTasks[] = "longTasks";
+constexpr char kTaskRunnerStatisticsStartTime[] = "startTime";
+constexpr char kTaskRunnerStatisticsDuration[] = "duration";
+constexpr char kHistogramCount[] = "count";
+constexpr char kHistogramMean[] = "mean";
+constexpr char kHistogramP50[] = "p50";
+constexpr char kHistogramP90[] = "p90";
+constexpr char kHistogramP99[] = "p99";
+constexpr char kHistogramMax[] = "max";
+constexpr char kHistogramBuckets[] = "buckets";
+
+// all durations are in microseconds, bucket i holds samples in [2^(i-1), 2^i) us
+static nlohmann::json HistogramToJson(const footstone::TimeHistogram& histogram) {
+  nlohmann::json json = nlohmann::json::object();
+  json[kHistogramCount] = histogram.GetCount();
+  json[kHistogramMean] = histogram.GetMean().ToMicroseconds();
+  json[kHistogramP50] = histogram.GetPercentile(0.5).ToMicroseconds();
+  json[kHistogramP90] = histogram.GetPercentile(0.9).ToMicroseconds();
+  json[kHistogramP99] = histogram.GetPercentile(0.99).ToMicroseconds();
+  json[kHistogramMax] = histogram.GetMax().ToMicroseconds();
+  json[kHistogramBuckets] = histogram.GetBuckets();
+  return json;
+}
 
 std::string TdfPerformanceDomain::GetDomainName() { return kFrontendKeyDomainNameTDFPerformance; }
 
@@ -36,6 +67,7 @@ void TdfPerformanceDomain::RegisterMethods() {
   REGISTER_DOMAIN(TdfPerformanceDomain, V8Tracing, BaseRequest);
   REGISTER_DOMAIN(TdfPerformanceDomain, FrameTimings, BaseRequest);
   REGISTER_DOMAIN(TdfPerformanceDomain, Timeline, BaseRequest);
+  REGISTER_DOMAIN(TdfPerformanceDomain, TaskRunnerStatistics, BaseRequest);
 }
 
 void TdfPerformanceDomain::RegisterCallback() {}
@@ -55,6 +87,11 @@ void TdfPerformanceDomain::Start(const BaseRequest& request) {
   } else {
     FOOTSTONE_DLOG(ERROR) << kDevToolsTag << "TdfPerformanceDomain::Start tracing_adapter is null";
   }
+  footstone::TaskRunnerStatistics::ResetAll();
+  if (!footstone::TaskRunnerStatistics::IsEnabled()) {
+    footstone::TaskRunnerStatistics::SetEnabled(true);
+    is_statistics_enabled_by_domain_ = true;
+  }
   nlohmann::json start_time_json = nlohmann::json::object();
   start_time_json["startTime"] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
   ResponseResultToFrontend(request.GetId(), start_time_json.dump());
@@ -63,6 +100,10 @@ void TdfPerformanceDomain::Start(const BaseRequest& request) {
 void TdfPerformanceDomain::End(const BaseRequest& request) {
   // just end record end, and then get tracing and timeline respectively
   FOOTSTONE_DLOG(INFO) << kDevToolsTag << "TdfPerformanceDomain::End";
+  if (is_statistics_enabled_by_domain_) {
+    footstone::TaskRunnerStatistics::SetEnabled(false);
+    is_statistics_enabled_by_domain_ = false;
+  }
   nlohmann::json end_time_json = nlohmann::json::object();
   end_time_json["endTime"] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
   ResponseResultToFrontend(request.GetId(), end_time_json.dump());
@@ -104,4 +145,35 @@ void TdfPerformanceDomain::Timeline(const BaseRequest& request) {
   }
 }
 
+void TdfPerformanceDomain::TaskRunnerStatistics(const BaseRequest& request) {
+  nlohmann::json result = nlohmann::json::object();
+  result[kTaskRunnerStatisticsEnabled] = footstone::TaskRunnerStatistics::IsEnabled();
+  result[kTaskRunnerStatisticsLongTaskThreshold] =
+      footstone::TaskRunnerStatistics::GetLongTaskThreshold().ToMicroseconds();
+  nlohmann::json runners = nlohmann::json::array();
+  for (const auto& statistics : footstone::TaskRunnerStatistics::GetAll()) {
+    if (statistics->GetRunHistogram().GetCount() == 0) {
+      continue;
+    }
+    nlohmann::json runner = nlohmann::json::object();
+    runner[kTaskRunnerStatisticsName] = statistics->GetName();
+    runner[kTaskRunnerStatisticsMaxQueueDepth] = statistics->GetMaxQueueDepth();
+    runner[kTaskRunnerStatisticsWait] = HistogramToJson(statistics->GetWaitHistogram());
+    runner[kTaskRunnerStatisticsRun] = HistogramToJson(statistics->GetRunHistogram());
+    nlohmann::json long_tasks = nlohmann::json::array();
+    for (const auto& long_task : statistics->GetLongTasks()) {
+      nlohmann::json long_task_json = nlohmann::json::object();
+      // same steady clock nanoseconds as startTime returned by Start
+      long_task_json[kTaskRunnerStatisticsStartTime] = long_task.start.ToEpochDelta().ToNanoseconds();
+      long_task_json[kTaskRunnerStatisticsWait] = long_task.wait.ToMicroseconds();
+      long_task_json[kTaskRunnerStatisticsDuration] = long_task.duration.ToMicroseconds();
+      long_tasks.push_back(long_task_json);
+    }
+    runner[kTaskRunnerStatisticsLongTasks] = long_tasks;
+    runners.push_back(runner);
+  }
+  result[kTaskRunnerStatisticsRunners] = runners;
+  ResponseResultToFrontend(request.GetId(), result.dump());
+}
+
 }  // namespace hippy::devtools
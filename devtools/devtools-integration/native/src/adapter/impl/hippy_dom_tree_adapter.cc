@@ -107,6 +107,10 @@ void HippyDomTreeAdapter::GetDomainData(int32_t node_id,
     auto node = dom_manager->GetNode(root_node, is_root ? root_node->GetId() : static_cast<uint32_t>(node_id));
     assert(node != nullptr);
     hippy::devtools::DomainMetas metas = DevToolsUtil::GetDomDomainData(root_node, node, depth, dom_manager);
+    if (is_root) {
+      const auto& statistics = root_node->GetNodeStatistics();
+      metas.SetNodeStatistics(statistics.total_count, statistics.layout_only_count);
+    }
     callback(metas);
   };
   DevToolsUtil::PostDomTask(hippy_dom_->dom_manager, func);
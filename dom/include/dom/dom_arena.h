@@ -0,0 +1,116 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hippy {
+inline namespace dom {
+
+template <typename T>
+class DomArenaAllocator;
+
+/**
+ * Slab allocator for the objects whose lifetime is bound to a RootNode, such as DomNode, LayoutNode, DomInfo,
+ * RefInfo, DiffInfo and DomEvent. Small blocks are carved out of large slabs and recycled through per size class
+ * free lists, so creating thousands of nodes only costs a handful of system allocations, and all slabs are
+ * released at once when the arena is destroyed.
+ *
+ * Every allocation made through MakeShared holds a reference to the arena, so the arena outlives all of its
+ * objects. Nodes are created in js thread and released in dom thread, so the arena is guarded by a mutex.
+ */
+class DomArena : public std::enable_shared_from_this<DomArena> {
+ public:
+  static constexpr size_t kAlignment = alignof(std::max_align_t);
+  static constexpr size_t kMaxBlockSize = 1024;
+  static constexpr size_t kDefaultSlabSize = 64 * 1024;
+
+  explicit DomArena(size_t slab_size = kDefaultSlabSize);
+  ~DomArena();
+
+  DomArena(const DomArena&) = delete;
+  DomArena& operator=(const DomArena&) = delete;
+
+  void* Allocate(size_t size);
+  void Deallocate(void* ptr, size_t size);
+
+  template <typename T, typename... Args>
+  std::shared_ptr<T> MakeShared(Args&&... args) {
+    return std::allocate_shared<T>(DomArenaAllocator<T>(shared_from_this()), std::forward<Args>(args)...);
+  }
+
+  size_t GetSlabCount();
+  size_t GetLiveBlockCount();
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  static inline size_t GetSizeClass(size_t size) { return (size + kAlignment - 1) / kAlignment; }
+
+  std::mutex mutex_;
+  size_t slab_size_;
+  uint8_t* cursor_ = nullptr;
+  uint8_t* end_ = nullptr;
+  size_t live_block_count_ = 0;
+  std::vector<void*> slabs_;
+  std::vector<FreeBlock*> free_lists_;
+};
+
+/**
+ * std allocator adapter of DomArena, which makes it possible to use std::allocate_shared and std containers with
+ * the arena.
+ */
+template <typename T>
+class DomArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit DomArenaAllocator(std::shared_ptr<DomArena> arena) : arena_(std::move(arena)) {}
+  template <typename U>
+  DomArenaAllocator(const DomArenaAllocator<U>& other) : arena_(other.arena_) {}
+
+  T* allocate(size_t n) { return static_cast<T*>(arena_->Allocate(n * sizeof(T))); }
+  void deallocate(T* ptr, size_t n) { arena_->Deallocate(ptr, n * sizeof(T)); }
+
+  template <typename U>
+  bool operator==(const DomArenaAllocator<U>& other) const {
+    return arena_ == other.arena_;
+  }
+  template <typename U>
+  bool operator!=(const DomArenaAllocator<U>& other) const {
+    return arena_ != other.arena_;
+  }
+
+ private:
+  template <typename U>
+  friend class DomArenaAllocator;
+
+  std::shared_ptr<DomArena> arena_;
+};
+
+}  // namespace dom
+}  // namespace hippy
@@ -0,0 +1,70 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hippy {
+inline namespace dom {
+
+class RootNode;
+struct DomInfo;
+
+/**
+ * Binary encoding of a batch of created or updated nodes, so that JS can hand a whole batch to SceneBuilder in one
+ * ArrayBuffer instead of walking every node object through the engine. The buffer is a single
+ * footstone::value::Serializer stream:
+ *
+ *   Header | Uint32 node count | Node * count
+ *
+ * and every node is written as consecutive values:
+ *
+ *   id | pid | view name | tag name | flags | [ref id | relative to ref] | props
+ *
+ * - id, pid, ref id and relative to ref are numbers, any number tag is accepted
+ * - flags is a Uint32 made of the kFlag* bits below, the two ref values are present only with kFlagHasRefInfo
+ * - props is an object with the same layout as the props of a JS node (style nested under "style"), or undefined
+ *
+ * The JS side encoder is encodeDomBatch in driver/js/packages/hippy-vue-next/src/runtime/render/dom-batch.ts.
+ */
+class DomBatch {
+ public:
+  static constexpr uint32_t kFlagHasRefInfo = 1;
+  static constexpr uint32_t kFlagHasDiffInfo = 1 << 1;
+  static constexpr uint32_t kFlagSkipStyleDiff = 1 << 2;
+
+  static std::string Encode(const std::vector<std::shared_ptr<DomInfo>>& nodes);
+  /**
+   * @brief 一次遍历解码整个批次, 不经过 JS 引擎, DomNode 等对象从 root_node 的 arena 中分配
+   * @param data 批次数据, 只需在调用期间有效
+   * @param nodes 解码出的节点, 可直接用于 SceneBuilder::Create/Update
+   * @return 批次是否完整有效, 无效时 nodes 中可能有部分已解码的节点
+   */
+  static bool Decode(const uint8_t* data, size_t length, const std::shared_ptr<RootNode>& root_node,
+                     std::vector<std::shared_ptr<DomInfo>>& nodes);
+};
+
+}  // namespace dom
+}  // namespace hippy
@@ -130,6 +130,8 @@ class DomManager : public std::enable_shared_from_this<DomManager> {
 
   static byte_string GetSnapShot(const std::shared_ptr<RootNode>& root_node);
   bool SetSnapShot(const std::shared_ptr<RootNode>& root_node, const byte_string& buffer);
+  // data 可以直接指向内存映射的快照文件, 只需在调用期间有效
+  bool SetSnapShot(const std::shared_ptr<RootNode>& root_node, const uint8_t* data, size_t length);
 
   void RecordDomStartTimePoint();
   void RecordDomEndTimePoint();
@@ -139,6 +141,8 @@ class DomManager : public std::enable_shared_from_this<DomManager> {
  private:
   friend class DomNode;
 
+  bool SetLegacySnapShot(const std::shared_ptr<RootNode>& root_node, const uint8_t* data, size_t length);
+
   uint32_t id_;
   std::shared_ptr<LayerOptimizedRenderManager> optimized_render_manager_;
   std::weak_ptr<RenderManager> render_manager_;
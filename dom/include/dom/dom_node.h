@@ -126,7 +126,7 @@ class DomNode : public std::enable_shared_from_this<DomNode> {
   inline const RenderInfo& GetRenderInfo() const { return render_info_; }
   inline void SetRenderInfo(const RenderInfo& render_info) { render_info_ = render_info; }
   inline bool IsLayoutOnly() const { return layout_only_; }
-  inline void SetLayoutOnly(bool layout_only) { layout_only_ = layout_only; }
+  void SetLayoutOnly(bool layout_only);
   inline bool IsVirtual() { return is_virtual_; }
   inline void SetIsVirtual(bool is_virtual) { is_virtual_ = is_virtual; }
   inline bool IsEnableEliminated() { return enable_eliminated_; }
@@ -147,12 +147,13 @@ class DomNode : public std::enable_shared_from_this<DomNode> {
 
   int32_t IndexOf(const std::shared_ptr<DomNode>& child);
   std::shared_ptr<DomNode> GetChildAt(size_t index);
-  const std::vector<std::shared_ptr<DomNode>>& GetChildren() { return children_; }
+  const std::vector<std::shared_ptr<DomNode>>& GetChildren() const { return children_; }
   int32_t AddChildByRefInfo(const std::shared_ptr<DomInfo>& dom_node);
   std::shared_ptr<DomNode> RemoveChildAt(int32_t index);
   std::shared_ptr<DomNode> RemoveChildById(uint32_t id);
   void DoLayout();
   void DoLayout(std::vector<std::shared_ptr<DomNode>>& changed_nodes);
+  void CalculateLayout();
   void ParseLayoutStyleInfo();
   void UpdateLayoutStyleInfo(
       const std::unordered_map<std::string, std::shared_ptr<footstone::value::HippyValue>>& style_update,
@@ -163,13 +164,44 @@ class DomNode : public std::enable_shared_from_this<DomNode> {
    * */
   LayoutResult GetLayoutInfoFromRoot();
   void TransferLayoutOutputsRecursive(std::vector<std::shared_ptr<DomNode>>& changed_nodes);
+  /**
+   * @brief 只在脏区域内收集布局变化的节点. 节点自身脏或布局结果变化时访问全部子节点, 否则只访问含脏节点的子树,
+   * 这些子树的根布局变化后 (可能挤压兄弟节点) 再访问其余子节点
+   * @param visit_count 累加访问过的节点数
+   * @return 节点自身的布局结果是否变化
+   */
+  bool TransferLayoutOutputsIncremental(std::vector<std::shared_ptr<DomNode>>& changed_nodes, uint32_t& visit_count);
+  /**
+   * @brief 标记节点需要重新收集布局结果, 并沿祖先链标记脏子树, 遇到布局边界 (layout boundary) 时停止,
+   * 由 RootNode 从该边界开始收集
+   */
+  void MarkLayoutDirty();
+  /**
+   * @brief 节点内容变化 (如文本) 需要重新测量时调用, 同时标记排版节点和布局收集的脏区域,
+   * 平台侧不应直接调用 LayoutNode::MarkDirty, 否则增量收集访问不到该节点
+   */
+  void MarkLayoutNodeDirty();
+  /**
+   * @brief 宽高都是固定数值的节点, 子树中的变化不会影响其尺寸, 因而不会影响其祖先和兄弟节点的布局.
+   * 父节点按 baseline 对齐时依赖内容, 不作为边界
+   */
+  bool IsLayoutBoundary();
+  inline bool HasLayoutDirty() const { return layout_dirty_ || has_dirty_descendant_; }
   std::tuple<float, float> GetLayoutSize();
   void SetLayoutSize(float width, float height);
   void SetLayoutOrigin(float x, float y);
   const LayoutResult& GetLayoutResult() const { return layout_; }
   const LayoutResult& GetRenderLayoutResult() const { return render_layout_; }
+  // 恢复快照中保存的布局结果, 布局引擎中的节点仍为脏, 下次布局时会重新计算
+  inline void RestoreLayoutResult(const LayoutResult& layout, const LayoutResult& render_layout) {
+    layout_ = layout;
+    render_layout_ = render_layout;
+  }
 
-  std::vector<std::shared_ptr<DomEventListenerInfo>> GetEventListener(const std::string& name, bool is_capture);
+  const std::vector<std::shared_ptr<DomEventListenerInfo>>& GetEventListener(const std::string& name,
+                                                                            bool is_capture) const;
+  bool HasEventListener(const std::string& name) const;
+  std::vector<std::string> GetEventListenerNames() const;
   const std::shared_ptr<std::unordered_map<std::string, std::shared_ptr<HippyValue>>>& GetStyleMap() const {
     return style_map_;
   }
@@ -223,6 +255,10 @@ class DomNode : public std::enable_shared_from_this<DomNode> {
   void UpdateStyle(const std::unordered_map<std::string, std::shared_ptr<HippyValue>>& update_style);
   void UpdateObjectStyle(HippyValue& style_map, const HippyValue& update_style);
   bool ReplaceStyle(HippyValue& object, const std::string& key, const HippyValue& value);
+  // 计算本节点布局输出并返回布局结果 (含层级优化后的坐标) 是否变化
+  bool TransferLayoutOutput(std::vector<std::shared_ptr<DomNode>>& changed_nodes);
+  // 与 ReplaceStyle 相同, 但 style 被共享时替换其副本, 不修改共享的 value
+  bool ReplaceStyleOnWrite(std::shared_ptr<HippyValue>& style, const std::string& key, const HippyValue& value);
 
   friend std::ostream& operator<<(std::ostream& os, const DomNode& hippy_value);
 
@@ -247,6 +283,9 @@ class DomNode : public std::enable_shared_from_this<DomNode> {
   bool is_layout_width_nan_ = false;
   bool is_layout_height_nan_ = false;
 
+  bool layout_dirty_ = false;           // style or children changed since last layout collection
+  bool has_dirty_descendant_ = false;   // some descendant (before the nearest layout boundary) is dirty
+
   // Node can only be eliminated for the first time,
   // and if they cannot be eliminated for the first time, they cannot be eliminated at all times.
   bool enable_eliminated_ = true;
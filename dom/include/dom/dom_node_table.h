@@ -0,0 +1,90 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace hippy {
+inline namespace dom {
+
+class DomNode;
+
+/**
+ * Id indexed table of the nodes attached to a RootNode. Ids allocated by the js side are dense and increase
+ * monotonically, so ids below kMaxDenseId are stored in lazily allocated fixed size pages and found with two
+ * array indexes, larger ids fall back to a hash map.
+ *
+ * Every slot keeps a generation which is bumped whenever its node is erased, a (id, generation) pair taken
+ * while the node is attached tells whether the id has since been reused by another node.
+ */
+class DomNodeTable {
+ public:
+  static constexpr uint32_t kPageBits = 10;
+  static constexpr uint32_t kPageSize = 1 << kPageBits;
+  static constexpr uint32_t kMaxDenseId = 1 << 22;
+
+  DomNodeTable() = default;
+  DomNodeTable(const DomNodeTable&) = delete;
+  DomNodeTable& operator=(const DomNodeTable&) = delete;
+
+  // returns false if the id is already taken
+  bool Insert(const std::shared_ptr<DomNode>& node);
+  // returns false if the id is not in the table
+  bool Erase(uint32_t id);
+  std::shared_ptr<DomNode> Find(uint32_t id) const;
+  /**
+   * @brief 批量查找, 结果与 ids 一一对应, 不存在的 id 对应 nullptr
+   */
+  void Find(const std::vector<uint32_t>& ids, std::vector<std::shared_ptr<DomNode>>& nodes) const;
+  inline bool Contains(uint32_t id) const { return GetSlot(id) != nullptr; }
+  // whether this exact node is attached, without locking the weak reference
+  bool Contains(const DomNode& node) const;
+  uint32_t GetGeneration(uint32_t id) const;
+  inline size_t Size() const { return size_; }
+  inline size_t GetPageCount() const { return page_count_; }
+  void ForEach(const std::function<void(const std::shared_ptr<DomNode>&)>& on_node) const;
+
+ private:
+  struct Slot {
+    std::weak_ptr<DomNode> node;
+    const DomNode* raw = nullptr;  // identity of the node, only compared and never dereferenced
+    uint32_t generation = 0;
+  };
+  using Page = std::array<Slot, kPageSize>;
+
+  // the slot of an attached node, nullptr if the id is free
+  const Slot* GetSlot(uint32_t id) const;
+  Slot& GetOrCreateSlot(uint32_t id);
+
+  std::vector<std::unique_ptr<Page>> pages_;
+  std::unordered_map<uint32_t, Slot> sparse_slots_;
+  size_t size_ = 0;
+  size_t page_count_ = 0;
+};
+
+}  // namespace dom
+}  // namespace hippy
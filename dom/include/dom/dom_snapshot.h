@@ -0,0 +1,71 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dom/dom_listener.h"
+
+namespace hippy {
+inline namespace dom {
+
+class RootNode;
+struct DomInfo;
+
+/**
+ * Flat binary snapshot of a dom tree, used for the instant first paint. All offsets are relative to the start
+ * of the buffer and all fields are little endian, so a snapshot can be restored by reading a memory mapped file in
+ * place, without building an intermediate HippyValue tree:
+ *
+ *   Header | Node table | Value table | String table | Blob
+ *
+ * - Node table: one fixed size record per node in pre-order, root node first, with the layout results
+ * - Value table: style and ext entries of all nodes, a node refers to a contiguous range of it
+ * - String table: (offset, length) of every interned string (tag names, view names, property names and string
+ *   values) in the blob
+ * - Blob: string bytes, and object/array values encoded by footstone::value::Serializer
+ */
+class DomSnapshot {
+ public:
+  static constexpr uint32_t kMagic = 0x4E534448;  // "HDSN"
+  static constexpr uint32_t kVersion = 1;
+
+  // returns an empty buffer if the snapshot exceeds the 4GB addressable by its uint32_t offsets
+  static std::string Encode(const std::shared_ptr<RootNode>& root_node);
+  // whether the buffer starts with the header of a snapshot of this version
+  static bool IsSnapshot(const uint8_t* data, size_t length);
+  /**
+   * @brief 原地读取快照并创建 DomNode, 节点已带有快照中的布局结果, 根节点 id 替换为 root_node 的 id
+   * @param data 快照数据, 只需在调用期间有效
+   * @param nodes 除根节点外的全部节点, 按先序排列, 可直接用于 CreateDomNodes
+   * @param root_layout 快照中根节点的布局结果
+   * @return 快照是否完整有效
+   */
+  static bool Decode(const uint8_t* data, size_t length, const std::shared_ptr<RootNode>& root_node,
+                     std::vector<std::shared_ptr<DomInfo>>& nodes, LayoutResult& root_layout);
+};
+
+}  // namespace dom
+}  // namespace hippy
@@ -22,6 +22,7 @@
 
 #include <functional>
 #include <unordered_map>
+#include "dom/dom_arena.h"
 #include "footstone/hippy_value.h"
 
 namespace hippy {
@@ -127,6 +128,13 @@ class LayoutNode {
 };
 
 std::shared_ptr<LayoutNode> CreateLayoutNode();
+std::shared_ptr<LayoutNode> CreateLayoutNode(const std::shared_ptr<DomArena>& arena);
+
+/**
+ * @brief 布局引擎是否支持并行布局: 不同的子树可以在多个线程上同时计算, 且单独计算一个宽高固定的子树与整棵树
+ * 计算的结果一致. 不支持时 RootNode 不会开启并行布局
+ */
+bool IsConcurrentLayoutSupported();
 
 }  // namespace dom
 }  // namespace hippy
@@ -0,0 +1,163 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "footstone/hippy_value.h"
+
+namespace hippy {
+inline namespace dom {
+
+/**
+ * Layout properties understood by the layout engines. The declaration order is the order in which the styles are
+ * applied, shorthands come before their longhands so that e.g. marginLeft overrides margin in the same update.
+ */
+enum class LayoutStyle : uint8_t {
+  kWidth,
+  kMinWidth,
+  kMaxWidth,
+  kHeight,
+  kMinHeight,
+  kMaxHeight,
+  kFlex,
+  kFlexGrow,
+  kFlexShrink,
+  kFlexBasis,
+  kDirection,
+  kFlexDirection,
+  kFlexWrap,
+  kAlignSelf,
+  kAlignItems,
+  kJustifyContent,
+  kOverflow,
+  kDisplay,
+  kMargin,
+  kMarginVertical,
+  kMarginHorizontal,
+  kMarginLeft,
+  kMarginRight,
+  kMarginTop,
+  kMarginBottom,
+  kPadding,
+  kPaddingVertical,
+  kPaddingHorizontal,
+  kPaddingLeft,
+  kPaddingRight,
+  kPaddingTop,
+  kPaddingBottom,
+  kBorderWidth,
+  kBorderLeftWidth,
+  kBorderTopWidth,
+  kBorderRightWidth,
+  kBorderBottomWidth,
+  kLeft,
+  kRight,
+  kTop,
+  kBottom,
+  kPosition,
+  kAspectRatio,
+  kAlignContent,
+  kCount
+};
+
+/**
+ * Keyword of an enumerated layout value, e.g. "row-reverse" of flexDirection. Each layout engine keeps its own
+ * small constexpr tables since the target enums differ.
+ */
+template <typename T>
+struct LayoutKeyword {
+  const char* name;
+  T value;
+};
+
+template <typename T, size_t N>
+T LookupLayoutKeyword(const LayoutKeyword<T> (&table)[N], const std::string& name, T default_value) {
+  for (const auto& keyword: table) {
+    if (strcmp(name.c_str(), keyword.name) == 0) {
+      return keyword.value;
+    }
+  }
+  return default_value;
+}
+
+/**
+ * Collects the layout part of a style update in one pass over the update map and the delete list, then hands the
+ * styles to typed setters in LayoutStyle order. Non layout properties are dropped by a single hash probe, so the
+ * cost is proportional to the size of the update instead of the number of supported layout properties.
+ */
+class LayoutStyleParser {
+ public:
+  using HippyValue = footstone::value::HippyValue;
+  using DomValueMap = std::unordered_map<std::string, std::shared_ptr<HippyValue>>;
+
+  static_assert(static_cast<size_t>(LayoutStyle::kCount) <= 64, "LayoutStyle must fit in a 64 bit mask");
+
+  LayoutStyleParser(const DomValueMap& style_update, const std::vector<std::string>& style_delete);
+
+  static bool Lookup(const std::string& name, LayoutStyle& style);
+
+  /**
+   * @brief dispatch the collected styles in LayoutStyle order, an update wins over a delete of the same style
+   * @param on_update void(LayoutStyle style, const HippyValue& value)
+   * @param on_delete void(LayoutStyle style)
+   */
+  template <typename UpdateHandler, typename DeleteHandler>
+  void Dispatch(UpdateHandler&& on_update, DeleteHandler&& on_delete) const {
+    auto mask = update_mask_ | delete_mask_;
+    for (uint32_t index = 0; mask != 0; ++index, mask >>= 1) {
+      if ((mask & 1) == 0) {
+        continue;
+      }
+      auto style = static_cast<LayoutStyle>(index);
+      if (update_mask_ & Bit(style)) {
+        on_update(style, *values_[index]);
+      } else {
+        on_delete(style);
+      }
+    }
+  }
+
+  inline const HippyValue* GetUpdate(LayoutStyle style) const {
+    return (update_mask_ & Bit(style)) ? values_[static_cast<size_t>(style)] : nullptr;
+  }
+  inline bool IsDeleted(LayoutStyle style) const {
+    return (delete_mask_ & Bit(style)) && !(update_mask_ & Bit(style));
+  }
+  inline bool empty() const { return (update_mask_ | delete_mask_) == 0; }
+
+ private:
+  static constexpr uint64_t Bit(LayoutStyle style) { return uint64_t{1} << static_cast<uint32_t>(style); }
+
+  uint64_t update_mask_ = 0;
+  uint64_t delete_mask_ = 0;
+  // only the entries whose bit is set in update_mask_ are valid
+  std::array<const HippyValue*, static_cast<size_t>(LayoutStyle::kCount)> values_;
+};
+
+}  // namespace dom
+}  // namespace hippy
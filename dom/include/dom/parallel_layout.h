@@ -0,0 +1,78 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "footstone/task_runner.h"
+#include "footstone/worker_manager.h"
+
+namespace hippy {
+inline namespace dom {
+
+class DomNode;
+
+/**
+ * Opt-in parallel layout, only enabled by embedders through RootNode::EnableParallelLayout and off by default.
+ * Layout boundaries (nodes with fixed width and height, see DomNode::IsLayoutBoundary) that are siblings of each
+ * other are independent once their parent is known: their size does not depend on their content, and their content
+ * only depends on their size. Before the serial layout pass from the root, such dirty sibling subtrees are laid out
+ * on a dedicated worker pool, so the serial pass only has to position them and takes their cached results.
+ *
+ * Only subtrees whose root size the parent cannot change (no flex, min/max or aspect ratio styles) and that contain
+ * no measure function are taken, see IsIndependentSubtree, so platform text measurement always runs on the dom
+ * thread. The layout engine must be able to lay out distinct subtrees concurrently and give a subtree laid out on
+ * its own the same result as the full tree pass, see IsConcurrentLayoutSupported.
+ */
+class ParallelLayout {
+ public:
+  using TaskRunner = footstone::runner::TaskRunner;
+  using WorkerManager = footstone::runner::WorkerManager;
+
+  // fewer subtrees than this are laid out serially, the dispatch costs more than it saves
+  static constexpr uint32_t kMinSubtreeCount = 4;
+
+  explicit ParallelLayout(uint32_t parallelism);
+  ~ParallelLayout();
+
+  /**
+   * @brief 在 dom 线程调用, 并行计算脏区域中相互独立的子树的布局, 返回之前所有子树都已计算完成.
+   * worker 未能及时开始的部分由调用线程串行计算, 所以不依赖 worker 的调度
+   * @param root 根节点
+   * @param boundaries 根节点之外的脏区域起点, 即 RootNode 记录的布局边界
+   * @return 并行计算的子树个数, 为 0 时由调用方串行计算
+   */
+  uint32_t CalculateIndependentSubtrees(const std::shared_ptr<DomNode>& root,
+                                        const std::vector<std::shared_ptr<DomNode>>& boundaries);
+
+  static bool IsIndependentSubtree(const std::shared_ptr<DomNode>& node);
+  static void CollectIndependentSubtrees(const std::shared_ptr<DomNode>& node,
+                                         std::vector<std::shared_ptr<DomNode>>& subtrees);
+
+ private:
+  std::shared_ptr<WorkerManager> worker_manager_;
+  std::vector<std::shared_ptr<TaskRunner>> runners_;
+};
+
+}  // namespace dom
+}  // namespace hippy
@@ -0,0 +1,148 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dom/dom_listener.h"
+#include "footstone/hippy_value.h"
+
+namespace hippy {
+inline namespace dom {
+
+class DomNode;
+
+enum class RenderOpType : uint8_t { kCreate = 1, kUpdate = 2, kMove = 3, kLayout = 4 };
+
+enum class RenderOpValueTag : uint8_t {
+  kUndefined = 0,
+  kNull = 1,
+  kFalse = 2,
+  kTrue = 3,
+  kInt32 = 4,   // zigzag varint
+  kUint32 = 5,  // varint
+  kDouble = 6,  // 8 bytes
+  kString = 7,  // varint length + utf8 bytes
+  kArray = 8,   // varint count + values
+  kObject = 9   // varint count + (varint length + utf8 bytes, value) pairs
+};
+
+/**
+ * Flat binary encoding of a render op batch, written straight from DomNodes into a buffer reused across batches.
+ * It replaces building a HippyValue array of per-node maps and serializing it again. All numbers are little endian.
+ *
+ *   header  magic u32 | version u8 | op type u8 | reserved u16 | node count u32 | key count u32
+ *   create  id u32 | pid u32 | index i32 | name key | prop count u32 | (key, value) * prop count
+ *   update  create record | delete count varint | key * delete count
+ *   move    id u32 | pid u32 | index i32
+ *   layout  id u32 | flags u8 | left, top, width, height f32 [| padding left, top, right, bottom f32]
+ *
+ * View names and top level property names are keys: a varint index into the key table of the batch, the index
+ * equal to the current table size defines the next key inline as varint length + utf8 bytes. So every name is
+ * sent once per batch. Keys of nested objects are arbitrary user data and are written inline.
+ */
+class RenderOpEncoder {
+ public:
+  using StyleFilter = std::function<bool(const std::string&)>;
+
+  static constexpr uint32_t kMagic = 0x504F5248;  // "HROP"
+  static constexpr uint8_t kVersion = 1;
+  static constexpr size_t kHeaderSize = 16;
+  static constexpr uint8_t kLayoutWithPadding = 1;
+
+  RenderOpEncoder() = default;
+  RenderOpEncoder(const RenderOpEncoder&) = delete;
+  RenderOpEncoder& operator=(const RenderOpEncoder&) = delete;
+
+  /**
+   * @brief 开始一个新批次，复用上一批次的内存
+   */
+  void Begin(RenderOpType type);
+
+  /**
+   * @brief 写入创建节点，样式属性经 style_filter 过滤（为空时全部写入），ext 属性全部写入且覆盖同名样式
+   */
+  void AddCreate(const std::shared_ptr<DomNode>& node, const StyleFilter& style_filter = nullptr);
+  void AddUpdate(const std::shared_ptr<DomNode>& node);
+  void AddMove(const std::shared_ptr<DomNode>& node);
+
+  /**
+   * @brief 写入布局结果，所有值乘以 scale（dp 转 px）
+   */
+  void AddLayout(uint32_t id, const LayoutResult& result, bool with_padding, float scale);
+
+  /**
+   * @brief 结束批次并回填头部，返回的内存在下一次 Begin 前有效
+   */
+  std::pair<const uint8_t*, size_t> Finish();
+
+  /**
+   * @brief 已分配的内存，Finish 返回的地址起 GetCapacity 字节均可访问，内存重新分配后地址会变化
+   */
+  inline size_t GetCapacity() const { return buffer_.size(); }
+
+  /**
+   * @brief 释放批次内存，下一次 Begin 重新分配
+   */
+  void ReleaseMemory();
+
+ private:
+  using DomValueMap = std::unordered_map<std::string, std::shared_ptr<footstone::value::HippyValue>>;
+  using KeyTable = std::unordered_map<std::string, uint32_t>;
+
+  uint8_t* Reserve(size_t length);
+  void WriteUint8(uint8_t value);
+  void WriteUint32(uint32_t value);
+  void WriteFloat(float value);
+  void WriteVarint(uint64_t value);
+  void WriteString(const std::string& value);
+  void WriteKey(const std::string& name);
+  void WriteValue(const footstone::value::HippyValue& value);
+  void WriteProps(const std::shared_ptr<DomValueMap>& props, const StyleFilter& filter, uint32_t& count);
+  void WriteNodeHeader(const std::shared_ptr<DomNode>& node);
+
+  RenderOpType type_ = RenderOpType::kCreate;
+  std::vector<uint8_t> buffer_;
+  size_t size_ = 0;
+  uint32_t node_count_ = 0;
+  uint32_t key_count_ = 0;
+  // 当前批次已发送的 key 及其序号，每个批次开始时清空，只保留本批次出现过的名字
+  KeyTable keys_;
+};
+
+/**
+ * Decodes a batch written by RenderOpEncoder into the HippyValue array the render managers used to serialize, i.e.
+ * one object per node with id, pId, index, name, props and deleteProps, or id, left, top, width, height and paddings
+ * for layout ops. Returns false on malformed input.
+ */
+class RenderOpDecoder {
+ public:
+  static bool Decode(const uint8_t* data, size_t length, RenderOpType& type, footstone::value::HippyValue& nodes);
+};
+
+}  // namespace dom
+}  // namespace hippy
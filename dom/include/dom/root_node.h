@@ -23,9 +23,13 @@
 #include <stack>
 
 #include "dom/diff_utils.h"
+#include "dom/dom_arena.h"
 #include "dom/dom_node.h"
+#include "dom/dom_node_table.h"
+#include "dom/parallel_layout.h"
 #include "footstone/persistent_object_map.h"
 #include "footstone/task_runner.h"
+#include "footstone/worker_manager.h"
 
 namespace hippy {
 inline namespace dom {
@@ -43,14 +47,46 @@ class DomNodeStyleDiffer {
 
   bool Calculate(const std::shared_ptr<hippy::dom::RootNode>& root_node, const std::shared_ptr<DomInfo>& dom_info,
                  hippy::dom::DiffValue& style_diff, hippy::dom::DiffValue& ext_style_diff);
-  void Reset() {
-    node_ext_style_map_.clear();
-    node_style_map_.clear();
-  }
+  void Reset() { node_snapshot_map_.clear(); }
 
  private:
-  std::unordered_map<uint32_t, std::unordered_map<std::string, std::shared_ptr<HippyValue>>> node_style_map_;
-  std::unordered_map<uint32_t, std::unordered_map<std::string, std::shared_ptr<HippyValue>>> node_ext_style_map_;
+  /**
+   * batch 中节点第一次更新前的 style 快照. style map 与 dom node 共享, 只增加引用计数, dom node 在原地修改共享的
+   * map 或 value 之前会先复制 (写时复制), 所以快照在整个 batch 中保持不变, batch 内的每次更新都直接与它做 diff.
+   */
+  struct StyleSnapshot {
+    std::shared_ptr<DomValueMap> style;
+    std::shared_ptr<DomValueMap> ext_style;
+  };
+
+  std::unordered_map<uint32_t, StyleSnapshot> node_snapshot_map_;
+};
+
+/**
+ * Node statistics of a RootNode. The counters are maintained incrementally when nodes are registered to or
+ * unregistered from the root node, so reading them never traverses the dom tree.
+ * Please note that they must be read in dom thread.
+ */
+struct DomNodeStatistics {
+  uint32_t total_count = 0;        // number of registered nodes, root node excluded
+  uint32_t layout_only_count = 0;  // number of nodes eliminated by layer optimization
+  std::unordered_map<std::string, uint32_t> view_name_count;
+
+  inline uint32_t GetRenderedCount() const { return total_count - layout_only_count; }
+};
+
+/**
+ * Counters of the dom operation coalescing pass of the last batch. Operations count the render manager calls,
+ * nodes count the node entries carried by them.
+ */
+struct DomOperationStatistics {
+  uint32_t operation_count = 0;            // operations before coalescing
+  uint32_t node_count = 0;                 // node entries before coalescing
+  uint32_t coalesced_operation_count = 0;  // operations sent to render manager
+  uint32_t coalesced_node_count = 0;       // node entries sent to render manager
+
+  inline uint32_t GetEliminatedOperationCount() const { return operation_count - coalesced_operation_count; }
+  inline uint32_t GetEliminatedNodeCount() const { return node_count - coalesced_node_count; }
 };
 
 class RootNode : public DomNode {
@@ -68,6 +104,8 @@ class RootNode : public DomNode {
     dom_manager_ = dom_manager;
   }
   inline std::shared_ptr<AnimationManager> GetAnimationManager() { return animation_manager_; }
+  // the arena is created with the root node and never replaced, so it can be read in any thread
+  inline const std::shared_ptr<DomArena>& GetArena() const { return arena_; }
 
   virtual void AddEventListener(const std::string& name, uint64_t listener_id, bool use_capture,
                                 const EventCallback& cb) override;
@@ -84,11 +122,38 @@ class RootNode : public DomNode {
   void DoAndFlushLayout(const std::shared_ptr<RenderManager>& render_manager);
   void AddEvent(uint32_t id, const std::string& event_name);
   void RemoveEvent(uint32_t id, const std::string& event_name);
+  void OnEventListenerAdded(const DomNode& node, const std::string& name);
+  void OnEventListenerRemoved(const DomNode& node, const std::string& name);
   void HandleEvent(const std::shared_ptr<DomEvent>& event) override;
+  // 树中是否有节点监听了该事件, 没有时事件分发直接返回, 不再遍历捕获/冒泡路径
+  bool HasEventListenerInTree(const std::string& name) const;
   void UpdateRenderNode(const std::shared_ptr<DomNode>& node);
-  uint32_t GetChildCount();
+  void OnDomNodeLayoutOnlyChanged(const std::shared_ptr<DomNode>& node);
+  inline uint32_t GetChildCount() const { return node_statistics_.total_count; }
+  inline const DomNodeStatistics& GetNodeStatistics() const { return node_statistics_; }
+  inline const DomOperationStatistics& GetDomOperationStatistics() const { return dom_operation_statistics_; }
+  // number of nodes visited by the last layout output collection of DoAndFlushLayout
+  inline uint32_t GetLayoutVisitCount() const { return layout_visit_count_; }
+  void AddLayoutDirtyBoundary(const std::shared_ptr<DomNode>& node);
+  /**
+   * @brief 开启并行布局, 相互独立的脏子树在独占的 parallelism - 1 个 worker 与 dom 线程上并行计算.
+   * 仅供接入方按需开启, 框架内默认不开启; 含 measure function 的子树始终在 dom 线程计算, 详见 ParallelLayout
+   * @return 布局引擎不支持并行布局 (见 IsConcurrentLayoutSupported) 或 parallelism 小于 2 时返回 false, 保持串行布局
+   */
+  bool EnableParallelLayout(uint32_t parallelism);
+  void DisableParallelLayout();
+  // number of subtrees laid out in parallel by the last DoAndFlushLayout, 0 if it was serial
+  inline uint32_t GetParallelLayoutSubtreeCount() const { return parallel_layout_subtree_count_; }
+  /**
+   * @brief 节点的布局结果已从快照恢复, 下一次 DoAndFlushLayout 直接下发恢复的布局结果, 跳过一次布局计算.
+   * 节点仍保持脏标记, 之后的布局会正常计算
+   */
+  inline void MarkLayoutRestored() { layout_restored_ = true; }
 
   std::shared_ptr<DomNode> GetNode(uint32_t id);
+  // 批量查找节点, 结果与 ids 一一对应, 不存在的节点为 nullptr
+  void GetNodes(const std::vector<uint32_t>& ids, std::vector<std::shared_ptr<DomNode>>& nodes);
+  inline const DomNodeTable& GetNodeTable() const { return nodes_; }
   std::tuple<float, float> GetRootSize();
   void SetRootSize(float width, float height);
   void SetRootOrigin(float x, float y);
@@ -119,13 +184,27 @@ class RootNode : public DomNode {
   std::vector<DomOperation> dom_operations_;
   std::vector<EventOperation> event_operations_;
 
+  void CoalesceDomOperations();
   void FlushDomOperations(const std::shared_ptr<RenderManager>& render_manager);
   void FlushEventOperations(const std::shared_ptr<RenderManager>& render_manager);
   void OnDomNodeCreated(const std::shared_ptr<DomNode>& node);
   void OnDomNodeDeleted(const std::shared_ptr<DomNode>& node);
+  void OnEventListenerCountDecreased(const std::string& name);
+  bool IsAttached(const DomNode& node) const;
+  void HandleDomEvent(const std::shared_ptr<DomNode>& node, const std::string& name);
   std::weak_ptr<RootNode> GetWeakSelf();
 
-  std::unordered_map<uint32_t, std::weak_ptr<DomNode>> nodes_;
+  std::shared_ptr<DomArena> arena_;
+  DomNodeTable nodes_;
+  DomNodeStatistics node_statistics_;
+  DomOperationStatistics dom_operation_statistics_;
+  // number of attached nodes listening to each event name
+  std::unordered_map<std::string, uint32_t> event_listener_count_;
+  std::vector<std::weak_ptr<DomNode>> layout_dirty_boundaries_;
+  uint32_t layout_visit_count_ = 0;
+  std::unique_ptr<ParallelLayout> parallel_layout_;
+  uint32_t parallel_layout_subtree_count_ = 0;
+  bool layout_restored_ = false;
   std::weak_ptr<DomManager> dom_manager_;
   std::vector<std::shared_ptr<DomActionInterceptor>> interceptors_;
   std::shared_ptr<AnimationManager> animation_manager_;
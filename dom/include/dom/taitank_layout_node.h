@@ -22,6 +22,7 @@
 
 #include <cstdint>
 #include "dom/layout_node.h"
+#include "dom/layout_style_parser.h"
 #include "taitank.h"
 
 namespace hippy {
@@ -225,6 +226,20 @@ class TaitankLayoutNode : public LayoutNode, public std::enable_shared_from_this
   void Parser(const std::unordered_map<std::string, std::shared_ptr<footstone::value::HippyValue>>& style_update,
               const std::vector<std::string>& style_delete);
 
+  /**
+   * @brief 设置单个排版属性
+   * @param style 属性
+   * @param value 属性值
+   */
+  void SetStyle(LayoutStyle style, const footstone::value::HippyValue& value);
+
+  /**
+   * @brief 将单个排版属性恢复为默认值
+   * @param style 属性
+   * @param parser 本次更新，部分属性的默认值取决于同一次更新中的简写属性
+   */
+  void ResetStyle(LayoutStyle style, const LayoutStyleParser& parser);
+
   /**
    * @brief 设置方向
    * @param direction 方向(DirectionInherit|DirectionLTR|DirectionRTL)
@@ -0,0 +1,133 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dom/layout_node.h"
+#include "footstone/hippy_value.h"
+
+namespace hippy {
+inline namespace dom {
+
+class DomNode;
+
+/**
+ * Cache of text measure results in front of the platform measure callbacks, shared by all nodes of a render
+ * manager. Results are keyed by the content of the measured subtree, i.e. the view name and every non layout
+ * property of the node (text, font attributes...), every property of its descendants (nested spans), plus the
+ * width/height constraints and measure modes. So the same label measured again after a relayout, or a recycled
+ * list item showing the same label, skips the round trip to the platform. Entries are looked up by a hash of the
+ * content and keep a full copy of it, a hit is only taken when the copy equals the measured node.
+ *
+ * Changing the text props changes the key by itself, so render managers need no extra call on DOM updates.
+ * Clear must be called when the platform side result may change without a DOM change, e.g. the font scale of
+ * the Android renderer (see NativeRenderManager::BeforeLayout). Only wrap measure functions that depend on DOM
+ * content alone and have no side effects: TextInput keeps the text being edited on the platform side and must
+ * not be cached.
+ * Only the Android renderer uses the cache, its measure functions are JNI round trips. The other renderers
+ * (iOS, TDF, OHOS with USE_C_MEASURE) measure text in process without such a crossing.
+ * Measure functions may run on layout worker threads (see ParallelLayout), the cache is thread-safe.
+ */
+class TextMeasureCache : public std::enable_shared_from_this<TextMeasureCache> {
+ public:
+  static constexpr size_t kDefaultCapacity = 1024;
+  // 同一内容在不同约束下的结果个数上限，超出时替换最早的
+  static constexpr size_t kMaxConstraintsPerContent = 4;
+
+  struct Stats {
+    uint64_t hit_count = 0;
+    uint64_t miss_count = 0;
+    uint64_t evict_count = 0;
+    size_t size = 0;
+  };
+
+  explicit TextMeasureCache(size_t capacity = kDefaultCapacity);
+
+  /**
+   * @brief 包装平台的 measure 回调，命中缓存时不再调用 measure
+   * @param node 文本节点
+   * @param measure 平台 measure 回调
+   * @return 带缓存的 measure 回调
+   */
+  MeasureFunction Wrap(const std::shared_ptr<DomNode>& node, MeasureFunction measure);
+
+  /**
+   * @brief 丢弃所有测量结果，平台字体环境变化（如字体缩放）时调用
+   */
+  void Clear();
+
+  Stats GetStats() const;
+
+  static uint64_t HashContent(const std::shared_ptr<DomNode>& node);
+
+ private:
+  struct Constraints {
+    float width;
+    float height;
+    LayoutMeasureMode width_measure_mode;
+    LayoutMeasureMode height_measure_mode;
+
+    bool operator==(const Constraints& other) const;
+  };
+
+  // 被测子树内容的副本, 属性按名字排序
+  struct Content {
+    using Props = std::vector<std::pair<std::string, footstone::value::HippyValue>>;
+
+    std::string view_name;
+    Props style;
+    Props ext;
+    std::vector<Content> children;
+  };
+
+  struct Entry {
+    uint64_t content_hash;
+    Content content;
+    std::vector<std::pair<Constraints, LayoutSize>> results;
+  };
+
+  static Content MakeContent(const std::shared_ptr<DomNode>& node, bool skip_layout_style);
+  static bool MatchContent(const Content& content, const std::shared_ptr<DomNode>& node, bool skip_layout_style);
+
+  static Constraints MakeConstraints(float width, LayoutMeasureMode width_measure_mode, float height,
+                                     LayoutMeasureMode height_measure_mode);
+  LayoutSize Measure(const std::shared_ptr<DomNode>& node, const MeasureFunction& measure,
+                     float width, LayoutMeasureMode width_measure_mode, float height,
+                     LayoutMeasureMode height_measure_mode, void* layout_context);
+
+  mutable std::mutex mutex_;
+  size_t capacity_;
+  // 按最近使用排序，链表头最新
+  std::list<Entry> entries_;
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+  Stats stats_;
+};
+
+}  // namespace dom
+}  // namespace hippy
@@ -26,6 +26,7 @@
 #pragma clang diagnostic pop
 
 #include "dom/layout_node.h"
+#include "dom/layout_style_parser.h"
 
 namespace hippy {
 inline namespace dom {
@@ -109,21 +110,25 @@ class YogaLayoutNode : public LayoutNode, public std::enable_shared_from_this<Yo
   void Parser(const std::unordered_map<std::string, std::shared_ptr<footstone::value::HippyValue>>& style_update,
               const std::vector<std::string>& style_delete);
 
-  void SetYGWidth(std::shared_ptr<footstone::value::HippyValue> hippy_value);
+  void SetStyle(LayoutStyle style, const footstone::value::HippyValue& value);
 
-  void SetYGHeight(std::shared_ptr<footstone::value::HippyValue> hippy_value);
+  void ResetStyle(LayoutStyle style);
+
+  void SetYGWidth(const footstone::value::HippyValue& hippy_value);
+
+  void SetYGHeight(const footstone::value::HippyValue& hippy_value);
 
   void SetDirection(YGDirection direction);
 
-  void SetYGMaxWidth(std::shared_ptr<footstone::value::HippyValue> hippy_value);
+  void SetYGMaxWidth(const footstone::value::HippyValue& hippy_value);
 
-  void SetYGMaxHeight(std::shared_ptr<footstone::value::HippyValue> hippy_value);
+  void SetYGMaxHeight(const footstone::value::HippyValue& hippy_value);
 
-  void SetYGMinWidth(std::shared_ptr<footstone::value::HippyValue> hippy_value);
+  void SetYGMinWidth(const footstone::value::HippyValue& hippy_value);
 
-  void SetYGMinHeight(std::shared_ptr<footstone::value::HippyValue> hippy_value);
+  void SetYGMinHeight(const footstone::value::HippyValue& hippy_value);
 
-  void SetYGFlexBasis(std::shared_ptr<footstone::value::HippyValue> dom_value);
+  void SetYGFlexBasis(const footstone::value::HippyValue& hippy_value);
 
   void SetFlex(float flex);
 
@@ -135,13 +140,13 @@ class YogaLayoutNode : public LayoutNode, public std::enable_shared_from_this<Yo
 
   void SetPositionType(YGPositionType position_type);
 
-  void SetYGPosition(YGEdge edge, std::shared_ptr<footstone::value::HippyValue> hippy_value);
+  void SetYGPosition(YGEdge edge, const footstone::value::HippyValue& hippy_value);
 
-  void SetYGMargin(YGEdge edge, std::shared_ptr<footstone::value::HippyValue> hippy_value);
+  void SetYGMargin(YGEdge edge, const footstone::value::HippyValue& hippy_value);
 
-  void SetYGPadding(YGEdge edge, std::shared_ptr<footstone::value::HippyValue> hippy_value);
+  void SetYGPadding(YGEdge edge, const footstone::value::HippyValue& hippy_value);
 
-  void SetYGBorder(YGEdge edge, std::shared_ptr<footstone::value::HippyValue> hippy_value);
+  void SetYGBorder(YGEdge edge, const footstone::value::HippyValue& hippy_value);
 
   void SetFlexWrap(YGWrap wrap_mode);
 
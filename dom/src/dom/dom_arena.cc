@@ -0,0 +1,94 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dom/dom_arena.h"
+
+#include <algorithm>
+
+#include "footstone/check.h"
+#include "footstone/logging.h"
+
+namespace hippy {
+inline namespace dom {
+
+DomArena::DomArena(size_t slab_size)
+    : slab_size_(std::max(slab_size, kMaxBlockSize)), free_lists_(GetSizeClass(kMaxBlockSize) + 1, nullptr) {}
+
+DomArena::~DomArena() {
+  FOOTSTONE_DCHECK(live_block_count_ == 0);
+  for (auto slab : slabs_) {
+    ::operator delete(slab);
+  }
+}
+
+void* DomArena::Allocate(size_t size) {
+  if (size > kMaxBlockSize) {
+    return ::operator new(size);
+  }
+  auto size_class = GetSizeClass(size);
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++live_block_count_;
+  auto& free_list = free_lists_[size_class];
+  if (free_list) {
+    auto block = free_list;
+    free_list = block->next;
+    return block;
+  }
+  auto block_size = size_class * kAlignment;
+  if (cursor_ == nullptr || static_cast<size_t>(end_ - cursor_) < block_size) {
+    auto slab = static_cast<uint8_t*>(::operator new(slab_size_));
+    slabs_.push_back(slab);
+    cursor_ = slab;
+    end_ = slab + slab_size_;
+  }
+  auto block = cursor_;
+  cursor_ += block_size;
+  return block;
+}
+
+void DomArena::Deallocate(void* ptr, size_t size) {
+  if (!ptr) {
+    return;
+  }
+  if (size > kMaxBlockSize) {
+    ::operator delete(ptr);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  FOOTSTONE_DCHECK(live_block_count_ > 0);
+  --live_block_count_;
+  auto block = static_cast<FreeBlock*>(ptr);
+  auto& free_list = free_lists_[GetSizeClass(size)];
+  block->next = free_list;
+  free_list = block;
+}
+
+size_t DomArena::GetSlabCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return slabs_.size();
+}
+
+size_t DomArena::GetLiveBlockCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return live_block_count_;
+}
+
+}  // namespace dom
+}  // namespace hippy
@@ -0,0 +1,108 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "dom/dom_arena.h"
+#include "dom/dom_node.h"
+#include "dom/root_node.h"
+
+namespace hippy {
+inline namespace dom {
+inline namespace testing {
+
+using DomValueMapType = std::unordered_map<std::string, std::shared_ptr<HippyValue>>;
+
+constexpr uint32_t kRootId = 1;
+constexpr uint32_t kChildrenPerNode = 10;
+
+std::shared_ptr<DomNode> MakeTreeNode(const std::shared_ptr<RootNode>& root_node, uint32_t id, uint32_t pid) {
+  auto style = std::make_shared<DomValueMapType>();
+  (*style)["width"] = std::make_shared<HippyValue>(100.0);
+  (*style)["height"] = std::make_shared<HippyValue>(50.0);
+  auto ext = std::make_shared<DomValueMapType>();
+  return root_node->GetArena()->MakeShared<DomNode>(id, pid, 0, "div", "View", style, ext, root_node);
+}
+
+TEST(DomArenaTest, ReuseFreedBlock) {
+  auto arena = std::make_shared<DomArena>();
+  auto first = arena->Allocate(40);
+  arena->Deallocate(first, 40);
+  auto second = arena->Allocate(48);
+  EXPECT_EQ(first, second) << "blocks of the same size class should be recycled";
+  EXPECT_EQ(arena->GetLiveBlockCount(), 1);
+  arena->Deallocate(second, 48);
+  EXPECT_EQ(arena->GetLiveBlockCount(), 0);
+  EXPECT_EQ(arena->GetSlabCount(), 1);
+}
+
+TEST(DomArenaTest, LargeBlockBypassSlab) {
+  auto arena = std::make_shared<DomArena>();
+  auto block = arena->Allocate(DomArena::kMaxBlockSize + 1);
+  EXPECT_NE(block, nullptr);
+  EXPECT_EQ(arena->GetSlabCount(), 0);
+  arena->Deallocate(block, DomArena::kMaxBlockSize + 1);
+}
+
+TEST(DomArenaTest, ArenaOutlivesObjects) {
+  auto arena = std::make_shared<DomArena>();
+  std::weak_ptr<DomArena> weak_arena = arena;
+  auto info = arena->MakeShared<RefInfo>(1, 0);
+  arena = nullptr;
+  EXPECT_FALSE(weak_arena.expired()) << "objects should keep the arena alive";
+  info = nullptr;
+  EXPECT_TRUE(weak_arena.expired());
+}
+
+TEST(DomArenaTest, CreateAndDeleteTree) {
+  constexpr uint32_t kNodeCount = 1000;
+  auto root_node = std::make_shared<RootNode>(kRootId);
+  auto arena = root_node->GetArena();
+  {
+    std::vector<std::shared_ptr<DomInfo>> infos;
+    infos.reserve(kNodeCount);
+    // every node has kChildrenPerNode children
+    for (uint32_t i = 0; i < kNodeCount; ++i) {
+      auto id = kRootId + 1 + i;
+      auto pid = i < kChildrenPerNode ? kRootId : kRootId + 1 + (i / kChildrenPerNode) - 1;
+      infos.push_back(arena->MakeShared<DomInfo>(MakeTreeNode(root_node, id, pid), nullptr, nullptr));
+    }
+    root_node->CreateDomNodes(std::move(infos), false);
+  }
+  EXPECT_EQ(root_node->GetChildCount(), kNodeCount);
+  EXPECT_GT(arena->GetLiveBlockCount(), kNodeCount);
+
+  {
+    std::vector<std::shared_ptr<DomInfo>> deletes;
+    for (const auto& child : root_node->GetChildren()) {
+      deletes.push_back(std::make_shared<DomInfo>(child, nullptr, nullptr));
+    }
+    root_node->DeleteDomNodes(std::move(deletes));
+  }
+  EXPECT_EQ(root_node->GetChildCount(), 0);
+  EXPECT_EQ(root_node->GetNode(kRootId + kNodeCount), nullptr);
+  // pending dom operations still reference the deleted nodes until the root node goes away
+  root_node = nullptr;
+  EXPECT_EQ(arena->GetLiveBlockCount(), 0) << "deleted nodes should return their blocks";
+}
+
+}  // namespace testing
+}  // namespace dom
+}  // namespace hippy
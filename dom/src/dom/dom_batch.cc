@@ -0,0 +1,185 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dom/dom_batch.h"
+
+#include <unordered_map>
+
+#include "dom/dom_node.h"
+#include "dom/root_node.h"
+#include "footstone/deserializer.h"
+#include "footstone/logging.h"
+#include "footstone/serializer.h"
+
+namespace hippy {
+inline namespace dom {
+
+using HippyValue = footstone::value::HippyValue;
+using Serializer = footstone::value::Serializer;
+using Deserializer = footstone::value::Deserializer;
+using DomValueMapType = std::unordered_map<std::string, std::shared_ptr<HippyValue>>;
+
+namespace {
+
+constexpr char kPropsStyle[] = "style";
+
+bool ReadNumber(Deserializer& deserializer, HippyValue& scratch, int32_t& value) {
+  double number;
+  if (!deserializer.ReadValue(scratch) || !scratch.ToDouble(number)) {
+    return false;
+  }
+  value = static_cast<int32_t>(number);
+  return true;
+}
+
+bool ReadString(Deserializer& deserializer, HippyValue& scratch, std::string& value) {
+  if (!deserializer.ReadValue(scratch) || !scratch.IsString()) {
+    return false;
+  }
+  value = std::move(scratch.ToStringChecked());
+  return true;
+}
+
+// props 对象的值直接移动到 style 和 ext 中, 不再复制一遍 HippyValue
+void SplitProps(HippyValue& props, DomValueMapType& style_map, DomValueMapType& ext_map) {
+  auto& props_map = props.ToObjectChecked();
+  ext_map.reserve(props_map.size());
+  for (auto& [key, value] : props_map) {
+    if (key == kPropsStyle) {
+      if (value.IsObject()) {
+        auto& style = value.ToObjectChecked();
+        style_map.reserve(style.size());
+        for (auto& [style_key, style_value] : style) {
+          style_map.emplace(style_key, std::make_shared<HippyValue>(std::move(style_value)));
+        }
+      }
+      continue;
+    }
+    ext_map.emplace(key, std::make_shared<HippyValue>(std::move(value)));
+  }
+}
+
+}  // namespace
+
+std::string DomBatch::Encode(const std::vector<std::shared_ptr<DomInfo>>& nodes) {
+  Serializer serializer;
+  serializer.WriteHeader();
+  serializer.WriteValue(HippyValue(static_cast<uint32_t>(nodes.size())));
+  for (const auto& info : nodes) {
+    auto& node = info->dom_node;
+    serializer.WriteValue(HippyValue(static_cast<int32_t>(node->GetId())));
+    serializer.WriteValue(HippyValue(static_cast<int32_t>(node->GetPid())));
+    serializer.WriteValue(HippyValue(node->GetViewName()));
+    serializer.WriteValue(HippyValue(node->GetTagName()));
+    uint32_t flags = 0;
+    if (info->ref_info) {
+      flags |= kFlagHasRefInfo;
+    }
+    if (info->diff_info) {
+      flags |= kFlagHasDiffInfo;
+      if (info->diff_info->skip_style_diff) {
+        flags |= kFlagSkipStyleDiff;
+      }
+    }
+    serializer.WriteValue(HippyValue(flags));
+    if (info->ref_info) {
+      serializer.WriteValue(HippyValue(static_cast<int32_t>(info->ref_info->ref_id)));
+      serializer.WriteValue(HippyValue(info->ref_info->relative_to_ref));
+    }
+    HippyValue::HippyValueObjectType props;
+    const auto& ext_map = node->GetExtStyle();
+    if (ext_map) {
+      for (const auto& [key, value] : *ext_map) {
+        props.emplace(key, *value);
+      }
+    }
+    const auto& style_map = node->GetStyleMap();
+    if (style_map && !style_map->empty()) {
+      HippyValue::HippyValueObjectType style;
+      for (const auto& [key, value] : *style_map) {
+        style.emplace(key, *value);
+      }
+      props.emplace(kPropsStyle, HippyValue(std::move(style)));
+    }
+    serializer.WriteValue(HippyValue(std::move(props)));
+  }
+  auto buffer = serializer.Release();
+  std::string data(reinterpret_cast<const char*>(buffer.first), buffer.second);
+  footstone::value::SerializerHelper::DestroyBuffer(buffer);
+  return data;
+}
+
+bool DomBatch::Decode(const uint8_t* data, size_t length, const std::shared_ptr<RootNode>& root_node,
+                      std::vector<std::shared_ptr<DomInfo>>& nodes) {
+  Deserializer deserializer(data, length);
+  HippyValue scratch;
+  int32_t count;
+  if (!root_node || !deserializer.ReadHeader() || !ReadNumber(deserializer, scratch, count) || count < 0) {
+    FOOTSTONE_LOG(ERROR) << "DomBatch::Decode invalid batch, length = " << length;
+    return false;
+  }
+  auto& arena = root_node->GetArena();
+  nodes.reserve(nodes.size() + static_cast<size_t>(count));
+  for (int32_t i = 0; i < count; ++i) {
+    int32_t id;
+    int32_t pid;
+    int32_t flags;
+    std::string view_name;
+    std::string tag_name;
+    if (!ReadNumber(deserializer, scratch, id) || !ReadNumber(deserializer, scratch, pid) ||
+        !ReadString(deserializer, scratch, view_name) || !ReadString(deserializer, scratch, tag_name) ||
+        !ReadNumber(deserializer, scratch, flags)) {
+      FOOTSTONE_LOG(ERROR) << "DomBatch::Decode invalid node header, index = " << i;
+      return false;
+    }
+    std::shared_ptr<RefInfo> ref_info;
+    if (flags & kFlagHasRefInfo) {
+      int32_t ref_id;
+      int32_t relative_to_ref;
+      if (!ReadNumber(deserializer, scratch, ref_id) || !ReadNumber(deserializer, scratch, relative_to_ref)) {
+        FOOTSTONE_LOG(ERROR) << "DomBatch::Decode invalid ref info, index = " << i;
+        return false;
+      }
+      ref_info = arena->MakeShared<RefInfo>(static_cast<uint32_t>(ref_id), relative_to_ref);
+    }
+    std::shared_ptr<DiffInfo> diff_info;
+    if (flags & kFlagHasDiffInfo) {
+      diff_info = arena->MakeShared<DiffInfo>((flags & kFlagSkipStyleDiff) != 0);
+    }
+    auto style_map = std::make_shared<DomValueMapType>();
+    auto ext_map = std::make_shared<DomValueMapType>();
+    if (!deserializer.ReadValue(scratch)) {
+      FOOTSTONE_LOG(ERROR) << "DomBatch::Decode invalid props, index = " << i;
+      return false;
+    }
+    if (scratch.IsObject()) {
+      SplitProps(scratch, *style_map, *ext_map);
+    }
+    // 与 JS 对象路径一致, index 不从批次中读取, 节点位置由 ref info 决定
+    auto dom_node = arena->MakeShared<DomNode>(static_cast<uint32_t>(id), static_cast<uint32_t>(pid), 0,
+                                               std::move(tag_name), std::move(view_name), std::move(style_map),
+                                               std::move(ext_map), root_node);
+    nodes.push_back(arena->MakeShared<DomInfo>(std::move(dom_node), std::move(ref_info), std::move(diff_info)));
+  }
+  return true;
+}
+
+}  // namespace dom
+}  // namespace hippy
@@ -0,0 +1,199 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "dom/dom_batch.h"
+#include "dom/dom_node.h"
+#include "dom/node_props.h"
+#include "dom/root_node.h"
+#include "footstone/serializer.h"
+
+namespace hippy {
+inline namespace dom {
+inline namespace testing {
+
+using DomValueMapType = std::unordered_map<std::string, std::shared_ptr<HippyValue>>;
+using HippyValueObjectType = footstone::value::HippyValue::HippyValueObjectType;
+using HippyValueArrayType = footstone::value::HippyValue::HippyValueArrayType;
+
+constexpr uint32_t kBatchRootId = 1;
+constexpr uint32_t kBatchNodeCount = 3000;
+
+std::shared_ptr<DomInfo> MakeBatchNodeInfo(const std::shared_ptr<RootNode>& root_node, uint32_t id, uint32_t pid) {
+  auto style = std::make_shared<DomValueMapType>();
+  (*style)[kWidth] = std::make_shared<HippyValue>(100.0);
+  (*style)[kHeight] = std::make_shared<HippyValue>(static_cast<int32_t>(id % 50));
+  (*style)["backgroundColor"] = std::make_shared<HippyValue>(static_cast<uint32_t>(0xFF00FF00));
+  (*style)["opacity"] = std::make_shared<HippyValue>(0.5);
+  HippyValueArrayType transform;
+  HippyValueObjectType scale;
+  scale["scale"] = HippyValue(2);
+  transform.emplace_back(scale);
+  (*style)["transform"] = std::make_shared<HippyValue>(transform);
+  auto ext = std::make_shared<DomValueMapType>();
+  (*ext)["text"] = std::make_shared<HippyValue>("item " + std::to_string(id));
+  (*ext)["key"] = std::make_shared<HippyValue>(static_cast<int32_t>(id));
+  auto node = std::make_shared<DomNode>(id, pid, 0, "div", "View", style, ext, root_node);
+  auto ref_info = id % 2 ? std::make_shared<RefInfo>(id - 1, RelativeType::kBack) : nullptr;
+  auto diff_info = id % 3 ? nullptr : std::make_shared<DiffInfo>(true);
+  return std::make_shared<DomInfo>(node, ref_info, diff_info);
+}
+
+std::vector<std::shared_ptr<DomInfo>> MakeBatch(const std::shared_ptr<RootNode>& root_node) {
+  std::vector<std::shared_ptr<DomInfo>> infos;
+  for (uint32_t id = kBatchRootId + 1; id <= kBatchRootId + kBatchNodeCount; ++id) {
+    infos.push_back(MakeBatchNodeInfo(root_node, id, kBatchRootId));
+  }
+  return infos;
+}
+
+TEST(DomBatchTest, RoundTrip) {
+  auto root_node = std::make_shared<RootNode>(kBatchRootId);
+  auto infos = MakeBatch(root_node);
+  auto buffer = DomBatch::Encode(infos);
+  std::vector<std::shared_ptr<DomInfo>> nodes;
+  ASSERT_TRUE(DomBatch::Decode(reinterpret_cast<const uint8_t*>(buffer.c_str()), buffer.length(), root_node, nodes));
+  ASSERT_EQ(nodes.size(), infos.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const auto& decoded = nodes[i]->dom_node;
+    const auto& orig = infos[i]->dom_node;
+    EXPECT_EQ(decoded->GetId(), orig->GetId());
+    EXPECT_EQ(decoded->GetPid(), orig->GetPid());
+    EXPECT_EQ(decoded->GetTagName(), orig->GetTagName());
+    EXPECT_EQ(decoded->GetViewName(), orig->GetViewName());
+    ASSERT_EQ(decoded->GetStyleMap()->size(), orig->GetStyleMap()->size());
+    for (const auto& [key, value] : *orig->GetStyleMap()) {
+      EXPECT_EQ(*decoded->GetStyleMap()->at(key), *value);
+    }
+    ASSERT_EQ(decoded->GetExtStyle()->size(), orig->GetExtStyle()->size());
+    for (const auto& [key, value] : *orig->GetExtStyle()) {
+      EXPECT_EQ(*decoded->GetExtStyle()->at(key), *value);
+    }
+    ASSERT_EQ(nodes[i]->ref_info != nullptr, infos[i]->ref_info != nullptr);
+    if (infos[i]->ref_info) {
+      EXPECT_EQ(nodes[i]->ref_info->ref_id, infos[i]->ref_info->ref_id);
+      EXPECT_EQ(nodes[i]->ref_info->relative_to_ref, infos[i]->ref_info->relative_to_ref);
+    }
+    ASSERT_EQ(nodes[i]->diff_info != nullptr, infos[i]->diff_info != nullptr);
+    if (infos[i]->diff_info) {
+      EXPECT_TRUE(nodes[i]->diff_info->skip_style_diff);
+    }
+  }
+
+  // decoded nodes can be created directly
+  root_node->CreateDomNodes(std::move(nodes), false);
+  EXPECT_EQ(root_node->GetChildCount(), kBatchNodeCount);
+}
+
+TEST(DomBatchTest, AcceptsDoubleNumbersAndRejectsTruncatedBatch) {
+  auto root_node = std::make_shared<RootNode>(kBatchRootId);
+  // JS encoders may write every number as a double, and leave props undefined
+  footstone::value::Serializer serializer;
+  serializer.WriteHeader();
+  serializer.WriteValue(HippyValue(1.0));
+  serializer.WriteValue(HippyValue(10.0));
+  serializer.WriteValue(HippyValue(static_cast<double>(kBatchRootId)));
+  serializer.WriteValue(HippyValue("Text"));
+  serializer.WriteValue(HippyValue(""));
+  serializer.WriteValue(HippyValue(0.0));
+  serializer.WriteValue(HippyValue::Undefined());
+  auto buffer = serializer.Release();
+  std::vector<std::shared_ptr<DomInfo>> nodes;
+  ASSERT_TRUE(DomBatch::Decode(buffer.first, buffer.second, root_node, nodes));
+  ASSERT_EQ(nodes.size(), 1);
+  EXPECT_EQ(nodes[0]->dom_node->GetId(), 10);
+  EXPECT_EQ(nodes[0]->dom_node->GetPid(), kBatchRootId);
+  EXPECT_EQ(nodes[0]->dom_node->GetViewName(), "Text");
+  EXPECT_TRUE(nodes[0]->dom_node->GetStyleMap()->empty());
+  EXPECT_EQ(nodes[0]->ref_info, nullptr);
+  footstone::value::SerializerHelper::DestroyBuffer(buffer);
+
+  auto batch = DomBatch::Encode(MakeBatch(root_node));
+  std::vector<std::shared_ptr<DomInfo>> truncated_nodes;
+  EXPECT_FALSE(DomBatch::Decode(reinterpret_cast<const uint8_t*>(batch.c_str()), batch.length() / 2, root_node,
+                                truncated_nodes));
+  EXPECT_FALSE(DomBatch::Decode(reinterpret_cast<const uint8_t*>(batch.c_str()), 0, root_node, truncated_nodes));
+}
+
+// output of encodeDomBatch in driver/js/packages/hippy-vue-next/src/runtime/render/dom-batch.ts for
+//   [[{ id: 2, pId: 1, name: 'View', tagName: 'div', props: { style: { width: 100, height: 50.5 },
+//       attributes: { class: 'item' } } }, {}],
+//    [{ id: 3, pId: 1, name: 'Text', tagName: 'p', props: { text: '你好😀', onClick: () => {}, visible: true,
+//       extra: null, list: [1, 'a'] } }, { refId: 2, relativeToRef: 1 }]]
+// the same bytes are checked on the js side, keep both in sync when the format changes
+constexpr uint8_t kJsEncodedBatch[] = {
+    0xff, 0x0d, 0x55, 0x02, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x4e, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xf0, 0x3f, 0x22, 0x04, 0x56, 0x69, 0x65, 0x77, 0x22, 0x03, 0x64, 0x69,
+    0x76, 0x55, 0x00, 0x6f, 0x22, 0x05, 0x73, 0x74, 0x79, 0x6c, 0x65, 0x6f, 0x22, 0x05, 0x77, 0x69,
+    0x64, 0x74, 0x68, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x59, 0x40, 0x22, 0x06, 0x68, 0x65,
+    0x69, 0x67, 0x68, 0x74, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x49, 0x40, 0x7b, 0x02, 0x22,
+    0x0a, 0x61, 0x74, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x65, 0x73, 0x6f, 0x22, 0x05, 0x63, 0x6c,
+    0x61, 0x73, 0x73, 0x22, 0x04, 0x69, 0x74, 0x65, 0x6d, 0x7b, 0x01, 0x7b, 0x02, 0x4e, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x08, 0x40, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x3f, 0x22,
+    0x04, 0x54, 0x65, 0x78, 0x74, 0x22, 0x01, 0x70, 0x55, 0x01, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x40, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x3f, 0x6f, 0x22, 0x04, 0x74,
+    0x65, 0x78, 0x74, 0x53, 0x0a, 0xe4, 0xbd, 0xa0, 0xe5, 0xa5, 0xbd, 0xf0, 0x9f, 0x98, 0x80, 0x22,
+    0x07, 0x76, 0x69, 0x73, 0x69, 0x62, 0x6c, 0x65, 0x54, 0x22, 0x05, 0x65, 0x78, 0x74, 0x72, 0x61,
+    0x30, 0x22, 0x04, 0x6c, 0x69, 0x73, 0x74, 0x41, 0x02, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xf0, 0x3f, 0x22, 0x01, 0x61, 0x24, 0x00, 0x02, 0x7b, 0x04,
+};
+
+TEST(DomBatchTest, DecodesJsEncodedBatch) {
+  auto root_node = std::make_shared<RootNode>(kBatchRootId);
+  std::vector<std::shared_ptr<DomInfo>> nodes;
+  ASSERT_TRUE(DomBatch::Decode(kJsEncodedBatch, sizeof(kJsEncodedBatch), root_node, nodes));
+  ASSERT_EQ(nodes.size(), 2);
+
+  const auto& view = nodes[0]->dom_node;
+  EXPECT_EQ(view->GetId(), 2);
+  EXPECT_EQ(view->GetPid(), kBatchRootId);
+  EXPECT_EQ(view->GetViewName(), "View");
+  EXPECT_EQ(view->GetTagName(), "div");
+  ASSERT_EQ(view->GetStyleMap()->size(), 2);
+  // numbers keep the double type of the js object path
+  EXPECT_EQ(*view->GetStyleMap()->at(kWidth), HippyValue(100.0));
+  EXPECT_EQ(*view->GetStyleMap()->at(kHeight), HippyValue(50.5));
+  ASSERT_EQ(view->GetExtStyle()->size(), 1);
+  HippyValueObjectType attributes;
+  attributes["class"] = HippyValue("item");
+  EXPECT_EQ(*view->GetExtStyle()->at("attributes"), HippyValue(attributes));
+  EXPECT_EQ(nodes[0]->ref_info, nullptr);
+
+  const auto& text = nodes[1]->dom_node;
+  EXPECT_EQ(text->GetId(), 3);
+  EXPECT_EQ(text->GetViewName(), "Text");
+  EXPECT_TRUE(text->GetStyleMap()->empty());
+  const auto& ext = *text->GetExtStyle();
+  ASSERT_EQ(ext.size(), 4);
+  EXPECT_EQ(ext.at("text")->ToStringChecked(), "你好😀");
+  EXPECT_EQ(ext.find("onClick"), ext.end());
+  EXPECT_EQ(*ext.at("visible"), HippyValue(true));
+  EXPECT_TRUE(ext.at("extra")->IsNull());
+  EXPECT_EQ(*ext.at("list"), HippyValue(HippyValueArrayType{HippyValue(1.0), HippyValue("a")}));
+  ASSERT_NE(nodes[1]->ref_info, nullptr);
+  EXPECT_EQ(nodes[1]->ref_info->ref_id, 2);
+  EXPECT_EQ(nodes[1]->ref_info->relative_to_ref, RelativeType::kBack);
+  EXPECT_EQ(nodes[1]->diff_info, nullptr);
+}
+
+}  // namespace testing
+}  // namespace dom
+}  // namespace hippy
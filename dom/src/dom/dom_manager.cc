@@ -31,6 +31,7 @@
 #include "dom/dom_action_interceptor.h"
 #include "dom/dom_event.h"
 #include "dom/dom_node.h"
+#include "dom/dom_snapshot.h"
 #include "dom/layer_optimized_render_manager.h"
 #include "dom/render_manager.h"
 #include "dom/root_node.h"
@@ -134,7 +135,8 @@ void DomManager::EndBatch(const std::weak_ptr<RootNode>& weak_root_node) {
   if (!root_node) {
     return;
   }
-  FOOTSTONE_DLOG(INFO) << "[Hippy Statistic] total node size = " << root_node->GetChildCount();
+  FOOTSTONE_DLOG(INFO) << "[Hippy Statistic] total node size = " << root_node->GetChildCount()
+                       << ", layout only node size = " << root_node->GetNodeStatistics().layout_only_count;
   root_node->SyncWithRenderManager(render_manager);
 }
 
@@ -216,22 +218,39 @@ void DomManager::CancelTask(uint32_t id) {
 }
 
 DomManager::byte_string DomManager::GetSnapShot(const std::shared_ptr<RootNode>& root_node) {
+  return DomSnapshot::Encode(root_node);
+}
+
+bool DomManager::SetSnapShot(const std::shared_ptr<RootNode>& root_node, const byte_string& buffer) {
+  return SetSnapShot(root_node, reinterpret_cast<const uint8_t*>(buffer.c_str()), buffer.length());
+}
+
+bool DomManager::SetSnapShot(const std::shared_ptr<RootNode>& root_node, const uint8_t* data, size_t length) {
   if (!root_node) {
-    return {};
+    return false;
   }
-  HippyValueArrayType array;
-  root_node->Traverse([&array](const std::shared_ptr<DomNode>& node) { array.emplace_back(node->Serialize()); });
-  Serializer serializer;
-  serializer.WriteHeader();
-  serializer.WriteValue(HippyValue(array));
-  auto buffer_pair = serializer.Release();
-  byte_string bs =  {reinterpret_cast<const char*>(buffer_pair.first), buffer_pair.second};
-  footstone::value::SerializerHelper::DestroyBuffer(buffer_pair);
-  return bs;
+  if (!DomSnapshot::IsSnapshot(data, length)) {
+    return SetLegacySnapShot(root_node, data, length);
+  }
+  std::vector<std::shared_ptr<DomInfo>> nodes;
+  LayoutResult root_layout;
+  if (!DomSnapshot::Decode(data, length, root_node, nodes, root_layout)) {
+    return false;
+  }
+  // 根节点尺寸与快照一致时快照中的布局结果仍然有效, 首帧可以跳过布局
+  auto layout_node = root_node->GetLayoutNode();
+  if (layout_node->GetStyleWidth() == root_layout.width && layout_node->GetStyleHeight() == root_layout.height) {
+    root_node->MarkLayoutRestored();
+  }
+
+  CreateDomNodes(root_node, std::move(nodes), false);
+  EndBatch(root_node);
+
+  return true;
 }
 
-bool DomManager::SetSnapShot(const std::shared_ptr<RootNode>& root_node, const byte_string& buffer) {
-  Deserializer deserializer(reinterpret_cast<const uint8_t*>(buffer.c_str()), buffer.length());
+bool DomManager::SetLegacySnapShot(const std::shared_ptr<RootNode>& root_node, const uint8_t* data, size_t length) {
+  Deserializer deserializer(data, length);
   HippyValue value;
   deserializer.ReadHeader();
   auto flag = deserializer.ReadValue(value);
@@ -256,7 +275,7 @@ bool DomManager::SetSnapShot(const std::shared_ptr<RootNode>& root_node, const b
   std::weak_ptr<DomManager> weak_dom_manager = weak_from_this();
   for (uint32_t i = 1; i < array.size(); ++i) {
     auto node = array[i];
-    auto dom_node = std::make_shared<DomNode>();
+    auto dom_node = root_node->GetArena()->MakeShared<DomNode>(kInvalidId, kInvalidId, root_node);
     flag = dom_node->Deserialize(node);
     if (!flag) {
       return false;
@@ -265,7 +284,7 @@ bool DomManager::SetSnapShot(const std::shared_ptr<RootNode>& root_node, const b
     if (dom_node->GetPid() == orig_root_id) {
       dom_node->SetPid(root_node->GetId());
     }
-    nodes.push_back(std::make_shared<DomInfo>(dom_node, nullptr, nullptr));
+    nodes.push_back(root_node->GetArena()->MakeShared<DomInfo>(dom_node, nullptr, nullptr));
   }
 
   CreateDomNodes(root_node, std::move(nodes), false);
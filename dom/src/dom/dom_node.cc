@@ -60,6 +60,20 @@ const std::map<int32_t, std::string> kRelativeTypeMap = {
 
 using HippyValueObjectType = footstone::value::HippyValue::HippyValueObjectType;
 
+// style map 及其中的 value 可能被 DomNodeStyleDiffer 的 batch 快照共享, 原地修改之前若有共享则先复制一份
+static void DetachIfShared(std::shared_ptr<DomValueMap>& map) {
+  if (map != nullptr && map.use_count() > 1) {
+    map = std::make_shared<DomValueMap>(*map);
+  }
+}
+
+static HippyValue& MutableValue(std::shared_ptr<HippyValue>& value) {
+  if (value.use_count() > 1) {
+    value = std::make_shared<HippyValue>(*value);
+  }
+  return *value;
+}
+
 DomNode::DomNode(uint32_t id, uint32_t pid, int32_t index, std::string tag_name, std::string view_name,
                  std::shared_ptr<std::unordered_map<std::string, std::shared_ptr<HippyValue>>> style_map,
                  std::shared_ptr<std::unordered_map<std::string, std::shared_ptr<HippyValue>>> dom_ext_map,
@@ -76,7 +90,12 @@ DomNode::DomNode(uint32_t id, uint32_t pid, int32_t index, std::string tag_name,
       current_callback_id_(0),
       func_cb_map_(nullptr),
       event_listener_map_(nullptr) {
-  layout_node_ = hippy::dom::CreateLayoutNode();
+  auto root_node = root_node_.lock();
+  if (root_node) {
+    layout_node_ = hippy::dom::CreateLayoutNode(root_node->GetArena());
+  } else {
+    layout_node_ = hippy::dom::CreateLayoutNode();
+  }
 }
 
 DomNode::DomNode(uint32_t id, uint32_t pid, std::weak_ptr<RootNode> weak_root_node)
@@ -132,6 +151,8 @@ int32_t DomNode::AddChildByRefInfo(const std::shared_ptr<DomInfo>& dom_info) {
     children_.push_back(dom_info->dom_node);
   }
   dom_info->dom_node->SetParent(shared_from_this());
+  // 子节点变化可能影响全部兄弟节点的位置
+  MarkLayoutDirty();
   int32_t index = dom_info->dom_node->GetSelfIndex();
   // TODO(charleeshen): 支持不同的view，需要终端注册
   if (view_name_ == "Text") {
@@ -142,6 +163,17 @@ int32_t DomNode::AddChildByRefInfo(const std::shared_ptr<DomInfo>& dom_info) {
   return index;
 }
 
+void DomNode::SetLayoutOnly(bool layout_only) {
+  if (layout_only_ == layout_only) {
+    return;
+  }
+  layout_only_ = layout_only;
+  auto root_node = root_node_.lock();
+  if (root_node) {
+    root_node->OnDomNodeLayoutOnlyChanged(shared_from_this());
+  }
+}
+
 int32_t DomNode::GetChildIndex(uint32_t id) {
   int32_t index = -1;
   for (uint32_t i = 0; i < children_.size(); ++i) {
@@ -180,6 +212,7 @@ std::shared_ptr<DomNode> DomNode::RemoveChildAt(int32_t index) {
   auto child = children_[footstone::check::checked_numeric_cast<int32_t, unsigned long>(index)];
   child->SetParent(nullptr);
   children_.erase(children_.begin() + index);
+  MarkLayoutDirty();
   layout_node_->RemoveChild(child->GetLayoutNode());
   return child;
 }
@@ -191,6 +224,7 @@ std::shared_ptr<DomNode> DomNode::RemoveChildById(uint32_t id) {
     if (id == child->GetId()) {
       child->SetParent(nullptr);
       children_.erase(it);
+      MarkLayoutDirty();
       layout_node_->RemoveChild(child->GetLayoutNode());
       return child;
     }
@@ -205,10 +239,14 @@ void DomNode::DoLayout() {
 }
 
 void DomNode::DoLayout(std::vector<std::shared_ptr<DomNode>>& changed_nodes) {
-  layout_node_->CalculateLayout(is_layout_width_nan_ ? NAN : 0, is_layout_height_nan_ ? NAN : 0);
+  CalculateLayout();
   TransferLayoutOutputsRecursive(changed_nodes);
 }
 
+void DomNode::CalculateLayout() {
+  layout_node_->CalculateLayout(is_layout_width_nan_ ? NAN : 0, is_layout_height_nan_ ? NAN : 0);
+}
+
 void DomNode::HandleEvent(const std::shared_ptr<DomEvent>& event) {
   auto root_node = root_node_.lock();
   if (root_node) {
@@ -226,11 +264,13 @@ void DomNode::SetLayoutSize(float width, float height) {
   
   layout_node_->SetWidth(width);
   layout_node_->SetHeight(height);
+  MarkLayoutDirty();
 }
 
 void DomNode::SetLayoutOrigin(float x, float y) {
   layout_node_->SetPosition(hippy::Edge::EdgeLeft, x);
   layout_node_->SetPosition(hippy::Edge::EdgeTop, y);
+  MarkLayoutDirty();
 }
 
 void DomNode::AddEventListener(const std::string& name, uint64_t listener_id, bool use_capture,
@@ -245,6 +285,7 @@ void DomNode::AddEventListener(const std::string& name, uint64_t listener_id, bo
     auto root_node = root_node_.lock();
     if (root_node) {
       root_node->AddEvent(GetId(), name);
+      root_node->OnEventListenerAdded(*this, name);
     }
   }
   if (use_capture) {
@@ -264,7 +305,7 @@ void DomNode::RemoveEventListener(const std::string& name, uint64_t listener_id)
   if (it == event_listener_map_->end()) {
     return;
   }
-  auto capture_listeners = it->second[kCapture];
+  auto& capture_listeners = it->second[kCapture];
   auto capture_it = std::find_if(capture_listeners.begin(), capture_listeners.end(),
                                  [listener_id](const std::shared_ptr<DomEventListenerInfo>& item) {
                                    if (item->id == listener_id) {
@@ -277,7 +318,7 @@ void DomNode::RemoveEventListener(const std::string& name, uint64_t listener_id)
   }
 
   // remove dom node bubble function
-  auto bubble_listeners = it->second[kBubble];
+  auto& bubble_listeners = it->second[kBubble];
   auto bubble_it = std::find_if(bubble_listeners.begin(), bubble_listeners.end(),
                                 [listener_id](const std::shared_ptr<DomEventListenerInfo>& item) {
                                   if (item->id == listener_id) {
@@ -293,30 +334,95 @@ void DomNode::RemoveEventListener(const std::string& name, uint64_t listener_id)
     auto root_node = root_node_.lock();
     if (root_node) {
       root_node->RemoveEvent(GetId(), name);
+      root_node->OnEventListenerRemoved(*this, name);
     }
   }
 }
 
-std::vector<std::shared_ptr<DomEventListenerInfo>> DomNode::GetEventListener(const std::string& name, bool is_capture) {
+const std::vector<std::shared_ptr<DomEventListenerInfo>>& DomNode::GetEventListener(const std::string& name,
+                                                                                   bool is_capture) const {
+  static const std::vector<std::shared_ptr<DomEventListenerInfo>> kEmptyListeners;
   if (!event_listener_map_) {
-    return {};
+    return kEmptyListeners;
   }
   auto it = event_listener_map_->find(name);
   if (it == event_listener_map_->end()) {
-    return {};
+    return kEmptyListeners;
   }
-  if (is_capture) {
-    return it->second[kCapture];
+  return it->second[is_capture ? kCapture : kBubble];
+}
+
+bool DomNode::HasEventListener(const std::string& name) const {
+  return event_listener_map_ != nullptr && event_listener_map_->find(name) != event_listener_map_->end();
+}
+
+std::vector<std::string> DomNode::GetEventListenerNames() const {
+  std::vector<std::string> names;
+  if (event_listener_map_) {
+    names.reserve(event_listener_map_->size());
+    for (const auto& [name, listeners] : *event_listener_map_) {
+      names.push_back(name);
+    }
   }
-  return it->second[kBubble];
+  return names;
 }
 
-void DomNode::ParseLayoutStyleInfo() { layout_node_->SetLayoutStyles(*style_map_, std::vector<std::string>{}); }
+void DomNode::ParseLayoutStyleInfo() {
+  layout_node_->SetLayoutStyles(*style_map_, std::vector<std::string>{});
+  MarkLayoutDirty();
+}
 
 void DomNode::UpdateLayoutStyleInfo(
     const std::unordered_map<std::string, std::shared_ptr<footstone::value::HippyValue>>& style_update,
     const std::vector<std::string>& style_delete) {
   layout_node_->SetLayoutStyles(style_update, style_delete);
+  MarkLayoutDirty();
+}
+
+void DomNode::MarkLayoutDirty() {
+  layout_dirty_ = true;
+  auto parent = GetParent();
+  while (parent != nullptr && !parent->has_dirty_descendant_) {
+    parent->has_dirty_descendant_ = true;
+    if (parent->IsLayoutBoundary()) {
+      auto root_node = root_node_.lock();
+      if (root_node != nullptr) {
+        root_node->AddLayoutDirtyBoundary(parent);
+        return;
+      }
+    }
+    parent = parent->GetParent();
+  }
+}
+
+void DomNode::MarkLayoutNodeDirty() {
+  layout_node_->MarkDirty();
+  MarkLayoutDirty();
+}
+
+bool DomNode::IsLayoutBoundary() {
+  if (style_map_ == nullptr) {
+    return false;
+  }
+  auto width = style_map_->find(kWidth);
+  auto height = style_map_->find(kHeight);
+  if (width == style_map_->end() || height == style_map_->end() || !width->second || !height->second ||
+      !width->second->IsNumber() || !height->second->IsNumber()) {
+    return false;
+  }
+  auto parent = GetParent();
+  if (parent == nullptr) {
+    return false;
+  }
+  auto parent_style = parent->GetStyleMap();
+  if (parent_style != nullptr) {
+    auto align_items = parent_style->find(kAlignItems);
+    if (align_items != parent_style->end() && align_items->second && align_items->second->IsString() &&
+        align_items->second->ToStringChecked() == "baseline") {
+      return false;
+    }
+  }
+  return true;
 }
 LayoutResult DomNode::GetLayoutInfoFromRoot() {
   LayoutResult result = layout_;
@@ -329,8 +435,9 @@ LayoutResult DomNode::GetLayoutInfoFromRoot() {
   return result;
 }
 
-void DomNode::TransferLayoutOutputsRecursive(std::vector<std::shared_ptr<DomNode>>& changed_nodes) {
+bool DomNode::TransferLayoutOutput(std::vector<std::shared_ptr<DomNode>>& changed_nodes) {
   auto not_equal = std::not_equal_to<>();
+  LayoutResult old_layout = layout_;
   bool changed =  layout_node_->IsDirty() || layout_node_->HasNewLayout();
   bool trigger_layout_event =
       not_equal(layout_.left, layout_node_->GetLeft()) || not_equal(layout_.top, layout_node_->GetTop()) ||
@@ -393,11 +500,64 @@ void DomNode::TransferLayoutOutputsRecursive(std::vector<std::shared_ptr<DomNode
       }
     }
   }
+  return not_equal(old_layout.left, layout_.left) || not_equal(old_layout.top, layout_.top) ||
+         not_equal(old_layout.width, layout_.width) || not_equal(old_layout.height, layout_.height) ||
+         not_equal(render_layout_.left, old_absolute_left) ||
+         not_equal(render_layout_.top, old_absolute_top) || not_equal(old_layout.marginLeft, layout_.marginLeft) ||
+         not_equal(old_layout.marginTop, layout_.marginTop) || not_equal(old_layout.marginRight, layout_.marginRight) ||
+         not_equal(old_layout.marginBottom, layout_.marginBottom) ||
+         not_equal(old_layout.paddingLeft, layout_.paddingLeft) ||
+         not_equal(old_layout.paddingTop, layout_.paddingTop) ||
+         not_equal(old_layout.paddingRight, layout_.paddingRight) ||
+         not_equal(old_layout.paddingBottom, layout_.paddingBottom);
+}
+
+
+void DomNode::TransferLayoutOutputsRecursive(std::vector<std::shared_ptr<DomNode>>& changed_nodes) {
+  TransferLayoutOutput(changed_nodes);
+  layout_dirty_ = false;
+  has_dirty_descendant_ = false;
   for (auto& it : children_) {
     it->TransferLayoutOutputsRecursive(changed_nodes);
   }
 }
 
+bool DomNode::TransferLayoutOutputsIncremental(std::vector<std::shared_ptr<DomNode>>& changed_nodes,
+                                               uint32_t& visit_count) {
+  ++visit_count;
+  bool layout_changed = TransferLayoutOutput(changed_nodes);
+  bool visit_all = layout_changed || layout_dirty_;
+  layout_dirty_ = false;
+  has_dirty_descendant_ = false;
+  if (visit_all) {
+    for (auto& it : children_) {
+      it->TransferLayoutOutputsIncremental(changed_nodes, visit_count);
+    }
+    return layout_changed;
+  }
+
+  std::vector<bool> visited(children_.size(), false);
+  bool siblings_affected = false;
+  for (size_t i = 0; i < children_.size(); ++i) {
+    auto& child = children_[i];
+    if (!child->HasLayoutDirty()) {
+      continue;
+    }
+    // 子节点自身的 style 或子节点列表变化, 即使其布局结果不变也可能影响兄弟节点
+    siblings_affected = child->layout_dirty_ || siblings_affected;
+    siblings_affected = child->TransferLayoutOutputsIncremental(changed_nodes, visit_count) || siblings_affected;
+    visited[i] = true;
+  }
+  if (siblings_affected) {
+    for (size_t i = 0; i < children_.size(); ++i) {
+      if (!visited[i]) {
+        children_[i]->TransferLayoutOutputsIncremental(changed_nodes, visit_count);
+      }
+    }
+  }
+  return layout_changed;
+}
+
 void DomNode::CallFunction(const std::string& name, const DomArgument& param, const CallFunctionCallback& cb) {
   if (!func_cb_map_) {
     func_cb_map_ =
@@ -445,12 +605,13 @@ CallFunctionCallback DomNode::GetCallback(const std::string& name, uint32_t id)
 bool DomNode::HasEventListeners() { return event_listener_map_ != nullptr && !event_listener_map_->empty(); }
 
 void DomNode::EmplaceStyleMap(const std::string& key, const HippyValue& value) {
+  DetachIfShared(style_map_);
   auto iter = style_map_->find(key);
   if (iter != style_map_->end()) {
     iter->second = std::make_shared<HippyValue>(value);
   } else {
     for (auto& style: *style_map_) {
-      auto replaced = ReplaceStyle(*style.second, key, value);
+      auto replaced = ReplaceStyleOnWrite(style.second, key, value);
       if (replaced) {
         return;
       }
@@ -461,13 +622,14 @@ void DomNode::EmplaceStyleMap(const std::string& key, const HippyValue& value) {
 
 void DomNode::EmplaceStyleMapAndGetDiff(const std::string& key, const HippyValue& value,
                                         std::unordered_map<std::string, std::shared_ptr<HippyValue>>& diff) {
+  DetachIfShared(style_map_);
   auto it = style_map_->find(key);
   if (it != style_map_->end()) {
     it->second = std::make_shared<HippyValue>(value);
     diff[key] = it->second;
   } else {
     for (auto& style: *style_map_) {
-      auto replaced = ReplaceStyle(*style.second, key, value);
+      auto replaced = ReplaceStyleOnWrite(style.second, key, value);
       if (replaced) {
         diff[style.first] = style.second;
         return;
@@ -517,11 +679,13 @@ void DomNode::UpdateDiff(const std::unordered_map<std::string,
 void DomNode::UpdateDomExt(const std::unordered_map<std::string, std::shared_ptr<HippyValue>>& update_dom_ext) {
   if (update_dom_ext.empty()) return;
 
-  for (const auto& v : update_dom_ext) {
-    if (this->dom_ext_map_ == nullptr) {
-      this->dom_ext_map_ = std::make_shared<std::unordered_map<std::string, std::shared_ptr<HippyValue>>>();
-    }
+  if (this->dom_ext_map_ == nullptr) {
+    this->dom_ext_map_ = std::make_shared<std::unordered_map<std::string, std::shared_ptr<HippyValue>>>();
+  } else {
+    DetachIfShared(this->dom_ext_map_);
+  }
 
+  for (const auto& v : update_dom_ext) {
     auto iter = this->dom_ext_map_->find(v.first);
     if (iter == this->dom_ext_map_->end()) {
       std::pair<std::string, std::shared_ptr<HippyValue>> pair = {v.first, std::make_shared<HippyValue>(*v.second)};
@@ -530,7 +694,7 @@ void DomNode::UpdateDomExt(const std::unordered_map<std::string, std::shared_ptr
     }
 
     if (v.second->IsObject() && iter->second->IsObject()) {
-      this->UpdateObjectStyle(*iter->second, *v.second);
+      this->UpdateObjectStyle(MutableValue(iter->second), *v.second);
     } else {
       iter->second = std::make_shared<HippyValue>(*v.second);
     }
@@ -540,11 +704,13 @@ void DomNode::UpdateDomExt(const std::unordered_map<std::string, std::shared_ptr
 void DomNode::UpdateStyle(const std::unordered_map<std::string, std::shared_ptr<HippyValue>>& update_style) {
   if (update_style.empty()) return;
 
-  for (const auto& v : update_style) {
-    if (this->style_map_ == nullptr) {
-      this->style_map_ = std::make_shared<std::unordered_map<std::string, std::shared_ptr<HippyValue>>>();
-    }
+  if (this->style_map_ == nullptr) {
+    this->style_map_ = std::make_shared<std::unordered_map<std::string, std::shared_ptr<HippyValue>>>();
+  } else {
+    DetachIfShared(this->style_map_);
+  }
 
+  for (const auto& v : update_style) {
     auto iter = this->style_map_->find(v.first);
     if (iter == this->style_map_->end()) {
       std::pair<std::string, std::shared_ptr<HippyValue>> pair = {v.first, std::make_shared<HippyValue>(*v.second)};
@@ -553,7 +719,7 @@ void DomNode::UpdateStyle(const std::unordered_map<std::string, std::shared_ptr<
     }
 
     if (v.second->IsObject() && iter->second->IsObject()) {
-      this->UpdateObjectStyle(*iter->second, *v.second);
+      this->UpdateObjectStyle(MutableValue(iter->second), *v.second);
     } else {
       iter->second = std::make_shared<HippyValue>(*v.second);
     }
@@ -579,6 +745,22 @@ void DomNode::UpdateObjectStyle(HippyValue& style_map, const HippyValue& update_
   }
 }
 
+bool DomNode::ReplaceStyleOnWrite(std::shared_ptr<HippyValue>& style, const std::string& key,
+                                  const HippyValue& value) {
+  if (style.use_count() == 1) {
+    return ReplaceStyle(*style, key, value);
+  }
+  if (!style->IsObject() && !style->IsArray()) {
+    return false;
+  }
+  auto copy = std::make_shared<HippyValue>(*style);
+  if (!ReplaceStyle(*copy, key, value)) {
+    return false;
+  }
+  style = std::move(copy);
+  return true;
+}
+
 bool DomNode::ReplaceStyle(HippyValue& style, const std::string& key, const HippyValue& value) {
   if (style.IsObject()) {
     auto& object = style.ToObjectChecked();
@@ -0,0 +1,159 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dom/dom_node_table.h"
+
+#include "dom/dom_node.h"
+
+namespace hippy {
+inline namespace dom {
+
+bool DomNodeTable::Insert(const std::shared_ptr<DomNode>& node) {
+  auto& slot = GetOrCreateSlot(node->GetId());
+  if (slot.raw != nullptr) {
+    return false;
+  }
+  slot.node = node;
+  slot.raw = node.get();
+  ++size_;
+  return true;
+}
+
+bool DomNodeTable::Erase(uint32_t id) {
+  Slot* slot = const_cast<Slot*>(GetSlot(id));
+  if (slot == nullptr) {
+    return false;
+  }
+  slot->node.reset();
+  slot->raw = nullptr;
+  ++slot->generation;
+  --size_;
+  if (id >= kMaxDenseId) {
+    // 稀疏 id 通常不会复用, 删除后不再保留其 generation
+    sparse_slots_.erase(id);
+  }
+  return true;
+}
+
+std::shared_ptr<DomNode> DomNodeTable::Find(uint32_t id) const {
+  auto slot = GetSlot(id);
+  return slot == nullptr ? nullptr : slot->node.lock();
+}
+
+void DomNodeTable::Find(const std::vector<uint32_t>& ids, std::vector<std::shared_ptr<DomNode>>& nodes) const {
+  nodes.clear();
+  nodes.reserve(ids.size());
+  // 批量 id 大多落在同一页内, 缓存上一次的页避免重复的页表查找
+  const Page* page = nullptr;
+  uint32_t page_index = 0;
+  for (auto id : ids) {
+    if (id >= kMaxDenseId) {
+      nodes.push_back(Find(id));
+      continue;
+    }
+    if (page == nullptr || (id >> kPageBits) != page_index) {
+      page_index = id >> kPageBits;
+      page = page_index < pages_.size() ? pages_[page_index].get() : nullptr;
+      if (page == nullptr) {
+        nodes.push_back(nullptr);
+        continue;
+      }
+    }
+    const auto& slot = (*page)[id & (kPageSize - 1)];
+    nodes.push_back(slot.raw == nullptr ? nullptr : slot.node.lock());
+  }
+}
+
+bool DomNodeTable::Contains(const DomNode& node) const {
+  auto slot = GetSlot(node.GetId());
+  return slot != nullptr && slot->raw == &node;
+}
+
+uint32_t DomNodeTable::GetGeneration(uint32_t id) const {
+  if (id < kMaxDenseId) {
+    auto page_index = id >> kPageBits;
+    if (page_index < pages_.size() && pages_[page_index] != nullptr) {
+      return (*pages_[page_index])[id & (kPageSize - 1)].generation;
+    }
+    return 0;
+  }
+  auto it = sparse_slots_.find(id);
+  return it == sparse_slots_.end() ? 0 : it->second.generation;
+}
+
+void DomNodeTable::ForEach(const std::function<void(const std::shared_ptr<DomNode>&)>& on_node) const {
+  for (const auto& page : pages_) {
+    if (page == nullptr) {
+      continue;
+    }
+    for (const auto& slot : *page) {
+      if (slot.raw == nullptr) {
+        continue;
+      }
+      auto node = slot.node.lock();
+      if (node != nullptr) {
+        on_node(node);
+      }
+    }
+  }
+  for (const auto& [id, slot] : sparse_slots_) {
+    auto node = slot.node.lock();
+    if (node != nullptr) {
+      on_node(node);
+    }
+  }
+}
+
+const DomNodeTable::Slot* DomNodeTable::GetSlot(uint32_t id) const {
+  const Slot* slot = nullptr;
+  if (id < kMaxDenseId) {
+    auto page_index = id >> kPageBits;
+    if (page_index >= pages_.size() || pages_[page_index] == nullptr) {
+      return nullptr;
+    }
+    slot = &(*pages_[page_index])[id & (kPageSize - 1)];
+  } else {
+    auto it = sparse_slots_.find(id);
+    if (it == sparse_slots_.end()) {
+      return nullptr;
+    }
+    slot = &it->second;
+  }
+  return slot->raw == nullptr ? nullptr : slot;
+}
+
+DomNodeTable::Slot& DomNodeTable::GetOrCreateSlot(uint32_t id) {
+  if (id >= kMaxDenseId) {
+    return sparse_slots_[id];
+  }
+  auto page_index = id >> kPageBits;
+  if (page_index >= pages_.size()) {
+    pages_.resize(page_index + 1);
+  }
+  auto& page = pages_[page_index];
+  if (page == nullptr) {
+    page = std::make_unique<Page>();
+    ++page_count_;
+  }
+  return (*page)[id & (kPageSize - 1)];
+}
+
+}  // namespace dom
+}  // namespace hippy
@@ -0,0 +1,173 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+
+#include "dom/dom_node.h"
+#include "dom/dom_node_table.h"
+#include "dom/root_node.h"
+
+namespace hippy {
+inline namespace dom {
+inline namespace testing {
+
+using DomValueMapType = std::unordered_map<std::string, std::shared_ptr<HippyValue>>;
+
+std::shared_ptr<DomNode> MakeTableNode(uint32_t id) {
+  return std::make_shared<DomNode>(id, 0, 0, "div", "View", std::make_shared<DomValueMapType>(),
+                                   std::make_shared<DomValueMapType>(), std::weak_ptr<RootNode>());
+}
+
+TEST(DomNodeTableTest, InsertFindErase) {
+  DomNodeTable table;
+  auto dense = MakeTableNode(10);
+  auto sparse = MakeTableNode(DomNodeTable::kMaxDenseId + 7);
+  EXPECT_TRUE(table.Insert(dense));
+  EXPECT_TRUE(table.Insert(sparse));
+  EXPECT_FALSE(table.Insert(MakeTableNode(10)));
+  EXPECT_EQ(table.Size(), 2);
+  EXPECT_EQ(table.GetPageCount(), 1);
+  EXPECT_EQ(table.Find(10), dense);
+  EXPECT_EQ(table.Find(DomNodeTable::kMaxDenseId + 7), sparse);
+  EXPECT_EQ(table.Find(11), nullptr);
+  EXPECT_EQ(table.Find(DomNodeTable::kPageSize * 3), nullptr);
+  EXPECT_TRUE(table.Contains(*dense));
+  EXPECT_FALSE(table.Contains(*MakeTableNode(10)));
+
+  std::vector<std::shared_ptr<DomNode>> nodes;
+  table.Find({10, 11, DomNodeTable::kMaxDenseId + 7, DomNodeTable::kPageSize * 5}, nodes);
+  EXPECT_EQ(nodes, (std::vector<std::shared_ptr<DomNode>>{dense, nullptr, sparse, nullptr}));
+
+  EXPECT_TRUE(table.Erase(10));
+  EXPECT_FALSE(table.Erase(10));
+  EXPECT_TRUE(table.Erase(DomNodeTable::kMaxDenseId + 7));
+  EXPECT_EQ(table.Size(), 0);
+  EXPECT_EQ(table.Find(10), nullptr);
+  size_t visited = 0;
+  table.ForEach([&visited](const std::shared_ptr<DomNode>&) { ++visited; });
+  EXPECT_EQ(visited, 0);
+}
+
+TEST(DomNodeTableTest, GenerationDetectsReusedId) {
+  DomNodeTable table;
+  table.Insert(MakeTableNode(3));
+  auto generation = table.GetGeneration(3);
+  table.Erase(3);
+  auto reused = MakeTableNode(3);
+  table.Insert(reused);
+  EXPECT_EQ(table.Find(3), reused);
+  EXPECT_NE(table.GetGeneration(3), generation);
+}
+
+// js allocates ids globally, so a root usually sees a dense range with holes left by deleted nodes, while
+// native created or restored nodes may bring large sparse ids
+std::vector<uint32_t> MakeIds(const std::string& distribution, uint32_t count) {
+  std::vector<uint32_t> ids;
+  std::mt19937 random(42);
+  for (uint32_t i = 0; ids.size() < count; ++i) {
+    if (distribution == "dense") {
+      ids.push_back(i + 1);
+    } else if (distribution == "holes") {
+      if (random() % 3 != 0) {
+        ids.push_back(i + 1);
+      }
+    } else {
+      ids.push_back(DomNodeTable::kMaxDenseId + static_cast<uint32_t>(random() % 0x7FFFFFFF));
+    }
+  }
+  return ids;
+}
+
+TEST(DomNodeTableTest, LookupByDistribution) {
+  constexpr uint32_t kNodeCount = 10000;
+  for (const auto& distribution : {"dense", "holes", "sparse"}) {
+    auto ids = MakeIds(distribution, kNodeCount);
+    std::vector<std::shared_ptr<DomNode>> nodes;
+    DomNodeTable table;
+    for (auto id : ids) {
+      auto node = MakeTableNode(id);
+      ASSERT_TRUE(table.Insert(node)) << distribution << " id " << id;
+      nodes.push_back(std::move(node));
+    }
+    EXPECT_EQ(table.Size(), kNodeCount);
+    for (const auto& node : nodes) {
+      ASSERT_EQ(table.Find(node->GetId()), node) << distribution << " id " << node->GetId();
+    }
+
+    std::sort(ids.begin(), ids.end());
+    std::vector<std::shared_ptr<DomNode>> batch;
+    table.Find(ids, batch);
+    ASSERT_EQ(batch.size(), ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+      ASSERT_NE(batch[i], nullptr);
+      EXPECT_EQ(batch[i]->GetId(), ids[i]);
+    }
+  }
+}
+
+TEST(DomNodeTableTest, BatchMutations) {
+  constexpr uint32_t kRootId = 1;
+  constexpr uint32_t kGroupCount = 100;
+  constexpr uint32_t kGroupSize = 100;
+  auto root_node = std::make_shared<RootNode>(kRootId);
+  auto make_info = [&root_node](uint32_t id, uint32_t pid, double value) {
+    auto style = std::make_shared<DomValueMapType>();
+    (*style)["opacity"] = std::make_shared<HippyValue>(value);
+    auto node = std::make_shared<DomNode>(id, pid, 0, "div", "View", style, std::make_shared<DomValueMapType>(),
+                                          root_node);
+    return std::make_shared<DomInfo>(node, nullptr, nullptr);
+  };
+  auto group_id = [](uint32_t group) { return kRootId + 1 + group * (kGroupSize + 1); };
+
+  std::vector<std::shared_ptr<DomInfo>> infos;
+  for (uint32_t group = 0; group < kGroupCount; ++group) {
+    infos.push_back(make_info(group_id(group), kRootId, 0));
+    for (uint32_t i = 1; i <= kGroupSize; ++i) {
+      infos.push_back(make_info(group_id(group) + i, group_id(group), 0));
+    }
+  }
+  root_node->CreateDomNodes(std::move(infos), false);
+  ASSERT_EQ(root_node->GetNodeTable().Size(), kGroupCount * (kGroupSize + 1));
+
+  infos.clear();
+  for (uint32_t group = 0; group < kGroupCount; ++group) {
+    for (uint32_t i = 1; i <= kGroupSize; ++i) {
+      infos.push_back(make_info(group_id(group) + i, group_id(group), 1));
+    }
+  }
+  root_node->UpdateDomNodes(std::move(infos));
+  EXPECT_EQ(*root_node->GetNode(group_id(kGroupCount - 1) + kGroupSize)->GetStyleMap()->at("opacity"),
+            HippyValue(1.0));
+
+  infos.clear();
+  for (uint32_t group = 0; group < kGroupCount; ++group) {
+    infos.push_back(make_info(group_id(group), kRootId, 0));
+  }
+  root_node->DeleteDomNodes(std::move(infos));
+  EXPECT_EQ(root_node->GetNodeTable().Size(), 0);
+  EXPECT_EQ(root_node->GetNode(group_id(0) + 1), nullptr);
+}
+
+}  // namespace testing
+}  // namespace dom
+}  // namespace hippy
@@ -0,0 +1,412 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dom/dom_snapshot.h"
+
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
+#include "dom/dom_node.h"
+#include "dom/root_node.h"
+#include "footstone/check.h"
+#include "footstone/deserializer.h"
+#include "footstone/logging.h"
+#include "footstone/serializer.h"
+
+namespace hippy {
+inline namespace dom {
+
+using HippyValue = footstone::value::HippyValue;
+using Serializer = footstone::value::Serializer;
+using Deserializer = footstone::value::Deserializer;
+using DomValueMapType = std::unordered_map<std::string, std::shared_ptr<HippyValue>>;
+
+namespace {
+
+constexpr size_t kLayoutFieldCount = 12;
+
+struct SnapshotHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t node_count;
+  uint32_t node_table_offset;
+  uint32_t value_count;
+  uint32_t value_table_offset;
+  uint32_t string_count;
+  uint32_t string_table_offset;
+  uint32_t blob_offset;
+  uint32_t blob_size;
+};
+
+struct SnapshotNode {
+  uint32_t id;
+  uint32_t pid;
+  int32_t index;
+  uint32_t tag_name;
+  uint32_t view_name;
+  uint32_t style_begin;
+  uint32_t style_count;
+  uint32_t ext_begin;
+  uint32_t ext_count;
+  float layout[kLayoutFieldCount];
+  float render_layout[kLayoutFieldCount];
+};
+
+enum class SnapshotValueType : uint32_t { kUndefined, kNull, kBoolean, kInt32, kUint32, kDouble, kString, kEncoded };
+
+struct SnapshotValue {
+  uint32_t key;
+  SnapshotValueType type;
+  union {
+    double d;
+    int32_t i32;
+    uint32_t u32;
+    uint32_t string;
+    struct {
+      uint32_t offset;
+      uint32_t length;
+    } encoded;
+  } payload;
+};
+
+struct SnapshotString {
+  uint32_t offset;
+  uint32_t length;
+};
+
+static_assert(sizeof(SnapshotHeader) == 40, "snapshot header layout changed");
+static_assert(sizeof(SnapshotNode) == 132, "snapshot node layout changed");
+static_assert(sizeof(SnapshotValue) == 16, "snapshot value layout changed");
+static_assert(sizeof(LayoutResult) == sizeof(float) * kLayoutFieldCount, "LayoutResult layout changed");
+
+// 快照可能来自任意对齐的内存, 统一按字节拷贝读取
+template <typename T>
+T ReadRecord(const uint8_t* data, size_t offset) {
+  T record;
+  memcpy(&record, data + offset, sizeof(T));
+  return record;
+}
+
+class SnapshotWriter {
+ public:
+  void AddNode(const std::shared_ptr<DomNode>& node) {
+    SnapshotNode record{};
+    record.id = node->GetId();
+    record.pid = node->GetPid();
+    record.index = node->GetIndex();
+    record.tag_name = Intern(node->GetTagName());
+    record.view_name = Intern(node->GetViewName());
+    AddValues(node->GetStyleMap(), record.style_begin, record.style_count);
+    AddValues(node->GetExtStyle(), record.ext_begin, record.ext_count);
+    memcpy(record.layout, &node->GetLayoutResult(), sizeof(record.layout));
+    memcpy(record.render_layout, &node->GetRenderLayoutResult(), sizeof(record.render_layout));
+    nodes_.push_back(record);
+  }
+
+  std::string Finish() {
+    // 表和数据的偏移都是 uint32_t, 超过 4GB 的快照无法表示
+    auto value_table_offset = sizeof(SnapshotHeader) + nodes_.size() * sizeof(SnapshotNode);
+    auto string_table_offset = value_table_offset + values_.size() * sizeof(SnapshotValue);
+    auto blob_offset = string_table_offset + strings_.size() * sizeof(SnapshotString);
+    if (blob_offset + blob_.size() > std::numeric_limits<uint32_t>::max()) {
+      FOOTSTONE_LOG(ERROR) << "DomSnapshot::Encode snapshot is too large, size = " << blob_offset + blob_.size();
+      return {};
+    }
+    SnapshotHeader header{};
+    header.magic = DomSnapshot::kMagic;
+    header.version = DomSnapshot::kVersion;
+    header.node_count = footstone::check::checked_numeric_cast<size_t, uint32_t>(nodes_.size());
+    header.node_table_offset = sizeof(SnapshotHeader);
+    header.value_count = footstone::check::checked_numeric_cast<size_t, uint32_t>(values_.size());
+    header.value_table_offset = footstone::check::checked_numeric_cast<size_t, uint32_t>(value_table_offset);
+    header.string_count = footstone::check::checked_numeric_cast<size_t, uint32_t>(strings_.size());
+    header.string_table_offset = footstone::check::checked_numeric_cast<size_t, uint32_t>(string_table_offset);
+    header.blob_offset = footstone::check::checked_numeric_cast<size_t, uint32_t>(blob_offset);
+    header.blob_size = footstone::check::checked_numeric_cast<size_t, uint32_t>(blob_.size());
+
+    std::string buffer(blob_offset + blob_.size(), '\0');
+    auto data = &buffer[0];
+    memcpy(data, &header, sizeof(header));
+    memcpy(data + header.node_table_offset, nodes_.data(), nodes_.size() * sizeof(SnapshotNode));
+    memcpy(data + header.value_table_offset, values_.data(), values_.size() * sizeof(SnapshotValue));
+    memcpy(data + header.string_table_offset, strings_.data(), strings_.size() * sizeof(SnapshotString));
+    memcpy(data + header.blob_offset, blob_.data(), blob_.size());
+    return buffer;
+  }
+
+ private:
+  uint32_t Intern(const std::string& str) {
+    auto it = string_index_.find(str);
+    if (it != string_index_.end()) {
+      return it->second;
+    }
+    auto index = static_cast<uint32_t>(strings_.size());
+    strings_.push_back({static_cast<uint32_t>(blob_.size()), static_cast<uint32_t>(str.size())});
+    blob_.append(str);
+    string_index_.emplace(str, index);
+    return index;
+  }
+
+  void AddValues(const std::shared_ptr<DomValueMapType>& map, uint32_t& begin, uint32_t& count) {
+    begin = static_cast<uint32_t>(values_.size());
+    count = 0;
+    if (map == nullptr) {
+      return;
+    }
+    for (const auto& [key, value] : *map) {
+      if (value == nullptr) {
+        continue;
+      }
+      SnapshotValue record{};
+      record.key = Intern(key);
+      EncodeValue(*value, record);
+      values_.push_back(record);
+      ++count;
+    }
+  }
+
+  void EncodeValue(const HippyValue& value, SnapshotValue& record) {
+    switch (value.GetType()) {
+      case HippyValue::Type::kUndefined:
+        record.type = SnapshotValueType::kUndefined;
+        break;
+      case HippyValue::Type::kNull:
+        record.type = SnapshotValueType::kNull;
+        break;
+      case HippyValue::Type::kBoolean:
+        record.type = SnapshotValueType::kBoolean;
+        record.payload.u32 = value.ToBooleanChecked() ? 1 : 0;
+        break;
+      case HippyValue::Type::kNumber:
+        if (value.GetNumberType() == HippyValue::NumberType::kInt32) {
+          record.type = SnapshotValueType::kInt32;
+          record.payload.i32 = value.ToInt32Checked();
+        } else if (value.GetNumberType() == HippyValue::NumberType::kUInt32) {
+          record.type = SnapshotValueType::kUint32;
+          record.payload.u32 = value.ToUint32Checked();
+        } else {
+          record.type = SnapshotValueType::kDouble;
+          record.payload.d = value.ToDoubleChecked();
+        }
+        break;
+      case HippyValue::Type::kString:
+        record.type = SnapshotValueType::kString;
+        record.payload.string = Intern(value.ToStringChecked());
+        break;
+      default: {
+        // object 和 array 使用 footstone 序列化格式保存在 blob 中
+        Serializer serializer;
+        serializer.WriteHeader();
+        serializer.WriteValue(value);
+        auto buffer_pair = serializer.Release();
+        std::string encoded(reinterpret_cast<const char*>(buffer_pair.first), buffer_pair.second);
+        footstone::value::SerializerHelper::DestroyBuffer(buffer_pair);
+        // 相同的复杂值 (如 transform) 在节点间大量重复, 与字符串一样只保存一份
+        auto it = encoded_index_.find(encoded);
+        if (it == encoded_index_.end()) {
+          it = encoded_index_.emplace(std::move(encoded), static_cast<uint32_t>(blob_.size())).first;
+          blob_.append(it->first);
+        }
+        record.type = SnapshotValueType::kEncoded;
+        record.payload.encoded.offset = it->second;
+        record.payload.encoded.length = static_cast<uint32_t>(it->first.size());
+        break;
+      }
+    }
+  }
+
+  std::vector<SnapshotNode> nodes_;
+  std::vector<SnapshotValue> values_;
+  std::vector<SnapshotString> strings_;
+  std::unordered_map<std::string, uint32_t> string_index_;
+  std::unordered_map<std::string, uint32_t> encoded_index_;
+  std::string blob_;
+};
+
+class SnapshotReader {
+ public:
+  SnapshotReader(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+  bool ReadHeader() {
+    if (length_ < sizeof(SnapshotHeader)) {
+      return false;
+    }
+    header_ = ReadRecord<SnapshotHeader>(data_, 0);
+    if (header_.magic != DomSnapshot::kMagic || header_.version != DomSnapshot::kVersion) {
+      return false;
+    }
+    return IsInRange(header_.node_table_offset, static_cast<uint64_t>(header_.node_count) * sizeof(SnapshotNode)) &&
+        IsInRange(header_.value_table_offset, static_cast<uint64_t>(header_.value_count) * sizeof(SnapshotValue)) &&
+        IsInRange(header_.string_table_offset,
+                  static_cast<uint64_t>(header_.string_count) * sizeof(SnapshotString)) &&
+        IsInRange(header_.blob_offset, header_.blob_size);
+  }
+
+  inline uint32_t GetNodeCount() const { return header_.node_count; }
+
+  SnapshotNode GetNode(uint32_t index) const {
+    return ReadRecord<SnapshotNode>(data_, header_.node_table_offset + index * sizeof(SnapshotNode));
+  }
+
+  bool GetString(uint32_t index, std::string_view& str) const {
+    if (index >= header_.string_count) {
+      return false;
+    }
+    auto record = ReadRecord<SnapshotString>(data_, header_.string_table_offset + index * sizeof(SnapshotString));
+    if (static_cast<uint64_t>(record.offset) + record.length > header_.blob_size) {
+      return false;
+    }
+    str = std::string_view(reinterpret_cast<const char*>(data_ + header_.blob_offset + record.offset),
+                           record.length);
+    return true;
+  }
+
+  bool ReadValues(uint32_t begin, uint32_t count, std::shared_ptr<DomValueMapType>& map) const {
+    if (static_cast<uint64_t>(begin) + count > header_.value_count) {
+      return false;
+    }
+    map = std::make_shared<DomValueMapType>();
+    map->reserve(count);
+    for (uint32_t i = begin; i < begin + count; ++i) {
+      auto record = ReadRecord<SnapshotValue>(data_, header_.value_table_offset + i * sizeof(SnapshotValue));
+      std::string_view key;
+      auto value = std::make_shared<HippyValue>();
+      if (!GetString(record.key, key) || !ReadValue(record, *value)) {
+        return false;
+      }
+      map->emplace(key, std::move(value));
+    }
+    return true;
+  }
+
+ private:
+  inline bool IsInRange(uint64_t offset, uint64_t size) const { return offset + size <= length_; }
+
+  bool ReadValue(const SnapshotValue& record, HippyValue& value) const {
+    switch (record.type) {
+      case SnapshotValueType::kUndefined:
+        value = HippyValue::Undefined();
+        return true;
+      case SnapshotValueType::kNull:
+        value = HippyValue::Null();
+        return true;
+      case SnapshotValueType::kBoolean:
+        value = HippyValue(record.payload.u32 != 0);
+        return true;
+      case SnapshotValueType::kInt32:
+        value = HippyValue(record.payload.i32);
+        return true;
+      case SnapshotValueType::kUint32:
+        value = HippyValue(record.payload.u32);
+        return true;
+      case SnapshotValueType::kDouble:
+        value = HippyValue(record.payload.d);
+        return true;
+      case SnapshotValueType::kString: {
+        std::string_view str;
+        if (!GetString(record.payload.string, str)) {
+          return false;
+        }
+        value = HippyValue(std::string(str));
+        return true;
+      }
+      case SnapshotValueType::kEncoded: {
+        auto offset = record.payload.encoded.offset;
+        auto length = record.payload.encoded.length;
+        if (static_cast<uint64_t>(offset) + length > header_.blob_size) {
+          return false;
+        }
+        Deserializer deserializer(data_ + header_.blob_offset + offset, length);
+        deserializer.ReadHeader();
+        return deserializer.ReadValue(value);
+      }
+      default:
+        return false;
+    }
+  }
+
+  const uint8_t* data_;
+  size_t length_;
+  SnapshotHeader header_{};
+};
+
+}  // namespace
+
+std::string DomSnapshot::Encode(const std::shared_ptr<RootNode>& root_node) {
+  if (!root_node) {
+    return {};
+  }
+  SnapshotWriter writer;
+  root_node->Traverse([&writer](const std::shared_ptr<DomNode>& node) { writer.AddNode(node); });
+  return writer.Finish();
+}
+
+bool DomSnapshot::IsSnapshot(const uint8_t* data, size_t length) {
+  if (data == nullptr || length < sizeof(SnapshotHeader)) {
+    return false;
+  }
+  auto header = ReadRecord<SnapshotHeader>(data, 0);
+  return header.magic == kMagic && header.version == kVersion;
+}
+
+bool DomSnapshot::Decode(const uint8_t* data, size_t length, const std::shared_ptr<RootNode>& root_node,
+                         std::vector<std::shared_ptr<DomInfo>>& nodes, LayoutResult& root_layout) {
+  SnapshotReader reader(data, length);
+  if (!root_node || !reader.ReadHeader() || reader.GetNodeCount() == 0) {
+    FOOTSTONE_LOG(ERROR) << "DomSnapshot::Decode invalid snapshot, length = " << length;
+    return false;
+  }
+  auto root_record = reader.GetNode(0);
+  if (root_record.pid != 0) {
+    return false;
+  }
+  memcpy(&root_layout, root_record.layout, sizeof(root_layout));
+  auto& arena = root_node->GetArena();
+  nodes.reserve(reader.GetNodeCount() - 1);
+  for (uint32_t i = 1; i < reader.GetNodeCount(); ++i) {
+    auto record = reader.GetNode(i);
+    std::string_view tag_name;
+    std::string_view view_name;
+    std::shared_ptr<DomValueMapType> style_map;
+    std::shared_ptr<DomValueMapType> ext_map;
+    if (!reader.GetString(record.tag_name, tag_name) || !reader.GetString(record.view_name, view_name) ||
+        !reader.ReadValues(record.style_begin, record.style_count, style_map) ||
+        !reader.ReadValues(record.ext_begin, record.ext_count, ext_map)) {
+      FOOTSTONE_LOG(ERROR) << "DomSnapshot::Decode invalid node record, index = " << i;
+      return false;
+    }
+    auto pid = record.pid == root_record.id ? root_node->GetId() : record.pid;
+    auto dom_node = arena->MakeShared<DomNode>(record.id, pid, record.index, std::string(tag_name),
+                                               std::string(view_name), std::move(style_map), std::move(ext_map),
+                                               root_node);
+    LayoutResult layout;
+    LayoutResult render_layout;
+    memcpy(&layout, record.layout, sizeof(layout));
+    memcpy(&render_layout, record.render_layout, sizeof(render_layout));
+    dom_node->RestoreLayoutResult(layout, render_layout);
+    nodes.push_back(arena->MakeShared<DomInfo>(std::move(dom_node), nullptr, nullptr));
+  }
+  return true;
+}
+
+}  // namespace dom
+}  // namespace hippy
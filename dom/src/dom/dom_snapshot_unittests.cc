@@ -0,0 +1,203 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "dom/dom_node.h"
+#include "dom/dom_snapshot.h"
+#include "dom/node_props.h"
+#include "dom/render_manager.h"
+#include "dom/root_node.h"
+#include "footstone/serializer.h"
+
+namespace hippy {
+inline namespace dom {
+inline namespace testing {
+
+using DomValueMapType = std::unordered_map<std::string, std::shared_ptr<HippyValue>>;
+using HippyValueArrayType = footstone::value::HippyValue::HippyValueArrayType;
+
+constexpr uint32_t kSnapshotRootId = 1;
+constexpr uint32_t kRestoredRootId = 100;
+constexpr uint32_t kSectionCount = 100;
+constexpr uint32_t kItemsPerSection = 20;
+
+class LayoutRecordingRenderManager : public RenderManager {
+ public:
+  LayoutRecordingRenderManager() : RenderManager("LayoutRecordingRenderManager") {}
+
+  void CreateRenderNode(std::weak_ptr<RootNode> root_node, std::vector<std::shared_ptr<DomNode>>&& nodes) override {
+    created_count += static_cast<uint32_t>(nodes.size());
+  }
+  void UpdateRenderNode(std::weak_ptr<RootNode> root_node, std::vector<std::shared_ptr<DomNode>>&& nodes) override {}
+  void MoveRenderNode(std::weak_ptr<RootNode> root_node, std::vector<std::shared_ptr<DomNode>>&& nodes) override {}
+  void DeleteRenderNode(std::weak_ptr<RootNode> root_node, std::vector<std::shared_ptr<DomNode>>&& nodes) override {}
+  void UpdateLayout(std::weak_ptr<RootNode> root_node, const std::vector<std::shared_ptr<DomNode>>& nodes) override {
+    layout_count += static_cast<uint32_t>(nodes.size());
+  }
+  void MoveRenderNode(std::weak_ptr<RootNode> root_node, std::vector<int32_t>&& moved_ids, int32_t from_pid,
+                      int32_t to_pid, int32_t index) override {}
+  void EndBatch(std::weak_ptr<RootNode> root_node) override {}
+  void BeforeLayout(std::weak_ptr<RootNode> root_node) override {}
+  void AfterLayout(std::weak_ptr<RootNode> root_node) override {}
+  void AddEventListener(std::weak_ptr<RootNode> root_node, std::weak_ptr<DomNode> dom_node,
+                        const std::string& name) override {}
+  void RemoveEventListener(std::weak_ptr<RootNode> root_node, std::weak_ptr<DomNode> dom_node,
+                           const std::string& name) override {}
+  void CallFunction(std::weak_ptr<RootNode> root_node, std::weak_ptr<DomNode> dom_node, const std::string& name,
+                    const DomArgument& param, uint32_t cb_id) override {}
+
+  uint32_t created_count = 0;
+  uint32_t layout_count = 0;
+};
+
+std::shared_ptr<DomInfo> MakeNodeInfo(const std::shared_ptr<RootNode>& root_node, uint32_t id, uint32_t pid,
+                                      double height) {
+  auto style = std::make_shared<DomValueMapType>();
+  (*style)[kWidth] = std::make_shared<HippyValue>(1000.0);
+  (*style)[kHeight] = std::make_shared<HippyValue>(height);
+  (*style)["backgroundColor"] = std::make_shared<HippyValue>(static_cast<uint32_t>(0xFF00FF00));
+  (*style)["opacity"] = std::make_shared<HippyValue>(0.5);
+  (*style)["visible"] = std::make_shared<HippyValue>(true);
+  (*style)["text"] = std::make_shared<HippyValue>("item " + std::to_string(id));
+  HippyValueArrayType transform;
+  footstone::value::HippyValue::HippyValueObjectType scale;
+  scale["scale"] = HippyValue(2);
+  transform.emplace_back(scale);
+  (*style)["transform"] = std::make_shared<HippyValue>(transform);
+  auto ext = std::make_shared<DomValueMapType>();
+  (*ext)["key"] = std::make_shared<HippyValue>(static_cast<int32_t>(id));
+  auto node = std::make_shared<DomNode>(id, pid, 0, "div", "View", style, ext, root_node);
+  return std::make_shared<DomInfo>(node, nullptr, nullptr);
+}
+
+// root -> kSectionCount sections -> kItemsPerSection items -> one text per item
+std::shared_ptr<RootNode> MakeLaidOutRoot() {
+  auto root_node = std::make_shared<RootNode>(kSnapshotRootId);
+  root_node->SetRootSize(1000, 1000);
+  std::vector<std::shared_ptr<DomInfo>> infos;
+  uint32_t id = kSnapshotRootId + 1;
+  for (uint32_t i = 0; i < kSectionCount; ++i) {
+    auto section_id = id++;
+    infos.push_back(MakeNodeInfo(root_node, section_id, kSnapshotRootId, kItemsPerSection * 50));
+    for (uint32_t j = 0; j < kItemsPerSection; ++j) {
+      auto item_id = id++;
+      infos.push_back(MakeNodeInfo(root_node, item_id, section_id, 50));
+      infos.push_back(MakeNodeInfo(root_node, id++, item_id, 20));
+    }
+  }
+  root_node->CreateDomNodes(std::move(infos), false);
+  root_node->SyncWithRenderManager(std::make_shared<LayoutRecordingRenderManager>());
+  return root_node;
+}
+
+// the format used by DomManager before the flat snapshot, a serialized array of DomNode::Serialize()
+std::string EncodeLegacySnapshot(const std::shared_ptr<RootNode>& root_node) {
+  HippyValueArrayType array;
+  root_node->Traverse([&array](const std::shared_ptr<DomNode>& node) { array.emplace_back(node->Serialize()); });
+  footstone::value::Serializer serializer;
+  serializer.WriteHeader();
+  serializer.WriteValue(HippyValue(array));
+  auto buffer_pair = serializer.Release();
+  std::string buffer(reinterpret_cast<const char*>(buffer_pair.first), buffer_pair.second);
+  footstone::value::SerializerHelper::DestroyBuffer(buffer_pair);
+  return buffer;
+}
+
+bool IsSameLayout(const LayoutResult& lhs, const LayoutResult& rhs) {
+  return lhs.left == rhs.left && lhs.top == rhs.top && lhs.width == rhs.width && lhs.height == rhs.height;
+}
+
+TEST(DomSnapshotTest, RoundTrip) {
+  auto root_node = MakeLaidOutRoot();
+  auto buffer = DomSnapshot::Encode(root_node);
+  auto data = reinterpret_cast<const uint8_t*>(buffer.c_str());
+  ASSERT_TRUE(DomSnapshot::IsSnapshot(data, buffer.length()));
+  EXPECT_FALSE(DomSnapshot::IsSnapshot(data, 8));
+
+  auto restored_root = std::make_shared<RootNode>(kRestoredRootId);
+  std::vector<std::shared_ptr<DomInfo>> nodes;
+  LayoutResult root_layout;
+  ASSERT_TRUE(DomSnapshot::Decode(data, buffer.length(), restored_root, nodes, root_layout));
+  EXPECT_EQ(root_layout.width, 1000);
+  ASSERT_EQ(nodes.size(), root_node->GetChildCount());
+  for (const auto& info : nodes) {
+    const auto& restored = info->dom_node;
+    auto orig = root_node->GetNode(restored->GetId());
+    ASSERT_NE(orig, nullptr);
+    auto expected_pid = orig->GetPid() == kSnapshotRootId ? kRestoredRootId : orig->GetPid();
+    EXPECT_EQ(restored->GetPid(), expected_pid);
+    EXPECT_EQ(restored->GetTagName(), orig->GetTagName());
+    EXPECT_EQ(restored->GetViewName(), orig->GetViewName());
+    EXPECT_EQ(*restored->GetStyleMap()->at("transform"), *orig->GetStyleMap()->at("transform"));
+    EXPECT_EQ(*restored->GetStyleMap()->at("text"), *orig->GetStyleMap()->at("text"));
+    EXPECT_EQ(*restored->GetStyleMap()->at("backgroundColor"), *orig->GetStyleMap()->at("backgroundColor"));
+    EXPECT_EQ(*restored->GetExtStyle()->at("key"), *orig->GetExtStyle()->at("key"));
+    EXPECT_TRUE(IsSameLayout(restored->GetRenderLayoutResult(), orig->GetRenderLayoutResult()));
+  }
+
+  // truncated snapshots are rejected instead of read out of bounds
+  std::vector<std::shared_ptr<DomInfo>> truncated_nodes;
+  EXPECT_FALSE(DomSnapshot::Decode(data, buffer.length() / 2, restored_root, truncated_nodes, root_layout));
+}
+
+TEST(DomSnapshotTest, FirstFrameSkipsLayout) {
+  auto root_node = MakeLaidOutRoot();
+  auto buffer = DomSnapshot::Encode(root_node);
+  auto restored_root = std::make_shared<RootNode>(kRestoredRootId);
+  restored_root->SetRootSize(1000, 1000);
+  std::vector<std::shared_ptr<DomInfo>> nodes;
+  LayoutResult root_layout;
+  ASSERT_TRUE(DomSnapshot::Decode(reinterpret_cast<const uint8_t*>(buffer.c_str()), buffer.length(), restored_root,
+                                  nodes, root_layout));
+  restored_root->MarkLayoutRestored();
+  restored_root->CreateDomNodes(std::move(nodes), false);
+  auto render_manager = std::make_shared<LayoutRecordingRenderManager>();
+  restored_root->SyncWithRenderManager(render_manager);
+  EXPECT_EQ(render_manager->created_count, root_node->GetChildCount());
+  EXPECT_EQ(render_manager->layout_count, root_node->GetChildCount() + 1);
+  EXPECT_EQ(restored_root->GetLayoutVisitCount(), 0);
+
+  // the deferred layout runs in the next batch and produces the same results as the snapshot
+  restored_root->SyncWithRenderManager(render_manager);
+  EXPECT_GT(restored_root->GetLayoutVisitCount(), 0);
+  restored_root->Traverse([&root_node](const std::shared_ptr<DomNode>& node) {
+    if (node->GetId() != kRestoredRootId) {
+      auto orig = root_node->GetNode(node->GetId());
+      EXPECT_TRUE(IsSameLayout(node->GetRenderLayoutResult(), orig->GetRenderLayoutResult()));
+    }
+  });
+}
+
+TEST(DomSnapshotTest, LegacySnapshotRejected) {
+  auto root_node = MakeLaidOutRoot();
+  auto legacy_buffer = EncodeLegacySnapshot(root_node);
+  auto data = reinterpret_cast<const uint8_t*>(legacy_buffer.c_str());
+  EXPECT_FALSE(DomSnapshot::IsSnapshot(data, legacy_buffer.length()));
+  auto restored_root = std::make_shared<RootNode>(kRestoredRootId);
+  std::vector<std::shared_ptr<DomInfo>> nodes;
+  LayoutResult root_layout;
+  EXPECT_FALSE(DomSnapshot::Decode(data, legacy_buffer.length(), restored_root, nodes, root_layout));
+  EXPECT_TRUE(nodes.empty());
+}
+
+}  // namespace testing
+}  // namespace dom
+}  // namespace hippy
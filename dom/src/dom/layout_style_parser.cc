@@ -0,0 +1,120 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dom/layout_style_parser.h"
+
+#include "dom/node_props.h"
+#include "footstone/check.h"
+
+namespace hippy {
+inline namespace dom {
+
+constexpr size_t kLayoutStyleCount = static_cast<size_t>(LayoutStyle::kCount);
+
+// 与 LayoutStyle 的声明顺序一一对应
+constexpr const char* kLayoutStyleNames[kLayoutStyleCount] = {
+    kWidth, kMinWidth, kMaxWidth, kHeight, kMinHeight, kMaxHeight,
+    kFlex, kFlexGrow, kFlexShrink, kFlexBasis,
+    kDirection, kFlexDirection, kFlexWrap, kAilgnSelf, kAlignItems, kJustifyContent, kOverflow, kDisplay,
+    kMargin, kMarginVertical, kMarginHorizontal, kMarginLeft, kMarginRight, kMarginTop, kMarginBottom,
+    kPadding, kPaddingVertical, kPaddingHorizontal, kPaddingLeft, kPaddingRight, kPaddingTop, kPaddingBottom,
+    kBorderWidth, kBorderLeftWidth, kBorderTopWidth, kBorderRightWidth, kBorderBottomWidth,
+    kLeft, kRight, kTop, kBottom,
+    kPosition, kAspectRatio, kAlignContent};
+
+// FNV-1a 取高 7 位作为槽位，种子是离线挑选的，保证上面的属性名互不冲突，下面的 static_assert 负责校验
+constexpr uint32_t kHashSeed = 83;
+constexpr uint32_t kHashBits = 7;
+constexpr size_t kSlotCount = size_t{1} << kHashBits;
+constexpr uint8_t kEmptySlot = 0xFF;
+
+constexpr uint32_t HashName(const char* name, size_t length) {
+  uint32_t hash = kHashSeed;
+  for (size_t i = 0; i < length; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(name[i])) * 16777619u;
+  }
+  return hash >> (32 - kHashBits);
+}
+
+constexpr size_t NameLength(const char* name) {
+  size_t length = 0;
+  while (name[length] != '\0') {
+    ++length;
+  }
+  return length;
+}
+
+constexpr std::array<uint8_t, kSlotCount> BuildSlots() {
+  std::array<uint8_t, kSlotCount> slots{};
+  for (auto& slot: slots) {
+    slot = kEmptySlot;
+  }
+  for (size_t i = 0; i < kLayoutStyleCount; ++i) {
+    auto name = kLayoutStyleNames[i];
+    slots[HashName(name, NameLength(name))] = static_cast<uint8_t>(i);
+  }
+  return slots;
+}
+
+constexpr std::array<uint8_t, kSlotCount> kSlots = BuildSlots();
+
+constexpr bool IsPerfectHash() {
+  for (size_t i = 0; i < kLayoutStyleCount; ++i) {
+    auto name = kLayoutStyleNames[i];
+    if (kSlots[HashName(name, NameLength(name))] != i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(IsPerfectHash(), "layout style names collide, pick another kHashSeed");
+
+bool LayoutStyleParser::Lookup(const std::string& name, LayoutStyle& style) {
+  auto index = kSlots[HashName(name.data(), name.size())];
+  if (index == kEmptySlot || strcmp(name.c_str(), kLayoutStyleNames[index]) != 0) {
+    return false;
+  }
+  style = static_cast<LayoutStyle>(index);
+  return true;
+}
+
+LayoutStyleParser::LayoutStyleParser(const DomValueMap& style_update, const std::vector<std::string>& style_delete) {
+  LayoutStyle style;
+  for (const auto& [key, value]: style_update) {
+    if (!Lookup(key, style)) {
+      continue;
+    }
+    FOOTSTONE_DCHECK(value != nullptr);
+    if (value == nullptr) {
+      continue;
+    }
+    update_mask_ |= Bit(style);
+    values_[static_cast<size_t>(style)] = value.get();
+  }
+  for (const auto& key: style_delete) {
+    if (Lookup(key, style)) {
+      delete_mask_ |= Bit(style);
+    }
+  }
+}
+
+}  // namespace dom
+}  // namespace hippy
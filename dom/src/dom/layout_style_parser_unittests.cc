@@ -0,0 +1,134 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dom/layout_style_parser.h"
+#include "dom/node_props.h"
+
+namespace hippy {
+inline namespace dom {
+inline namespace testing {
+
+using HippyValue = footstone::value::HippyValue;
+using DomValueMapType = std::unordered_map<std::string, std::shared_ptr<HippyValue>>;
+
+const std::vector<std::string> kAllLayoutStyles = {
+    kWidth, kMinWidth, kMaxWidth, kHeight, kMinHeight, kMaxHeight,
+    kFlex, kFlexGrow, kFlexShrink, kFlexBasis,
+    kDirection, kFlexDirection, kFlexWrap, kAilgnSelf, kAlignItems, kJustifyContent, kOverflow, kDisplay,
+    kMargin, kMarginVertical, kMarginHorizontal, kMarginLeft, kMarginRight, kMarginTop, kMarginBottom,
+    kPadding, kPaddingVertical, kPaddingHorizontal, kPaddingLeft, kPaddingRight, kPaddingTop, kPaddingBottom,
+    kBorderWidth, kBorderLeftWidth, kBorderTopWidth, kBorderRightWidth, kBorderBottomWidth,
+    kLeft, kRight, kTop, kBottom,
+    kPosition, kAspectRatio, kAlignContent};
+
+TEST(LayoutStyleParserTest, Lookup) {
+  ASSERT_EQ(kAllLayoutStyles.size(), static_cast<size_t>(LayoutStyle::kCount));
+  LayoutStyle style;
+  for (size_t i = 0; i < kAllLayoutStyles.size(); ++i) {
+    ASSERT_TRUE(LayoutStyleParser::Lookup(kAllLayoutStyles[i], style)) << kAllLayoutStyles[i];
+    EXPECT_EQ(static_cast<size_t>(style), i);
+  }
+  for (const auto& name : {"", "color", "opacity", "backgroundColor", "widt", "widths", "Width", "marginStart"}) {
+    EXPECT_FALSE(LayoutStyleParser::Lookup(name, style)) << name;
+  }
+}
+
+TEST(LayoutStyleParserTest, DispatchOrder) {
+  DomValueMapType update = {{kMarginLeft, std::make_shared<HippyValue>(5)},
+                            {kMargin, std::make_shared<HippyValue>(10)},
+                            {kFlexDirection, std::make_shared<HippyValue>("row")},
+                            {kWidth, std::make_shared<HippyValue>(100)},
+                            {kHeight, nullptr},
+                            {"color", std::make_shared<HippyValue>(0xff)}};
+  std::vector<std::string> remove = {kTop, kWidth, "opacity", kPaddingTop};
+  LayoutStyleParser parser(update, remove);
+
+  std::vector<std::pair<LayoutStyle, bool>> calls;
+  parser.Dispatch([&calls](LayoutStyle style, const HippyValue&) { calls.emplace_back(style, true); },
+                  [&calls](LayoutStyle style) { calls.emplace_back(style, false); });
+  std::vector<std::pair<LayoutStyle, bool>> expected = {{LayoutStyle::kWidth, true},
+                                                        {LayoutStyle::kFlexDirection, true},
+                                                        {LayoutStyle::kMargin, true},
+                                                        {LayoutStyle::kMarginLeft, true},
+                                                        {LayoutStyle::kPaddingTop, false},
+                                                        {LayoutStyle::kTop, false}};
+  EXPECT_EQ(calls, expected);
+
+  ASSERT_NE(parser.GetUpdate(LayoutStyle::kMargin), nullptr);
+  EXPECT_EQ(parser.GetUpdate(LayoutStyle::kMargin)->ToInt32Checked(), 10);
+  EXPECT_EQ(parser.GetUpdate(LayoutStyle::kHeight), nullptr);
+  EXPECT_FALSE(parser.IsDeleted(LayoutStyle::kWidth));
+  EXPECT_TRUE(parser.IsDeleted(LayoutStyle::kTop));
+  EXPECT_FALSE(parser.empty());
+  EXPECT_TRUE(LayoutStyleParser({{"color", std::make_shared<HippyValue>(1)}}, {"opacity"}).empty());
+}
+
+TEST(LayoutStyleParserTest, LookupKeyword) {
+  enum class Align { kAuto, kStart, kCenter };
+  constexpr LayoutKeyword<Align> keywords[] = {
+      {"auto", Align::kAuto}, {"flex-start", Align::kStart}, {"center", Align::kCenter}};
+  EXPECT_EQ(LookupLayoutKeyword(keywords, "center", Align::kAuto), Align::kCenter);
+  EXPECT_EQ(LookupLayoutKeyword(keywords, "flex-start", Align::kAuto), Align::kStart);
+  EXPECT_EQ(LookupLayoutKeyword(keywords, "flex-end", Align::kCenter), Align::kCenter);
+}
+
+// 旧实现的解析方式：对每个支持的排版属性都查一次 update，再线性扫描一次 delete，作为结果的参照
+static size_t ProbeEveryStyle(const DomValueMapType& update, const std::vector<std::string>& remove) {
+  size_t count = 0;
+  for (const auto& name : kAllLayoutStyles) {
+    if (update.find(name) != update.end()) {
+      count += update.find(name)->second != nullptr;
+    } else if (std::find(remove.begin(), remove.end(), name) != remove.end()) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+TEST(LayoutStyleParserTest, DispatchMatchesProbeEveryStyle) {
+  DomValueMapType small = {{kWidth, std::make_shared<HippyValue>(100)}};
+  DomValueMapType large = {{"color", std::make_shared<HippyValue>(0xff000000)},
+                           {"backgroundColor", std::make_shared<HippyValue>(0xffffffff)},
+                           {"opacity", std::make_shared<HippyValue>(0.5)},
+                           {"borderRadius", std::make_shared<HippyValue>(4)}};
+  for (size_t i = 0; i < kAllLayoutStyles.size(); i += 2) {
+    large[kAllLayoutStyles[i]] = std::make_shared<HippyValue>(static_cast<double>(i));
+  }
+  std::vector<std::string> remove = {kMinHeight, "opacity"};
+
+  for (const auto* update : {&small, &large}) {
+    size_t parser_count = 0;
+    LayoutStyleParser parser(*update, remove);
+    parser.Dispatch([&parser_count](LayoutStyle, const HippyValue&) { ++parser_count; },
+                    [&parser_count](LayoutStyle) { ++parser_count; });
+    EXPECT_EQ(ProbeEveryStyle(*update, remove), parser_count);
+  }
+}
+
+}  // namespace testing
+}  // namespace dom
+}  // namespace hippy
@@ -0,0 +1,178 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dom/parallel_layout.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "dom/dom_node.h"
+#include "dom/layout_node.h"
+#include "dom/node_props.h"
+
+namespace hippy {
+inline namespace dom {
+
+constexpr char kParallelLayoutRunnerName[] = "hippy_parallel_layout";
+
+// 一次并行布局的共享状态, 由 worker 任务共同持有, 调用线程返回后迟到的任务也不会访问失效的内存
+struct ParallelLayoutBatch {
+  std::vector<std::shared_ptr<DomNode>> subtrees;
+  size_t chunk_size = 0;
+  std::unique_ptr<std::atomic<bool>[]> claimed;  // 每个 lane 只会被一个线程计算
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t finished_count = 0;
+};
+
+// 宽高固定的节点仍可能被父节点的 flex 伸缩或被 min/max、宽高比修正尺寸, 这样的子树不能脱离父节点单独计算
+constexpr const char* kParentDependentStyles[] = {kFlex, kFlexGrow, kFlexShrink, kFlexBasis, kMinWidth,
+                                                  kMaxWidth, kMinHeight, kMaxHeight, kAspectRatio};
+
+static bool HasMeasureNode(const std::shared_ptr<DomNode>& node) {
+  if (node->GetLayoutNode()->HasMeasureFunction()) {
+    return true;
+  }
+  const auto& children = node->GetChildren();
+  return std::any_of(children.begin(), children.end(), HasMeasureNode);
+}
+
+static void CalculateSubtrees(const std::vector<std::shared_ptr<DomNode>>& subtrees, size_t begin, size_t end) {
+  for (auto i = begin; i < end; ++i) {
+    auto layout_node = subtrees[i]->GetLayoutNode();
+    // 子树根的尺寸不受父节点影响 (见 IsIndependentSubtree), 父节点解析后给它的约束就是它自身的宽高
+    layout_node->CalculateLayout(layout_node->GetStyleWidth(), layout_node->GetStyleHeight());
+  }
+}
+
+static void CalculateLane(ParallelLayoutBatch& batch, size_t lane) {
+  if (batch.claimed[lane].exchange(true)) {
+    return;
+  }
+  auto begin = std::min(lane * batch.chunk_size, batch.subtrees.size());
+  auto end = std::min(begin + batch.chunk_size, batch.subtrees.size());
+  CalculateSubtrees(batch.subtrees, begin, end);
+  std::lock_guard<std::mutex> lock(batch.mutex);
+  ++batch.finished_count;
+  batch.cv.notify_one();
+}
+
+ParallelLayout::ParallelLayout(uint32_t parallelism) {
+  // dom 线程自身也承担一份任务, 其余由独占的 worker 计算, 不与 dom runner 或其他业务共用线程
+  if (parallelism < 2) {
+    return;
+  }
+  worker_manager_ = std::make_shared<WorkerManager>(parallelism - 1);
+  for (uint32_t i = 1; i < parallelism; ++i) {
+    runners_.push_back(worker_manager_->CreateTaskRunner(kParallelLayoutRunnerName + std::to_string(i)));
+  }
+}
+
+ParallelLayout::~ParallelLayout() {
+  if (worker_manager_ != nullptr) {
+    worker_manager_->Terminate();
+  }
+}
+
+bool ParallelLayout::IsIndependentSubtree(const std::shared_ptr<DomNode>& node) {
+  if (!node->IsLayoutBoundary()) {
+    return false;
+  }
+  const auto& style = node->GetStyleMap();
+  for (const auto& name : kParentDependentStyles) {
+    if (style->find(name) != style->end()) {
+      return false;
+    }
+  }
+  // measure function 调用平台的文本测量 (JNI 等), 只能在 dom 线程执行
+  return !HasMeasureNode(node);
+}
+
+void ParallelLayout::CollectIndependentSubtrees(const std::shared_ptr<DomNode>& node,
+                                                std::vector<std::shared_ptr<DomNode>>& subtrees) {
+  const auto& children = node->GetChildren();
+  uint32_t boundary_count = 0;
+  for (const auto& child : children) {
+    if (child->HasLayoutDirty() && IsIndependentSubtree(child)) {
+      ++boundary_count;
+    }
+  }
+  for (const auto& child : children) {
+    if (!child->HasLayoutDirty()) {
+      continue;
+    }
+    // 至少两个脏的布局边界互为兄弟时才拆分, 否则继续向下寻找
+    if (boundary_count > 1 && IsIndependentSubtree(child)) {
+      subtrees.push_back(child);
+    } else {
+      CollectIndependentSubtrees(child, subtrees);
+    }
+  }
+}
+
+uint32_t ParallelLayout::CalculateIndependentSubtrees(const std::shared_ptr<DomNode>& root,
+                                                      const std::vector<std::shared_ptr<DomNode>>& boundaries) {
+  if (runners_.empty()) {
+    return 0;
+  }
+  std::vector<std::shared_ptr<DomNode>> subtrees;
+  CollectIndependentSubtrees(root, subtrees);
+  for (const auto& boundary : boundaries) {
+    // 祖先链全部为脏时边界已经在根节点的脏区域中, 避免同一子树被两个线程同时计算
+    auto parent = boundary->GetParent();
+    while (parent != nullptr && parent->HasLayoutDirty()) {
+      parent = parent->GetParent();
+    }
+    if (parent == nullptr) {
+      continue;
+    }
+    CollectIndependentSubtrees(boundary, subtrees);
+  }
+  if (subtrees.size() < kMinSubtreeCount) {
+    return 0;
+  }
+
+  auto batch = std::make_shared<ParallelLayoutBatch>();
+  auto lane_count = std::min(runners_.size() + 1, subtrees.size());
+  batch->chunk_size = (subtrees.size() + lane_count - 1) / lane_count;
+  batch->subtrees = std::move(subtrees);
+  batch->claimed = std::make_unique<std::atomic<bool>[]>(lane_count);
+  for (size_t lane = 0; lane < lane_count; ++lane) {
+    batch->claimed[lane] = false;
+  }
+  for (size_t lane = 1; lane < lane_count; ++lane) {
+    runners_[lane - 1]->PostTask([batch, lane] { CalculateLane(*batch, lane); });
+  }
+  // 先算自己的一份, 再接手还没有被 worker 开始的部分, worker 繁忙或已终止时退化为串行计算
+  for (size_t lane = 0; lane < lane_count; ++lane) {
+    CalculateLane(*batch, lane);
+  }
+  // 剩下的 lane 都已在 worker 上开始计算, 同一子树不能被两个线程同时计算, 必须等它们完成.
+  // 这些子树不含 measure 节点, 不会调用平台代码, 等待时间不超过串行计算它们的时间
+  std::unique_lock<std::mutex> lock(batch->mutex);
+  batch->cv.wait(lock, [&batch, lane_count] { return batch->finished_count == lane_count; });
+  return static_cast<uint32_t>(batch->subtrees.size());
+}
+
+}  // namespace dom
+}  // namespace hippy
@@ -0,0 +1,449 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dom/render_op_codec.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "dom/dom_node.h"
+#include "footstone/check.h"
+
+namespace hippy {
+inline namespace dom {
+
+using HippyValue = footstone::value::HippyValue;
+
+constexpr char kOpId[] = "id";
+constexpr char kOpPid[] = "pId";
+constexpr char kOpIndex[] = "index";
+constexpr char kOpName[] = "name";
+constexpr char kOpProps[] = "props";
+constexpr char kOpDeleteProps[] = "deleteProps";
+constexpr char kOpLeft[] = "left";
+constexpr char kOpTop[] = "top";
+constexpr char kOpWidth[] = "width";
+constexpr char kOpHeight[] = "height";
+constexpr char kOpPaddingLeft[] = "paddingLeft";
+constexpr char kOpPaddingTop[] = "paddingTop";
+constexpr char kOpPaddingRight[] = "paddingRight";
+constexpr char kOpPaddingBottom[] = "paddingBottom";
+
+// 头部中 node count 和 key count 的偏移，Finish 时回填
+constexpr size_t kNodeCountOffset = 8;
+constexpr size_t kKeyCountOffset = 12;
+constexpr size_t kInitialCapacity = 4096;
+constexpr size_t kMaxVarintLength = 10;
+
+static_assert(sizeof(float) == 4 && sizeof(double) == 8, "unexpected float size");
+
+void RenderOpEncoder::Begin(RenderOpType type) {
+  type_ = type;
+  size_ = 0;
+  node_count_ = 0;
+  key_count_ = 0;
+  keys_.clear();
+  WriteUint32(kMagic);
+  WriteUint8(kVersion);
+  WriteUint8(static_cast<uint8_t>(type));
+  WriteUint8(0);
+  WriteUint8(0);
+  WriteUint32(0);
+  WriteUint32(0);
+}
+
+std::pair<const uint8_t*, size_t> RenderOpEncoder::Finish() {
+  FOOTSTONE_DCHECK(size_ >= kHeaderSize);
+  memcpy(buffer_.data() + kNodeCountOffset, &node_count_, sizeof(node_count_));
+  memcpy(buffer_.data() + kKeyCountOffset, &key_count_, sizeof(key_count_));
+  return std::make_pair(buffer_.data(), size_);
+}
+
+void RenderOpEncoder::ReleaseMemory() {
+  std::vector<uint8_t>().swap(buffer_);
+  KeyTable().swap(keys_);
+  size_ = 0;
+}
+
+uint8_t* RenderOpEncoder::Reserve(size_t length) {
+  if (size_ + length > buffer_.size()) {
+    buffer_.resize(std::max(std::max(buffer_.size() * 2, kInitialCapacity), size_ + length));
+  }
+  auto data = buffer_.data() + size_;
+  size_ += length;
+  return data;
+}
+
+void RenderOpEncoder::WriteUint8(uint8_t value) {
+  *Reserve(1) = value;
+}
+
+void RenderOpEncoder::WriteUint32(uint32_t value) {
+  memcpy(Reserve(sizeof(value)), &value, sizeof(value));
+}
+
+void RenderOpEncoder::WriteFloat(float value) {
+  memcpy(Reserve(sizeof(value)), &value, sizeof(value));
+}
+
+void RenderOpEncoder::WriteVarint(uint64_t value) {
+  auto data = Reserve(kMaxVarintLength);
+  size_t length = 0;
+  while (value >= 0x80) {
+    data[length++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  data[length++] = static_cast<uint8_t>(value);
+  size_ -= kMaxVarintLength - length;
+}
+
+void RenderOpEncoder::WriteString(const std::string& value) {
+  WriteVarint(value.size());
+  if (!value.empty()) {
+    memcpy(Reserve(value.size()), value.data(), value.size());
+  }
+}
+
+void RenderOpEncoder::WriteKey(const std::string& name) {
+  auto [it, is_new] = keys_.try_emplace(name, key_count_);
+  WriteVarint(it->second);
+  if (is_new) {
+    ++key_count_;
+    WriteString(name);
+  }
+}
+
+void RenderOpEncoder::WriteValue(const HippyValue& value) {
+  switch (value.GetType()) {
+    case HippyValue::Type::kUndefined:
+      WriteUint8(static_cast<uint8_t>(RenderOpValueTag::kUndefined));
+      break;
+    case HippyValue::Type::kNull:
+      WriteUint8(static_cast<uint8_t>(RenderOpValueTag::kNull));
+      break;
+    case HippyValue::Type::kBoolean:
+      WriteUint8(static_cast<uint8_t>(value.ToBooleanChecked() ? RenderOpValueTag::kTrue : RenderOpValueTag::kFalse));
+      break;
+    case HippyValue::Type::kNumber: {
+      switch (value.GetNumberType()) {
+        case HippyValue::NumberType::kInt32: {
+          auto i32 = value.ToInt32Checked();
+          WriteUint8(static_cast<uint8_t>(RenderOpValueTag::kInt32));
+          WriteVarint((static_cast<uint32_t>(i32) << 1) ^ static_cast<uint32_t>(i32 >> 31));
+          break;
+        }
+        case HippyValue::NumberType::kUInt32:
+          WriteUint8(static_cast<uint8_t>(RenderOpValueTag::kUint32));
+          WriteVarint(value.ToUint32Checked());
+          break;
+        default: {
+          double d = value.GetNumberType() == HippyValue::NumberType::kDouble ? value.ToDoubleChecked()
+                                                                              : std::numeric_limits<double>::quiet_NaN();
+          WriteUint8(static_cast<uint8_t>(RenderOpValueTag::kDouble));
+          memcpy(Reserve(sizeof(d)), &d, sizeof(d));
+          break;
+        }
+      }
+      break;
+    }
+    case HippyValue::Type::kString:
+      WriteUint8(static_cast<uint8_t>(RenderOpValueTag::kString));
+      WriteString(value.ToStringChecked());
+      break;
+    case HippyValue::Type::kArray: {
+      const auto& array = value.ToArrayChecked();
+      WriteUint8(static_cast<uint8_t>(RenderOpValueTag::kArray));
+      WriteVarint(array.size());
+      for (const auto& item: array) {
+        WriteValue(item);
+      }
+      break;
+    }
+    case HippyValue::Type::kObject: {
+      const auto& object = value.ToObjectChecked();
+      WriteUint8(static_cast<uint8_t>(RenderOpValueTag::kObject));
+      WriteVarint(object.size());
+      for (const auto& [key, item]: object) {
+        WriteString(key);
+        WriteValue(item);
+      }
+      break;
+    }
+  }
+}
+
+void RenderOpEncoder::WriteProps(const std::shared_ptr<DomValueMap>& props, const StyleFilter& filter,
+                                 uint32_t& count) {
+  if (!props) {
+    return;
+  }
+  for (const auto& [key, value]: *props) {
+    if (!value || (filter && !filter(key))) {
+      continue;
+    }
+    WriteKey(key);
+    WriteValue(*value);
+    ++count;
+  }
+}
+
+void RenderOpEncoder::WriteNodeHeader(const std::shared_ptr<DomNode>& node) {
+  const auto& render_info = node->GetRenderInfo();
+  WriteUint32(render_info.id);
+  WriteUint32(render_info.pid);
+  WriteUint32(static_cast<uint32_t>(render_info.index));
+}
+
+void RenderOpEncoder::AddCreate(const std::shared_ptr<DomNode>& node, const StyleFilter& style_filter) {
+  FOOTSTONE_DCHECK(type_ == RenderOpType::kCreate);
+  WriteNodeHeader(node);
+  WriteKey(node->GetViewName());
+  auto count_offset = size_;
+  WriteUint32(0);
+  uint32_t count = 0;
+  WriteProps(node->GetStyleMap(), style_filter, count);
+  WriteProps(node->GetExtStyle(), nullptr, count);
+  memcpy(buffer_.data() + count_offset, &count, sizeof(count));
+  ++node_count_;
+}
+
+void RenderOpEncoder::AddUpdate(const std::shared_ptr<DomNode>& node) {
+  FOOTSTONE_DCHECK(type_ == RenderOpType::kUpdate);
+  WriteNodeHeader(node);
+  WriteKey(node->GetViewName());
+  auto count_offset = size_;
+  WriteUint32(0);
+  uint32_t count = 0;
+  WriteProps(node->GetDiffStyle(), nullptr, count);
+  memcpy(buffer_.data() + count_offset, &count, sizeof(count));
+  auto delete_props = node->GetDeleteProps();
+  if (delete_props) {
+    WriteVarint(delete_props->size());
+    for (const auto& name: *delete_props) {
+      WriteKey(name);
+    }
+  } else {
+    WriteVarint(0);
+  }
+  ++node_count_;
+}
+
+void RenderOpEncoder::AddMove(const std::shared_ptr<DomNode>& node) {
+  FOOTSTONE_DCHECK(type_ == RenderOpType::kMove);
+  WriteNodeHeader(node);
+  ++node_count_;
+}
+
+void RenderOpEncoder::AddLayout(uint32_t id, const LayoutResult& result, bool with_padding, float scale) {
+  FOOTSTONE_DCHECK(type_ == RenderOpType::kLayout);
+  WriteUint32(id);
+  WriteUint8(with_padding ? kLayoutWithPadding : 0);
+  float frame[8] = {result.left * scale, result.top * scale, result.width * scale, result.height * scale,
+                    result.paddingLeft * scale, result.paddingTop * scale, result.paddingRight * scale,
+                    result.paddingBottom * scale};
+  auto length = (with_padding ? 8 : 4) * sizeof(float);
+  memcpy(Reserve(length), frame, length);
+  ++node_count_;
+}
+
+namespace {
+
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t length) : data_(data), end_(data + length) {}
+
+  bool ok() const { return ok_; }
+
+  template<typename T>
+  T Read() {
+    T value{};
+    if (static_cast<size_t>(end_ - data_) < sizeof(T)) {
+      ok_ = false;
+      return value;
+    }
+    memcpy(&value, data_, sizeof(T));
+    data_ += sizeof(T);
+    return value;
+  }
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+      if (data_ >= end_) {
+        break;
+      }
+      auto byte = *data_++;
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    ok_ = false;
+    return 0;
+  }
+
+  std::string ReadString() {
+    auto length = ReadVarint();
+    if (!ok_ || length > static_cast<uint64_t>(end_ - data_)) {
+      ok_ = false;
+      return {};
+    }
+    std::string value(reinterpret_cast<const char*>(data_), length);
+    data_ += length;
+    return value;
+  }
+
+  const std::string& ReadKey() {
+    auto index = ReadVarint();
+    if (ok_ && index == keys_.size()) {
+      keys_.push_back(ReadString());
+    } else if (index > keys_.size()) {
+      ok_ = false;
+    }
+    return ok_ ? keys_[index] : empty_;
+  }
+
+  HippyValue ReadValue(uint32_t depth) {
+    if (depth > kMaxDepth) {
+      ok_ = false;
+      return {};
+    }
+    switch (static_cast<RenderOpValueTag>(Read<uint8_t>())) {
+      case RenderOpValueTag::kUndefined:
+        return HippyValue::Undefined();
+      case RenderOpValueTag::kNull:
+        return HippyValue::Null();
+      case RenderOpValueTag::kFalse:
+        return HippyValue(false);
+      case RenderOpValueTag::kTrue:
+        return HippyValue(true);
+      case RenderOpValueTag::kInt32: {
+        auto zigzag = static_cast<uint32_t>(ReadVarint());
+        return HippyValue(static_cast<int32_t>((zigzag >> 1) ^ (~(zigzag & 1) + 1)));
+      }
+      case RenderOpValueTag::kUint32:
+        return HippyValue(static_cast<uint32_t>(ReadVarint()));
+      case RenderOpValueTag::kDouble:
+        return HippyValue(Read<double>());
+      case RenderOpValueTag::kString:
+        return HippyValue(ReadString());
+      case RenderOpValueTag::kArray: {
+        auto count = ReadVarint();
+        HippyValue::HippyValueArrayType array;
+        for (uint64_t i = 0; ok_ && i < count; ++i) {
+          array.push_back(ReadValue(depth + 1));
+        }
+        return HippyValue(std::move(array));
+      }
+      case RenderOpValueTag::kObject: {
+        auto count = ReadVarint();
+        HippyValue::HippyValueObjectType object;
+        for (uint64_t i = 0; ok_ && i < count; ++i) {
+          auto key = ReadString();
+          object[key] = ReadValue(depth + 1);
+        }
+        return HippyValue(std::move(object));
+      }
+      default:
+        ok_ = false;
+        return {};
+    }
+  }
+
+  size_t GetKeyCount() const { return keys_.size(); }
+
+ private:
+  static constexpr uint32_t kMaxDepth = 64;
+
+  const uint8_t* data_;
+  const uint8_t* end_;
+  bool ok_ = true;
+  std::vector<std::string> keys_;
+  std::string empty_;
+};
+
+}  // namespace
+
+bool RenderOpDecoder::Decode(const uint8_t* data, size_t length, RenderOpType& type, HippyValue& nodes) {
+  Reader reader(data, length);
+  auto magic = reader.Read<uint32_t>();
+  auto version = reader.Read<uint8_t>();
+  auto op = reader.Read<uint8_t>();
+  reader.Read<uint16_t>();
+  auto node_count = reader.Read<uint32_t>();
+  auto key_count = reader.Read<uint32_t>();
+  if (!reader.ok() || magic != RenderOpEncoder::kMagic || version != RenderOpEncoder::kVersion
+      || op < static_cast<uint8_t>(RenderOpType::kCreate) || op > static_cast<uint8_t>(RenderOpType::kLayout)) {
+    return false;
+  }
+  type = static_cast<RenderOpType>(op);
+
+  HippyValue::HippyValueArrayType array;
+  for (uint32_t i = 0; reader.ok() && i < node_count; ++i) {
+    HippyValue::HippyValueObjectType node;
+    if (type == RenderOpType::kLayout) {
+      node[kOpId] = HippyValue(reader.Read<uint32_t>());
+      auto flags = reader.Read<uint8_t>();
+      node[kOpLeft] = HippyValue(reader.Read<float>());
+      node[kOpTop] = HippyValue(reader.Read<float>());
+      node[kOpWidth] = HippyValue(reader.Read<float>());
+      node[kOpHeight] = HippyValue(reader.Read<float>());
+      if (flags & RenderOpEncoder::kLayoutWithPadding) {
+        node[kOpPaddingLeft] = HippyValue(reader.Read<float>());
+        node[kOpPaddingTop] = HippyValue(reader.Read<float>());
+        node[kOpPaddingRight] = HippyValue(reader.Read<float>());
+        node[kOpPaddingBottom] = HippyValue(reader.Read<float>());
+      }
+      array.push_back(HippyValue(std::move(node)));
+      continue;
+    }
+    node[kOpId] = HippyValue(reader.Read<uint32_t>());
+    node[kOpPid] = HippyValue(reader.Read<uint32_t>());
+    node[kOpIndex] = HippyValue(reader.Read<int32_t>());
+    if (type != RenderOpType::kMove) {
+      node[kOpName] = HippyValue(reader.ReadKey());
+      auto prop_count = reader.Read<uint32_t>();
+      HippyValue::HippyValueObjectType props;
+      for (uint32_t j = 0; reader.ok() && j < prop_count; ++j) {
+        const auto& key = reader.ReadKey();
+        props[key] = reader.ReadValue(0);
+      }
+      node[kOpProps] = HippyValue(std::move(props));
+    }
+    if (type == RenderOpType::kUpdate) {
+      auto delete_count = reader.ReadVarint();
+      HippyValue::HippyValueArrayType delete_props;
+      for (uint64_t j = 0; reader.ok() && j < delete_count; ++j) {
+        delete_props.push_back(HippyValue(reader.ReadKey()));
+      }
+      node[kOpDeleteProps] = HippyValue(std::move(delete_props));
+    }
+    array.push_back(HippyValue(std::move(node)));
+  }
+  if (!reader.ok() || reader.GetKeyCount() != key_count) {
+    return false;
+  }
+  nodes = HippyValue(std::move(array));
+  return true;
+}
+
+}  // namespace dom
+}  // namespace hippy
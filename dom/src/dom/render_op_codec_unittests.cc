@@ -0,0 +1,230 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dom/dom_node.h"
+#include "dom/render_op_codec.h"
+#include "footstone/serializer.h"
+
+namespace hippy {
+inline namespace dom {
+inline namespace testing {
+
+using HippyValue = footstone::value::HippyValue;
+using DomValueMapType = std::unordered_map<std::string, std::shared_ptr<HippyValue>>;
+
+// 典型首屏：View/Text/Image 混合，每个节点带几项颜色、尺寸、字符串和嵌套的 transform
+std::vector<std::shared_ptr<DomNode>> MakeFirstScreen(uint32_t count) {
+  const char* kViewNames[] = {"View", "Text", "Image", "View", "ListViewItem"};
+  std::vector<std::shared_ptr<DomNode>> nodes;
+  for (uint32_t i = 0; i < count; ++i) {
+    auto style = std::make_shared<DomValueMapType>();
+    (*style)["width"] = std::make_shared<HippyValue>(static_cast<double>(100 + i % 7));
+    (*style)["height"] = std::make_shared<HippyValue>(44.5);
+    (*style)["backgroundColor"] = std::make_shared<HippyValue>(static_cast<uint32_t>(0xff000000 + i));
+    (*style)["opacity"] = std::make_shared<HippyValue>(0.8);
+    (*style)["borderRadius"] = std::make_shared<HippyValue>(4);
+    (*style)["color"] = std::make_shared<HippyValue>(static_cast<uint32_t>(0xff333333));
+    (*style)["fontSize"] = std::make_shared<HippyValue>(14);
+    if (i % 4 == 0) {
+      HippyValue::HippyValueObjectType translate;
+      translate["translateX"] = HippyValue(i % 2 ? -3 : 5);
+      HippyValue::HippyValueArrayType transform{HippyValue(std::move(translate))};
+      (*style)["transform"] = std::make_shared<HippyValue>(std::move(transform));
+    }
+    auto ext = std::make_shared<DomValueMapType>();
+    (*ext)["text"] = std::make_shared<HippyValue>("item label " + std::to_string(i));
+    (*ext)["accessible"] = std::make_shared<HippyValue>(true);
+    auto node = std::make_shared<DomNode>(i + 10, i / 10 + 1, static_cast<int32_t>(i % 10), "div",
+                                          kViewNames[i % 5], style, ext, std::weak_ptr<RootNode>());
+    node->SetRenderInfo({i + 10, i / 10 + 1, static_cast<int32_t>(i % 10), 0});
+    nodes.push_back(node);
+  }
+  return nodes;
+}
+
+bool SkipLayoutStyle(const std::string& name) {
+  return name != "width" && name != "height";
+}
+
+// NativeRenderManager 原来的做法：逐节点拼 HippyValue 再整体序列化
+HippyValue BuildLegacyCreate(const std::vector<std::shared_ptr<DomNode>>& nodes) {
+  HippyValue::HippyValueArrayType dom_node_array;
+  dom_node_array.resize(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const auto& render_info = nodes[i]->GetRenderInfo();
+    HippyValue::HippyValueObjectType dom_node;
+    dom_node["id"] = HippyValue(render_info.id);
+    dom_node["pId"] = HippyValue(render_info.pid);
+    dom_node["index"] = HippyValue(render_info.index);
+    dom_node["name"] = HippyValue(nodes[i]->GetViewName());
+    HippyValue::HippyValueObjectType props;
+    for (const auto& [key, value]: *nodes[i]->GetStyleMap()) {
+      if (SkipLayoutStyle(key)) {
+        props[key] = *value;
+      }
+    }
+    for (const auto& [key, value]: *nodes[i]->GetExtStyle()) {
+      props[key] = *value;
+    }
+    dom_node["props"] = HippyValue(std::move(props));
+    dom_node_array[i] = HippyValue(std::move(dom_node));
+  }
+  return HippyValue(std::move(dom_node_array));
+}
+
+TEST(RenderOpCodecTest, CreateRoundTrip) {
+  auto nodes = MakeFirstScreen(50);
+  RenderOpEncoder encoder;
+  encoder.Begin(RenderOpType::kCreate);
+  for (const auto& node: nodes) {
+    encoder.AddCreate(node, SkipLayoutStyle);
+  }
+  auto [data, length] = encoder.Finish();
+
+  RenderOpType type;
+  HippyValue decoded;
+  ASSERT_TRUE(RenderOpDecoder::Decode(data, length, type, decoded));
+  EXPECT_EQ(type, RenderOpType::kCreate);
+  EXPECT_EQ(decoded, BuildLegacyCreate(nodes));
+
+  // 截断或损坏的数据不能解出结果
+  for (size_t cut: {size_t{0}, size_t{3}, RenderOpEncoder::kHeaderSize, length / 2, length - 1}) {
+    EXPECT_FALSE(RenderOpDecoder::Decode(data, cut, type, decoded)) << cut;
+  }
+  std::vector<uint8_t> corrupted(data, data + length);
+  corrupted[0] ^= 0xFF;
+  EXPECT_FALSE(RenderOpDecoder::Decode(corrupted.data(), corrupted.size(), type, decoded));
+}
+
+TEST(RenderOpCodecTest, KeysAreSentOncePerBatch) {
+  auto nodes = MakeFirstScreen(2);
+  RenderOpEncoder encoder;
+  encoder.Begin(RenderOpType::kCreate);
+  encoder.AddCreate(nodes[0]);
+  auto first = encoder.Finish().second;
+  encoder.AddCreate(nodes[0]);
+  auto second = encoder.Finish().second - first;
+  EXPECT_LT(second, first - RenderOpEncoder::kHeaderSize);
+
+  // 新批次重新发送 key，解码器不依赖上一批次的状态
+  encoder.Begin(RenderOpType::kCreate);
+  encoder.AddCreate(nodes[0]);
+  auto [data, length] = encoder.Finish();
+  EXPECT_EQ(length, first);
+  RenderOpType type;
+  HippyValue decoded;
+  ASSERT_TRUE(RenderOpDecoder::Decode(data, length, type, decoded));
+
+  // 释放内存后 key 表也一并清空，下一批次仍然完整
+  encoder.ReleaseMemory();
+  EXPECT_EQ(encoder.GetCapacity(), 0);
+  encoder.Begin(RenderOpType::kCreate);
+  encoder.AddCreate(nodes[0]);
+  std::tie(data, length) = encoder.Finish();
+  EXPECT_EQ(length, first);
+  ASSERT_TRUE(RenderOpDecoder::Decode(data, length, type, decoded));
+}
+
+TEST(RenderOpCodecTest, UpdateMoveAndLayoutRoundTrip) {
+  auto nodes = MakeFirstScreen(3);
+  auto diff = std::make_shared<DomValueMapType>();
+  (*diff)["opacity"] = std::make_shared<HippyValue>(0.5);
+  (*diff)["text"] = std::make_shared<HippyValue>("changed");
+  nodes[1]->SetDiffStyle(diff);
+  nodes[1]->SetDeleteProps(std::make_shared<std::vector<std::string>>(std::vector<std::string>{"color", "text"}));
+
+  RenderOpEncoder encoder;
+  encoder.Begin(RenderOpType::kUpdate);
+  encoder.AddUpdate(nodes[0]);
+  encoder.AddUpdate(nodes[1]);
+  auto [data, length] = encoder.Finish();
+  RenderOpType type;
+  HippyValue decoded;
+  ASSERT_TRUE(RenderOpDecoder::Decode(data, length, type, decoded));
+  EXPECT_EQ(type, RenderOpType::kUpdate);
+  const auto& updates = decoded.ToArrayChecked();
+  ASSERT_EQ(updates.size(), 2);
+  EXPECT_TRUE(updates[0].ToObjectChecked().at("props").ToObjectChecked().empty());
+  EXPECT_TRUE(updates[0].ToObjectChecked().at("deleteProps").ToArrayChecked().empty());
+  HippyValue::HippyValueObjectType expected_props{{"opacity", HippyValue(0.5)}, {"text", HippyValue("changed")}};
+  EXPECT_EQ(updates[1].ToObjectChecked().at("props"), HippyValue(expected_props));
+  EXPECT_EQ(updates[1].ToObjectChecked().at("deleteProps"),
+            HippyValue(HippyValue::HippyValueArrayType{HippyValue("color"), HippyValue("text")}));
+  EXPECT_EQ(updates[1].ToObjectChecked().at("name"), HippyValue("Text"));
+
+  encoder.Begin(RenderOpType::kMove);
+  encoder.AddMove(nodes[2]);
+  std::tie(data, length) = encoder.Finish();
+  ASSERT_TRUE(RenderOpDecoder::Decode(data, length, type, decoded));
+  EXPECT_EQ(type, RenderOpType::kMove);
+  HippyValue::HippyValueObjectType expected_move{
+      {"id", HippyValue(12u)}, {"pId", HippyValue(1u)}, {"index", HippyValue(2)}};
+  EXPECT_EQ(decoded, HippyValue(HippyValue::HippyValueArrayType{HippyValue(expected_move)}));
+
+  LayoutResult layout;
+  layout.left = 1;
+  layout.top = 2.5f;
+  layout.width = 100;
+  layout.height = 20;
+  layout.paddingLeft = 3;
+  encoder.Begin(RenderOpType::kLayout);
+  encoder.AddLayout(10, layout, false, 2);
+  encoder.AddLayout(11, layout, true, 2);
+  std::tie(data, length) = encoder.Finish();
+  EXPECT_EQ(length, RenderOpEncoder::kHeaderSize + 2 * (4 + 1 + 16) + 16);
+  ASSERT_TRUE(RenderOpDecoder::Decode(data, length, type, decoded));
+  const auto& frames = decoded.ToArrayChecked();
+  ASSERT_EQ(frames.size(), 2);
+  const auto& frame = frames[1].ToObjectChecked();
+  EXPECT_EQ(frame.at("id"), HippyValue(11u));
+  EXPECT_EQ(frame.at("top"), HippyValue(5.0f));
+  EXPECT_EQ(frame.at("width"), HippyValue(200.0f));
+  EXPECT_EQ(frame.at("paddingLeft"), HippyValue(6.0f));
+  EXPECT_EQ(frames[0].ToObjectChecked().count("paddingLeft"), 0);
+}
+
+TEST(RenderOpCodecTest, SmallerThanSerializedHippyValue) {
+  for (uint32_t count: {100u, 1000u}) {
+    auto nodes = MakeFirstScreen(count);
+    footstone::value::Serializer serializer;
+    serializer.WriteHeader();
+    serializer.WriteValue(BuildLegacyCreate(nodes));
+    auto buffer = serializer.Release();
+    auto legacy_bytes = buffer.second;
+    footstone::value::SerializerHelper::DestroyBuffer(buffer);
+
+    RenderOpEncoder encoder;
+    encoder.Begin(RenderOpType::kCreate);
+    for (const auto& node: nodes) {
+      encoder.AddCreate(node, SkipLayoutStyle);
+    }
+    EXPECT_LT(encoder.Finish().second, legacy_bytes) << count;
+  }
+}
+
+}  // namespace testing
+}  // namespace dom
+}  // namespace hippy
@@ -21,6 +21,7 @@
 #include "dom/root_node.h"
 
 #include <stack>
+#include <unordered_set>
 
 #include "dom/animation/animation_manager.h"
 #include "dom/render_manager.h"
@@ -78,29 +79,25 @@ bool DomNodeStyleDiffer::Calculate(const std::shared_ptr<hippy::dom::RootNode>&
   uint32_t dom_id = dom_node->GetId();
 
   // 保存 batch 最早的 style 和 ext_style, 该批次中的所有的 diff 都由这个 style 比较产生
-  if (node_style_map_.find(dom_id) == node_style_map_.end()) {
-    std::unordered_map<std::string, std::shared_ptr<HippyValue>> style;
-    std::unordered_map<std::string, std::shared_ptr<HippyValue>> ext_style;
-    auto dom_style = dom_node->GetStyleMap();
-    for (const auto& pair : *dom_style) {
-      style[pair.first] = std::make_shared<HippyValue>(*pair.second);
-    }
-    node_style_map_.insert({dom_id, style});
-    auto dom_ext_style = dom_node->GetExtStyle();
-    for (const auto& pair : *dom_ext_style) {
-      ext_style[pair.first] = std::make_shared<HippyValue>(*pair.second);
-    }
-    node_ext_style_map_.insert({dom_id, ext_style});
-  }
-
-  auto base_style = node_style_map_.at(dom_id);
-  auto base_ext_style = node_ext_style_map_.at(dom_id);
-  style_diff = DiffUtils::DiffProps(base_style, *dom_info->dom_node->GetStyleMap(), false);
-  ext_style_diff = DiffUtils::DiffProps(base_ext_style, *dom_info->dom_node->GetExtStyle(), false);
+  const auto& new_style = dom_info->dom_node->GetStyleMap();
+  const auto& new_ext_style = dom_info->dom_node->GetExtStyle();
+  auto [snapshot_it, inserted] = node_snapshot_map_.try_emplace(dom_id);
+  auto& snapshot = snapshot_it->second;
+  if (inserted) {
+    // 只共享 dom node 当前的 style map, 不做深拷贝
+    snapshot.style = dom_node->GetStyleMap();
+    snapshot.ext_style = dom_node->GetExtStyle();
+  }
+  static const DomValueMap kEmptyValueMap;
+  style_diff = DiffUtils::DiffProps(snapshot.style ? *snapshot.style : kEmptyValueMap,
+                                    new_style ? *new_style : kEmptyValueMap, false);
+  ext_style_diff = DiffUtils::DiffProps(snapshot.ext_style ? *snapshot.ext_style : kEmptyValueMap,
+                                        new_ext_style ? *new_ext_style : kEmptyValueMap, false);
   return true;
 }
 
-RootNode::RootNode(uint32_t id) : DomNode(id, 0, 0, "", "", nullptr, nullptr, {}) {
+RootNode::RootNode(uint32_t id)
+    : DomNode(id, 0, 0, "", "", nullptr, nullptr, {}), arena_(std::make_shared<DomArena>()) {
   SetRenderInfo({id, 0, 0});
   animation_manager_ = std::make_shared<AnimationManager>();
   interceptors_.push_back(animation_manager_);
@@ -111,13 +108,21 @@ RootNode::RootNode() : RootNode(0) {}
 
 void RootNode::AddEventListener(const std::string& name, uint64_t listener_id, bool use_capture,
                                 const EventCallback& cb) {
+  auto is_new_event = !HasEventListener(name);
   DomNode::AddEventListener(name, listener_id, use_capture, cb);
   AddEvent(GetId(), name);
+  if (is_new_event) {
+    OnEventListenerAdded(*this, name);
+  }
 }
 
 void RootNode::RemoveEventListener(const std::string& name, uint64_t listener_id) {
+  auto had_event = HasEventListener(name);
   DomNode::RemoveEventListener(name, listener_id);
   RemoveEvent(GetId(), name);
+  if (had_event && !HasEventListener(name)) {
+    OnEventListenerRemoved(*this, name);
+  }
 }
 
 void RootNode::ReleaseResources() {}
@@ -137,8 +142,7 @@ void RootNode::CreateDomNodes(std::vector<std::shared_ptr<DomInfo>>&& nodes, boo
     // 解析布局属性
     node->ParseLayoutStyleInfo();
     parent_node->AddChildByRefInfo(node_info);
-    auto event = std::make_shared<DomEvent>(kDomCreated, node, nullptr);
-    node->HandleEvent(event);
+    HandleDomEvent(node, kDomCreated);
     OnDomNodeCreated(node);
   }
   for (const auto& node : nodes_to_create) {
@@ -169,8 +173,7 @@ void RootNode::CreateDomNodes(std::vector<std::shared_ptr<DomInfo>>&& nodes, boo
     });
   }
 
-  auto event = std::make_shared<DomEvent>(kDomTreeCreated, weak_from_this(), nullptr);
-  HandleEvent(event);
+  HandleDomEvent(shared_from_this(), kDomTreeCreated);
 
   if (!nodes_to_create.empty()) {
     dom_operations_.push_back({DomOperation::Op::kOpCreate, nodes_to_create});
@@ -182,9 +185,18 @@ void RootNode::UpdateDomNodes(std::vector<std::shared_ptr<DomInfo>>&& nodes) {
     interceptor->OnDomNodeUpdate(nodes);
   }
 
-  std::vector<std::shared_ptr<DomNode>> nodes_to_update;
+  // 更新不会增删节点, 可以一次查出全部节点
+  std::vector<uint32_t> ids;
+  ids.reserve(nodes.size());
   for (const auto& node : nodes) {
-    std::shared_ptr<DomNode> dom_node = GetNode(node->dom_node->GetId());
+    ids.push_back(node->dom_node->GetId());
+  }
+  std::vector<std::shared_ptr<DomNode>> dom_nodes;
+  GetNodes(ids, dom_nodes);
+  std::vector<std::shared_ptr<DomNode>> nodes_to_update;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const auto& node = nodes[i];
+    const auto& dom_node = dom_nodes[i];
     if (dom_node == nullptr) {
       continue;
     }
@@ -222,17 +234,19 @@ void RootNode::UpdateDomNodes(std::vector<std::shared_ptr<DomInfo>>&& nodes) {
     if (!style_update->empty() || !style_delete->empty()) {
       dom_node->UpdateLayoutStyleInfo(*style_update, *style_delete);
     }
+    // 文本等内容在 ext 中, 只有 ext 变化时测量节点也要重新测量
+    if ((!ext_update->empty() || !ext_delete->empty()) && dom_node->GetLayoutNode()->HasMeasureFunction()) {
+      dom_node->MarkLayoutNodeDirty();
+    }
 
     if (delete_value->size() != 0 || diff_value->size() != 0) {
       nodes_to_update.push_back(dom_node);
     }
 
-    auto event = std::make_shared<DomEvent>(kDomUpdated, dom_node, nullptr);
-    dom_node->HandleEvent(event);
+    HandleDomEvent(dom_node, kDomUpdated);
   }
 
-  auto event = std::make_shared<DomEvent>(kDomTreeUpdated, weak_from_this(), nullptr);
-  HandleEvent(event);
+  HandleDomEvent(shared_from_this(), kDomTreeUpdated);
 
   if (!nodes_to_update.empty()) {
     dom_operations_.push_back({DomOperation::Op::kOpUpdate, nodes_to_update});
@@ -254,7 +268,7 @@ void RootNode::MoveDomNodes(std::vector<std::shared_ptr<DomInfo>>&& nodes) {
       continue;
     }
     nodes_to_move.push_back(node);
-    parent_node->AddChildByRefInfo(std::make_shared<DomInfo>(node, node_info->ref_info, nullptr));
+    parent_node->AddChildByRefInfo(arena_->MakeShared<DomInfo>(node, node_info->ref_info, nullptr));
   }
   for (const auto& node : nodes_to_move) {
     node->SetRenderInfo({node->GetId(), node->GetPid(), node->GetSelfIndex()});
@@ -279,13 +293,11 @@ void RootNode::DeleteDomNodes(std::vector<std::shared_ptr<DomInfo>>&& nodes) {
     if (parent_node != nullptr) {
       parent_node->RemoveChildAt(parent_node->IndexOf(node));
     }
-    auto event = std::make_shared<DomEvent>(kDomDeleted, node, nullptr);
-    node->HandleEvent(event);
+    HandleDomEvent(node, kDomDeleted);
     OnDomNodeDeleted(node);
   }
 
-  auto event = std::make_shared<DomEvent>(kDomTreeDeleted, weak_from_this(), nullptr);
-  HandleEvent(event);
+  HandleDomEvent(shared_from_this(), kDomTreeDeleted);
 
   if (!nodes_to_delete.empty()) {
     dom_operations_.push_back({DomOperation::Op::kOpDelete, nodes_to_delete});
@@ -302,11 +314,9 @@ void RootNode::UpdateAnimation(std::vector<std::shared_ptr<DomNode>>&& nodes) {
     node->MarkWillChange(true);
     nodes_to_update.push_back(node);
     node->ParseLayoutStyleInfo();
-    auto event = std::make_shared<DomEvent>(kDomUpdated, node, nullptr);
-    node->HandleEvent(event);
+    HandleDomEvent(node, kDomUpdated);
   }
-  auto event = std::make_shared<DomEvent>(kDomTreeUpdated, weak_from_this(), nullptr);
-  HandleEvent(event);
+  HandleDomEvent(shared_from_this(), kDomTreeUpdated);
   if (!nodes_to_update.empty()) {
     dom_operations_.push_back({DomOperation::Op::kOpUpdate, nodes_to_update});
   }
@@ -355,26 +365,28 @@ void RootNode::HandleEvent(const std::shared_ptr<DomEvent>& event) {
   if (!target) {
     return;
   }
-  auto event_name = event->GetType();
-  std::stack<std::shared_ptr<DomNode>> capture_list = {};
+  const auto& event_name = event->GetType();
+  // 整棵树都没有监听者时无需遍历路径, 尚未挂到树上的 target 只检查其自身
+  if (!HasEventListenerInTree(event_name) && !target->HasEventListener(event_name)) {
+    return;
+  }
   // 执行捕获流程，注：target节点event.StopPropagation并不会阻止捕获流程
+  // 只收集监听了该事件的祖先节点, 从 target 的父节点到根节点排列, 逆序即为捕获顺序, 正序即为冒泡顺序
+  std::vector<std::shared_ptr<DomNode>> path;
   if (event->CanCapture()) {
-    // 获取捕获列表
     auto parent = target->GetParent();
     while (parent) {
-      capture_list.push(parent);
+      if (parent->HasEventListener(event_name)) {
+        path.push_back(parent);
+      }
       parent = parent->GetParent();
     }
   }
-  auto capture_target_listeners = target->GetEventListener(event_name, true);
-  auto bubble_target_listeners = target->GetEventListener(event_name, false);
-  // 捕获列表反过来就是冒泡列表，不需要额外遍历生成
   // 执行捕获流程
-  std::stack<std::shared_ptr<DomNode>> bubble_list = {};
-  while (!capture_list.empty()) {
-    auto capture_node = capture_list.top();
-    capture_list.pop();
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    const auto& capture_node = *it;
     event->SetCurrentTarget(capture_node);  // 设置当前节点，cb里会用到
+    // 回调中可能增删监听者, 这里遍历副本
     auto listeners = capture_node->GetEventListener(event_name, true);
     for (const auto& listener : listeners) {
       event->SetEventPhase(EventPhase::kCapturePhase);
@@ -383,10 +395,10 @@ void RootNode::HandleEvent(const std::shared_ptr<DomEvent>& event) {
     if (event->IsPreventCapture()) {  // cb 内部调用了 event.StopPropagation 会阻止捕获
       return;  // 捕获流中StopPropagation不仅会导致捕获流程结束，后面的目标事件和冒泡都会终止
     }
-    bubble_list.push(std::move(capture_node));
   }
   // 执行本身节点回调
   event->SetCurrentTarget(event->GetTarget());
+  auto capture_target_listeners = target->GetEventListener(event_name, true);
   for (const auto& listener : capture_target_listeners) {
     event->SetEventPhase(EventPhase::kAtTarget);
     listener->cb(event);
@@ -394,6 +406,7 @@ void RootNode::HandleEvent(const std::shared_ptr<DomEvent>& event) {
   if (event->IsPreventCapture()) {
     return;
   }
+  auto bubble_target_listeners = target->GetEventListener(event_name, false);
   for (const auto& listener : bubble_target_listeners) {
     event->SetEventPhase(EventPhase::kAtTarget);
     listener->cb(event);
@@ -402,9 +415,7 @@ void RootNode::HandleEvent(const std::shared_ptr<DomEvent>& event) {
     return;
   }
   // 执行冒泡流程
-  while (!bubble_list.empty()) {
-    auto bubble_node = bubble_list.top();
-    bubble_list.pop();
+  for (const auto& bubble_node : path) {
     event->SetCurrentTarget(bubble_node);
     auto listeners = bubble_node->GetEventListener(event_name, false);
     for (const auto& listener : listeners) {
@@ -417,6 +428,17 @@ void RootNode::HandleEvent(const std::shared_ptr<DomEvent>& event) {
   }
 }
 
+bool RootNode::HasEventListenerInTree(const std::string& name) const {
+  return event_listener_count_.find(name) != event_listener_count_.end();
+}
+
+void RootNode::HandleDomEvent(const std::shared_ptr<DomNode>& node, const std::string& name) {
+  if (!HasEventListenerInTree(name) && !node->HasEventListener(name)) {
+    return;
+  }
+  HandleEvent(arena_->MakeShared<DomEvent>(name, node, nullptr));
+}
+
 void RootNode::UpdateRenderNode(const std::shared_ptr<DomNode>& node) {
   auto dom_manager = dom_manager_.lock();
   if (!dom_manager) {
@@ -439,21 +461,32 @@ void RootNode::UpdateRenderNode(const std::shared_ptr<DomNode>& node) {
   SyncWithRenderManager(render_manager);
 }
 
-uint32_t RootNode::GetChildCount() {
-  uint32_t child_count = 0;
-  Traverse([&child_count](const std::shared_ptr<DomNode>&) { child_count++; });
-  return child_count;
+void RootNode::OnDomNodeLayoutOnlyChanged(const std::shared_ptr<DomNode>& node) {
+  if (!node || !nodes_.Contains(node->GetId())) {
+    return;
+  }
+  if (node->IsLayoutOnly()) {
+    ++node_statistics_.layout_only_count;
+  } else {
+    FOOTSTONE_DCHECK(node_statistics_.layout_only_count > 0);
+    --node_statistics_.layout_only_count;
+  }
 }
 
 std::shared_ptr<DomNode> RootNode::GetNode(uint32_t id) {
   if (id == GetId()) {
     return shared_from_this();
   }
-  auto found = nodes_.find(id);
-  if (found == nodes_.end()) {
-    return nullptr;
+  return nodes_.Find(id);
+}
+
+void RootNode::GetNodes(const std::vector<uint32_t>& ids, std::vector<std::shared_ptr<DomNode>>& nodes) {
+  nodes_.Find(ids, nodes);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (ids[i] == GetId()) {
+      nodes[i] = shared_from_this();
+    }
   }
-  return found->second.lock();
 }
 
 std::tuple<float, float> RootNode::GetRootSize() { return GetLayoutSize(); }
@@ -469,9 +502,45 @@ void RootNode::SetRootOrigin(float x, float y) { SetLayoutOrigin(x, y); }
 void RootNode::DoAndFlushLayout(const std::shared_ptr<RenderManager>& render_manager) {
   // Before Layout
   render_manager->BeforeLayout(GetWeakSelf());
-  // 触发布局计算
+  if (layout_restored_) {
+    // 快照恢复的首帧直接使用快照中的布局结果, 布局计算推迟到下一次
+    layout_restored_ = false;
+    parallel_layout_subtree_count_ = 0;
+    layout_visit_count_ = 0;
+    std::vector<std::shared_ptr<DomNode>> restored_nodes;
+    restored_nodes.reserve(nodes_.Size() + 1);
+    Traverse([&restored_nodes](const std::shared_ptr<DomNode>& node) { restored_nodes.push_back(node); });
+    render_manager->AfterLayout(GetWeakSelf());
+    render_manager->UpdateLayout(GetWeakSelf(), restored_nodes);
+    return;
+  }
+  // 触发布局计算, 布局引擎自身只重新计算脏节点, 这里只在脏区域内收集布局变化的节点:
+  // 先从根节点沿脏子树收集, 再从脏节点最近的布局边界开始收集
   std::vector<std::shared_ptr<DomNode>> layout_changed_nodes;
-  DoLayout(layout_changed_nodes);
+  parallel_layout_subtree_count_ = 0;
+  if (parallel_layout_ != nullptr) {
+    std::vector<std::shared_ptr<DomNode>> boundaries;
+    for (const auto& weak_boundary : layout_dirty_boundaries_) {
+      auto boundary = weak_boundary.lock();
+      if (boundary != nullptr && GetNode(boundary->GetId()) == boundary) {
+        boundaries.push_back(std::move(boundary));
+      }
+    }
+    parallel_layout_subtree_count_ = parallel_layout_->CalculateIndependentSubtrees(shared_from_this(), boundaries);
+  }
+  CalculateLayout();
+  layout_visit_count_ = 0;
+  TransferLayoutOutputsIncremental(layout_changed_nodes, layout_visit_count_);
+  auto boundaries = std::move(layout_dirty_boundaries_);
+  layout_dirty_boundaries_.clear();
+  for (const auto& weak_boundary : boundaries) {
+    auto boundary = weak_boundary.lock();
+    // 已在上面的收集中访问过或已被删除的边界直接跳过
+    if (boundary == nullptr || !boundary->HasLayoutDirty() || GetNode(boundary->GetId()) != boundary) {
+      continue;
+    }
+    boundary->TransferLayoutOutputsIncremental(layout_changed_nodes, layout_visit_count_);
+  }
   // After Layout
   render_manager->AfterLayout(GetWeakSelf());
 
@@ -480,7 +549,130 @@ void RootNode::DoAndFlushLayout(const std::shared_ptr<RenderManager>& render_man
   }
 }
 
+void RootNode::AddLayoutDirtyBoundary(const std::shared_ptr<DomNode>& node) {
+  layout_dirty_boundaries_.push_back(node);
+}
+
+bool RootNode::EnableParallelLayout(uint32_t parallelism) {
+  if (!IsConcurrentLayoutSupported() || parallelism < 2) {
+    FOOTSTONE_LOG(WARNING) << "parallel layout is not supported, parallelism = " << parallelism;
+    return false;
+  }
+  parallel_layout_ = std::make_unique<ParallelLayout>(parallelism);
+  return true;
+}
+
+void RootNode::DisableParallelLayout() { parallel_layout_ = nullptr; }
+
+void RootNode::CoalesceDomOperations() {
+  dom_operation_statistics_ = {};
+  dom_operation_statistics_.operation_count = static_cast<uint32_t>(dom_operations_.size());
+  std::unordered_set<const DomNode*> created;
+  std::unordered_set<const DomNode*> deleted;
+  // 节点最后一次 update/move 的位置 (操作下标, 节点下标), render manager 在 flush 时才读取节点的
+  // diff style 和 render info, 所以只有最后一次是有效的
+  using Position = std::pair<size_t, size_t>;
+  std::unordered_map<const DomNode*, Position> last_update;
+  std::unordered_map<const DomNode*, Position> last_move;
+  for (size_t i = 0; i < dom_operations_.size(); ++i) {
+    const auto& nodes = dom_operations_[i].nodes;
+    dom_operation_statistics_.node_count += static_cast<uint32_t>(nodes.size());
+    for (size_t j = 0; j < nodes.size(); ++j) {
+      const auto* node = nodes[j].get();
+      switch (dom_operations_[i].op) {
+        case DomOperation::Op::kOpCreate:
+          created.insert(node);
+          break;
+        case DomOperation::Op::kOpUpdate:
+          last_update[node] = {i, j};
+          break;
+        case DomOperation::Op::kOpDelete:
+          deleted.insert(node);
+          break;
+        case DomOperation::Op::kOpMove:
+          last_move[node] = {i, j};
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  // 同一 batch 中创建又删除的节点不需要发给 render manager. 删除时子树上的节点仍挂在被删节点下, 保守起见只有整棵
+  // 子树都是本 batch 创建的才丢弃, 否则仍由 render manager 随父节点一起删除
+  std::unordered_set<const DomNode*> discarded;
+  for (const auto* node : deleted) {
+    if (created.find(node) == created.end()) {
+      continue;
+    }
+    std::vector<const DomNode*> subtree;
+    std::stack<const DomNode*> stack;
+    stack.push(node);
+    bool all_created = true;
+    while (!stack.empty() && all_created) {
+      auto current = stack.top();
+      stack.pop();
+      all_created = created.find(current) != created.end();
+      subtree.push_back(current);
+      for (const auto& child : current->GetChildren()) {
+        stack.push(child.get());
+      }
+    }
+    if (all_created) {
+      discarded.insert(subtree.begin(), subtree.end());
+    }
+  }
+
+  std::vector<DomOperation> coalesced;
+  for (size_t i = 0; i < dom_operations_.size(); ++i) {
+    auto& dom_operation = dom_operations_[i];
+    std::vector<std::shared_ptr<DomNode>> nodes;
+    nodes.reserve(dom_operation.nodes.size());
+    for (size_t j = 0; j < dom_operation.nodes.size(); ++j) {
+      const auto* node = dom_operation.nodes[j].get();
+      if (discarded.find(node) != discarded.end()) {
+        continue;
+      }
+      Position position = {i, j};
+      bool keep = true;
+      switch (dom_operation.op) {
+        case DomOperation::Op::kOpUpdate:
+          // create 时 render manager 读取的是节点最新的完整 style, 本 batch 创建的节点无需再 update
+          keep = created.find(node) == created.end() && deleted.find(node) == deleted.end() &&
+              last_update[node] == position;
+          break;
+        case DomOperation::Op::kOpMove:
+          keep = deleted.find(node) == deleted.end() && last_move[node] == position;
+          break;
+        default:
+          break;
+      }
+      if (keep) {
+        nodes.push_back(std::move(dom_operation.nodes[j]));
+      }
+    }
+    if (nodes.empty()) {
+      continue;
+    }
+    dom_operation_statistics_.coalesced_node_count += static_cast<uint32_t>(nodes.size());
+    // 相邻的同类操作合并为一次 render manager 调用
+    if (!coalesced.empty() && coalesced.back().op == dom_operation.op) {
+      auto& last_nodes = coalesced.back().nodes;
+      last_nodes.insert(last_nodes.end(), std::make_move_iterator(nodes.begin()),
+                        std::make_move_iterator(nodes.end()));
+    } else {
+      coalesced.push_back({dom_operation.op, std::move(nodes)});
+    }
+  }
+  dom_operation_statistics_.coalesced_operation_count = static_cast<uint32_t>(coalesced.size());
+  dom_operations_ = std::move(coalesced);
+}
+
 void RootNode::FlushDomOperations(const std::shared_ptr<RenderManager>& render_manager) {
+  CoalesceDomOperations();
+  FOOTSTONE_DLOG(INFO) << "FlushDomOperations root id: " << GetId() << ", eliminated operations: "
+                       << dom_operation_statistics_.GetEliminatedOperationCount()
+                       << ", eliminated nodes: " << dom_operation_statistics_.GetEliminatedNodeCount();
   for (auto& dom_operation : dom_operations_) {
     MarkLayoutNodeDirty(dom_operation.nodes);
     switch (dom_operation.op) {
@@ -511,6 +703,7 @@ void RootNode::MarkLayoutNodeDirty(const std::vector<std::shared_ptr<DomNode>>&
         auto layout_node = parent->GetLayoutNode();
         if (layout_node->HasParentEngineNode() && layout_node->HasMeasureFunction()) {
           layout_node->MarkDirty();
+          parent->MarkLayoutDirty();
           break;
         }
         parent = parent->GetParent();
@@ -541,7 +734,20 @@ void RootNode::FlushEventOperations(const std::shared_ptr<RenderManager>& render
 }
 
 void RootNode::OnDomNodeCreated(const std::shared_ptr<DomNode>& node) {
-  nodes_.insert(std::make_pair(node->GetId(), node));
+  auto inserted = nodes_.Insert(node);
+  if (!inserted) {
+    return;
+  }
+  if (node->HasEventListeners()) {
+    for (const auto& name : node->GetEventListenerNames()) {
+      ++event_listener_count_[name];
+    }
+  }
+  ++node_statistics_.total_count;
+  ++node_statistics_.view_name_count[node->GetViewName()];
+  if (node->IsLayoutOnly()) {
+    ++node_statistics_.layout_only_count;
+  }
 }
 
 void RootNode::OnDomNodeDeleted(const std::shared_ptr<DomNode>& node) {
@@ -551,7 +757,50 @@ void RootNode::OnDomNodeDeleted(const std::shared_ptr<DomNode>& node) {
         OnDomNodeDeleted(child);
       }
     }
-    nodes_.erase(node->GetId());
+    if (!nodes_.Erase(node->GetId())) {
+      return;
+    }
+    if (node->HasEventListeners()) {
+      for (const auto& name : node->GetEventListenerNames()) {
+        OnEventListenerCountDecreased(name);
+      }
+    }
+    --node_statistics_.total_count;
+    auto it = node_statistics_.view_name_count.find(node->GetViewName());
+    if (it != node_statistics_.view_name_count.end() && --it->second == 0) {
+      node_statistics_.view_name_count.erase(it);
+    }
+    if (node->IsLayoutOnly()) {
+      --node_statistics_.layout_only_count;
+    }
+  }
+}
+
+bool RootNode::IsAttached(const DomNode& node) const {
+  if (&node == this) {
+    return true;
+  }
+  return nodes_.Contains(node);
+}
+
+void RootNode::OnEventListenerAdded(const DomNode& node, const std::string& name) {
+  // 未挂到树上的节点在 OnDomNodeCreated 时统一计数
+  if (IsAttached(node)) {
+    ++event_listener_count_[name];
+  }
+}
+
+void RootNode::OnEventListenerRemoved(const DomNode& node, const std::string& name) {
+  if (IsAttached(node)) {
+    OnEventListenerCountDecreased(name);
+  }
+}
+
+void RootNode::OnEventListenerCountDecreased(const std::string& name) {
+  auto it = event_listener_count_.find(name);
+  FOOTSTONE_DCHECK(it != event_listener_count_.end());
+  if (it != event_listener_count_.end() && --it->second == 0) {
+    event_listener_count_.erase(it);
   }
 }
 
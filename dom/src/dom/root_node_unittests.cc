@@ -0,0 +1,582 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+#include "dom/dom_event.h"
+#include "dom/dom_node.h"
+#include "dom/node_props.h"
+#include "dom/render_manager.h"
+#include "dom/root_node.h"
+
+namespace hippy {
+inline namespace dom {
+inline namespace testing {
+
+using DomValueMapType = std::unordered_map<std::string, std::shared_ptr<HippyValue>>;
+
+constexpr uint32_t kStyleRootId = 1;
+
+std::shared_ptr<DomValueMapType> MakeStyle(uint32_t property_count, double value) {
+  auto style = std::make_shared<DomValueMapType>();
+  for (uint32_t i = 0; i < property_count; ++i) {
+    (*style)["prop" + std::to_string(i)] = std::make_shared<HippyValue>(value + i);
+  }
+  return style;
+}
+
+std::shared_ptr<DomInfo> MakeUpdateInfo(const std::shared_ptr<RootNode>& root_node, uint32_t id,
+                                        const std::shared_ptr<DomValueMapType>& style) {
+  auto node = std::make_shared<DomNode>(id, kStyleRootId, 0, "div", "View", style,
+                                        std::make_shared<DomValueMapType>(), root_node);
+  return std::make_shared<DomInfo>(node, nullptr, nullptr);
+}
+
+std::shared_ptr<RootNode> MakeStyleRoot(uint32_t node_count, uint32_t property_count) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  std::vector<std::shared_ptr<DomInfo>> infos;
+  for (uint32_t i = 0; i < node_count; ++i) {
+    infos.push_back(MakeUpdateInfo(root_node, kStyleRootId + 1 + i, MakeStyle(property_count, 0)));
+  }
+  root_node->CreateDomNodes(std::move(infos), false);
+  return root_node;
+}
+
+class RecordingRenderManager : public RenderManager {
+ public:
+  enum class Op { kCreate, kUpdate, kMove, kDelete };
+  struct Record {
+    Op op;
+    std::vector<uint32_t> ids;
+  };
+
+  RecordingRenderManager() : RenderManager("RecordingRenderManager") {}
+
+  void CreateRenderNode(std::weak_ptr<RootNode> root_node, std::vector<std::shared_ptr<DomNode>>&& nodes) override {
+    Append(Op::kCreate, nodes);
+  }
+  void UpdateRenderNode(std::weak_ptr<RootNode> root_node, std::vector<std::shared_ptr<DomNode>>&& nodes) override {
+    Append(Op::kUpdate, nodes);
+  }
+  void MoveRenderNode(std::weak_ptr<RootNode> root_node, std::vector<std::shared_ptr<DomNode>>&& nodes) override {
+    Append(Op::kMove, nodes);
+  }
+  void DeleteRenderNode(std::weak_ptr<RootNode> root_node, std::vector<std::shared_ptr<DomNode>>&& nodes) override {
+    Append(Op::kDelete, nodes);
+  }
+  void UpdateLayout(std::weak_ptr<RootNode> root_node, const std::vector<std::shared_ptr<DomNode>>& nodes) override {
+    for (const auto& node : nodes) {
+      layout_ids.push_back(node->GetId());
+    }
+  }
+  void MoveRenderNode(std::weak_ptr<RootNode> root_node, std::vector<int32_t>&& moved_ids, int32_t from_pid,
+                      int32_t to_pid, int32_t index) override {}
+  void EndBatch(std::weak_ptr<RootNode> root_node) override {}
+  void BeforeLayout(std::weak_ptr<RootNode> root_node) override {}
+  void AfterLayout(std::weak_ptr<RootNode> root_node) override {}
+  void AddEventListener(std::weak_ptr<RootNode> root_node, std::weak_ptr<DomNode> dom_node,
+                        const std::string& name) override {}
+  void RemoveEventListener(std::weak_ptr<RootNode> root_node, std::weak_ptr<DomNode> dom_node,
+                           const std::string& name) override {}
+  void CallFunction(std::weak_ptr<RootNode> root_node, std::weak_ptr<DomNode> dom_node, const std::string& name,
+                    const DomArgument& param, uint32_t cb_id) override {}
+
+  std::vector<Record> records;
+  std::vector<uint32_t> layout_ids;
+
+ private:
+  void Append(Op op, const std::vector<std::shared_ptr<DomNode>>& nodes) {
+    Record record{op, {}};
+    for (const auto& node : nodes) {
+      record.ids.push_back(node->GetId());
+    }
+    records.push_back(std::move(record));
+  }
+};
+
+std::shared_ptr<DomInfo> MakeCreateInfo(const std::shared_ptr<RootNode>& root_node, uint32_t id, uint32_t pid) {
+  auto node = std::make_shared<DomNode>(id, pid, 0, "div", "View", std::make_shared<DomValueMapType>(),
+                                        std::make_shared<DomValueMapType>(), root_node);
+  return std::make_shared<DomInfo>(node, nullptr, nullptr);
+}
+
+std::shared_ptr<DomInfo> MakeSizedInfo(const std::shared_ptr<RootNode>& root_node, uint32_t id, uint32_t pid,
+                                       double width, double height) {
+  auto style = std::make_shared<DomValueMapType>();
+  (*style)[kWidth] = std::make_shared<HippyValue>(width);
+  (*style)[kHeight] = std::make_shared<HippyValue>(height);
+  auto node = std::make_shared<DomNode>(id, pid, 0, "div", "View", style, std::make_shared<DomValueMapType>(),
+                                        root_node);
+  return std::make_shared<DomInfo>(node, nullptr, nullptr);
+}
+
+// root -> list -> kCellCount cells with fixed size -> one text per cell, returns the render manager after first layout
+constexpr uint32_t kListId = 2;
+constexpr uint32_t kCellCount = 5000;
+constexpr uint32_t kCellHeight = 50;
+
+uint32_t CellId(uint32_t index) { return kListId + 1 + index * 2; }
+uint32_t TextId(uint32_t index) { return CellId(index) + 1; }
+
+std::shared_ptr<RecordingRenderManager> MakeListRoot(const std::shared_ptr<RootNode>& root_node) {
+  auto render_manager = std::make_shared<RecordingRenderManager>();
+  root_node->SetRootSize(1000, 1000);
+  std::vector<std::shared_ptr<DomInfo>> infos;
+  infos.push_back(MakeSizedInfo(root_node, kListId, kStyleRootId, 1000, 1000));
+  for (uint32_t i = 0; i < kCellCount; ++i) {
+    infos.push_back(MakeSizedInfo(root_node, CellId(i), kListId, 1000, kCellHeight));
+    infos.push_back(MakeSizedInfo(root_node, TextId(i), CellId(i), 1000, 20));
+  }
+  root_node->CreateDomNodes(std::move(infos), false);
+  root_node->SyncWithRenderManager(render_manager);
+  return render_manager;
+}
+
+std::shared_ptr<DomInfo> MakeMoveInfo(uint32_t id, uint32_t pid, uint32_t ref_id, int32_t relative_to_ref) {
+  auto node = std::make_shared<DomNode>(id, pid, 0, "", "", nullptr, nullptr, std::weak_ptr<RootNode>());
+  return std::make_shared<DomInfo>(node, std::make_shared<RefInfo>(ref_id, relative_to_ref), nullptr);
+}
+
+std::vector<std::shared_ptr<DomInfo>> Infos(std::initializer_list<std::shared_ptr<DomInfo>> infos) {
+  return std::vector<std::shared_ptr<DomInfo>>(infos);
+}
+
+TEST(DomNodeStyleDifferTest, DiffAgainstBatchBaseline) {
+  auto root_node = MakeStyleRoot(1, 0);
+  auto id = kStyleRootId + 1;
+  DomNodeStyleDiffer differ;
+  DiffValue style_diff, ext_diff;
+
+  auto first = std::make_shared<DomValueMapType>();
+  (*first)["width"] = std::make_shared<HippyValue>(10);
+  auto first_info = MakeUpdateInfo(root_node, id, first);
+  ASSERT_TRUE(differ.Calculate(root_node, first_info, style_diff, ext_diff));
+  EXPECT_EQ(std::get<0>(style_diff)->size(), 1);
+  root_node->GetNode(id)->SetStyleMap(first);
+
+  // the second update of the batch is diffed against the style before the batch, not against the first update
+  auto second = std::make_shared<DomValueMapType>();
+  (*second)["height"] = std::make_shared<HippyValue>(20);
+  ASSERT_TRUE(differ.Calculate(root_node, MakeUpdateInfo(root_node, id, second), style_diff, ext_diff));
+  EXPECT_EQ(std::get<0>(style_diff)->size(), 1);
+  EXPECT_TRUE(std::get<0>(style_diff)->count("height"));
+  EXPECT_TRUE(std::get<1>(style_diff)->empty());
+
+  differ.Reset();
+  ASSERT_TRUE(differ.Calculate(root_node, MakeUpdateInfo(root_node, id, second), style_diff, ext_diff));
+  EXPECT_EQ(std::get<1>(style_diff)->size(), 1);
+}
+
+TEST(DomNodeStyleDifferTest, SnapshotCopyOnWrite) {
+  auto root_node = MakeStyleRoot(1, 0);
+  auto id = kStyleRootId + 1;
+  auto node = root_node->GetNode(id);
+  auto style = std::make_shared<DomValueMapType>();
+  (*style)["width"] = std::make_shared<HippyValue>(10);
+  HippyValue::HippyValueObjectType transform = {{"scale", HippyValue(1)}};
+  (*style)["transform"] = std::make_shared<HippyValue>(transform);
+  node->SetStyleMap(style);
+
+  DomNodeStyleDiffer differ;
+  DiffValue style_diff, ext_diff;
+  // the new style shares the node style map, so the baseline is shared with the node as well
+  ASSERT_TRUE(differ.Calculate(root_node, MakeUpdateInfo(root_node, id, style), style_diff, ext_diff));
+  auto width = (*style)["width"];
+  auto transform_value = (*style)["transform"];
+
+  // modify in place like animations do, the snapshot must not observe it
+  node->EmplaceStyleMap("width", HippyValue(11));
+  node->EmplaceStyleMap("scale", HippyValue(2));
+  EXPECT_NE(node->GetStyleMap(), style);
+  EXPECT_EQ(*width, HippyValue(10));
+  EXPECT_EQ(transform_value->ToObjectChecked().at("scale"), HippyValue(1));
+
+  ASSERT_TRUE(differ.Calculate(root_node, MakeUpdateInfo(root_node, id, node->GetStyleMap()), style_diff, ext_diff));
+  EXPECT_EQ(std::get<0>(style_diff)->size(), 2);
+}
+
+TEST(DomNodeStatisticsTest, CountsFollowCreateDeleteAndLayoutOnly) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  auto text = std::make_shared<DomNode>(5, 3, 0, "p", "Text", std::make_shared<DomValueMapType>(),
+                                        std::make_shared<DomValueMapType>(), root_node);
+  root_node->CreateDomNodes(Infos({MakeCreateInfo(root_node, 2, kStyleRootId), MakeCreateInfo(root_node, 3, 2),
+                                   MakeCreateInfo(root_node, 4, 2), std::make_shared<DomInfo>(text, nullptr, nullptr)}),
+                            false);
+  const auto& statistics = root_node->GetNodeStatistics();
+  EXPECT_EQ(statistics.total_count, 4);
+  EXPECT_EQ(statistics.layout_only_count, 0);
+  EXPECT_EQ(statistics.view_name_count.at("View"), 3);
+  EXPECT_EQ(statistics.view_name_count.at("Text"), 1);
+
+  root_node->GetNode(3)->SetLayoutOnly(true);
+  root_node->GetNode(4)->SetLayoutOnly(true);
+  EXPECT_EQ(statistics.layout_only_count, 2);
+  EXPECT_EQ(statistics.GetRenderedCount(), 2);
+  root_node->GetNode(4)->SetLayoutOnly(false);
+  EXPECT_EQ(statistics.layout_only_count, 1);
+
+  // deleting node 3 removes its descendants as well
+  root_node->DeleteDomNodes(Infos({MakeCreateInfo(root_node, 3, 2)}));
+  EXPECT_EQ(statistics.total_count, 2);
+  EXPECT_EQ(statistics.layout_only_count, 0);
+  EXPECT_EQ(statistics.view_name_count.at("View"), 2);
+  EXPECT_EQ(statistics.view_name_count.count("Text"), 0);
+  EXPECT_EQ(statistics.GetRenderedCount(), 2);
+}
+
+TEST(DomOperationCoalesceTest, UpdateAfterCreate) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  auto render_manager = std::make_shared<RecordingRenderManager>();
+  root_node->CreateDomNodes(Infos({MakeCreateInfo(root_node, 2, kStyleRootId)}), false);
+  root_node->UpdateDomNodes(Infos({MakeUpdateInfo(root_node, 2, MakeStyle(1, 1))}));
+  root_node->UpdateDomNodes(Infos({MakeUpdateInfo(root_node, 2, MakeStyle(1, 2))}));
+  root_node->SyncWithRenderManager(render_manager);
+
+  ASSERT_EQ(render_manager->records.size(), 1);
+  EXPECT_EQ(render_manager->records[0].op, RecordingRenderManager::Op::kCreate);
+  const auto& statistics = root_node->GetDomOperationStatistics();
+  EXPECT_EQ(statistics.operation_count, 3);
+  EXPECT_EQ(statistics.GetEliminatedOperationCount(), 2);
+  EXPECT_EQ(statistics.GetEliminatedNodeCount(), 2);
+}
+
+TEST(DomOperationCoalesceTest, CreateThenDelete) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  auto render_manager = std::make_shared<RecordingRenderManager>();
+  root_node->CreateDomNodes(Infos({MakeCreateInfo(root_node, 2, kStyleRootId)}), false);
+  root_node->SyncWithRenderManager(render_manager);
+  render_manager->records.clear();
+
+  // node 3 and its child 4 are created and deleted in the same batch, they never reach the render manager
+  root_node->CreateDomNodes(Infos({MakeCreateInfo(root_node, 3, kStyleRootId), MakeCreateInfo(root_node, 4, 3)}),
+                            false);
+  root_node->UpdateDomNodes(Infos({MakeUpdateInfo(root_node, 2, MakeStyle(1, 1))}));
+  root_node->DeleteDomNodes(Infos({MakeCreateInfo(root_node, 3, kStyleRootId)}));
+  root_node->SyncWithRenderManager(render_manager);
+  ASSERT_EQ(render_manager->records.size(), 1);
+  EXPECT_EQ(render_manager->records[0].op, RecordingRenderManager::Op::kUpdate);
+  EXPECT_EQ(render_manager->records[0].ids, std::vector<uint32_t>{2});
+}
+
+TEST(DomOperationCoalesceTest, CreateMoveThenDeleteSubtree) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  auto render_manager = std::make_shared<RecordingRenderManager>();
+  root_node->CreateDomNodes(Infos({MakeCreateInfo(root_node, 2, kStyleRootId)}), false);
+  root_node->SyncWithRenderManager(render_manager);
+  render_manager->records.clear();
+
+  // the whole subtree of node 3 is created, reordered and deleted in the same batch
+  root_node->CreateDomNodes(Infos({MakeCreateInfo(root_node, 3, kStyleRootId), MakeCreateInfo(root_node, 4, 3),
+                                   MakeCreateInfo(root_node, 5, 3), MakeCreateInfo(root_node, 6, 5)}),
+                            false);
+  root_node->MoveDomNodes(Infos({MakeMoveInfo(5, 3, 4, RelativeType::kFront)}));
+  root_node->MoveDomNodes(Infos({MakeMoveInfo(3, kStyleRootId, 2, RelativeType::kFront)}));
+  root_node->UpdateDomNodes(Infos({MakeUpdateInfo(root_node, 6, MakeStyle(1, 1))}));
+  root_node->DeleteDomNodes(Infos({MakeCreateInfo(root_node, 3, kStyleRootId)}));
+  root_node->SyncWithRenderManager(render_manager);
+  EXPECT_TRUE(render_manager->records.empty());
+  const auto& statistics = root_node->GetDomOperationStatistics();
+  EXPECT_EQ(statistics.coalesced_operation_count, 0);
+  EXPECT_EQ(statistics.GetEliminatedNodeCount(), statistics.node_count);
+  EXPECT_EQ(root_node->GetNode(3), nullptr);
+  EXPECT_EQ(root_node->GetNode(6), nullptr);
+}
+
+TEST(DomOperationCoalesceTest, DropOperationsOfDeletedNode) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  auto render_manager = std::make_shared<RecordingRenderManager>();
+  root_node->CreateDomNodes(Infos({MakeCreateInfo(root_node, 2, kStyleRootId),
+                                   MakeCreateInfo(root_node, 3, kStyleRootId)}), false);
+  root_node->SyncWithRenderManager(render_manager);
+  render_manager->records.clear();
+
+  root_node->UpdateDomNodes(Infos({MakeUpdateInfo(root_node, 2, MakeStyle(1, 1))}));
+  root_node->MoveDomNodes(Infos({MakeMoveInfo(2, kStyleRootId, 3, RelativeType::kBack)}));
+  root_node->DeleteDomNodes(Infos({MakeCreateInfo(root_node, 2, kStyleRootId)}));
+  root_node->SyncWithRenderManager(render_manager);
+  ASSERT_EQ(render_manager->records.size(), 1);
+  EXPECT_EQ(render_manager->records[0].op, RecordingRenderManager::Op::kDelete);
+  EXPECT_EQ(render_manager->records[0].ids, std::vector<uint32_t>{2});
+}
+
+TEST(DomOperationCoalesceTest, RepeatedMovesAndAdjacentOperations) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  auto render_manager = std::make_shared<RecordingRenderManager>();
+  root_node->CreateDomNodes(Infos({MakeCreateInfo(root_node, 2, kStyleRootId),
+                                   MakeCreateInfo(root_node, 3, kStyleRootId),
+                                   MakeCreateInfo(root_node, 4, kStyleRootId)}), false);
+  root_node->SyncWithRenderManager(render_manager);
+  render_manager->records.clear();
+
+  root_node->MoveDomNodes(Infos({MakeMoveInfo(4, kStyleRootId, 2, RelativeType::kFront)}));
+  root_node->MoveDomNodes(Infos({MakeMoveInfo(4, kStyleRootId, 3, RelativeType::kFront)}));
+  root_node->UpdateDomNodes(Infos({MakeUpdateInfo(root_node, 2, MakeStyle(1, 1))}));
+  root_node->UpdateDomNodes(Infos({MakeUpdateInfo(root_node, 3, MakeStyle(1, 1))}));
+  root_node->SyncWithRenderManager(render_manager);
+  ASSERT_EQ(render_manager->records.size(), 2);
+  EXPECT_EQ(render_manager->records[0].op, RecordingRenderManager::Op::kMove);
+  EXPECT_EQ(render_manager->records[0].ids, std::vector<uint32_t>{4});
+  EXPECT_EQ(render_manager->records[1].op, RecordingRenderManager::Op::kUpdate);
+  EXPECT_EQ(render_manager->records[1].ids, (std::vector<uint32_t>{2, 3}));
+  EXPECT_EQ(root_node->GetNode(4)->GetSelfIndex(), 1);
+}
+
+TEST(EventDispatchTest, CaptureAndBubbleThroughListeningAncestors) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  root_node->CreateDomNodes(Infos({MakeCreateInfo(root_node, 2, kStyleRootId), MakeCreateInfo(root_node, 3, 2),
+                                   MakeCreateInfo(root_node, 4, 3)}),
+                            false);
+  std::vector<std::string> calls;
+  auto record = [&calls](const std::string& tag) {
+    return [&calls, tag](const std::shared_ptr<DomEvent>&) { calls.push_back(tag); };
+  };
+  root_node->AddEventListener("click", 1, true, record("root capture"));
+  root_node->GetNode(2)->AddEventListener("click", 2, false, record("2 bubble"));
+  root_node->GetNode(4)->AddEventListener("click", 3, false, record("4 target"));
+  EXPECT_TRUE(root_node->HasEventListenerInTree("click"));
+  EXPECT_FALSE(root_node->HasEventListenerInTree("touchstart"));
+
+  root_node->HandleEvent(std::make_shared<DomEvent>("click", root_node->GetNode(4), true, true));
+  EXPECT_EQ(calls, (std::vector<std::string>{"root capture", "4 target", "2 bubble"}));
+
+  calls.clear();
+  root_node->GetNode(2)->RemoveEventListener("click", 2);
+  root_node->HandleEvent(std::make_shared<DomEvent>("click", root_node->GetNode(4), true, true));
+  EXPECT_EQ(calls, (std::vector<std::string>{"root capture", "4 target"}));
+  EXPECT_TRUE(root_node->GetNode(2)->GetEventListener("click", false).empty());
+}
+
+TEST(EventDispatchTest, ListenerCountFollowsAttachedNodes) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  root_node->CreateDomNodes(Infos({MakeCreateInfo(root_node, 2, kStyleRootId), MakeCreateInfo(root_node, 3, 2)}),
+                            false);
+  root_node->GetNode(3)->AddEventListener("click", 1, false, [](const std::shared_ptr<DomEvent>&) {});
+  EXPECT_TRUE(root_node->HasEventListenerInTree("click"));
+  // deleting an ancestor detaches the listening descendant too
+  root_node->DeleteDomNodes(Infos({MakeCreateInfo(root_node, 2, kStyleRootId)}));
+  EXPECT_FALSE(root_node->HasEventListenerInTree("click"));
+
+  // listeners added before the node is attached are counted on creation
+  auto info = MakeCreateInfo(root_node, 5, kStyleRootId);
+  uint32_t created_count = 0;
+  info->dom_node->AddEventListener("DomCreated", 2, false,
+                                   [&created_count](const std::shared_ptr<DomEvent>&) { ++created_count; });
+  EXPECT_FALSE(root_node->HasEventListenerInTree("DomCreated"));
+  root_node->CreateDomNodes(Infos({info}), false);
+  EXPECT_EQ(created_count, 1);
+  EXPECT_TRUE(root_node->HasEventListenerInTree("DomCreated"));
+}
+
+TEST(EventDispatchTest, UpdateEventOnlyForListeningNodes) {
+  auto root_node = MakeStyleRoot(2, 1);
+  auto first_id = kStyleRootId + 1;
+  auto second_id = kStyleRootId + 2;
+  uint32_t updated_count = 0;
+  root_node->GetNode(first_id)->AddEventListener(
+      "DomUpdated", 1, false, [&updated_count](const std::shared_ptr<DomEvent>&) { ++updated_count; });
+  EXPECT_TRUE(root_node->HasEventListenerInTree("DomUpdated"));
+  root_node->UpdateDomNodes(Infos({MakeUpdateInfo(root_node, first_id, MakeStyle(1, 1)),
+                                   MakeUpdateInfo(root_node, second_id, MakeStyle(1, 1))}));
+  EXPECT_EQ(updated_count, 1);
+
+  root_node->GetNode(first_id)->RemoveEventListener("DomUpdated", 1);
+  EXPECT_FALSE(root_node->HasEventListenerInTree("DomUpdated"));
+  root_node->UpdateDomNodes(Infos({MakeUpdateInfo(root_node, first_id, MakeStyle(1, 2))}));
+  EXPECT_EQ(updated_count, 1);
+}
+
+TEST(IncrementalLayoutTest, UpdateInsideLayoutBoundary) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  auto render_manager = MakeListRoot(root_node);
+  EXPECT_GE(root_node->GetLayoutVisitCount(), kCellCount * 2);
+  render_manager->layout_ids.clear();
+
+  // the cell has a fixed size, so only the cell subtree is collected
+  auto style = std::make_shared<DomValueMapType>();
+  (*style)[kWidth] = std::make_shared<HippyValue>(1000.0);
+  (*style)[kHeight] = std::make_shared<HippyValue>(30.0);
+  root_node->UpdateDomNodes(Infos({MakeUpdateInfo(root_node, TextId(100), style)}));
+  root_node->SyncWithRenderManager(render_manager);
+  EXPECT_LT(root_node->GetLayoutVisitCount(), 10);
+  auto& layout_ids = render_manager->layout_ids;
+  EXPECT_NE(std::find(layout_ids.begin(), layout_ids.end(), TextId(100)), layout_ids.end());
+  EXPECT_EQ(std::find(layout_ids.begin(), layout_ids.end(), CellId(101)), layout_ids.end());
+  EXPECT_EQ(root_node->GetNode(TextId(100))->GetLayoutResult().height, 30);
+}
+
+TEST(IncrementalLayoutTest, SiblingsShiftedBySizeChange) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  auto render_manager = MakeListRoot(root_node);
+  render_manager->layout_ids.clear();
+
+  auto style = std::make_shared<DomValueMapType>();
+  (*style)[kWidth] = std::make_shared<HippyValue>(1000.0);
+  (*style)[kHeight] = std::make_shared<HippyValue>(kCellHeight + 10.0);
+  constexpr uint32_t kIndex = kCellCount - 10;
+  root_node->UpdateDomNodes(Infos({MakeUpdateInfo(root_node, CellId(kIndex), style)}));
+  root_node->SyncWithRenderManager(render_manager);
+  // the resized cell and every cell after it, besides the ancestors re-laid out by the layout engine
+  auto& layout_ids = render_manager->layout_ids;
+  for (uint32_t i = kIndex; i < kCellCount; ++i) {
+    EXPECT_NE(std::find(layout_ids.begin(), layout_ids.end(), CellId(i)), layout_ids.end());
+  }
+  EXPECT_EQ(std::find(layout_ids.begin(), layout_ids.end(), CellId(kIndex - 1)), layout_ids.end());
+  EXPECT_EQ(root_node->GetNode(CellId(kCellCount - 1))->GetLayoutResult().top,
+            (kCellCount - 1) * kCellHeight + 10);
+}
+
+TEST(IncrementalLayoutTest, RepeatedUpdatesVisitOnlyDirtySubtrees) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  auto render_manager = MakeListRoot(root_node);
+  auto style = std::make_shared<DomValueMapType>();
+  (*style)[kWidth] = std::make_shared<HippyValue>(1000.0);
+  (*style)[kHeight] = std::make_shared<HippyValue>(30.0);
+  for (uint32_t i = 0; i < 100; ++i) {
+    root_node->UpdateDomNodes(Infos({MakeUpdateInfo(root_node, TextId(i), style)}));
+    root_node->SyncWithRenderManager(render_manager);
+    EXPECT_LT(root_node->GetLayoutVisitCount(), 10);
+    EXPECT_EQ(root_node->GetNode(TextId(i))->GetLayoutResult().height, 30);
+  }
+}
+
+std::shared_ptr<DomInfo> MakeTextInfo(const std::shared_ptr<RootNode>& root_node, uint32_t id, uint32_t pid,
+                                      const std::string& text) {
+  auto style = std::make_shared<DomValueMapType>();
+  (*style)[kWidth] = std::make_shared<HippyValue>(1000.0);
+  auto ext = std::make_shared<DomValueMapType>();
+  (*ext)[kText] = std::make_shared<HippyValue>(text);
+  auto node = std::make_shared<DomNode>(id, pid, 0, "p", "Text", style, ext, root_node);
+  return std::make_shared<DomInfo>(node, nullptr, nullptr);
+}
+
+TEST(IncrementalLayoutTest, TextChangeShiftsSiblings) {
+  // root -> fixed size container -> text measured by its length, sibling below it
+  constexpr uint32_t kContainerId = kStyleRootId + 1;
+  constexpr uint32_t kTextId = kContainerId + 1;
+  constexpr uint32_t kSiblingId = kTextId + 1;
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  auto render_manager = std::make_shared<RecordingRenderManager>();
+  root_node->SetRootSize(1000, 1000);
+  root_node->CreateDomNodes(Infos({MakeSizedInfo(root_node, kContainerId, kStyleRootId, 1000, 1000),
+                                   MakeTextInfo(root_node, kTextId, kContainerId, "0123456789"),
+                                   MakeSizedInfo(root_node, kSiblingId, kContainerId, 1000, 20)}),
+                            false);
+  auto text_node = root_node->GetNode(kTextId);
+  std::weak_ptr<DomNode> weak_text_node = text_node;
+  text_node->GetLayoutNode()->SetMeasureFunction(
+      [weak_text_node](float width, LayoutMeasureMode, float, LayoutMeasureMode, void*) -> LayoutSize {
+        auto node = weak_text_node.lock();
+        auto length = node ? node->GetExtStyle()->at(kText)->ToStringChecked().length() : 0;
+        return LayoutSize{width, static_cast<float>(length)};
+      });
+  root_node->SyncWithRenderManager(render_manager);
+  EXPECT_EQ(text_node->GetLayoutResult().height, 10);
+  EXPECT_EQ(root_node->GetNode(kSiblingId)->GetLayoutResult().top, 10);
+  render_manager->layout_ids.clear();
+
+  // only the text in ext changes, the style is the same as before
+  root_node->UpdateDomNodes(Infos({MakeTextInfo(root_node, kTextId, kContainerId, std::string(30, 'a'))}));
+  root_node->SyncWithRenderManager(render_manager);
+  EXPECT_EQ(text_node->GetLayoutResult().height, 30);
+  EXPECT_EQ(root_node->GetNode(kSiblingId)->GetLayoutResult().top, 30);
+  auto& layout_ids = render_manager->layout_ids;
+  EXPECT_NE(std::find(layout_ids.begin(), layout_ids.end(), kTextId), layout_ids.end());
+  EXPECT_NE(std::find(layout_ids.begin(), layout_ids.end(), kSiblingId), layout_ids.end());
+}
+
+// synthetic multi-column page: root -> kColumnCount columns -> fixed size items -> item content
+constexpr uint32_t kColumnCount = 4;
+constexpr uint32_t kItemsPerColumn = 2500;
+constexpr uint32_t kNodesPerItem = 5;
+
+std::shared_ptr<RootNode> RunMultiColumnLayout(uint32_t parallelism) {
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  if (parallelism > 0) {
+    EXPECT_TRUE(root_node->EnableParallelLayout(parallelism));
+  }
+  root_node->SetRootSize(1000, 1000);
+  std::vector<std::shared_ptr<DomInfo>> infos;
+  uint32_t id = kStyleRootId + 1;
+  for (uint32_t column = 0; column < kColumnCount; ++column) {
+    auto column_id = id++;
+    infos.push_back(MakeCreateInfo(root_node, column_id, kStyleRootId));
+    for (uint32_t item = 0; item < kItemsPerColumn; ++item) {
+      auto item_id = id++;
+      infos.push_back(MakeSizedInfo(root_node, item_id, column_id, 250, 100 + (item % 3) * 10));
+      for (uint32_t i = 1; i < kNodesPerItem; ++i) {
+        infos.push_back(MakeSizedInfo(root_node, id++, item_id, 250, 10 + i * 5));
+      }
+    }
+  }
+  root_node->CreateDomNodes(std::move(infos), false);
+  root_node->SyncWithRenderManager(std::make_shared<RecordingRenderManager>());
+  return root_node;
+}
+
+TEST(ParallelLayoutTest, SameResultAsSerialLayout) {
+  EXPECT_FALSE(std::make_shared<RootNode>(kStyleRootId)->EnableParallelLayout(1));
+  auto serial_root = RunMultiColumnLayout(0);
+  EXPECT_EQ(serial_root->GetParallelLayoutSubtreeCount(), 0);
+  auto parallel_root = RunMultiColumnLayout(4);
+  EXPECT_EQ(parallel_root->GetParallelLayoutSubtreeCount(), kColumnCount * kItemsPerColumn);
+
+  auto node_count = kColumnCount * (1 + kItemsPerColumn * kNodesPerItem);
+  for (uint32_t id = kStyleRootId + 1; id <= kStyleRootId + node_count; ++id) {
+    const auto& expected = serial_root->GetNode(id)->GetLayoutResult();
+    const auto& actual = parallel_root->GetNode(id)->GetLayoutResult();
+    ASSERT_EQ(expected.left, actual.left) << "node " << id;
+    ASSERT_EQ(expected.top, actual.top) << "node " << id;
+    ASSERT_EQ(expected.width, actual.width) << "node " << id;
+    ASSERT_EQ(expected.height, actual.height) << "node " << id;
+  }
+}
+
+TEST(ParallelLayoutTest, SkipsParentDependentAndMeasuredSubtrees) {
+  // fixed size items under one container: half of them can be shrunk by the parent, half contain a measured text
+  constexpr uint32_t kContainerId = kStyleRootId + 1;
+  constexpr uint32_t kItemCount = 8;
+  auto root_node = std::make_shared<RootNode>(kStyleRootId);
+  EXPECT_TRUE(root_node->EnableParallelLayout(4));
+  root_node->SetRootSize(1000, 1000);
+  std::vector<std::shared_ptr<DomInfo>> infos;
+  infos.push_back(MakeCreateInfo(root_node, kContainerId, kStyleRootId));
+  for (uint32_t i = 0; i < kItemCount; ++i) {
+    auto item_id = kContainerId + 1 + i * 2;
+    auto item = MakeSizedInfo(root_node, item_id, kContainerId, 1000, 100);
+    if (i % 2 == 0) {
+      (*item->dom_node->GetStyleMap())[kFlexShrink] = std::make_shared<HippyValue>(1.0);
+    }
+    infos.push_back(item);
+    infos.push_back(MakeTextInfo(root_node, item_id + 1, item_id, "0123456789"));
+  }
+  root_node->CreateDomNodes(std::move(infos), false);
+  for (uint32_t i = 1; i < kItemCount; i += 2) {
+    root_node->GetNode(kContainerId + 2 + i * 2)->GetLayoutNode()->SetMeasureFunction(
+        [](float width, LayoutMeasureMode, float, LayoutMeasureMode, void*) { return LayoutSize{width, 10}; });
+  }
+  root_node->SyncWithRenderManager(std::make_shared<RecordingRenderManager>());
+  EXPECT_EQ(root_node->GetParallelLayoutSubtreeCount(), 0);
+}
+
+}  // namespace testing
+}  // namespace dom
+}  // namespace hippy
@@ -21,7 +21,6 @@
 #include "dom/taitank_layout_node.h"
 
 #include <cmath>
-#include <map>
 
 #include "footstone/logging.h"
 
@@ -30,150 +29,76 @@
 namespace hippy {
 inline namespace dom {
 
-const std::map<std::string, OverflowType> kOverflowMap = {{"visible", OverflowType::OVERFLOW_VISIBLE},
-                                                          {"hidden", OverflowType::OVERFLOW_HIDDEN},
-                                                          {"scroll", OverflowType::OVERFLOW_SCROLL}};
+constexpr LayoutKeyword<OverflowType> kOverflowKeywords[] = {{"visible", OverflowType::OVERFLOW_VISIBLE},
+                                                             {"hidden", OverflowType::OVERFLOW_HIDDEN},
+                                                             {"scroll", OverflowType::OVERFLOW_SCROLL}};
 
-const std::map<std::string, FlexDirection> kFlexDirectionMap = {
+constexpr LayoutKeyword<FlexDirection> kFlexDirectionKeywords[] = {
     {"row", FlexDirection::FLEX_DIRECTION_ROW},
     {"row-reverse", FlexDirection::FLEX_DIRECTION_ROW_REVERSE},
     {"column", FlexDirection::FLEX_DIRECTION_COLUMN},
     {"column-reverse", FlexDirection::FLEX_DIRECTION_COLUNM_REVERSE}};
 
-const std::map<std::string, FlexWrapMode> kWrapModeMap = {{"nowrap", FlexWrapMode::FLEX_NO_WRAP},
-                                                          {"wrap", FlexWrapMode::FLEX_WRAP},
-                                                          {"wrap-reverse", FlexWrapMode::FLEX_WRAP_REVERSE}};
-
-const std::map<std::string, FlexAlign> kJustifyMap = {{"flex-start", FlexAlign::FLEX_ALIGN_START},
-                                                      {"center", FlexAlign::FLEX_ALIGN_CENTER},
-                                                      {"flex-end", FlexAlign::FLEX_ALIGN_END},
-                                                      {"space-between", FlexAlign::FLEX_ALIGN_SPACE_BETWEEN},
-                                                      {"space-around", FlexAlign::FLEX_ALIGN_SPACE_AROUND},
-                                                      {"space-evenly", FlexAlign::FLEX_ALIGN_SPACE_EVENLY}};
-
-const std::map<std::string, FlexAlign> kAlignMap = {{"auto", FlexAlign::FLEX_ALIGN_AUTO},
-                                                    {"flex-start", FlexAlign::FLEX_ALIGN_START},
-                                                    {"center", FlexAlign::FLEX_ALIGN_CENTER},
-                                                    {"flex-end", FlexAlign::FLEX_ALIGN_END},
-                                                    {"stretch", FlexAlign::FLEX_ALIGN_STRETCH},
-                                                    {"baseline", FlexAlign::FLEX_ALIGN_BASE_LINE},
-                                                    {"space-between", FlexAlign::FLEX_ALIGN_SPACE_BETWEEN},
-                                                    {"space-around", FlexAlign::FLEX_ALIGN_SPACE_AROUND}};
-
-const std::map<std::string, CSSDirection> kMarginMap = {{kMargin, CSSDirection::CSS_ALL},
-                                                        {kMarginVertical, CSSDirection::CSS_VERTICAL},
-                                                        {kMarginHorizontal, CSSDirection::CSS_HORIZONTAL},
-                                                        {kMarginLeft, CSSDirection::CSS_LEFT},
-                                                        {kMarginRight, CSSDirection::CSS_RIGHT},
-                                                        {kMarginTop, CSSDirection::CSS_TOP},
-                                                        {kMarginBottom, CSSDirection::CSS_BOTTOM}};
-
-const std::map<std::string, CSSDirection> kPaddingMap = {{kPadding, CSSDirection::CSS_ALL},
-                                                         {kPaddingVertical, CSSDirection::CSS_VERTICAL},
-                                                         {kPaddingHorizontal, CSSDirection::CSS_HORIZONTAL},
-                                                         {kPaddingLeft, CSSDirection::CSS_LEFT},
-                                                         {kPaddingRight, CSSDirection::CSS_RIGHT},
-                                                         {kPaddingTop, CSSDirection::CSS_TOP},
-                                                         {kPaddingBottom, CSSDirection::CSS_BOTTOM}};
-
-const std::map<std::string, CSSDirection> kPositionMap = {{kLeft, CSSDirection::CSS_LEFT},
-                                                          {kRight, CSSDirection::CSS_RIGHT},
-                                                          {kTop, CSSDirection::CSS_TOP},
-                                                          {kBottom, CSSDirection::CSS_BOTTOM}};
-
-const std::map<std::string, CSSDirection> kBorderMap = {{kBorderWidth, CSSDirection::CSS_ALL},
-                                                        {kBorderLeftWidth, CSSDirection::CSS_LEFT},
-                                                        {kBorderTopWidth, CSSDirection::CSS_TOP},
-                                                        {kBorderRightWidth, CSSDirection::CSS_RIGHT},
-                                                        {kBorderBottomWidth, CSSDirection::CSS_BOTTOM}};
-
-const std::map<std::string, PositionType> kPositionTypeMap = {{"relative", PositionType::POSITION_TYPE_RELATIVE},
-                                                              {"absolute", PositionType::POSITION_TYPE_ABSOLUTE}};
-
-const std::map<std::string, DisplayType> kDisplayTypeMap = {{"none", DisplayType::DISPLAY_TYPE_NONE}};
-
-const std::map<std::string, TaitankDirection> kDirectionMap = {
-    {"inherit", DIRECTION_INHERIT}, {"ltr", DIRECTION_LTR}, {"rtl", DIRECTION_RTL}};
-
-#define TAITANK_GET_STYLE_DECL(NAME, TYPE, DEFAULT)      \
-  static TYPE GetStyle##NAME(const std::string& key) {   \
-    auto iter = k##NAME##Map.find(key);                  \
-    if (iter != k##NAME##Map.end()) return iter->second; \
-    return DEFAULT;                                      \
-  }
-
-TAITANK_GET_STYLE_DECL(Overflow, OverflowType, OverflowType::OVERFLOW_VISIBLE)
-
-TAITANK_GET_STYLE_DECL(FlexDirection, FlexDirection, FlexDirection::FLEX_DIRECTION_COLUMN)
-
-TAITANK_GET_STYLE_DECL(WrapMode, FlexWrapMode, FlexWrapMode::FLEX_NO_WRAP)
-
-TAITANK_GET_STYLE_DECL(Justify, FlexAlign, FlexAlign::FLEX_ALIGN_START)
-
-TAITANK_GET_STYLE_DECL(Align, FlexAlign, FlexAlign::FLEX_ALIGN_STRETCH)
-
-TAITANK_GET_STYLE_DECL(Margin, CSSDirection, CSSDirection::CSS_NONE)
-
-TAITANK_GET_STYLE_DECL(Padding, CSSDirection, CSSDirection::CSS_NONE)
+constexpr LayoutKeyword<FlexWrapMode> kWrapModeKeywords[] = {{"nowrap", FlexWrapMode::FLEX_NO_WRAP},
+                                                             {"wrap", FlexWrapMode::FLEX_WRAP},
+                                                             {"wrap-reverse", FlexWrapMode::FLEX_WRAP_REVERSE}};
 
-TAITANK_GET_STYLE_DECL(Border, CSSDirection, CSSDirection::CSS_NONE)
+constexpr LayoutKeyword<FlexAlign> kJustifyKeywords[] = {{"flex-start", FlexAlign::FLEX_ALIGN_START},
+                                                         {"center", FlexAlign::FLEX_ALIGN_CENTER},
+                                                         {"flex-end", FlexAlign::FLEX_ALIGN_END},
+                                                         {"space-between", FlexAlign::FLEX_ALIGN_SPACE_BETWEEN},
+                                                         {"space-around", FlexAlign::FLEX_ALIGN_SPACE_AROUND},
+                                                         {"space-evenly", FlexAlign::FLEX_ALIGN_SPACE_EVENLY}};
 
-TAITANK_GET_STYLE_DECL(Position, CSSDirection, CSSDirection::CSS_NONE)
+constexpr LayoutKeyword<FlexAlign> kAlignKeywords[] = {{"auto", FlexAlign::FLEX_ALIGN_AUTO},
+                                                       {"flex-start", FlexAlign::FLEX_ALIGN_START},
+                                                       {"center", FlexAlign::FLEX_ALIGN_CENTER},
+                                                       {"flex-end", FlexAlign::FLEX_ALIGN_END},
+                                                       {"stretch", FlexAlign::FLEX_ALIGN_STRETCH},
+                                                       {"baseline", FlexAlign::FLEX_ALIGN_BASE_LINE},
+                                                       {"space-between", FlexAlign::FLEX_ALIGN_SPACE_BETWEEN},
+                                                       {"space-around", FlexAlign::FLEX_ALIGN_SPACE_AROUND}};
 
-TAITANK_GET_STYLE_DECL(PositionType, PositionType, PositionType::POSITION_TYPE_RELATIVE)
+constexpr LayoutKeyword<PositionType> kPositionTypeKeywords[] = {
+    {"relative", PositionType::POSITION_TYPE_RELATIVE}, {"absolute", PositionType::POSITION_TYPE_ABSOLUTE}};
 
-TAITANK_GET_STYLE_DECL(DisplayType, DisplayType, DisplayType::DISPLAY_TYPE_FLEX)
+constexpr LayoutKeyword<DisplayType> kDisplayTypeKeywords[] = {{"none", DisplayType::DISPLAY_TYPE_NONE}};
 
-TAITANK_GET_STYLE_DECL(Direction, TaitankDirection, TaitankDirection::DIRECTION_LTR)
-
-#define SET_STYLE_VALUE(NAME, DEFAULT)                                                         \
-  if (style_update.find(k##NAME) != style_update.end()) {                                      \
-    auto hippy_value = style_update.find(k##NAME)->second;                                     \
-    FOOTSTONE_DCHECK(hippy_value != nullptr);                                                  \
-    if (hippy_value != nullptr) {                                                              \
-      CheckValueType(hippy_value->GetType());                                                  \
-      float value = DEFAULT;                                                                   \
-      if (hippy_value->IsNumber()) value = static_cast<float>(hippy_value->ToDoubleChecked()); \
-      Set##NAME(value);                                                                        \
-    }                                                                                          \
-  } else {                                                                                     \
-    auto it = std::find(style_delete.begin(), style_delete.end(), k##NAME);                    \
-    if (it != style_delete.end()) Set##NAME(DEFAULT);                                          \
-  }
-
-#define SET_STYLE_VALUES(NAME, STYLENAME, DEFAULT)                                             \
-  if (style_update.find(k##STYLENAME) != style_update.end()) {                                 \
-    auto hippy_value = style_update.find(k##STYLENAME)->second;                                \
-    FOOTSTONE_DCHECK(hippy_value != nullptr);                                                  \
-    if (hippy_value != nullptr) {                                                              \
-      CheckValueType(hippy_value->GetType());                                                  \
-      float value = DEFAULT;                                                                   \
-      if (hippy_value->IsNumber()) value = static_cast<float>(hippy_value->ToDoubleChecked()); \
-      Set##NAME(GetStyle##NAME(k##STYLENAME), value);                                          \
-    }                                                                                          \
-  } else {                                                                                     \
-    auto it = std::find(style_delete.begin(), style_delete.end(), k##STYLENAME);               \
-    if (it != style_delete.end()) Set##NAME(GetStyle##NAME(k##STYLENAME), DEFAULT);            \
-  }
+constexpr LayoutKeyword<TaitankDirection> kDirectionKeywords[] = {
+    {"inherit", DIRECTION_INHERIT}, {"ltr", DIRECTION_LTR}, {"rtl", DIRECTION_RTL}};
 
 static void CheckValueType(footstone::value::HippyValue::Type type) {
   if (type == footstone::value::HippyValue::Type::kString || type == footstone::value::HippyValue::Type::kObject)
     FOOTSTONE_DLOG(WARNING) << "Taitank Layout Node Value Type Error";
 }
 
-static float GetDefaultValue(
-    const std::string& key, const std::string& relation_key,
-    const std::unordered_map<std::string, std::shared_ptr<footstone::value::HippyValue>>& style_update,
-    const std::vector<std::string>& style_delete) {
-  auto it = std::find(style_delete.begin(), style_delete.end(), key);
-  if (it == style_delete.end()) return 0;
+static float ToLength(const footstone::value::HippyValue& value, float default_value) {
+  CheckValueType(value.GetType());
+  return value.IsNumber() ? static_cast<float>(value.ToDoubleChecked()) : default_value;
+}
+
+static bool ToFlexNumber(const footstone::value::HippyValue& value, const char* style_name, float& number) {
+  double double_value;
+  if (!value.ToDouble(double_value)) {
+    FOOTSTONE_LOG(WARNING) << "layout style " << style_name << " value is not correct";
+    return false;
+  }
+  number = static_cast<float>(double_value);
+  return true;
+}
 
-  float default_value = 0;
-  if (style_update.find(relation_key) != style_update.end()) {
-    auto hippy_value = style_update.find(relation_key)->second;
-    if (hippy_value->IsNumber()) default_value = static_cast<float>(hippy_value->ToDoubleChecked());
+static const std::string* ToKeyword(const footstone::value::HippyValue& value, const char* style_name) {
+  if (!value.IsString()) {
+    FOOTSTONE_LOG(WARNING) << "layout style " << style_name << " value is not correct";
+    return nullptr;
   }
-  return default_value;
+  return &value.ToStringChecked();
+}
+
+// 删除单边属性时回落到本次更新中对应简写属性的值
+static float GetEdgeDefaultValue(const LayoutStyleParser& parser, LayoutStyle shorthand) {
+  auto value = parser.GetUpdate(shorthand);
+  return (value && value->IsNumber()) ? static_cast<float>(value->ToDoubleChecked()) : 0;
 }
 
 static LayoutMeasureMode ToLayoutMeasureMode(MeasureMode measure_mode) {
@@ -234,227 +159,176 @@ void TaitankLayoutNode::SetLayoutStyles(
 void TaitankLayoutNode::Parser(
     const std::unordered_map<std::string, std::shared_ptr<footstone::value::HippyValue>>& style_update,
     const std::vector<std::string>& style_delete) {
-  SET_STYLE_VALUE(Width, NAN)
-  SET_STYLE_VALUE(MinWidth, NAN)
-  SET_STYLE_VALUE(MaxWidth, NAN)
-  SET_STYLE_VALUE(Height, NAN)
-  SET_STYLE_VALUE(MinHeight, NAN)
-  SET_STYLE_VALUE(MaxHeight, NAN)
-
-  if (style_update.find(kFlex) != style_update.end()) {
-    FOOTSTONE_DCHECK(style_update.find(kFlex)->second != nullptr);
-    if (style_update.find(kFlex)->second != nullptr) {
-      double value;
-      if (style_update.find(kFlex)->second->ToDouble(value)) {
-        SetFlex(static_cast<float>(value));
-      } else {
-        FOOTSTONE_LOG(WARNING) << "layout flex value is not correct";
-      }
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kFlex);
-    if (it != style_delete.end()) SetFlex(0);
-  }
-
-  if (style_update.find(kFlexGrow) != style_update.end()) {
-    FOOTSTONE_DCHECK(style_update.find(kFlexGrow)->second != nullptr);
-    if (style_update.find(kFlexGrow)->second != nullptr) {
-      double value;
-      if (style_update.find(kFlexGrow)->second->ToDouble(value)) {
-        SetFlexGrow(static_cast<float>(value));
-      } else {
-        FOOTSTONE_LOG(WARNING) << "layout flex grow value is not correct";
+  LayoutStyleParser parser(style_update, style_delete);
+  parser.Dispatch([this](LayoutStyle style, const footstone::value::HippyValue& value) { SetStyle(style, value); },
+                  [this, &parser](LayoutStyle style) { ResetStyle(style, parser); });
+}
+
+void TaitankLayoutNode::SetStyle(LayoutStyle style, const footstone::value::HippyValue& value) {
+  float number;
+  const std::string* keyword;
+  switch (style) {
+    case LayoutStyle::kWidth: SetWidth(ToLength(value, NAN)); break;
+    case LayoutStyle::kMinWidth: SetMinWidth(ToLength(value, NAN)); break;
+    case LayoutStyle::kMaxWidth: SetMaxWidth(ToLength(value, NAN)); break;
+    case LayoutStyle::kHeight: SetHeight(ToLength(value, NAN)); break;
+    case LayoutStyle::kMinHeight: SetMinHeight(ToLength(value, NAN)); break;
+    case LayoutStyle::kMaxHeight: SetMaxHeight(ToLength(value, NAN)); break;
+    case LayoutStyle::kFlex:
+      if (ToFlexNumber(value, kFlex, number)) SetFlex(number);
+      break;
+    case LayoutStyle::kFlexGrow:
+      if (ToFlexNumber(value, kFlexGrow, number)) SetFlexGrow(number);
+      break;
+    case LayoutStyle::kFlexShrink:
+      if (ToFlexNumber(value, kFlexShrink, number)) SetFlexShrink(number);
+      break;
+    case LayoutStyle::kFlexBasis:
+      if (ToFlexNumber(value, kFlexBasis, number)) SetFlexBasis(number);
+      break;
+    case LayoutStyle::kDirection:
+      if ((keyword = ToKeyword(value, kDirection))) {
+        SetDirection(LookupLayoutKeyword(kDirectionKeywords, *keyword, TaitankDirection::DIRECTION_LTR));
       }
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kFlexGrow);
-    if (it != style_delete.end()) SetFlexGrow(0);
-  }
-
-  if (style_update.find(kFlexShrink) != style_update.end()) {
-    FOOTSTONE_DCHECK(style_update.find(kFlexShrink)->second != nullptr);
-    if (style_update.find(kFlexShrink)->second != nullptr) {
-      double value;
-      if (style_update.find(kFlexShrink)->second->ToDouble(value)) {
-        SetFlexShrink(static_cast<float>(value));
-      } else {
-        FOOTSTONE_LOG(WARNING) << "layout flex shrink value is not correct";
-      }
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kFlexShrink);
-    if (it != style_delete.end()) SetFlexShrink(0);
-  }
-
-  if (style_update.find(kFlexBasis) != style_update.end()) {
-    FOOTSTONE_DCHECK(style_update.find(kFlexBasis)->second != nullptr);
-    if (style_update.find(kFlexBasis)->second != nullptr) {
-      double value;
-      if (style_update.find(kFlexBasis)->second->ToDouble(value)) {
-        SetFlexBasis(static_cast<float>(value));
-      } else {
-        FOOTSTONE_LOG(WARNING) << "layout flex basis value is not correct";
+      break;
+    case LayoutStyle::kFlexDirection:
+      if ((keyword = ToKeyword(value, kFlexDirection))) {
+        SetFlexDirection(
+            LookupLayoutKeyword(kFlexDirectionKeywords, *keyword, FlexDirection::FLEX_DIRECTION_COLUMN));
       }
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kFlexBasis);
-    if (it != style_delete.end()) SetFlexBasis(NAN);
-  }
-
-  if (style_update.find(kDirection) != style_update.end()) {
-    if (style_update.find(kDirection)->second != nullptr) {
-      std::string value;
-      if (style_update.find(kDirection)->second->ToString(value)) {
-        SetDirection(GetStyleDirection(value));
-      } else {
-        FOOTSTONE_LOG(WARNING) << "layout direction value is not correct";
+      break;
+    case LayoutStyle::kFlexWrap:
+      if ((keyword = ToKeyword(value, kFlexWrap))) {
+        SetFlexWrap(LookupLayoutKeyword(kWrapModeKeywords, *keyword, FlexWrapMode::FLEX_NO_WRAP));
       }
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kDirection);
-    if (it != style_delete.end()) SetDirection(TaitankDirection::DIRECTION_LTR);
-  }
-
-  if (style_update.find(kFlexDirection) != style_update.end()) {
-    FOOTSTONE_DCHECK(style_update.find(kFlexDirection)->second != nullptr);
-    if (style_update.find(kFlexDirection)->second != nullptr) {
-      std::string value;
-      if (style_update.find(kFlexDirection)->second->ToString(value)) {
-        SetFlexDirection(GetStyleFlexDirection(value));
-      } else {
-        FOOTSTONE_LOG(WARNING) << "layout style flex direction value is not correct";
+      break;
+    case LayoutStyle::kAlignSelf:
+      if ((keyword = ToKeyword(value, kAilgnSelf))) {
+        SetAlignSelf(LookupLayoutKeyword(kAlignKeywords, *keyword, FlexAlign::FLEX_ALIGN_STRETCH));
       }
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kFlexDirection);
-    if (it != style_delete.end()) SetFlexDirection(FlexDirection::FLEX_DIRECTION_COLUMN);
-  }
-
-  if (style_update.find(kFlexWrap) != style_update.end()) {
-    FOOTSTONE_DCHECK(style_update.find(kFlexWrap)->second != nullptr);
-    if (style_update.find(kFlexWrap)->second != nullptr) {
-      std::string value;
-      if (style_update.find(kFlexWrap)->second->ToString(value)) {
-        SetFlexWrap(GetStyleWrapMode(value));
-      } else {
-        FOOTSTONE_LOG(WARNING) << "layout style flex wrap value is not correct";
+      break;
+    case LayoutStyle::kAlignItems:
+      if ((keyword = ToKeyword(value, kAlignItems))) {
+        SetAlignItems(LookupLayoutKeyword(kAlignKeywords, *keyword, FlexAlign::FLEX_ALIGN_STRETCH));
       }
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kFlexWrap);
-    if (it != style_delete.end()) SetFlexWrap(FlexWrapMode::FLEX_NO_WRAP);
-  }
-
-  if (style_update.find(kAilgnSelf) != style_update.end()) {
-    FOOTSTONE_DCHECK(style_update.find(kAilgnSelf)->second != nullptr);
-    if (style_update.find(kAilgnSelf)->second != nullptr) {
-      std::string value;
-      if (style_update.find(kAilgnSelf)->second->ToString(value)) {
-        SetAlignSelf(GetStyleAlign(value));
-      } else {
-        FOOTSTONE_LOG(WARNING) << "layout style flex align self value is not correct";
+      break;
+    case LayoutStyle::kJustifyContent:
+      if ((keyword = ToKeyword(value, kJustifyContent))) {
+        SetJustifyContent(LookupLayoutKeyword(kJustifyKeywords, *keyword, FlexAlign::FLEX_ALIGN_START));
       }
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kAilgnSelf);
-    if (it != style_delete.end()) SetAlignSelf(FlexAlign::FLEX_ALIGN_AUTO);
-  }
-
-  if (style_update.find(kAlignItems) != style_update.end()) {
-    FOOTSTONE_DCHECK(style_update.find(kAlignItems)->second != nullptr);
-    if (style_update.find(kAlignItems)->second != nullptr) {
-      std::string value;
-      if (style_update.find(kAlignItems)->second->ToString(value)) {
-        SetAlignItems(GetStyleAlign(value));
-      } else {
-        FOOTSTONE_LOG(WARNING) << "layout style flex align items value is not correct";
+      break;
+    case LayoutStyle::kOverflow:
+      if ((keyword = ToKeyword(value, kOverflow))) {
+        SetOverflow(LookupLayoutKeyword(kOverflowKeywords, *keyword, OverflowType::OVERFLOW_VISIBLE));
       }
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kAlignItems);
-    if (it != style_delete.end()) SetAlignItems(FlexAlign::FLEX_ALIGN_STRETCH);
-  }
-
-  if (style_update.find(kJustifyContent) != style_update.end()) {
-    FOOTSTONE_DCHECK(style_update.find(kJustifyContent)->second != nullptr);
-    if (style_update.find(kJustifyContent)->second != nullptr) {
-      std::string value;
-      if (style_update.find(kJustifyContent)->second->ToString(value)) {
-        SetJustifyContent(GetStyleJustify(value));
-      } else {
-        FOOTSTONE_LOG(WARNING) << "layout style flex justify content value is not correct";
+      break;
+    case LayoutStyle::kDisplay:
+      if ((keyword = ToKeyword(value, kDisplay))) {
+        SetDisplay(LookupLayoutKeyword(kDisplayTypeKeywords, *keyword, DisplayType::DISPLAY_TYPE_FLEX));
       }
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kJustifyContent);
-    if (it != style_delete.end()) SetJustifyContent(FlexAlign::FLEX_ALIGN_START);
-  }
-
-  if (style_update.find(kOverflow) != style_update.end()) {
-    FOOTSTONE_DCHECK(style_update.find(kOverflow)->second != nullptr);
-    if (style_update.find(kOverflow)->second != nullptr) {
-      std::string value;
-      if (style_update.find(kOverflow)->second->ToString(value)) {
-        SetOverflow(GetStyleOverflow(value));
-      } else {
-        FOOTSTONE_LOG(WARNING) << "layout style over flow value is not correct";
+      break;
+    case LayoutStyle::kPosition:
+      if ((keyword = ToKeyword(value, kPosition))) {
+        SetPositionType(
+            LookupLayoutKeyword(kPositionTypeKeywords, *keyword, PositionType::POSITION_TYPE_RELATIVE));
       }
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kOverflow);
-    if (it != style_delete.end()) SetOverflow(OverflowType::OVERFLOW_VISIBLE);
-  }
-
-  if (style_update.find(kDisplay) != style_update.end()) {
-    std::string value;
-    if (style_update.find(kDisplay)->second != nullptr && style_update.find(kDisplay)->second->ToString(value)) {
-      SetDisplay(GetStyleDisplayType(value));
-    } else {
-      FOOTSTONE_LOG(WARNING) << "layout style display value is not correct";
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kOverflow);
-    if (it != style_delete.end()) SetDisplay(DisplayType::DISPLAY_TYPE_FLEX);
+      break;
+    case LayoutStyle::kMargin: SetMargin(CSSDirection::CSS_ALL, ToLength(value, 0)); break;
+    case LayoutStyle::kMarginVertical: SetMargin(CSSDirection::CSS_VERTICAL, ToLength(value, 0)); break;
+    case LayoutStyle::kMarginHorizontal: SetMargin(CSSDirection::CSS_HORIZONTAL, ToLength(value, 0)); break;
+    case LayoutStyle::kMarginLeft: SetMargin(CSSDirection::CSS_LEFT, ToLength(value, 0)); break;
+    case LayoutStyle::kMarginRight: SetMargin(CSSDirection::CSS_RIGHT, ToLength(value, 0)); break;
+    case LayoutStyle::kMarginTop: SetMargin(CSSDirection::CSS_TOP, ToLength(value, 0)); break;
+    case LayoutStyle::kMarginBottom: SetMargin(CSSDirection::CSS_BOTTOM, ToLength(value, 0)); break;
+    case LayoutStyle::kPadding: SetPadding(CSSDirection::CSS_ALL, ToLength(value, 0)); break;
+    case LayoutStyle::kPaddingVertical: SetPadding(CSSDirection::CSS_VERTICAL, ToLength(value, 0)); break;
+    case LayoutStyle::kPaddingHorizontal: SetPadding(CSSDirection::CSS_HORIZONTAL, ToLength(value, 0)); break;
+    case LayoutStyle::kPaddingLeft: SetPadding(CSSDirection::CSS_LEFT, ToLength(value, 0)); break;
+    case LayoutStyle::kPaddingRight: SetPadding(CSSDirection::CSS_RIGHT, ToLength(value, 0)); break;
+    case LayoutStyle::kPaddingTop: SetPadding(CSSDirection::CSS_TOP, ToLength(value, 0)); break;
+    case LayoutStyle::kPaddingBottom: SetPadding(CSSDirection::CSS_BOTTOM, ToLength(value, 0)); break;
+    case LayoutStyle::kBorderWidth: SetBorder(CSSDirection::CSS_ALL, ToLength(value, 0)); break;
+    case LayoutStyle::kBorderLeftWidth: SetBorder(CSSDirection::CSS_LEFT, ToLength(value, 0)); break;
+    case LayoutStyle::kBorderTopWidth: SetBorder(CSSDirection::CSS_TOP, ToLength(value, 0)); break;
+    case LayoutStyle::kBorderRightWidth: SetBorder(CSSDirection::CSS_RIGHT, ToLength(value, 0)); break;
+    case LayoutStyle::kBorderBottomWidth: SetBorder(CSSDirection::CSS_BOTTOM, ToLength(value, 0)); break;
+    case LayoutStyle::kLeft: SetPosition(CSSDirection::CSS_LEFT, ToLength(value, NAN)); break;
+    case LayoutStyle::kRight: SetPosition(CSSDirection::CSS_RIGHT, ToLength(value, NAN)); break;
+    case LayoutStyle::kTop: SetPosition(CSSDirection::CSS_TOP, ToLength(value, NAN)); break;
+    case LayoutStyle::kBottom: SetPosition(CSSDirection::CSS_BOTTOM, ToLength(value, NAN)); break;
+    default: break;
   }
+}
 
-  SET_STYLE_VALUES(Margin, Margin, 0)
-  SET_STYLE_VALUES(Margin, MarginVertical, 0)
-  SET_STYLE_VALUES(Margin, MarginHorizontal, 0)
-  SET_STYLE_VALUES(Margin, MarginLeft, GetDefaultValue(kMarginLeft, kMargin, style_update, style_delete))
-  SET_STYLE_VALUES(Margin, MarginRight, GetDefaultValue(kMarginRight, kMargin, style_update, style_delete))
-  SET_STYLE_VALUES(Margin, MarginTop, GetDefaultValue(kMarginTop, kMargin, style_update, style_delete))
-  SET_STYLE_VALUES(Margin, MarginBottom, GetDefaultValue(kMarginBottom, kMargin, style_update, style_delete))
-  SET_STYLE_VALUES(Padding, Padding, 0)
-  SET_STYLE_VALUES(Padding, PaddingVertical, 0)
-  SET_STYLE_VALUES(Padding, PaddingHorizontal, 0)
-  SET_STYLE_VALUES(Padding, PaddingLeft, GetDefaultValue(kPaddingLeft, kPadding, style_update, style_delete))
-  SET_STYLE_VALUES(Padding, PaddingRight, GetDefaultValue(kPaddingRight, kPadding, style_update, style_delete))
-  SET_STYLE_VALUES(Padding, PaddingTop, GetDefaultValue(kPaddingTop, kPadding, style_update, style_delete))
-  SET_STYLE_VALUES(Padding, PaddingBottom, GetDefaultValue(kPaddingBottom, kPadding, style_update, style_delete))
-  SET_STYLE_VALUES(Border, BorderWidth, 0)
-  SET_STYLE_VALUES(Border, BorderLeftWidth, GetDefaultValue(kBorderLeftWidth, kBorderWidth, style_update, style_delete))
-  SET_STYLE_VALUES(Border, BorderTopWidth, GetDefaultValue(kBorderTopWidth, kBorderWidth, style_update, style_delete))
-  SET_STYLE_VALUES(Border, BorderRightWidth,
-                   GetDefaultValue(kBorderRightWidth, kBorderWidth, style_update, style_delete))
-  SET_STYLE_VALUES(Border, BorderBottomWidth,
-                   GetDefaultValue(kBorderBottomWidth, kBorderWidth, style_update, style_delete))
-  SET_STYLE_VALUES(Position, Left, NAN)
-  SET_STYLE_VALUES(Position, Right, NAN)
-  SET_STYLE_VALUES(Position, Top, NAN)
-  SET_STYLE_VALUES(Position, Bottom, NAN)
-  if (style_update.find(kPosition) != style_update.end()) {
-    FOOTSTONE_DCHECK(style_update.find(kPosition)->second != nullptr);
-    if (style_update.find(kPosition)->second != nullptr) {
-      std::string value;
-      if (style_update.find(kPosition)->second->ToString(value)) {
-        SetPositionType(GetStylePositionType(value));
-      } else {
-        FOOTSTONE_LOG(WARNING) << "layout style position type value is not correct";
-      }
-    }
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kPosition);
-    if (it != style_delete.end()) SetPositionType(PositionType::POSITION_TYPE_RELATIVE);
+void TaitankLayoutNode::ResetStyle(LayoutStyle style, const LayoutStyleParser& parser) {
+  switch (style) {
+    case LayoutStyle::kWidth: SetWidth(NAN); break;
+    case LayoutStyle::kMinWidth: SetMinWidth(NAN); break;
+    case LayoutStyle::kMaxWidth: SetMaxWidth(NAN); break;
+    case LayoutStyle::kHeight: SetHeight(NAN); break;
+    case LayoutStyle::kMinHeight: SetMinHeight(NAN); break;
+    case LayoutStyle::kMaxHeight: SetMaxHeight(NAN); break;
+    case LayoutStyle::kFlex: SetFlex(0); break;
+    case LayoutStyle::kFlexGrow: SetFlexGrow(0); break;
+    case LayoutStyle::kFlexShrink: SetFlexShrink(0); break;
+    case LayoutStyle::kFlexBasis: SetFlexBasis(NAN); break;
+    case LayoutStyle::kDirection: SetDirection(TaitankDirection::DIRECTION_LTR); break;
+    case LayoutStyle::kFlexDirection: SetFlexDirection(FlexDirection::FLEX_DIRECTION_COLUMN); break;
+    case LayoutStyle::kFlexWrap: SetFlexWrap(FlexWrapMode::FLEX_NO_WRAP); break;
+    case LayoutStyle::kAlignSelf: SetAlignSelf(FlexAlign::FLEX_ALIGN_AUTO); break;
+    case LayoutStyle::kAlignItems: SetAlignItems(FlexAlign::FLEX_ALIGN_STRETCH); break;
+    case LayoutStyle::kJustifyContent: SetJustifyContent(FlexAlign::FLEX_ALIGN_START); break;
+    case LayoutStyle::kOverflow: SetOverflow(OverflowType::OVERFLOW_VISIBLE); break;
+    case LayoutStyle::kDisplay: SetDisplay(DisplayType::DISPLAY_TYPE_FLEX); break;
+    case LayoutStyle::kPosition: SetPositionType(PositionType::POSITION_TYPE_RELATIVE); break;
+    case LayoutStyle::kMargin: SetMargin(CSSDirection::CSS_ALL, 0); break;
+    case LayoutStyle::kMarginVertical: SetMargin(CSSDirection::CSS_VERTICAL, 0); break;
+    case LayoutStyle::kMarginHorizontal: SetMargin(CSSDirection::CSS_HORIZONTAL, 0); break;
+    case LayoutStyle::kMarginLeft:
+      SetMargin(CSSDirection::CSS_LEFT, GetEdgeDefaultValue(parser, LayoutStyle::kMargin));
+      break;
+    case LayoutStyle::kMarginRight:
+      SetMargin(CSSDirection::CSS_RIGHT, GetEdgeDefaultValue(parser, LayoutStyle::kMargin));
+      break;
+    case LayoutStyle::kMarginTop:
+      SetMargin(CSSDirection::CSS_TOP, GetEdgeDefaultValue(parser, LayoutStyle::kMargin));
+      break;
+    case LayoutStyle::kMarginBottom:
+      SetMargin(CSSDirection::CSS_BOTTOM, GetEdgeDefaultValue(parser, LayoutStyle::kMargin));
+      break;
+    case LayoutStyle::kPadding: SetPadding(CSSDirection::CSS_ALL, 0); break;
+    case LayoutStyle::kPaddingVertical: SetPadding(CSSDirection::CSS_VERTICAL, 0); break;
+    case LayoutStyle::kPaddingHorizontal: SetPadding(CSSDirection::CSS_HORIZONTAL, 0); break;
+    case LayoutStyle::kPaddingLeft:
+      SetPadding(CSSDirection::CSS_LEFT, GetEdgeDefaultValue(parser, LayoutStyle::kPadding));
+      break;
+    case LayoutStyle::kPaddingRight:
+      SetPadding(CSSDirection::CSS_RIGHT, GetEdgeDefaultValue(parser, LayoutStyle::kPadding));
+      break;
+    case LayoutStyle::kPaddingTop:
+      SetPadding(CSSDirection::CSS_TOP, GetEdgeDefaultValue(parser, LayoutStyle::kPadding));
+      break;
+    case LayoutStyle::kPaddingBottom:
+      SetPadding(CSSDirection::CSS_BOTTOM, GetEdgeDefaultValue(parser, LayoutStyle::kPadding));
+      break;
+    case LayoutStyle::kBorderWidth: SetBorder(CSSDirection::CSS_ALL, 0); break;
+    case LayoutStyle::kBorderLeftWidth:
+      SetBorder(CSSDirection::CSS_LEFT, GetEdgeDefaultValue(parser, LayoutStyle::kBorderWidth));
+      break;
+    case LayoutStyle::kBorderTopWidth:
+      SetBorder(CSSDirection::CSS_TOP, GetEdgeDefaultValue(parser, LayoutStyle::kBorderWidth));
+      break;
+    case LayoutStyle::kBorderRightWidth:
+      SetBorder(CSSDirection::CSS_RIGHT, GetEdgeDefaultValue(parser, LayoutStyle::kBorderWidth));
+      break;
+    case LayoutStyle::kBorderBottomWidth:
+      SetBorder(CSSDirection::CSS_BOTTOM, GetEdgeDefaultValue(parser, LayoutStyle::kBorderWidth));
+      break;
+    case LayoutStyle::kLeft: SetPosition(CSSDirection::CSS_LEFT, NAN); break;
+    case LayoutStyle::kRight: SetPosition(CSSDirection::CSS_RIGHT, NAN); break;
+    case LayoutStyle::kTop: SetPosition(CSSDirection::CSS_TOP, NAN); break;
+    case LayoutStyle::kBottom: SetPosition(CSSDirection::CSS_BOTTOM, NAN); break;
+    default: break;
   }
 }
 
@@ -813,5 +687,12 @@ void TaitankLayoutNode::Deallocate() {
 
 std::shared_ptr<LayoutNode> CreateLayoutNode() { return std::make_shared<TaitankLayoutNode>(); }
 
+std::shared_ptr<LayoutNode> CreateLayoutNode(const std::shared_ptr<DomArena>& arena) {
+  return arena->MakeShared<TaitankLayoutNode>();
+}
+
+// Taitank 的布局状态与缓存都保存在各自的节点和 config 中, 没有全局可变状态
+bool IsConcurrentLayoutSupported() { return true; }
+
 }  // namespace dom
 }  // namespace hippy
@@ -0,0 +1,244 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dom/text_measure_cache.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+
+#include "dom/dom_node.h"
+#include "dom/layout_style_parser.h"
+#include "footstone/check.h"
+
+namespace hippy {
+inline namespace dom {
+
+using HippyValue = footstone::value::HippyValue;
+using DomValueMap = std::unordered_map<std::string, std::shared_ptr<HippyValue>>;
+
+static uint64_t Mix(uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xbf58476d1ce4e5b9ULL;
+  value ^= value >> 27;
+  value *= 0x94d049bb133111ebULL;
+  value ^= value >> 31;
+  return value;
+}
+
+static uint64_t Combine(uint64_t seed, uint64_t value) {
+  return Mix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+static bool IsContentProp(const std::string& name, const std::shared_ptr<HippyValue>& value,
+                          bool skip_layout_style) {
+  LayoutStyle style;
+  return value && !(skip_layout_style && LayoutStyleParser::Lookup(name, style));
+}
+
+// unordered_map 的遍历顺序与插入历史有关，逐项混合后求和，保证相同内容得到相同结果
+static uint64_t HashProps(const std::shared_ptr<DomValueMap>& props, bool skip_layout_style) {
+  if (!props) {
+    return 0;
+  }
+  uint64_t hash = 0;
+  for (const auto& [name, value]: *props) {
+    if (IsContentProp(name, value, skip_layout_style)) {
+      hash += Combine(std::hash<std::string>{}(name), std::hash<HippyValue>{}(*value));
+    }
+  }
+  return hash;
+}
+
+template <typename Props>
+static Props CopyProps(const std::shared_ptr<DomValueMap>& props, bool skip_layout_style) {
+  Props copy;
+  if (!props) {
+    return copy;
+  }
+  for (const auto& [name, value]: *props) {
+    if (IsContentProp(name, value, skip_layout_style)) {
+      copy.emplace_back(name, *value);
+    }
+  }
+  std::sort(copy.begin(), copy.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+  return copy;
+}
+
+template <typename Props>
+static bool MatchProps(const Props& copy, const std::shared_ptr<DomValueMap>& props, bool skip_layout_style) {
+  size_t count = 0;
+  if (props) {
+    for (const auto& [name, value]: *props) {
+      if (!IsContentProp(name, value, skip_layout_style)) {
+        continue;
+      }
+      auto it = std::lower_bound(copy.begin(), copy.end(), name,
+                                 [](const auto& prop, const std::string& key) { return prop.first < key; });
+      if (it == copy.end() || it->first != name || !(it->second == *value)) {
+        return false;
+      }
+      ++count;
+    }
+  }
+  return count == copy.size();
+}
+
+static uint64_t HashNode(const std::shared_ptr<DomNode>& node, bool skip_layout_style) {
+  uint64_t hash = Combine(std::hash<std::string>{}(node->GetViewName()),
+                          HashProps(node->GetStyleMap(), skip_layout_style));
+  hash = Combine(hash, HashProps(node->GetExtStyle(), skip_layout_style));
+  for (const auto& child: node->GetChildren()) {
+    hash = Combine(hash, HashNode(child, false));
+  }
+  return hash;
+}
+
+TextMeasureCache::Content TextMeasureCache::MakeContent(const std::shared_ptr<DomNode>& node,
+                                                        bool skip_layout_style) {
+  Content content{node->GetViewName(), CopyProps<Content::Props>(node->GetStyleMap(), skip_layout_style),
+                  CopyProps<Content::Props>(node->GetExtStyle(), skip_layout_style), {}};
+  const auto& children = node->GetChildren();
+  content.children.reserve(children.size());
+  for (const auto& child: children) {
+    content.children.push_back(MakeContent(child, false));
+  }
+  return content;
+}
+
+bool TextMeasureCache::MatchContent(const Content& content, const std::shared_ptr<DomNode>& node,
+                                    bool skip_layout_style) {
+  const auto& children = node->GetChildren();
+  if (content.view_name != node->GetViewName() || content.children.size() != children.size() ||
+      !MatchProps(content.style, node->GetStyleMap(), skip_layout_style) ||
+      !MatchProps(content.ext, node->GetExtStyle(), skip_layout_style)) {
+    return false;
+  }
+  for (size_t i = 0; i < children.size(); ++i) {
+    if (!MatchContent(content.children[i], children[i], false)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TextMeasureCache::Constraints::operator==(const Constraints& other) const {
+  return width == other.width && height == other.height && width_measure_mode == other.width_measure_mode
+      && height_measure_mode == other.height_measure_mode;
+}
+
+TextMeasureCache::TextMeasureCache(size_t capacity) : capacity_(capacity) {
+  FOOTSTONE_DCHECK(capacity_ > 0);
+}
+
+uint64_t TextMeasureCache::HashContent(const std::shared_ptr<DomNode>& node) {
+  // 被测节点自身的排版属性由排版引擎处理，已体现在约束里；子节点（如图片 span 的宽高）参与测量，全部计入
+  return HashNode(node, true);
+}
+
+TextMeasureCache::Constraints TextMeasureCache::MakeConstraints(float width, LayoutMeasureMode width_measure_mode,
+                                                                float height,
+                                                                LayoutMeasureMode height_measure_mode) {
+  // Undefined 模式下的尺寸没有意义，可能是 NaN，统一归零
+  return Constraints{width_measure_mode == LayoutMeasureMode::Undefined ? 0 : width,
+                     height_measure_mode == LayoutMeasureMode::Undefined ? 0 : height,
+                     width_measure_mode, height_measure_mode};
+}
+
+MeasureFunction TextMeasureCache::Wrap(const std::shared_ptr<DomNode>& node, MeasureFunction measure) {
+  FOOTSTONE_DCHECK(node != nullptr && measure != nullptr);
+  std::weak_ptr<TextMeasureCache> weak_cache = weak_from_this();
+  std::weak_ptr<DomNode> weak_node = node;
+  return [weak_cache, weak_node, measure = std::move(measure)](
+      float width, LayoutMeasureMode width_measure_mode, float height, LayoutMeasureMode height_measure_mode,
+      void* layout_context) -> LayoutSize {
+    auto cache = weak_cache.lock();
+    auto dom_node = weak_node.lock();
+    if (!cache || !dom_node) {
+      return measure(width, width_measure_mode, height, height_measure_mode, layout_context);
+    }
+    return cache->Measure(dom_node, measure, width, width_measure_mode, height, height_measure_mode,
+                          layout_context);
+  };
+}
+
+LayoutSize TextMeasureCache::Measure(const std::shared_ptr<DomNode>& node, const MeasureFunction& measure,
+                                     float width, LayoutMeasureMode width_measure_mode, float height,
+                                     LayoutMeasureMode height_measure_mode, void* layout_context) {
+  auto content_hash = HashContent(node);
+  auto constraints = MakeConstraints(width, width_measure_mode, height, height_measure_mode);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(content_hash);
+    // hash 相同但内容不同时按未命中处理
+    if (it != index_.end() && MatchContent(it->second->content, node, true)) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      for (const auto& [result_constraints, size]: it->second->results) {
+        if (result_constraints == constraints) {
+          ++stats_.hit_count;
+          return size;
+        }
+      }
+    }
+    ++stats_.miss_count;
+  }
+
+  // 平台测量可能很慢，不持有锁
+  auto size = measure(width, width_measure_mode, height, height_measure_mode, layout_context);
+  auto content = MakeContent(node, true);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(content_hash);
+  if (it != index_.end() && !MatchContent(it->second->content, node, true)) {
+    // 冲突的旧内容让位给最近测量的内容
+    it->second->content = std::move(content);
+    it->second->results.clear();
+  } else if (it == index_.end()) {
+    entries_.push_front(Entry{content_hash, std::move(content), {}});
+    it = index_.emplace(content_hash, entries_.begin()).first;
+    while (entries_.size() > capacity_) {
+      index_.erase(entries_.back().content_hash);
+      entries_.pop_back();
+      ++stats_.evict_count;
+    }
+  }
+  auto& results = it->second->results;
+  if (results.size() >= kMaxConstraintsPerContent) {
+    results.erase(results.begin());
+  }
+  results.emplace_back(constraints, size);
+  return size;
+}
+
+void TextMeasureCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  index_.clear();
+}
+
+TextMeasureCache::Stats TextMeasureCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto stats = stats_;
+  stats.size = entries_.size();
+  return stats;
+}
+
+}  // namespace dom
+}  // namespace hippy
@@ -0,0 +1,210 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dom/dom_node.h"
+#include "dom/text_measure_cache.h"
+
+namespace hippy {
+inline namespace dom {
+inline namespace testing {
+
+using HippyValue = footstone::value::HippyValue;
+using DomValueMapType = std::unordered_map<std::string, std::shared_ptr<HippyValue>>;
+
+std::shared_ptr<DomNode> MakeTextNode(uint32_t id, const std::string& text, double font_size,
+                                      const DomValueMapType& layout = {}) {
+  auto style = std::make_shared<DomValueMapType>(layout);
+  (*style)["fontSize"] = std::make_shared<HippyValue>(font_size);
+  auto ext = std::make_shared<DomValueMapType>();
+  (*ext)["text"] = std::make_shared<HippyValue>(text);
+  return std::make_shared<DomNode>(id, 0, 0, "p", "Text", style, ext, std::weak_ptr<RootNode>());
+}
+
+// 模拟平台测量：按字符数折行，记录实际调用次数
+struct FakeMeasureBackend {
+  uint32_t call_count = 0;
+
+  MeasureFunction Bind(const std::string& text, float font_size) {
+    return [this, text, font_size](float width, LayoutMeasureMode width_measure_mode, float, LayoutMeasureMode,
+                                   void*) -> LayoutSize {
+      ++call_count;
+      auto text_width = static_cast<float>(text.size()) * font_size * 0.5f;
+      auto line_width = width_measure_mode == LayoutMeasureMode::Undefined ? text_width : width;
+      auto lines = line_width > 0 ? static_cast<int>(text_width / line_width) + 1 : 1;
+      return LayoutSize{std::min(text_width, line_width), static_cast<float>(lines) * font_size * 1.2f};
+    };
+  }
+};
+
+TEST(TextMeasureCacheTest, HitsOnSameContentAndConstraints) {
+  auto cache = std::make_shared<TextMeasureCache>();
+  FakeMeasureBackend backend;
+  auto first = MakeTextNode(1, "hello", 16, {{"width", std::make_shared<HippyValue>(10)}});
+  auto second = MakeTextNode(2, "hello", 16, {{"margin", std::make_shared<HippyValue>(4)}});
+  auto other = MakeTextNode(3, "world", 16);
+  auto measure_first = cache->Wrap(first, backend.Bind("hello", 16));
+  auto measure_second = cache->Wrap(second, backend.Bind("hello", 16));
+  auto measure_other = cache->Wrap(other, backend.Bind("world", 16));
+
+  auto size = measure_first(100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  EXPECT_EQ(backend.call_count, 1);
+  // 排版属性不同、内容相同的节点共享结果，Undefined 模式下的尺寸被忽略
+  auto cached = measure_second(100, LayoutMeasureMode::AtMost, 7, LayoutMeasureMode::Undefined, nullptr);
+  EXPECT_EQ(backend.call_count, 1);
+  EXPECT_EQ(cached.width, size.width);
+  EXPECT_EQ(cached.height, size.height);
+
+  measure_first(50, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  measure_first(100, LayoutMeasureMode::Exactly, NAN, LayoutMeasureMode::Undefined, nullptr);
+  measure_other(100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  EXPECT_EQ(backend.call_count, 4);
+
+  auto stats = cache->GetStats();
+  EXPECT_EQ(stats.hit_count, 1);
+  EXPECT_EQ(stats.miss_count, 4);
+  EXPECT_EQ(stats.size, 2);
+}
+
+TEST(TextMeasureCacheTest, TextChangeAndClear) {
+  auto cache = std::make_shared<TextMeasureCache>();
+  FakeMeasureBackend backend;
+  auto node = MakeTextNode(1, "hello", 16);
+  auto measure = cache->Wrap(node, backend.Bind("hello", 16));
+  measure(100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  measure(100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  EXPECT_EQ(backend.call_count, 1);
+
+  (*node->GetStyleMap())["fontSize"] = std::make_shared<HippyValue>(18.0);
+  measure(100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  EXPECT_EQ(backend.call_count, 2);
+
+  // 嵌套的 span 是内容的一部分
+  auto span = MakeTextNode(2, " world", 12);
+  node->AddChildByRefInfo(std::make_shared<DomInfo>(span, nullptr, nullptr));
+  measure(100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  EXPECT_EQ(backend.call_count, 3);
+  // span 的宽高（如图片 span）影响测量结果
+  (*span->GetStyleMap())["width"] = std::make_shared<HippyValue>(20.0);
+  measure(100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  EXPECT_EQ(backend.call_count, 4);
+
+  // 字体缩放等平台侧变化后清空，重新测量
+  cache->Clear();
+  EXPECT_EQ(cache->GetStats().size, 0);
+  measure(100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  EXPECT_EQ(backend.call_count, 5);
+}
+
+TEST(TextMeasureCacheTest, ComparesFullContent) {
+  auto cache = std::make_shared<TextMeasureCache>();
+  FakeMeasureBackend backend;
+  footstone::value::HippyValue::HippyValueObjectType offset;
+  offset["width"] = HippyValue(1.0);
+  offset["height"] = HippyValue(2.0);
+  auto first = MakeTextNode(1, "hello", 16);
+  (*first->GetStyleMap())["textShadowOffset"] = std::make_shared<HippyValue>(offset);
+  (*first->GetStyleMap())["fontFamily"] = std::make_shared<HippyValue>("serif");
+  // 属性插入顺序不同、对象值相等时内容相同
+  auto second = MakeTextNode(2, "hello", 16);
+  (*second->GetStyleMap())["fontFamily"] = std::make_shared<HippyValue>("serif");
+  (*second->GetStyleMap())["textShadowOffset"] = std::make_shared<HippyValue>(offset);
+  auto other = MakeTextNode(3, "hello", 16);
+  (*other->GetStyleMap())["textShadowOffset"] = std::make_shared<HippyValue>(offset);
+  (*other->GetStyleMap())["fontFamily"] = std::make_shared<HippyValue>("monospace");
+
+  auto measure = [&cache, &backend](const std::shared_ptr<DomNode>& node) {
+    cache->Wrap(node, backend.Bind("hello", 16))(100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined,
+                                                 nullptr);
+  };
+  measure(first);
+  measure(second);
+  EXPECT_EQ(backend.call_count, 1);
+  measure(other);
+  EXPECT_EQ(backend.call_count, 2);
+}
+
+TEST(TextMeasureCacheTest, EvictsLeastRecentlyUsed) {
+  auto cache = std::make_shared<TextMeasureCache>(2);
+  FakeMeasureBackend backend;
+  std::vector<MeasureFunction> measures;
+  std::vector<std::shared_ptr<DomNode>> nodes;
+  for (uint32_t i = 0; i < 3; ++i) {
+    auto text = "label " + std::to_string(i);
+    nodes.push_back(MakeTextNode(i + 1, text, 16));
+    measures.push_back(cache->Wrap(nodes.back(), backend.Bind(text, 16)));
+  }
+  measures[0](100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  measures[1](100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  measures[0](100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  measures[2](100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  EXPECT_EQ(backend.call_count, 3);
+  measures[0](100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  EXPECT_EQ(backend.call_count, 3);
+  measures[1](100, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+  EXPECT_EQ(backend.call_count, 4);
+  EXPECT_EQ(cache->GetStats().evict_count, 2);
+}
+
+TEST(TextMeasureCacheTest, ListMeasuresEachLabelOnce) {
+  // 一个 500 项的列表，只有 20 种不同的文案，每轮排版对每个文本测两种约束，共 5 轮，中间回收重建一次
+  constexpr uint32_t kItemCount = 500;
+  constexpr uint32_t kLabelCount = 20;
+  constexpr int kPasses = 5;
+  FakeMeasureBackend backend;
+  auto cache = std::make_shared<TextMeasureCache>();
+  std::vector<MeasureFunction> measures;
+  std::vector<std::shared_ptr<DomNode>> nodes;
+  auto build = [&](uint32_t first_id) {
+    measures.clear();
+    nodes.clear();
+    for (uint32_t i = 0; i < kItemCount; ++i) {
+      auto text = "list item label number " + std::to_string(i % kLabelCount);
+      nodes.push_back(MakeTextNode(first_id + i, text, 14));
+      measures.push_back(cache->Wrap(nodes.back(), backend.Bind(text, 14)));
+    }
+  };
+  auto run = [&]() {
+    for (int pass = 0; pass < kPasses; ++pass) {
+      for (auto& measure : measures) {
+        measure(320, LayoutMeasureMode::AtMost, NAN, LayoutMeasureMode::Undefined, nullptr);
+        measure(280, LayoutMeasureMode::Exactly, NAN, LayoutMeasureMode::Undefined, nullptr);
+      }
+    }
+  };
+  build(1);
+  run();
+  build(kItemCount + 1);
+  run();
+
+  auto stats = cache->GetStats();
+  EXPECT_EQ(backend.call_count, kLabelCount * 2);
+  EXPECT_EQ(stats.miss_count, kLabelCount * 2);
+  EXPECT_EQ(stats.hit_count + stats.miss_count, kItemCount * 2 * kPasses * 2);
+}
+
+}  // namespace testing
+}  // namespace dom
+}  // namespace hippy
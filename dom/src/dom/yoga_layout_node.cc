@@ -33,65 +33,46 @@ static std::atomic<int64_t> global_measure_function_key{0};
 static std::map<int64_t, MeasureFunction> measure_function_map;
 static std::mutex mutex;
 
-const std::map<std::string, YGOverflow> kOverflowMap = {
+constexpr LayoutKeyword<YGOverflow> kOverflowKeywords[] = {
     {"visible", YGOverflowVisible}, {"hidden", YGOverflowHidden}, {"scroll", YGOverflowScroll}};
 
-const std::map<std::string, YGFlexDirection> kFlexDirectionMap = {{"row", YGFlexDirectionRow},
-                                                                  {"row-reverse", YGFlexDirectionRowReverse},
-                                                                  {"column", YGFlexDirectionColumn},
-                                                                  {"column-reverse", YGFlexDirectionColumnReverse}};
-const std::map<std::string, YGWrap> kWrapModeMap = {
+constexpr LayoutKeyword<YGFlexDirection> kFlexDirectionKeywords[] = {{"row", YGFlexDirectionRow},
+                                                                     {"row-reverse", YGFlexDirectionRowReverse},
+                                                                     {"column", YGFlexDirectionColumn},
+                                                                     {"column-reverse", YGFlexDirectionColumnReverse}};
+constexpr LayoutKeyword<YGWrap> kWrapModeKeywords[] = {
     {"nowrap", YGWrapNoWrap}, {"wrap", YGWrapWrap}, {"wrap-reverse", YGWrapWrapReverse}};
 
-const std::map<std::string, YGJustify> kJustifyMap = {
+constexpr LayoutKeyword<YGJustify> kJustifyKeywords[] = {
     {"flex-start", YGJustifyFlexStart},     {"center", YGJustifyCenter},
     {"flex-end", YGJustifyFlexEnd},         {"space-between", YGJustifySpaceBetween},
     {"space-around", YGJustifySpaceAround}, {"space-evenly", YGJustifySpaceEvenly}};
 
-const std::map<std::string, YGAlign> kAlignMap = {{"auto", YGAlignAuto},
-                                                  {"flex-start", YGAlignFlexStart},
-                                                  {"center", YGAlignCenter},
-                                                  {"flex-end", YGAlignFlexEnd},
-                                                  {"stretch", YGAlignStretch},
-                                                  {"baseline", YGAlignBaseline},
-                                                  {"space-between", YGAlignSpaceBetween},
-                                                  {"space-around", YGAlignSpaceAround}};
-
-const std::map<std::string, YGEdge> kMarginMap = {
-    {"margin", YGEdgeAll},         {"marginVertical", YGEdgeVertical}, {"marginHorizontal", YGEdgeHorizontal},
-    {"marginLeft", YGEdgeLeft},    {"marginTop", YGEdgeTop},           {"marginRight", YGEdgeRight},
-    {"marginBottom", YGEdgeBottom}};
-
-const std::map<std::string, YGEdge> kPaddingMap = {
-    {"padding", YGEdgeAll},         {"paddingVertical", YGEdgeVertical}, {"paddingHorizontal", YGEdgeHorizontal},
-    {"paddingLeft", YGEdgeLeft},    {"paddingTop", YGEdgeTop},           {"paddingRight", YGEdgeRight},
-    {"paddingBottom", YGEdgeBottom}};
-
-const std::map<std::string, YGEdge> kPositionMap = {
-    {"left", YGEdgeLeft}, {"top", YGEdgeTop}, {"right", YGEdgeRight}, {"bottom", YGEdgeBottom}};
-
-const std::map<std::string, YGEdge> kBorderMap = {{"borderWidth", YGEdgeAll},
-                                                  {"borderLeftWidth", YGEdgeLeft},
-                                                  {"borderTopWidth", YGEdgeTop},
-                                                  {"borderRightWidth", YGEdgeRight},
-                                                  {"borderBottomWidth", YGEdgeBottom}};
-
-const std::map<std::string, YGPositionType> kPositionTypeMap = {
+constexpr LayoutKeyword<YGAlign> kAlignKeywords[] = {{"auto", YGAlignAuto},
+                                                     {"flex-start", YGAlignFlexStart},
+                                                     {"center", YGAlignCenter},
+                                                     {"flex-end", YGAlignFlexEnd},
+                                                     {"stretch", YGAlignStretch},
+                                                     {"baseline", YGAlignBaseline},
+                                                     {"space-between", YGAlignSpaceBetween},
+                                                     {"space-around", YGAlignSpaceAround}};
+
+constexpr LayoutKeyword<YGPositionType> kPositionTypeKeywords[] = {
     {"static", YGPositionTypeStatic}, {"relative", YGPositionTypeRelative}, {"absolute", YGPositionTypeAbsolute}};
 
-const std::map<std::string, YGDisplay> kDisplayTypeMap = {{"flex", YGDisplayFlex}, {"none", YGDisplayNone}};
+constexpr LayoutKeyword<YGDisplay> kDisplayTypeKeywords[] = {{"flex", YGDisplayFlex}, {"none", YGDisplayNone}};
 
-const std::map<std::string, YGDirection> kDirectionMap = {
+constexpr LayoutKeyword<YGDirection> kDirectionKeywords[] = {
     {"inherit", YGDirectionInherit}, {"ltr", YGDirectionLTR}, {"rtl", YGDirectionRTL}};
 
 #define YG_SET_NUMBER_PERCENT_AUTO_DECL(NAME)                                                      \
-  void YogaLayoutNode::SetYG##NAME(std::shared_ptr<footstone::value::HippyValue> hippy_value) {    \
-    footstone::value::HippyValue::Type type = hippy_value->GetType();                              \
+  void YogaLayoutNode::SetYG##NAME(const footstone::value::HippyValue& hippy_value) {              \
+    footstone::value::HippyValue::Type type = hippy_value.GetType();                               \
     if (type == footstone::value::HippyValue::Type::kNumber) {                                     \
-      auto value = static_cast<float>(hippy_value->ToDoubleChecked());                             \
+      auto value = static_cast<float>(hippy_value.ToDoubleChecked());                              \
       YGNodeStyleSet##NAME(yoga_node_, value);                                                     \
     } else if (type == footstone::value::HippyValue::Type::kString) {                              \
-      std::string value = hippy_value->ToStringChecked();                                          \
+      std::string value = hippy_value.ToStringChecked();                                           \
       if (value == "auto") {                                                                       \
         YGNodeStyleSet##NAME##Auto(yoga_node_);                                                    \
       } else if (value.at(value.length() - 1) == '%') {                                            \
@@ -105,13 +86,13 @@ const std::map<std::string, YGDirection> kDirectionMap = {
   }
 
 #define YG_SET_NUMBER_PERCENT_DECL(NAME)                                                           \
-  void YogaLayoutNode::SetYG##NAME(std::shared_ptr<footstone::value::HippyValue> hippy_value) {    \
-    footstone::value::HippyValue::Type type = hippy_value->GetType();                              \
+  void YogaLayoutNode::SetYG##NAME(const footstone::value::HippyValue& hippy_value) {              \
+    footstone::value::HippyValue::Type type = hippy_value.GetType();                               \
     if (type == footstone::value::HippyValue::Type::kNumber) {                                     \
-      auto value = static_cast<float>(hippy_value->ToDoubleChecked());                             \
+      auto value = static_cast<float>(hippy_value.ToDoubleChecked());                              \
       YGNodeStyleSet##NAME(yoga_node_, value);                                                     \
     } else if (type == footstone::value::HippyValue::Type::kString) {                              \
-      std::string value = hippy_value->ToStringChecked();                                          \
+      std::string value = hippy_value.ToStringChecked();                                           \
       if (value.at(value.length() - 1) == '%') {                                                   \
         YGNodeStyleSet##NAME##Percent(yoga_node_, std::stof(value.substr(0, value.length() - 1))); \
       } else {                                                                                     \
@@ -122,118 +103,55 @@ const std::map<std::string, YGDirection> kDirectionMap = {
     }                                                                                              \
   }
 
-#define YG_SET_EDGE_NUMBER_PRECENT_DECL(NAME)                                                                \
-  void YogaLayoutNode::SetYG##NAME(YGEdge edge, std::shared_ptr<footstone::value::HippyValue> hippy_value) { \
-    footstone::value::HippyValue::Type type = hippy_value->GetType();                                        \
-    if (type == footstone::value::HippyValue::Type::kNumber) {                                               \
-      auto value = static_cast<float>(hippy_value->ToDoubleChecked());                                       \
-      YGNodeStyleSet##NAME(yoga_node_, edge, value);                                                         \
-    } else if (type == footstone::value::HippyValue::Type::kString) {                                        \
-      std::string value = hippy_value->ToStringChecked();                                                    \
-      if (value.at(value.length() - 1) == '%') {                                                             \
-        YGNodeStyleSet##NAME##Percent(yoga_node_, edge, std::stof(value.substr(0, value.length() - 1)));     \
-      } else {                                                                                               \
-        FOOTSTONE_DCHECK(false);                                                                             \
-      }                                                                                                      \
-    } else {                                                                                                 \
-      FOOTSTONE_DCHECK(false);                                                                               \
-    }                                                                                                        \
-  }
-
-#define YG_SET_EDGE_NUMBER_PERCENT_AUTO_DECL(NAME)                                                           \
-  void YogaLayoutNode::SetYG##NAME(YGEdge edge, std::shared_ptr<footstone::value::HippyValue> hippy_value) { \
-    footstone::value::HippyValue::Type type = hippy_value->GetType();                                        \
-    if (type == footstone::value::HippyValue::Type::kNumber) {                                               \
-      float value = static_cast<float>(hippy_value->ToDoubleChecked());                                      \
-      YGNodeStyleSet##NAME(yoga_node_, edge, value);                                                         \
-    } else if (type == footstone::value::HippyValue::Type::kString) {                                        \
-      std::string value = hippy_value->ToStringChecked();                                                    \
-      if (value == "auto") {                                                                                 \
-        YGNodeStyleSet##NAME##Auto(yoga_node_, edge);                                                        \
-      } else if (value.at(value.length() - 1) == '%') {                                                      \
-        YGNodeStyleSet##NAME##Percent(yoga_node_, edge, std::stof(value.substr(0, value.length() - 1)));     \
-      } else {                                                                                               \
-        FOOTSTONE_DCHECK(false);                                                                             \
-      }                                                                                                      \
-    } else {                                                                                                 \
-      FOOTSTONE_DCHECK(false);                                                                               \
-    }                                                                                                        \
-  }
-
-#define YG_SET_EDGE_NUMBER_DECL(NAME)                                                                        \
-  void YogaLayoutNode::SetYG##NAME(YGEdge edge, std::shared_ptr<footstone::value::HippyValue> hippy_value) { \
-    footstone::value::HippyValue::Type type = hippy_value->GetType();                                        \
-    if (type == footstone::value::HippyValue::Type::kNumber) {                                               \
-      float value = static_cast<float>(hippy_value->ToDoubleChecked());                                      \
-      YGNodeStyleSet##NAME(yoga_node_, edge, value);                                                         \
-    } else {                                                                                                 \
-      FOOTSTONE_DCHECK(false);                                                                               \
-    }                                                                                                        \
-  }
-
-static YGOverflow GetFlexOverflow(const std::string& overflow) {
-  auto iter = kOverflowMap.find(overflow);
-  if (iter == kOverflowMap.end()) return YGOverflowVisible;
-  return iter->second;
-}
-
-static YGFlexDirection GetFlexDirection(const std::string& flex_direction) {
-  auto iter = kFlexDirectionMap.find(flex_direction);
-  if (iter == kFlexDirectionMap.end()) return YGFlexDirectionColumn;
-  return iter->second;
-}
-
-static YGWrap GetFlexWrapMode(const std::string& wrap_mode) {
-  auto iter = kWrapModeMap.find(wrap_mode);
-  if (iter == kWrapModeMap.end()) return YGWrapNoWrap;
-  return iter->second;
-}
-
-static YGJustify GetFlexJustify(const std::string& justify_content) {
-  auto iter = kJustifyMap.find(justify_content);
-  if (iter == kJustifyMap.end()) return YGJustifyFlexStart;
-  return iter->second;
-}
-
-static YGAlign GetFlexAlign(const std::string& align) {
-  auto iter = kAlignMap.find(align);
-  if (iter == kAlignMap.end()) return YGAlignStretch;
-  return iter->second;
-}
-
-#define YG_EDGE_DECL(NAME)                                 \
-  static YGEdge Get##NAME##Edge(const std::string& edge) { \
-    auto iter = k##NAME##Map.find(edge);                   \
-    FOOTSTONE_CHECK(iter != k##NAME##Map.end());           \
-    return iter->second;                                   \
+#define YG_SET_EDGE_NUMBER_PRECENT_DECL(NAME)                                                            \
+  void YogaLayoutNode::SetYG##NAME(YGEdge edge, const footstone::value::HippyValue& hippy_value) {       \
+    footstone::value::HippyValue::Type type = hippy_value.GetType();                                     \
+    if (type == footstone::value::HippyValue::Type::kNumber) {                                           \
+      auto value = static_cast<float>(hippy_value.ToDoubleChecked());                                    \
+      YGNodeStyleSet##NAME(yoga_node_, edge, value);                                                     \
+    } else if (type == footstone::value::HippyValue::Type::kString) {                                    \
+      std::string value = hippy_value.ToStringChecked();                                                 \
+      if (value.at(value.length() - 1) == '%') {                                                         \
+        YGNodeStyleSet##NAME##Percent(yoga_node_, edge, std::stof(value.substr(0, value.length() - 1))); \
+      } else {                                                                                           \
+        FOOTSTONE_DCHECK(false);                                                                         \
+      }                                                                                                  \
+    } else {                                                                                             \
+      FOOTSTONE_DCHECK(false);                                                                           \
+    }                                                                                                    \
+  }
+
+#define YG_SET_EDGE_NUMBER_PERCENT_AUTO_DECL(NAME)                                                       \
+  void YogaLayoutNode::SetYG##NAME(YGEdge edge, const footstone::value::HippyValue& hippy_value) {       \
+    footstone::value::HippyValue::Type type = hippy_value.GetType();                                     \
+    if (type == footstone::value::HippyValue::Type::kNumber) {                                           \
+      float value = static_cast<float>(hippy_value.ToDoubleChecked());                                   \
+      YGNodeStyleSet##NAME(yoga_node_, edge, value);                                                     \
+    } else if (type == footstone::value::HippyValue::Type::kString) {                                    \
+      std::string value = hippy_value.ToStringChecked();                                                 \
+      if (value == "auto") {                                                                             \
+        YGNodeStyleSet##NAME##Auto(yoga_node_, edge);                                                    \
+      } else if (value.at(value.length() - 1) == '%') {                                                  \
+        YGNodeStyleSet##NAME##Percent(yoga_node_, edge, std::stof(value.substr(0, value.length() - 1))); \
+      } else {                                                                                           \
+        FOOTSTONE_DCHECK(false);                                                                         \
+      }                                                                                                  \
+    } else {                                                                                             \
+      FOOTSTONE_DCHECK(false);                                                                           \
+    }                                                                                                    \
+  }
+
+#define YG_SET_EDGE_NUMBER_DECL(NAME)                                                              \
+  void YogaLayoutNode::SetYG##NAME(YGEdge edge, const footstone::value::HippyValue& hippy_value) { \
+    footstone::value::HippyValue::Type type = hippy_value.GetType();                               \
+    if (type == footstone::value::HippyValue::Type::kNumber) {                                     \
+      float value = static_cast<float>(hippy_value.ToDoubleChecked());                             \
+      YGNodeStyleSet##NAME(yoga_node_, edge, value);                                               \
+    } else {                                                                                       \
+      FOOTSTONE_DCHECK(false);                                                                     \
+    }                                                                                              \
   }
 
-YG_EDGE_DECL(Margin)
-
-YG_EDGE_DECL(Padding)
-
-YG_EDGE_DECL(Border)
-
-YG_EDGE_DECL(Position)
-
-static YGPositionType GetPositionType(const std::string& position_type) {
-  auto iter = kPositionTypeMap.find(position_type);
-  if (iter == kPositionTypeMap.end()) return YGPositionTypeRelative;
-  return iter->second;
-}
-
-static YGDisplay GetDisplayType(const std::string& display_type) {
-  auto iter = kDisplayTypeMap.find(display_type);
-  if (iter == kDisplayTypeMap.end()) return YGDisplayFlex;
-  return iter->second;
-}
-
-static YGDirection GetDirection(const std::string& direction) {
-  auto iter = kDirectionMap.find(direction);
-  if (iter == kDirectionMap.end()) return YGDirectionLTR;
-  return iter->second;
-}
-
 static YGEdge GetYGEdgeFromEdge(hippy::dom::Edge edge) {
   if (hippy::dom::Edge::EdgeLeft == edge) {
     return YGEdge::YGEdgeLeft;
@@ -406,297 +324,127 @@ void YogaLayoutNode::Reset() { YGNodeReset(yoga_node_); }
 void YogaLayoutNode::Parser(
     const std::unordered_map<std::string, std::shared_ptr<footstone::value::HippyValue>>& style_update,
     const std::vector<std::string>& style_delete) {
-  if (style_update.find(kWidth) != style_update.end()) {
-    auto hippy_value = style_update.find(kWidth)->second;
-    SetYGWidth(hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kWidth);
-    if (it != style_delete.end()) YGNodeStyleSetWidth(yoga_node_, NAN);
-  }
-  if (style_update.find(kMinWidth) != style_update.end()) {
-    auto hippy_value = style_update.find(kMinWidth)->second;
-    SetYGMinWidth(hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kMinWidth);
-    if (it != style_delete.end()) YGNodeStyleSetMinWidth(yoga_node_, NAN);
-  }
-  if (style_update.find(kMaxWidth) != style_update.end()) {
-    auto hippy_value = style_update.find(kMaxWidth)->second;
-    SetYGMaxWidth(hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kMaxWidth);
-    if (it != style_delete.end()) YGNodeStyleSetMaxWidth(yoga_node_, NAN);
-  }
-  if (style_update.find(kHeight) != style_update.end()) {
-    auto hippy_value = style_update.find(kHeight)->second;
-    SetYGHeight(hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kHeight);
-    if (it != style_delete.end()) YGNodeStyleSetHeight(yoga_node_, NAN);
-  }
-  if (style_update.find(kMinHeight) != style_update.end()) {
-    auto hippy_value = style_update.find(kMinHeight)->second;
-    SetYGMinHeight(hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kMinHeight);
-    if (it != style_delete.end()) YGNodeStyleSetMinHeight(yoga_node_, NAN);
-  }
-  if (style_update.find(kMaxHeight) != style_update.end()) {
-    auto hippy_value = style_update.find(kMaxHeight)->second;
-    SetYGMaxHeight(hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kMaxHeight);
-    if (it != style_delete.end()) YGNodeStyleSetMaxHeight(yoga_node_, NAN);
-  }
-  if (style_update.find(kFlex) != style_update.end()) {
-    SetFlex(static_cast<float>(style_update.find(kFlex)->second->ToDoubleChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kFlex);
-    if (it != style_delete.end()) YGNodeStyleSetFlex(yoga_node_, 0);
-  }
-  if (style_update.find(kFlexGrow) != style_update.end()) {
-    SetFlexGrow(static_cast<float>(style_update.find(kFlexGrow)->second->ToDoubleChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kFlexGrow);
-    if (it != style_delete.end()) YGNodeStyleSetFlexGrow(yoga_node_, 0);
-  }
-  if (style_update.find(kFlexShrink) != style_update.end()) {
-    SetFlexShrink(static_cast<float>(style_update.find(kFlexShrink)->second->ToDoubleChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kFlexShrink);
-    if (it != style_delete.end()) YGNodeStyleSetFlexShrink(yoga_node_, 0);
-  }
-  if (style_update.find(kFlexBasis) != style_update.end()) {
-    auto dom_value = style_update.find(kFlexBasis)->second;
-    SetYGFlexBasis(dom_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kFlexBasis);
-    if (it != style_delete.end()) YGNodeStyleSetFlexBasis(yoga_node_, NAN);
-  }
-  if (style_update.find(kDirection) != style_update.end()) {
-    SetDirection(GetDirection(style_update.find(kDirection)->second->ToStringChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kDirection);
-    if (it != style_delete.end()) YGNodeStyleSetDirection(yoga_node_, YGDirectionLTR);
-  }
-  if (style_update.find(kFlexDirection) != style_update.end()) {
-    SetFlexDirection(GetFlexDirection(style_update.find(kFlexDirection)->second->ToStringChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kFlexDirection);
-    if (it != style_delete.end()) YGNodeStyleSetFlexDirection(yoga_node_, YGFlexDirectionColumn);
-  }
-  if (style_update.find(kFlexWrap) != style_update.end()) {
-    SetFlexWrap(GetFlexWrapMode(style_update.find(kFlexWrap)->second->ToStringChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kFlexWrap);
-    if (it != style_delete.end()) YGNodeStyleSetFlexWrap(yoga_node_, YGWrapNoWrap);
-  }
-  if (style_update.find(kAilgnSelf) != style_update.end()) {
-    SetAlignSelf(GetFlexAlign(style_update.find(kAilgnSelf)->second->ToStringChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kAilgnSelf);
-    if (it != style_delete.end()) YGNodeStyleSetAlignSelf(yoga_node_, YGAlignAuto);
-  }
-  if (style_update.find(kAlignItems) != style_update.end()) {
-    SetAlignItems(GetFlexAlign(style_update.find(kAlignItems)->second->ToStringChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kAlignItems);
-    if (it != style_delete.end()) YGNodeStyleSetAlignItems(yoga_node_, YGAlignStretch);
-  }
-  if (style_update.find(kJustifyContent) != style_update.end()) {
-    SetJustifyContent(GetFlexJustify(style_update.find(kJustifyContent)->second->ToStringChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kJustifyContent);
-    if (it != style_delete.end()) YGNodeStyleSetJustifyContent(yoga_node_, YGJustifyFlexStart);
-  }
-  if (style_update.find(kOverflow) != style_update.end()) {
-    SetOverflow(GetFlexOverflow(style_update.find(kOverflow)->second->ToStringChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kOverflow);
-    if (it != style_delete.end()) YGNodeStyleSetOverflow(yoga_node_, YGOverflowVisible);
-  }
-  if (style_update.find(kDisplay) != style_update.end()) {
-    SetDisplay(GetDisplayType(style_update.find(kDisplay)->second->ToStringChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kDisplay);
-    if (it != style_delete.end()) YGNodeStyleSetDisplay(yoga_node_, YGDisplayFlex);
-  }
-  if (style_update.find(kMargin) != style_update.end()) {
-    auto hippy_value = style_update.find(kMargin)->second;
-    SetYGMargin(GetMarginEdge(kMargin), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kMargin);
-    if (it != style_delete.end()) YGNodeStyleSetMargin(yoga_node_, YGEdgeAll, 0);
-  }
-  if (style_update.find(kMarginVertical) != style_update.end()) {
-    auto hippy_value = style_update.find(kMarginVertical)->second;
-    SetYGMargin(GetMarginEdge(kMarginVertical), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kMarginVertical);
-    if (it != style_delete.end()) YGNodeStyleSetMargin(yoga_node_, YGEdgeVertical, 0);
-  }
-  if (style_update.find(kMarginHorizontal) != style_update.end()) {
-    auto hippy_value = style_update.find(kMarginHorizontal)->second;
-    SetYGMargin(GetMarginEdge(kMarginHorizontal), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kMarginHorizontal);
-    if (it != style_delete.end()) YGNodeStyleSetMargin(yoga_node_, YGEdgeHorizontal, 0);
-  }
-  if (style_update.find(kMarginLeft) != style_update.end()) {
-    auto hippy_value = style_update.find(kMarginLeft)->second;
-    SetYGMargin(GetMarginEdge(kMarginLeft), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kMarginLeft);
-    if (it != style_delete.end()) YGNodeStyleSetMargin(yoga_node_, YGEdgeLeft, 0);
-  }
-  if (style_update.find(kMarginRight) != style_update.end()) {
-    auto hippy_value = style_update.find(kMarginRight)->second;
-    SetYGMargin(GetMarginEdge(kMarginRight), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kMarginRight);
-    if (it != style_delete.end()) YGNodeStyleSetMargin(yoga_node_, YGEdgeRight, 0);
-  }
-  if (style_update.find(kMarginTop) != style_update.end()) {
-    auto hippy_value = style_update.find(kMarginTop)->second;
-    SetYGMargin(GetMarginEdge(kMarginTop), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kMarginTop);
-    if (it != style_delete.end()) YGNodeStyleSetMargin(yoga_node_, YGEdgeTop, 0);
-  }
-  if (style_update.find(kMarginBottom) != style_update.end()) {
-    auto hippy_value = style_update.find(kMarginBottom)->second;
-    SetYGMargin(GetMarginEdge(kMarginBottom), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kMarginBottom);
-    if (it != style_delete.end()) YGNodeStyleSetMargin(yoga_node_, YGEdgeBottom, 0);
-  }
-  if (style_update.find(kPadding) != style_update.end()) {
-    auto hippy_value = style_update.find(kPadding)->second;
-    SetYGPadding(GetPaddingEdge(kPadding), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kPadding);
-    if (it != style_delete.end()) YGNodeStyleSetPadding(yoga_node_, YGEdgeAll, 0);
-  }
-  if (style_update.find(kPaddingVertical) != style_update.end()) {
-    auto hippy_value = style_update.find(kPaddingVertical)->second;
-    SetYGPadding(GetPaddingEdge(kPaddingVertical), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kPaddingVertical);
-    if (it != style_delete.end()) YGNodeStyleSetPadding(yoga_node_, YGEdgeVertical, 0);
-  }
-  if (style_update.find(kPaddingHorizontal) != style_update.end()) {
-    auto hippy_value = style_update.find(kPaddingHorizontal)->second;
-    SetYGPadding(GetPaddingEdge(kPaddingHorizontal), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kPaddingHorizontal);
-    if (it != style_delete.end()) YGNodeStyleSetPadding(yoga_node_, YGEdgeHorizontal, 0);
-  }
-  if (style_update.find(kPaddingLeft) != style_update.end()) {
-    auto hippy_value = style_update.find(kPaddingLeft)->second;
-    SetYGPadding(GetPaddingEdge(kPaddingLeft), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kPaddingLeft);
-    if (it != style_delete.end()) YGNodeStyleSetPadding(yoga_node_, YGEdgeLeft, 0);
-  }
-  if (style_update.find(kPaddingRight) != style_update.end()) {
-    auto hippy_value = style_update.find(kPaddingRight)->second;
-    SetYGPadding(GetPaddingEdge(kPaddingRight), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kPaddingRight);
-    if (it != style_delete.end()) YGNodeStyleSetPadding(yoga_node_, YGEdgeRight, 0);
-  }
-  if (style_update.find(kPaddingTop) != style_update.end()) {
-    auto hippy_value = style_update.find(kPaddingTop)->second;
-    SetYGPadding(GetPaddingEdge(kPaddingTop), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kPaddingTop);
-    if (it != style_delete.end()) YGNodeStyleSetPadding(yoga_node_, YGEdgeTop, 0);
-  }
-  if (style_update.find(kPaddingBottom) != style_update.end()) {
-    auto hippy_value = style_update.find(kPaddingBottom)->second;
-    SetYGPadding(GetPaddingEdge(kPaddingBottom), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kPaddingBottom);
-    if (it != style_delete.end()) YGNodeStyleSetPadding(yoga_node_, YGEdgeBottom, 0);
-  }
-  if (style_update.find(kBorderWidth) != style_update.end()) {
-    auto hippy_value = style_update.find(kBorderWidth)->second;
-    SetYGBorder(GetBorderEdge(kBorderWidth), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kBorderWidth);
-    if (it != style_delete.end()) YGNodeStyleSetBorder(yoga_node_, YGEdgeAll, 0);
-  }
-  if (style_update.find(kBorderLeftWidth) != style_update.end()) {
-    auto hippy_value = style_update.find(kBorderLeftWidth)->second;
-    SetYGBorder(GetBorderEdge(kBorderLeftWidth), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kBorderLeftWidth);
-    if (it != style_delete.end()) YGNodeStyleSetBorder(yoga_node_, YGEdgeLeft, 0);
-  }
-  if (style_update.find(kBorderTopWidth) != style_update.end()) {
-    auto hippy_value = style_update.find(kBorderTopWidth)->second;
-    SetYGBorder(GetBorderEdge(kBorderTopWidth), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kBorderTopWidth);
-    if (it != style_delete.end()) YGNodeStyleSetBorder(yoga_node_, YGEdgeTop, 0);
-  }
-  if (style_update.find(kBorderRightWidth) != style_update.end()) {
-    auto hippy_value = style_update.find(kBorderRightWidth)->second;
-    SetYGBorder(GetBorderEdge(kBorderRightWidth), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kBorderRightWidth);
-    if (it != style_delete.end()) YGNodeStyleSetBorder(yoga_node_, YGEdgeRight, 0);
-  }
-  if (style_update.find(kBorderBottomWidth) != style_update.end()) {
-    auto hippy_value = style_update.find(kBorderBottomWidth)->second;
-    SetYGBorder(GetBorderEdge(kBorderBottomWidth), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kBorderBottomWidth);
-    if (it != style_delete.end()) YGNodeStyleSetBorder(yoga_node_, YGEdgeBottom, 0);
-  }
-  if (style_update.find(kLeft) != style_update.end()) {
-    auto hippy_value = style_update.find(kLeft)->second;
-    SetYGPosition(GetPositionEdge(kLeft), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kLeft);
-    if (it != style_delete.end()) YGNodeStyleSetPosition(yoga_node_, YGEdgeLeft, 0);
-  }
-  if (style_update.find(kRight) != style_update.end()) {
-    auto hippy_value = style_update.find(kRight)->second;
-    SetYGPosition(GetPositionEdge(kRight), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kRight);
-    if (it != style_delete.end()) YGNodeStyleSetPosition(yoga_node_, YGEdgeRight, 0);
-  }
-  if (style_update.find(kTop) != style_update.end()) {
-    auto hippy_value = style_update.find(kTop)->second;
-    SetYGPosition(GetPositionEdge(kTop), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kTop);
-    if (it != style_delete.end()) YGNodeStyleSetPosition(yoga_node_, YGEdgeTop, 0);
-  }
-  if (style_update.find(kBottom) != style_update.end()) {
-    auto hippy_value = style_update.find(kBottom)->second;
-    SetYGPosition(GetPositionEdge(kBottom), hippy_value);
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kBottom);
-    if (it != style_delete.end()) YGNodeStyleSetPosition(yoga_node_, YGEdgeBottom, 0);
-  }
-  if (style_update.find(kPosition) != style_update.end()) {
-    SetPositionType(GetPositionType(style_update.find(kPosition)->second->ToStringChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kPosition);
-    if (it != style_delete.end()) YGNodeStyleSetPositionType(yoga_node_, YGPositionTypeRelative);
-  }
-  if (style_update.find(kAspectRatio) != style_update.end()) {
-    SetAspectRatio(static_cast<float>(style_update.find(kAspectRatio)->second->ToDoubleChecked()));
-  } else {
-    auto it = std::find(style_delete.begin(), style_delete.end(), kAspectRatio);
-    if (it != style_delete.end()) YGNodeStyleSetAspectRatio(yoga_node_, 0);
+  LayoutStyleParser parser(style_update, style_delete);
+  parser.Dispatch([this](LayoutStyle style, const footstone::value::HippyValue& value) { SetStyle(style, value); },
+                  [this](LayoutStyle style) { ResetStyle(style); });
+}
+
+void YogaLayoutNode::SetStyle(LayoutStyle style, const footstone::value::HippyValue& value) {
+  switch (style) {
+    case LayoutStyle::kWidth: SetYGWidth(value); break;
+    case LayoutStyle::kMinWidth: SetYGMinWidth(value); break;
+    case LayoutStyle::kMaxWidth: SetYGMaxWidth(value); break;
+    case LayoutStyle::kHeight: SetYGHeight(value); break;
+    case LayoutStyle::kMinHeight: SetYGMinHeight(value); break;
+    case LayoutStyle::kMaxHeight: SetYGMaxHeight(value); break;
+    case LayoutStyle::kFlex: SetFlex(static_cast<float>(value.ToDoubleChecked())); break;
+    case LayoutStyle::kFlexGrow: SetFlexGrow(static_cast<float>(value.ToDoubleChecked())); break;
+    case LayoutStyle::kFlexShrink: SetFlexShrink(static_cast<float>(value.ToDoubleChecked())); break;
+    case LayoutStyle::kFlexBasis: SetYGFlexBasis(value); break;
+    case LayoutStyle::kDirection:
+      SetDirection(LookupLayoutKeyword(kDirectionKeywords, value.ToStringChecked(), YGDirectionLTR));
+      break;
+    case LayoutStyle::kFlexDirection:
+      SetFlexDirection(LookupLayoutKeyword(kFlexDirectionKeywords, value.ToStringChecked(), YGFlexDirectionColumn));
+      break;
+    case LayoutStyle::kFlexWrap:
+      SetFlexWrap(LookupLayoutKeyword(kWrapModeKeywords, value.ToStringChecked(), YGWrapNoWrap));
+      break;
+    case LayoutStyle::kAlignSelf:
+      SetAlignSelf(LookupLayoutKeyword(kAlignKeywords, value.ToStringChecked(), YGAlignStretch));
+      break;
+    case LayoutStyle::kAlignItems:
+      SetAlignItems(LookupLayoutKeyword(kAlignKeywords, value.ToStringChecked(), YGAlignStretch));
+      break;
+    case LayoutStyle::kAlignContent:
+      SetAlignContent(LookupLayoutKeyword(kAlignKeywords, value.ToStringChecked(), YGAlignStretch));
+      break;
+    case LayoutStyle::kJustifyContent:
+      SetJustifyContent(LookupLayoutKeyword(kJustifyKeywords, value.ToStringChecked(), YGJustifyFlexStart));
+      break;
+    case LayoutStyle::kOverflow:
+      SetOverflow(LookupLayoutKeyword(kOverflowKeywords, value.ToStringChecked(), YGOverflowVisible));
+      break;
+    case LayoutStyle::kDisplay:
+      SetDisplay(LookupLayoutKeyword(kDisplayTypeKeywords, value.ToStringChecked(), YGDisplayFlex));
+      break;
+    case LayoutStyle::kPosition:
+      SetPositionType(LookupLayoutKeyword(kPositionTypeKeywords, value.ToStringChecked(), YGPositionTypeRelative));
+      break;
+    case LayoutStyle::kAspectRatio: SetAspectRatio(static_cast<float>(value.ToDoubleChecked())); break;
+    case LayoutStyle::kMargin: SetYGMargin(YGEdgeAll, value); break;
+    case LayoutStyle::kMarginVertical: SetYGMargin(YGEdgeVertical, value); break;
+    case LayoutStyle::kMarginHorizontal: SetYGMargin(YGEdgeHorizontal, value); break;
+    case LayoutStyle::kMarginLeft: SetYGMargin(YGEdgeLeft, value); break;
+    case LayoutStyle::kMarginRight: SetYGMargin(YGEdgeRight, value); break;
+    case LayoutStyle::kMarginTop: SetYGMargin(YGEdgeTop, value); break;
+    case LayoutStyle::kMarginBottom: SetYGMargin(YGEdgeBottom, value); break;
+    case LayoutStyle::kPadding: SetYGPadding(YGEdgeAll, value); break;
+    case LayoutStyle::kPaddingVertical: SetYGPadding(YGEdgeVertical, value); break;
+    case LayoutStyle::kPaddingHorizontal: SetYGPadding(YGEdgeHorizontal, value); break;
+    case LayoutStyle::kPaddingLeft: SetYGPadding(YGEdgeLeft, value); break;
+    case LayoutStyle::kPaddingRight: SetYGPadding(YGEdgeRight, value); break;
+    case LayoutStyle::kPaddingTop: SetYGPadding(YGEdgeTop, value); break;
+    case LayoutStyle::kPaddingBottom: SetYGPadding(YGEdgeBottom, value); break;
+    case LayoutStyle::kBorderWidth: SetYGBorder(YGEdgeAll, value); break;
+    case LayoutStyle::kBorderLeftWidth: SetYGBorder(YGEdgeLeft, value); break;
+    case LayoutStyle::kBorderTopWidth: SetYGBorder(YGEdgeTop, value); break;
+    case LayoutStyle::kBorderRightWidth: SetYGBorder(YGEdgeRight, value); break;
+    case LayoutStyle::kBorderBottomWidth: SetYGBorder(YGEdgeBottom, value); break;
+    case LayoutStyle::kLeft: SetYGPosition(YGEdgeLeft, value); break;
+    case LayoutStyle::kRight: SetYGPosition(YGEdgeRight, value); break;
+    case LayoutStyle::kTop: SetYGPosition(YGEdgeTop, value); break;
+    case LayoutStyle::kBottom: SetYGPosition(YGEdgeBottom, value); break;
+    default: break;
   }
+}
 
-  if (style_update.find(kAlignContent) != style_update.end()) {
-    SetAlignContent(GetFlexAlign(style_update.find(kAlignContent)->second->ToStringChecked()));
+void YogaLayoutNode::ResetStyle(LayoutStyle style) {
+  switch (style) {
+    case LayoutStyle::kWidth: YGNodeStyleSetWidth(yoga_node_, NAN); break;
+    case LayoutStyle::kMinWidth: YGNodeStyleSetMinWidth(yoga_node_, NAN); break;
+    case LayoutStyle::kMaxWidth: YGNodeStyleSetMaxWidth(yoga_node_, NAN); break;
+    case LayoutStyle::kHeight: YGNodeStyleSetHeight(yoga_node_, NAN); break;
+    case LayoutStyle::kMinHeight: YGNodeStyleSetMinHeight(yoga_node_, NAN); break;
+    case LayoutStyle::kMaxHeight: YGNodeStyleSetMaxHeight(yoga_node_, NAN); break;
+    case LayoutStyle::kFlex: YGNodeStyleSetFlex(yoga_node_, 0); break;
+    case LayoutStyle::kFlexGrow: YGNodeStyleSetFlexGrow(yoga_node_, 0); break;
+    case LayoutStyle::kFlexShrink: YGNodeStyleSetFlexShrink(yoga_node_, 0); break;
+    case LayoutStyle::kFlexBasis: YGNodeStyleSetFlexBasis(yoga_node_, NAN); break;
+    case LayoutStyle::kDirection: YGNodeStyleSetDirection(yoga_node_, YGDirectionLTR); break;
+    case LayoutStyle::kFlexDirection: YGNodeStyleSetFlexDirection(yoga_node_, YGFlexDirectionColumn); break;
+    case LayoutStyle::kFlexWrap: YGNodeStyleSetFlexWrap(yoga_node_, YGWrapNoWrap); break;
+    case LayoutStyle::kAlignSelf: YGNodeStyleSetAlignSelf(yoga_node_, YGAlignAuto); break;
+    case LayoutStyle::kAlignItems: YGNodeStyleSetAlignItems(yoga_node_, YGAlignStretch); break;
+    case LayoutStyle::kJustifyContent: YGNodeStyleSetJustifyContent(yoga_node_, YGJustifyFlexStart); break;
+    case LayoutStyle::kOverflow: YGNodeStyleSetOverflow(yoga_node_, YGOverflowVisible); break;
+    case LayoutStyle::kDisplay: YGNodeStyleSetDisplay(yoga_node_, YGDisplayFlex); break;
+    case LayoutStyle::kPosition: YGNodeStyleSetPositionType(yoga_node_, YGPositionTypeRelative); break;
+    case LayoutStyle::kAspectRatio: YGNodeStyleSetAspectRatio(yoga_node_, 0); break;
+    case LayoutStyle::kMargin: YGNodeStyleSetMargin(yoga_node_, YGEdgeAll, 0); break;
+    case LayoutStyle::kMarginVertical: YGNodeStyleSetMargin(yoga_node_, YGEdgeVertical, 0); break;
+    case LayoutStyle::kMarginHorizontal: YGNodeStyleSetMargin(yoga_node_, YGEdgeHorizontal, 0); break;
+    case LayoutStyle::kMarginLeft: YGNodeStyleSetMargin(yoga_node_, YGEdgeLeft, 0); break;
+    case LayoutStyle::kMarginRight: YGNodeStyleSetMargin(yoga_node_, YGEdgeRight, 0); break;
+    case LayoutStyle::kMarginTop: YGNodeStyleSetMargin(yoga_node_, YGEdgeTop, 0); break;
+    case LayoutStyle::kMarginBottom: YGNodeStyleSetMargin(yoga_node_, YGEdgeBottom, 0); break;
+    case LayoutStyle::kPadding: YGNodeStyleSetPadding(yoga_node_, YGEdgeAll, 0); break;
+    case LayoutStyle::kPaddingVertical: YGNodeStyleSetPadding(yoga_node_, YGEdgeVertical, 0); break;
+    case LayoutStyle::kPaddingHorizontal: YGNodeStyleSetPadding(yoga_node_, YGEdgeHorizontal, 0); break;
+    case LayoutStyle::kPaddingLeft: YGNodeStyleSetPadding(yoga_node_, YGEdgeLeft, 0); break;
+    case LayoutStyle::kPaddingRight: YGNodeStyleSetPadding(yoga_node_, YGEdgeRight, 0); break;
+    case LayoutStyle::kPaddingTop: YGNodeStyleSetPadding(yoga_node_, YGEdgeTop, 0); break;
+    case LayoutStyle::kPaddingBottom: YGNodeStyleSetPadding(yoga_node_, YGEdgeBottom, 0); break;
+    case LayoutStyle::kBorderWidth: YGNodeStyleSetBorder(yoga_node_, YGEdgeAll, 0); break;
+    case LayoutStyle::kBorderLeftWidth: YGNodeStyleSetBorder(yoga_node_, YGEdgeLeft, 0); break;
+    case LayoutStyle::kBorderTopWidth: YGNodeStyleSetBorder(yoga_node_, YGEdgeTop, 0); break;
+    case LayoutStyle::kBorderRightWidth: YGNodeStyleSetBorder(yoga_node_, YGEdgeRight, 0); break;
+    case LayoutStyle::kBorderBottomWidth: YGNodeStyleSetBorder(yoga_node_, YGEdgeBottom, 0); break;
+    case LayoutStyle::kLeft: YGNodeStyleSetPosition(yoga_node_, YGEdgeLeft, 0); break;
+    case LayoutStyle::kRight: YGNodeStyleSetPosition(yoga_node_, YGEdgeRight, 0); break;
+    case LayoutStyle::kTop: YGNodeStyleSetPosition(yoga_node_, YGEdgeTop, 0); break;
+    case LayoutStyle::kBottom: YGNodeStyleSetPosition(yoga_node_, YGEdgeBottom, 0); break;
+    default: break;
   }
 }
 
@@ -769,5 +517,12 @@ void YogaLayoutNode::Deallocate() {
 
 std::shared_ptr<LayoutNode> CreateLayoutNode() { return std::make_shared<YogaLayoutNode>(); }
 
+std::shared_ptr<LayoutNode> CreateLayoutNode(const std::shared_ptr<DomArena>& arena) {
+  return arena->MakeShared<YogaLayoutNode>();
+}
+
+// Yoga 布局时会修改全局状态 (generation count, 递归深度等), 不能在多个线程上同时计算
+bool IsConcurrentLayoutSupported() { return false; }
+
 }  // namespace dom
 }  // namespace hippy
@@ -0,0 +1,72 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "footstone/string_view.h"
+
+namespace hippy {
+inline namespace driver {
+inline namespace base {
+
+/**
+ * code cache 的磁盘存储，每个脚本一个条目，条目文件由定长头部和原始二进制数据组成。
+ * 头部记录引擎版本标识（V8 为 CachedDataVersionTag，包含版本与 flags）、源码 hash 和数据校验和，
+ * 任何一项不匹配的条目都只删除自身。写入先落临时文件再 rename，目录总大小超过上限时按最近使用时间淘汰。
+ */
+class CodeCacheStore {
+ public:
+  using string_view = footstone::string_view;
+
+  static constexpr size_t kDefaultMaxSize = 20 * 1024 * 1024;
+
+  struct Entry {
+    uint64_t source_hash = 0;
+    std::string data;
+  };
+
+  CodeCacheStore(const string_view& dir, uint32_t engine_tag, size_t max_size = kDefaultMaxSize);
+
+  static uint64_t HashSource(const std::string& source);
+
+  bool Exists(const std::string& name) const;
+  // 读取并校验条目，校验失败时删除该条目；源码 hash 由调用方在源码就绪后比较
+  bool Load(const std::string& name, Entry& entry) const;
+  bool Store(const std::string& name, uint64_t source_hash, const std::string& data) const;
+  void Remove(const std::string& name) const;
+
+ private:
+  std::string GetEntryPath(const std::string& name) const;
+  bool PrepareDir() const;
+  void Trim(const std::string& keep_path) const;
+
+  std::string dir_;
+  uint32_t engine_tag_;
+  size_t max_size_;
+};
+
+}  // namespace base
+}  // namespace driver
+}  // namespace hippy
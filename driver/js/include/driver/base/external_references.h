@@ -0,0 +1,53 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace hippy {
+inline namespace driver {
+inline namespace base {
+
+/**
+ * 启动快照中引用到的 native 函数地址表。快照只记录地址在表中的下标，恢复时按下标换成当前进程的地址，
+ * 因此生成和使用快照的必须是同一个二进制，表的顺序由静态初始化顺序决定。
+ */
+class ExternalReferences {
+ public:
+  static void Register(intptr_t address);
+  static bool Contains(intptr_t address);
+  // 以 0 结尾，供 V8 使用；首次调用后表不再变化
+  static const intptr_t* Get();
+};
+
+class ExternalReferenceRegistrar {
+ public:
+  explicit ExternalReferenceRegistrar(intptr_t address) { ExternalReferences::Register(address); }
+};
+
+}  // namespace base
+}  // namespace driver
+}  // namespace hippy
+
+#define REGISTER_EXTERNAL_REFERENCES(FUNC_NAME) \
+  static hippy::ExternalReferenceRegistrar FUNC_NAME##ExternalReferenceRegistrar(reinterpret_cast<intptr_t>(FUNC_NAME));
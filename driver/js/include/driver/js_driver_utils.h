@@ -49,6 +49,14 @@ class JsDriverUtils {
                                                                 int64_t group_id,
                                                                 bool is_reload);
 
+  /**
+   * 在 task_runner 上用独立的 isolate 执行 bootstrap 并生成 V8 启动快照，通过 V8VMInitParam 的
+   * kUseSnapshot 和 snapshot_blob 使用。global_config 会被 bootstrap 读取，只有与 InitInstance 传入的一致时
+   * 新的 scope 才会从快照恢复，否则按原流程初始化。失败或非 V8 引擎时 blob 为空
+   */
+  static void CreateSnapshot(const std::shared_ptr<TaskRunner>& task_runner,
+                             const string_view& global_config,
+                             std::function<void(byte_string&& blob)>&& callback);
   static void InitInstance(const std::shared_ptr<Engine>& engine,
                            const std::shared_ptr<VMInitParam>& param,
                            const string_view& global_config,
@@ -24,6 +24,8 @@
 
 #include "driver/modules/module_base.h"
 #include "driver/napi/callback_info.h"
+#include "footstone/time_delta.h"
+#include "footstone/time_point.h"
 
 class Scope;
 
@@ -41,6 +43,10 @@ public:
 
 private:
   void UpdateFrame(const std::shared_ptr<Scope>& scope);
+  // 把帧开始时间同步给 JS 线程的 TaskRunner，idle task 据此避开帧生产的时间
+  void FeedFrameDeadline(const std::shared_ptr<Scope>& scope);
+  footstone::TimePoint last_frame_time_;
+  footstone::TimeDelta frame_interval_;
   int32_t frame_id_;
   uint64_t listener_id_;
   bool has_event_listener_;
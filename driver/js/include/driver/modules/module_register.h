@@ -23,6 +23,7 @@
 #pragma once
 
 #include "footstone/string_view.h"
+#include "driver/base/external_references.h"
 #include "driver/napi/callback_info.h"
 #include "driver/scope.h"
 
@@ -33,11 +34,8 @@
     FOOTSTONE_CHECK(scope);                                                                     \
     auto target = std::static_pointer_cast<Module>(scope->GetModuleObject(#Module));            \
     target->Function(info, data);                                                               \
-  }
-
-#ifndef REGISTER_EXTERNAL_REFERENCES
-#define REGISTER_EXTERNAL_REFERENCES(FUNC_NAME)
-#endif
+  }                                                                                             \
+  REGISTER_EXTERNAL_REFERENCES(Name)
 
 #define GEN_INVOKE_CB(Module, Function) \
   GEN_INVOKE_CB_INTERNAL(Module, Function, Invoke##Module##Function)
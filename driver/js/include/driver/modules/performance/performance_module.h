@@ -23,6 +23,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "driver/scope.h"
 #include "driver/napi/js_ctx_value.h"
@@ -31,6 +32,9 @@ namespace hippy {
 inline namespace driver {
 inline namespace module {
 
+// 把条目包装成对应子类的 JS 实例数组
+std::shared_ptr<CtxValue> CreatePerformanceEntryArray(const std::shared_ptr<Scope>& scope,
+                                                      const std::vector<std::shared_ptr<PerformanceEntry>>& entries);
 std::shared_ptr<ClassTemplate<Performance>> RegisterPerformance(const std::weak_ptr<Scope>& weak_scope);
 
 }
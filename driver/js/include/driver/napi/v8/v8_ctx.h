@@ -40,13 +40,19 @@ namespace hippy {
 inline namespace driver {
 inline namespace napi {
 
+class V8ScriptStream;
+
 class V8Ctx : public Ctx {
  public:
   using unicode_string_view = footstone::string_view;
 
   explicit V8Ctx(v8::Isolate* isolate);
+  // 接管从启动快照中反序列化出来的 context
+  V8Ctx(v8::Isolate* isolate, v8::Local<v8::Context> context);
 
   ~V8Ctx() {
+    code_cache_script_map_.clear();
+    snapshot_items_.clear();
     context_persistent_.Reset();
     global_persistent_.Reset();
   }
@@ -164,8 +170,32 @@ class V8Ctx : public Ctx {
       bool is_use_code_cache,
       unicode_string_view* cache,
       bool is_copy);
+  // 创建后需在后台线程运行 V8ScriptStream::RunParseTask
+  std::shared_ptr<V8ScriptStream> CreateScriptStream();
+  // 用流式解析的结果编译并运行脚本，data 为完整的 UTF-8 源码，须与流入 stream 的内容一致
+  std::shared_ptr<CtxValue> RunScript(
+      const std::shared_ptr<V8ScriptStream>& stream,
+      const unicode_string_view& data,
+      const unicode_string_view& file_name,
+      bool is_use_code_cache,
+      unicode_string_view* cache);
+  // 开启后保留生成了 code cache 的脚本，供执行后重新生成 code cache
+  inline void SetRetainScriptForCodeCache(bool is_retain) { is_retain_script_for_code_cache_ = is_retain; }
+  // 执行后重新生成的 code cache 包含执行期间已编译的函数，二次启动时不必再 lazy compile，调用后释放对脚本的引用
+  bool CreateCodeCacheAfterExecute(const unicode_string_view& file_name, std::string& cache);
 
   virtual void SetDefaultContext(const std::shared_ptr<v8::SnapshotCreator>& creator);
+  /**
+   * 启动快照：生成快照的 context 记录 DefineClass 和 NewInstance 的结果，随 context 一起写入快照；
+   * 恢复出的 context 在 native 侧按相同顺序重新初始化时直接返回快照中的对象，只重建 native 侧的状态
+   */
+  inline void RecordForSnapshot() { snapshot_mode_ = SnapshotMode::kRecord; }
+  // 调用前须执行完 bootstrap，返回 false 表示 bootstrap 期间创建了无法写入快照的对象
+  bool AddToSnapshot(const std::shared_ptr<v8::SnapshotCreator>& creator, const std::string& snapshot_tag);
+  // snapshot_tag 与生成快照时不一致时返回 false，此时不能使用该 context
+  bool RestoreFromSnapshot(const std::string& snapshot_tag);
+  // native 侧重新初始化结束后调用，检查回放的顺序与快照一致
+  bool FinishRestoreFromSnapshot();
 
   virtual void ThrowException(const std::shared_ptr<CtxValue>& exception) override;
   virtual void ThrowException(const unicode_string_view& exception) override;
@@ -179,6 +209,7 @@ class V8Ctx : public Ctx {
   void SetExternalData(void* data) override;
   virtual std::shared_ptr<ClassDefinition> GetClassDefinition(const string_view& name) override;
 
+  // 超过 Serializer::kMaxReusedBuffersSize 的结果直接接管 reused_buffer 的内存，否则拷贝并保留 reused_buffer
   std::string GetSerializationBuffer(const std::shared_ptr<CtxValue>& value,
                                      std::string& reused_buffer);
   void SetAlignedPointerInEmbedderData(int index, intptr_t address);
@@ -186,17 +217,38 @@ class V8Ctx : public Ctx {
   v8::Isolate* isolate_;
   v8::Persistent<v8::ObjectTemplate> global_persistent_;
   v8::Persistent<v8::Context> context_persistent_;
-  std::unordered_map<void*, void*> func_external_data_map_;
   std::unordered_map<string_view, std::shared_ptr<V8ClassDefinition>> template_map_;
 
  private:
+  enum class SnapshotMode {
+    kNone, kRecord, kReplay
+  };
+
   v8::Local<v8::FunctionTemplate> CreateTemplate(const std::unique_ptr<FunctionWrapper>& wrapper);
+  v8::Local<v8::Value> CreateCallbackData(const std::unique_ptr<FunctionWrapper>& wrapper);
+  uint32_t AddFunctionWrapper(const std::unique_ptr<FunctionWrapper>& wrapper);
+  void RecordSnapshotItem(char kind, v8::Local<v8::Data> item);
+  template<typename T>
+  v8::Local<T> ReplaySnapshotItem(v8::Local<v8::Context> context, char kind);
   std::shared_ptr<CtxValue> InternalRunScript(
       v8::Local<v8::Context> context,
       v8::Local<v8::String> source,
       const unicode_string_view& file_name,
       bool is_use_code_cache,
       unicode_string_view* cache);
+  void RetainScriptForCodeCache(const unicode_string_view& file_name, v8::Local<v8::Script> script);
+
+  bool is_retain_script_for_code_cache_ = false;
+  std::unordered_map<unicode_string_view, v8::Global<v8::UnboundScript>> code_cache_script_map_;
+  // 带 data 的 callback 以下标作为模板的 callback data，context 的 embedder data 指向该表
+  std::vector<FunctionWrapper*> function_wrapper_table_;
+  SnapshotMode snapshot_mode_ = SnapshotMode::kNone;
+  bool is_snapshot_compatible_ = true;
+  std::string snapshot_item_kinds_;
+  std::vector<v8::Global<v8::Data>> snapshot_items_;
+  std::vector<v8::Global<v8::Object>> snapshot_instances_;
+  size_t snapshot_replay_index_ = 0;
+  uint32_t snapshot_table_size_ = 0;
 };
 
 }
@@ -0,0 +1,87 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wconversion"
+#include "v8/v8.h"
+#pragma clang diagnostic pop
+
+namespace hippy {
+inline namespace driver {
+inline namespace napi {
+
+/**
+ * 流式编译的 UTF-8 脚本源。加载线程通过 Append 逐块写入，RunParseTask 在后台线程边接收边解析，
+ * 全部写入后调用 Finish，最后由 V8Ctx::RunScript 在 JS 线程完成编译。
+ * 每块数据都记录了长度和哈希，IsSameContent 用于确认最终内容与流入 V8 的数据一致（如未被拦截器改写）。
+ */
+class V8ScriptStream {
+ public:
+  // 需在 JS 线程创建
+  explicit V8ScriptStream(v8::Isolate* isolate);
+  ~V8ScriptStream();
+
+  V8ScriptStream(const V8ScriptStream&) = delete;
+  V8ScriptStream& operator=(const V8ScriptStream&) = delete;
+
+  // 任意线程调用，Finish 之后的数据会被忽略
+  void Append(const uint8_t* data, size_t length);
+  void Finish();
+  // 在后台线程运行 V8 的解析任务，直到 Finish 且所有数据解析完
+  void RunParseTask();
+  void WaitForParse();
+  bool IsSameContent(const std::string& content);
+
+  inline size_t GetLength() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return length_;
+  }
+
+  inline v8::ScriptCompiler::StreamedSource* GetStreamedSource() {
+    return streamed_source_.get();
+  }
+
+ private:
+  class SourceStream;
+
+  SourceStream* source_stream_;  // 由 streamed_source_ 持有
+  std::unique_ptr<v8::ScriptCompiler::StreamedSource> streamed_source_;
+  std::unique_ptr<v8::ScriptCompiler::ScriptStreamingTask> task_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool is_parse_done_;
+  size_t length_;
+  std::vector<std::pair<size_t, size_t>> chunks_;  // 每块的长度和哈希
+};
+
+}
+}
+}
@@ -22,11 +22,16 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 #include "footstone/string_view.h"
+#include "footstone/task_runner.h"
 #include "driver/performance/performance_entry.h"
+#include "driver/performance/performance_entry_buffer.h"
+#include "driver/performance/performance_observer.h"
 #include "driver/performance/performance_resource_timing.h"
 #include "driver/performance/performance_navigation_timing.h"
 #include "driver/performance/performance_paint_timing.h"
@@ -37,10 +42,11 @@ inline namespace performance {
 
 extern const char* kPerfNavigationHippyInit;
 
-class Performance {
+class Performance : public std::enable_shared_from_this<Performance> {
  public:
   using string_view = footstone::string_view;
   using TimePoint = footstone::TimePoint;
+  using TaskRunner = footstone::runner::TaskRunner;
 
   struct PerformanceEntryFilterOptions {
     string_view name;
@@ -50,8 +56,11 @@ class Performance {
 
   Performance();
 
-  inline void SetResourceTimingBufferSize(uint32_t max_size) {
-    resource_timing_max_buffer_size_ = max_size;
+  void SetResourceTimingBufferSize(uint32_t max_size);
+
+  // 观察者回调所在的线程，未设置时在插入条目时同步回调
+  inline void SetTaskRunner(const std::shared_ptr<TaskRunner>& runner) {
+    task_runner_ = runner;
   }
 
   inline const TimePoint& GetTimeOrigin() {
@@ -80,18 +89,50 @@ class Performance {
   std::vector<std::shared_ptr<PerformanceEntry>> GetEntriesByType(PerformanceEntry::Type type);
   string_view ToJSON();
 
+  // 按插入顺序遍历某一类型的条目，不复制条目
+  template <typename Visitor>
+  void ForEachEntry(PerformanceEntry::Type type, Visitor&& visitor) const {
+    const auto& buffer = buffers_[static_cast<size_t>(type)];
+    for (size_t i = 0; i < buffer.GetSize(); ++i) {
+      visitor(buffer.At(i).entry);
+    }
+  }
+
+  // buffered 为 true 时先把缓冲区中已有的条目投递给观察者
+  void Observe(const std::shared_ptr<PerformanceObserver>& observer,
+               const std::vector<PerformanceEntry::Type>& types,
+               bool buffered);
+  void Disconnect(const std::shared_ptr<PerformanceObserver>& observer);
+  void ClearObservers();
+
   static TimePoint Now();
 
  private:
+  static constexpr size_t kEntryTypeCount = static_cast<size_t>(PerformanceEntry::Type::kPaint) + 1;
+
+  struct InternedName {
+    const string_view* name;
+    uint32_t ref_count;
+  };
+
   bool InsertEntry(const std::shared_ptr<PerformanceEntry>& entry);
-  void RemoveEntry(const string_view& name);
+  std::shared_ptr<PerformanceEntry> FindLastEntry(const string_view& name, PerformanceEntry::Type type);
   void RemoveEntry(PerformanceEntry::Type type);
   void RemoveEntry(const string_view& name, PerformanceEntry::Type type);
-
-  std::unordered_map<string_view, std::vector<std::shared_ptr<PerformanceEntry>>> name_map_;
-  std::unordered_map<PerformanceEntry::Type, std::vector<std::shared_ptr<PerformanceEntry>>> type_map_;
-  uint32_t resource_timing_current_buffer_size_;
-  uint32_t resource_timing_max_buffer_size_;
+  uint32_t InternName(const string_view& name);
+  bool FindNameId(const string_view& name, uint32_t& name_id) const;
+  void ReleaseName(uint32_t name_id);
+  void NotifyObservers(const std::shared_ptr<PerformanceEntry>& entry);
+  void FlushObservers();
+
+  std::array<PerformanceEntryBuffer, kEntryTypeCount> buffers_;
+  // 条目名统一转成 utf16 后驻留，缓冲区中只保存名字的 id
+  std::unordered_map<string_view, uint32_t> name_ids_;
+  std::vector<InternedName> names_;
+  std::vector<uint32_t> free_name_ids_;
+  std::vector<std::shared_ptr<PerformanceObserver>> observers_;
+  std::weak_ptr<TaskRunner> task_runner_;
+  bool is_flush_pending_;
   TimePoint time_origin_;
 };
 
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "footstone/string_view.h"
 #include "footstone/time_point.h"
 #include "footstone/time_delta.h"
@@ -30,7 +32,7 @@ namespace hippy {
 inline namespace driver {
 inline namespace performance {
 
-class PerformanceEntry {
+class PerformanceEntry : public std::enable_shared_from_this<PerformanceEntry> {
  public:
   using string_view = footstone::string_view;
   using TimePoint = footstone::TimePoint;
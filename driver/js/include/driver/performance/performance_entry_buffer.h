@@ -0,0 +1,118 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2023 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "driver/performance/performance_entry.h"
+
+namespace hippy {
+inline namespace driver {
+inline namespace performance {
+
+/**
+ * 定长环形缓冲区，按插入顺序保存同一类型的条目。槽位在首次插入时一次性分配，
+ * 之后插入不再分配内存，写满后覆盖最旧的条目。
+ */
+class PerformanceEntryBuffer {
+ public:
+  struct Slot {
+    uint32_t name_id = 0;
+    std::shared_ptr<PerformanceEntry> entry;
+  };
+
+  PerformanceEntryBuffer() = default;
+
+  inline size_t GetCapacity() const { return capacity_; }
+  inline size_t GetSize() const { return size_; }
+  inline bool IsFull() const { return size_ >= capacity_; }
+
+  // 下标 0 为最旧的条目
+  inline const Slot& At(size_t index) const { return slots_[(head_ + index) % capacity_]; }
+
+  // 写满时覆盖并返回最旧的条目，否则返回空槽位
+  Slot Push(uint32_t name_id, const std::shared_ptr<PerformanceEntry>& entry);
+
+  // 按插入顺序移除满足条件的条目，被移除的槽位交给 on_remove，返回移除的数量
+  template <typename Predicate, typename Callback>
+  size_t RemoveIf(Predicate&& predicate, Callback&& on_remove) {
+    size_t kept = 0;
+    for (size_t i = 0; i < size_; ++i) {
+      auto& slot = SlotAt(i);
+      if (predicate(static_cast<const Slot&>(slot))) {
+        on_remove(static_cast<const Slot&>(slot));
+      } else {
+        if (kept != i) {
+          SlotAt(kept) = std::move(slot);
+        }
+        ++kept;
+      }
+    }
+    for (size_t i = kept; i < size_; ++i) {
+      SlotAt(i) = Slot();
+    }
+    auto removed = size_ - kept;
+    size_ = kept;
+    return removed;
+  }
+
+  template <typename Callback>
+  void Clear(Callback&& on_remove) {
+    RemoveIf([](const Slot&) { return true; }, std::forward<Callback>(on_remove));
+    head_ = 0;
+  }
+
+  // 调整容量，缩小时保留最旧的条目
+  template <typename Callback>
+  void Resize(size_t capacity, Callback&& on_remove) {
+    auto size = std::min(size_, capacity);
+    for (size_t i = size; i < size_; ++i) {
+      on_remove(static_cast<const Slot&>(SlotAt(i)));
+    }
+    std::vector<Slot> slots;
+    if (size > 0) {
+      slots.resize(capacity);
+      for (size_t i = 0; i < size; ++i) {
+        slots[i] = std::move(SlotAt(i));
+      }
+    }
+    slots_ = std::move(slots);
+    capacity_ = capacity;
+    head_ = 0;
+    size_ = size;
+  }
+
+ private:
+  inline Slot& SlotAt(size_t index) { return slots_[(head_ + index) % capacity_]; }
+
+  std::vector<Slot> slots_;
+  size_t capacity_ = 0;
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
+}
+}
+}
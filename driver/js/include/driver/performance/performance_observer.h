@@ -0,0 +1,87 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2023 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "driver/performance/performance_entry.h"
+
+namespace hippy {
+inline namespace driver {
+inline namespace performance {
+
+/**
+ * 对应 W3C PerformanceObserver，新条目先进入观察者自己的队列，由 Performance 在 JS 线程上批量回调，
+ * 因此回调时 resource、navigation 等条目的时间字段已经在同一任务内填充完毕。
+ */
+class PerformanceObserver : public std::enable_shared_from_this<PerformanceObserver> {
+ public:
+  using Entries = std::vector<std::shared_ptr<PerformanceEntry>>;
+  using Callback = std::function<void(Entries&& entries)>;
+
+  explicit PerformanceObserver(Callback callback);
+
+  void AddEntryType(PerformanceEntry::Type type);
+  inline void ClearEntryTypes() { type_mask_ = 0; }
+  inline bool IsObserving(PerformanceEntry::Type type) const {
+    return (type_mask_ & TypeBit(type)) != 0;
+  }
+  inline bool IsObserving() const { return type_mask_ != 0; }
+
+  void Enqueue(const std::shared_ptr<PerformanceEntry>& entry);
+  Entries TakeRecords();
+  // 队列非空时回调一次并清空队列
+  void Notify();
+
+ private:
+  static inline uint32_t TypeBit(PerformanceEntry::Type type) {
+    return 1u << static_cast<uint32_t>(type);
+  }
+
+  Callback callback_;
+  uint32_t type_mask_;
+  Entries records_;
+};
+
+// 回调给 JS 的条目列表，对应 W3C PerformanceObserverEntryList
+class PerformanceObserverEntryList {
+ public:
+  using string_view = footstone::string_view;
+  using Entries = PerformanceObserver::Entries;
+
+  explicit PerformanceObserverEntryList(Entries&& entries): entries_(std::move(entries)) {}
+
+  inline const Entries& GetEntries() const { return entries_; }
+  Entries GetEntriesByName(const string_view& name) const;
+  Entries GetEntriesByName(const string_view& name, PerformanceEntry::Type type) const;
+  Entries GetEntriesByType(PerformanceEntry::Type type) const;
+
+ private:
+  Entries entries_;
+};
+
+}
+}
+}
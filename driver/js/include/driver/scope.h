@@ -330,7 +330,10 @@ class Scope : public std::enable_shared_from_this<Scope> {
 
   void WillExit();
   void SyncInitialize();
+  // 从启动快照恢复的 context 已包含 bootstrap 的结果，只重建 native 侧的状态
+  void SyncInitializeFromSnapshot();
   void CreateContext();
+  void AttachContext(const std::shared_ptr<Ctx>& context);
   void RegisterJavascriptClasses();
 
   template<typename T>
@@ -31,6 +31,8 @@
 
 class Serializer : public v8::ValueSerializer::Delegate {
  public:
+  static constexpr size_t kMaxReusedBuffersSize = 128 * 1024;  // 128k
+
   Serializer(v8::Isolate* isolate,
              v8::Local<v8::Context> context,
              std::string& reused_buffer);
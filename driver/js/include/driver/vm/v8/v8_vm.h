@@ -40,6 +40,9 @@
 
 namespace hippy {
 inline namespace driver {
+inline namespace napi {
+class V8Ctx;
+}
 inline namespace vm {
 
 struct V8VMInitParam : public VM::VMInitParam {
@@ -52,10 +55,13 @@ struct V8VMInitParam : public VM::VMInitParam {
   v8::NearHeapLimitCallback near_heap_limit_callback;
   void* near_heap_limit_callback_data;
   V8VMInitType type;
+  // kUseSnapshot 时使用，须由同一个二进制通过 JsDriverUtils::CreateSnapshot 生成
   std::shared_ptr<v8::StartupData> snapshot_blob;
   std::any holder;
   std::basic_string<uint8_t> buffer;
   bool enable_v8_serialization;
+  // 页面空闲后用执行过的脚本重新生成 code cache
+  bool enable_code_cache_after_idle = true;
 
   static size_t HeapLimitSlowGrowthStrategy(void* data, size_t current_heap_limit,
                                             size_t initial_heap_limit) {
@@ -104,6 +110,7 @@ class V8VM : public VM {
     uncaught_exception_ = std::move(wrapper);
   }
   inline bool IsEnableV8Serialization() { return enable_v8_serialization_; }
+  inline bool IsEnableCodeCacheAfterIdle() { return enable_code_cache_after_idle_; }
   inline std::string& GetBuffer() { return serializer_reused_buffer_; }
 
 #if defined(ENABLE_INSPECTOR) && defined(JS_V8) && !defined(V8_WITHOUT_INSPECTOR)
@@ -115,6 +122,12 @@ class V8VM : public VM {
   }
 #endif
   virtual std::shared_ptr<Ctx> CreateContext() override;
+  // 未使用启动快照或 snapshot_tag 不一致时返回 nullptr
+  std::shared_ptr<V8Ctx> CreateContextFromSnapshot(const std::string& snapshot_tag);
+  inline bool HasSnapshot() { return snapshot_blob_ != nullptr; }
+  inline std::shared_ptr<v8::SnapshotCreator> GetSnapshotCreator() { return snapshot_creator_; }
+  // kCreateSnapshot 模式下调用，调用前须释放该 isolate 上所有的 V8Ctx 和 CtxValue，调用后 VM 不能再使用
+  std::string CreateSnapshotBlob();
   virtual std::shared_ptr<CtxValue> ParseJson(const std::shared_ptr<Ctx>& ctx, const string_view& json) override;
   void AddUncaughtExceptionMessageListener(const std::unique_ptr<FunctionWrapper>& wrapper) const;
   DeserializerResult Deserializer(const std::shared_ptr<Ctx>& ctx, const std::string& buffer);
@@ -138,6 +151,9 @@ class V8VM : public VM {
   std::unique_ptr<FunctionWrapper> uncaught_exception_;
   std::string serializer_reused_buffer_;
   bool enable_v8_serialization_;
+  bool enable_code_cache_after_idle_;
+  std::shared_ptr<v8::SnapshotCreator> snapshot_creator_;
+  std::shared_ptr<v8::StartupData> snapshot_blob_;
 
 #if defined(ENABLE_INSPECTOR) && !defined(V8_WITHOUT_INSPECTOR)
   std::shared_ptr<V8InspectorClientImpl> inspector_client_;
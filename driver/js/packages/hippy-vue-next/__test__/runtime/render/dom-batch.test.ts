@@ -0,0 +1,77 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import { encodeDomBatch } from '../../../src/runtime/render/dom-batch';
+
+/**
+ * render/dom-batch.ts unit test case
+ */
+describe('runtime/render/dom-batch.ts', () => {
+  it('should encode nodes in the format decoded by native DomBatch.', () => {
+    const nodes: HippyTypes.TranslatedNodes[] = [
+      [
+        {
+          id: 2,
+          pId: 1,
+          name: 'View',
+          tagName: 'div',
+          props: { style: { width: 100, height: 50.5 }, attributes: { class: 'item' } },
+        },
+        {},
+      ],
+      [
+        {
+          id: 3,
+          pId: 1,
+          name: 'Text',
+          tagName: 'p',
+          props: { text: '你好😀', onClick: () => {}, visible: true, extra: null, list: [1, 'a'] },
+        },
+        { refId: 2, relativeToRef: 1 },
+      ],
+    ];
+    // same bytes as kJsEncodedBatch in dom/src/dom/dom_batch_unittests.cc, which decodes them natively
+    const expected = [
+      0xff, 0x0d, 0x55, 0x02, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x4e, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0xf0, 0x3f, 0x22, 0x04, 0x56, 0x69, 0x65, 0x77, 0x22, 0x03, 0x64, 0x69,
+      0x76, 0x55, 0x00, 0x6f, 0x22, 0x05, 0x73, 0x74, 0x79, 0x6c, 0x65, 0x6f, 0x22, 0x05, 0x77, 0x69,
+      0x64, 0x74, 0x68, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x59, 0x40, 0x22, 0x06, 0x68, 0x65,
+      0x69, 0x67, 0x68, 0x74, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x49, 0x40, 0x7b, 0x02, 0x22,
+      0x0a, 0x61, 0x74, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x65, 0x73, 0x6f, 0x22, 0x05, 0x63, 0x6c,
+      0x61, 0x73, 0x73, 0x22, 0x04, 0x69, 0x74, 0x65, 0x6d, 0x7b, 0x01, 0x7b, 0x02, 0x4e, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x08, 0x40, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x3f, 0x22,
+      0x04, 0x54, 0x65, 0x78, 0x74, 0x22, 0x01, 0x70, 0x55, 0x01, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x40, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x3f, 0x6f, 0x22, 0x04, 0x74,
+      0x65, 0x78, 0x74, 0x53, 0x0a, 0xe4, 0xbd, 0xa0, 0xe5, 0xa5, 0xbd, 0xf0, 0x9f, 0x98, 0x80, 0x22,
+      0x07, 0x76, 0x69, 0x73, 0x69, 0x62, 0x6c, 0x65, 0x54, 0x22, 0x05, 0x65, 0x78, 0x74, 0x72, 0x61,
+      0x30, 0x22, 0x04, 0x6c, 0x69, 0x73, 0x74, 0x41, 0x02, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0xf0, 0x3f, 0x22, 0x01, 0x61, 0x24, 0x00, 0x02, 0x7b, 0x04,
+    ];
+    expect(Array.from(new Uint8Array(encodeDomBatch(nodes)))).toEqual(expected);
+  });
+
+  it('should grow the buffer for large batches.', () => {
+    const text = 'a'.repeat(10000);
+    const buffer = encodeDomBatch([[{ id: 2, pId: 1, name: 'Text', props: { text } }, {}]]);
+    const bytes = new Uint8Array(buffer);
+    expect(bytes.length).toBeGreaterThan(text.length);
+    expect(bytes[bytes.length - 1]).toEqual(1);
+  });
+});
@@ -80,6 +80,30 @@ describe('runtime/render.ts', () => {
     });
   });
 
+  describe('test node buffer', () => {
+    it('should pass nodes in one buffer when native supports it.', async () => {
+      const { SceneBuilder } = global.Hippy;
+      const createWithBuffer = jest.fn();
+      const updateWithBuffer = jest.fn();
+      global.Hippy.SceneBuilder = function SceneBuilderWithBuffer() {
+        SceneBuilder.call(this);
+        this.createWithBuffer = createWithBuffer;
+        this.updateWithBuffer = updateWithBuffer;
+      };
+      const nativeNodes = [
+        [{ id: 2, pId: 1, index: 0, name: 'View', tagName: 'div', props: {} }, {}],
+      ];
+      renderInsertChildNativeNode([nativeNodes, [], []]);
+      await nextTick();
+      renderUpdateChildNativeNode([nativeNodes, [], []]);
+      await nextTick();
+      global.Hippy.SceneBuilder = SceneBuilder;
+
+      expect(createWithBuffer).toHaveBeenCalledWith(expect.any(ArrayBuffer), true);
+      expect(updateWithBuffer).toHaveBeenCalledWith(expect.any(ArrayBuffer));
+    });
+  });
+
   describe('test renderUpdateChildNativeNode', () => {
     it('should call updateNode method in Android platform.', async () => {
       const updateNodeSpy = jest.spyOn(
@@ -0,0 +1,258 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Encode a batch of native nodes into the DomBatch binary format (dom/include/dom/dom_batch.h),
+ * so that the whole batch is handed to SceneBuilder.createWithBuffer/updateWithBuffer in one ArrayBuffer
+ * and decoded natively, instead of reading every node object field by field through the js engine.
+ *
+ * The buffer is a footstone serializer stream (V8 ValueSerializer wire format, version 13):
+ *   Header | Uint32 node count | Node * count
+ * and every node is written as
+ *   id | pid | view name | tag name | flags | [ref id | relative to ref] | props
+ */
+import type { NeedToTyped } from '../../types';
+
+// serialization tags, same as footstone::value::SerializationTag
+enum Tag {
+  VERSION = 0xFF,
+  UNDEFINED = 0x5F, // '_'
+  NULL = 0x30, // '0'
+  TRUE = 0x54, // 'T'
+  FALSE = 0x46, // 'F'
+  UINT32 = 0x55, // 'U'
+  DOUBLE = 0x4E, // 'N'
+  UTF8_STRING = 0x53, // 'S'
+  ONE_BYTE_STRING = 0x22, // '"'
+  BEGIN_JS_OBJECT = 0x6F, // 'o'
+  END_JS_OBJECT = 0x7B, // '{'
+  BEGIN_DENSE_JS_ARRAY = 0x41, // 'A'
+  END_DENSE_JS_ARRAY = 0x24, // '$'
+}
+
+const SERIALIZER_VERSION = 13;
+
+// node flags, same as DomBatch::kFlag*
+export const FLAG_HAS_REF_INFO = 1;
+
+const INITIAL_CAPACITY = 4096;
+
+class BatchWriter {
+  private buffer = new Uint8Array(INITIAL_CAPACITY);
+
+  private view = new DataView(this.buffer.buffer);
+
+  private length = 0;
+
+  public writeHeader(): void {
+    this.writeTag(Tag.VERSION);
+    this.writeVarint(SERIALIZER_VERSION);
+  }
+
+  public writeUint32(value: number): void {
+    this.writeTag(Tag.UINT32);
+    this.writeVarint(value);
+  }
+
+  public writeNumber(value: number): void {
+    // the object path converts every js number to double, keep the same HippyValue number type
+    this.reserve(9);
+    this.buffer[this.length] = Tag.DOUBLE;
+    this.view.setFloat64(this.length + 1, value, true);
+    this.length += 9;
+  }
+
+  public writeString(value: string): void {
+    let isAscii = true;
+    for (let i = 0; i < value.length; i += 1) {
+      if (value.charCodeAt(i) >= 0x80) {
+        isAscii = false;
+        break;
+      }
+    }
+    if (isAscii) {
+      this.writeTag(Tag.ONE_BYTE_STRING);
+      this.writeVarint(value.length);
+      this.reserve(value.length);
+      for (let i = 0; i < value.length; i += 1) {
+        this.buffer[this.length + i] = value.charCodeAt(i);
+      }
+      this.length += value.length;
+      return;
+    }
+    const utf8 = encodeUtf8(value);
+    this.writeTag(Tag.UTF8_STRING);
+    this.writeVarint(utf8.length);
+    this.reserve(utf8.length);
+    this.buffer.set(utf8, this.length);
+    this.length += utf8.length;
+  }
+
+  /**
+   * Write a props value the same way the object path converts it to HippyValue,
+   * functions and symbols are dropped from objects and arrays
+   */
+  public writeValue(value: NeedToTyped): void {
+    switch (typeof value) {
+      case 'number':
+        this.writeNumber(value);
+        return;
+      case 'string':
+        this.writeString(value);
+        return;
+      case 'boolean':
+        this.writeTag(value ? Tag.TRUE : Tag.FALSE);
+        return;
+      case 'object':
+        if (value === null) {
+          this.writeTag(Tag.NULL);
+        } else if (Array.isArray(value)) {
+          this.writeArray(value);
+        } else {
+          this.writeObject(value);
+        }
+        return;
+      default:
+        this.writeTag(Tag.UNDEFINED);
+    }
+  }
+
+  public release(): ArrayBuffer {
+    return this.buffer.buffer.slice(0, this.length);
+  }
+
+  private writeArray(value: NeedToTyped[]): void {
+    const items = value.filter(isSerializable);
+    this.writeTag(Tag.BEGIN_DENSE_JS_ARRAY);
+    this.writeVarint(items.length);
+    items.forEach(item => this.writeValue(item));
+    this.writeTag(Tag.END_DENSE_JS_ARRAY);
+    this.writeVarint(0);
+    this.writeVarint(items.length);
+  }
+
+  private writeObject(value: Record<string, NeedToTyped>): void {
+    let count = 0;
+    this.writeTag(Tag.BEGIN_JS_OBJECT);
+    Object.keys(value).forEach((key) => {
+      const item = value[key];
+      if (isSerializable(item)) {
+        this.writeString(key);
+        this.writeValue(item);
+        count += 1;
+      }
+    });
+    this.writeTag(Tag.END_JS_OBJECT);
+    this.writeVarint(count);
+  }
+
+  private writeTag(tag: Tag): void {
+    this.reserve(1);
+    this.buffer[this.length] = tag;
+    this.length += 1;
+  }
+
+  private writeVarint(rawValue: number): void {
+    let value = rawValue >>> 0;
+    this.reserve(5);
+    do {
+      let byte = value & 0x7F;
+      value >>>= 7;
+      if (value) {
+        byte |= 0x80;
+      }
+      this.buffer[this.length] = byte;
+      this.length += 1;
+    } while (value);
+  }
+
+  private reserve(size: number): void {
+    if (this.length + size <= this.buffer.length) {
+      return;
+    }
+    let capacity = this.buffer.length * 2;
+    while (capacity < this.length + size) {
+      capacity *= 2;
+    }
+    const buffer = new Uint8Array(capacity);
+    buffer.set(this.buffer.subarray(0, this.length));
+    this.buffer = buffer;
+    this.view = new DataView(buffer.buffer);
+  }
+}
+
+function isSerializable(value: NeedToTyped): boolean {
+  return typeof value !== 'function' && typeof value !== 'symbol';
+}
+
+function encodeUtf8(value: string): number[] {
+  const bytes: number[] = [];
+  for (let i = 0; i < value.length; i += 1) {
+    let code = value.charCodeAt(i);
+    if (code >= 0xD800 && code <= 0xDBFF && i + 1 < value.length) {
+      const low = value.charCodeAt(i + 1);
+      if (low >= 0xDC00 && low <= 0xDFFF) {
+        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        i += 1;
+      }
+    }
+    if (code < 0x80) {
+      bytes.push(code);
+    } else if (code < 0x800) {
+      bytes.push(0xC0 | (code >> 6), 0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+      bytes.push(0xE0 | (code >> 12), 0x80 | ((code >> 6) & 0x3F), 0x80 | (code & 0x3F));
+    } else {
+      bytes.push(
+        0xF0 | (code >> 18),
+        0x80 | ((code >> 12) & 0x3F),
+        0x80 | ((code >> 6) & 0x3F),
+        0x80 | (code & 0x3F),
+      );
+    }
+  }
+  return bytes;
+}
+
+/**
+ * Encode translated nodes into one DomBatch buffer
+ *
+ * @param nodes - nodes of one create or update chunk, each one is [nativeNode, refInfo]
+ */
+export function encodeDomBatch(nodes: HippyTypes.TranslatedNodes[]): ArrayBuffer {
+  const writer = new BatchWriter();
+  writer.writeHeader();
+  writer.writeUint32(nodes.length);
+  nodes.forEach(([nativeNode, refInfo]) => {
+    const { id, pId, name = '', tagName = '', props } = nativeNode;
+    const hasRefInfo = !!refInfo && typeof refInfo.refId === 'number' && typeof refInfo.relativeToRef === 'number';
+    writer.writeNumber(id);
+    writer.writeNumber(pId);
+    writer.writeString(name);
+    writer.writeString(tagName);
+    writer.writeUint32(hasRefInfo ? FLAG_HAS_REF_INFO : 0);
+    if (hasRefInfo) {
+      writer.writeNumber(refInfo.refId as number);
+      writer.writeNumber(refInfo.relativeToRef as number);
+    }
+    writer.writeValue(props);
+  });
+  return writer.release();
+}
@@ -25,8 +25,8 @@ import { nextTick } from '@vue/runtime-core';
 
 import { isTraceEnabled, trace } from '../../util';
 import { getHippyCachedInstance } from '../../util/instance';
-import type { NativeNode } from '../../types';
 import { EventHandlerType, isNativeGesture, NativeEventMap, translateToNativeEventName } from '../../util/event';
+import { encodeDomBatch } from './dom-batch';
 
 // operation type of native node
 enum NodeOperateType {
@@ -42,7 +42,7 @@ interface BatchNativeNode {
   // operation type
   type: NodeOperateType;
   // node list
-  nodes: NativeNode[];
+  nodes: HippyTypes.TranslatedNodes[];
   eventNodes: HippyTypes.EventNode[];
   printedNodes: HippyTypes.PrintedNode[];
 }
@@ -146,17 +146,27 @@ function endBatch() {
     const sceneBuilder = new global.Hippy.SceneBuilder(rootViewId);
     // nodes need sort by index
     const needSortByIndex = true;
+    // native supports decoding a whole chunk from one buffer, skip reading nodes through the js engine
+    const supportBuffer = typeof sceneBuilder.createWithBuffer === 'function';
     // batch operations on nodes based on operation type
     chunks.forEach((chunk) => {
       switch (chunk.type) {
         case NodeOperateType.CREATE:
           printNodeOperation(chunk.printedNodes, 'createNode');
-          sceneBuilder.create(chunk.nodes, needSortByIndex);
+          if (supportBuffer) {
+            sceneBuilder.createWithBuffer(encodeDomBatch(chunk.nodes), needSortByIndex);
+          } else {
+            sceneBuilder.create(chunk.nodes, needSortByIndex);
+          }
           handleEventListeners(chunk.eventNodes, sceneBuilder);
           break;
         case NodeOperateType.UPDATE:
           printNodeOperation(chunk.printedNodes, 'updateNode');
-          sceneBuilder.update(chunk.nodes);
+          if (supportBuffer) {
+            sceneBuilder.updateWithBuffer(encodeDomBatch(chunk.nodes));
+          } else {
+            sceneBuilder.update(chunk.nodes);
+          }
           handleEventListeners(chunk.eventNodes, sceneBuilder);
           break;
         case NodeOperateType.DELETE:
@@ -0,0 +1,251 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "driver/base/code_cache_store.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "footstone/logging.h"
+#include "footstone/string_view_utils.h"
+
+namespace hippy {
+inline namespace driver {
+inline namespace base {
+
+using StringViewUtils = footstone::stringview::StringViewUtils;
+
+constexpr uint32_t kEntryMagic = 0x43435048;  // "HPCC"
+constexpr uint32_t kEntryFormatVersion = 1;
+constexpr char kEntrySuffix[] = ".hcc";
+constexpr char kTempSuffix[] = ".tmp";
+
+struct EntryHeader {
+  uint32_t magic;
+  uint32_t format_version;
+  uint32_t engine_tag;
+  uint32_t reserved;
+  uint64_t source_hash;
+  uint64_t data_length;
+  uint64_t checksum;
+};
+
+static_assert(sizeof(EntryHeader) == 40, "EntryHeader must be packed");
+
+static std::atomic<uint32_t> g_temp_file_id{0};
+
+static uint64_t Checksum(const std::string& data) {
+  return std::hash<std::string_view>{}(std::string_view(data.data(), data.size()));
+}
+
+static bool EndsWith(const std::string& str, const char* suffix) {
+  auto suffix_length = strlen(suffix);
+  return str.length() >= suffix_length && str.compare(str.length() - suffix_length, suffix_length, suffix) == 0;
+}
+
+static bool WriteFully(int fd, const void* data, size_t length) {
+  auto ptr = reinterpret_cast<const char*>(data);
+  while (length > 0) {
+    auto written = write(fd, ptr, length);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    ptr += written;
+    length -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+CodeCacheStore::CodeCacheStore(const string_view& dir, uint32_t engine_tag, size_t max_size)
+    : engine_tag_(engine_tag), max_size_(max_size) {
+  dir_ = StringViewUtils::ToStdString(StringViewUtils::ConvertEncoding(dir, string_view::Encoding::Utf8).utf8_value());
+  if (!dir_.empty() && dir_.back() != '/') {
+    dir_ += '/';
+  }
+}
+
+uint64_t CodeCacheStore::HashSource(const std::string& source) {
+  return std::hash<std::string_view>{}(std::string_view(source.data(), source.size()));
+}
+
+bool CodeCacheStore::Exists(const std::string& name) const {
+  return access(GetEntryPath(name).c_str(), F_OK) == 0;
+}
+
+bool CodeCacheStore::Load(const std::string& name, Entry& entry) const {
+  auto path = GetEntryPath(name);
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (file.fail()) {
+    FOOTSTONE_DLOG(INFO) << "CodeCacheStore Load miss, path = " << path;
+    return false;
+  }
+  EntryHeader header{};
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+  auto is_valid = file.gcount() == sizeof(header) && header.magic == kEntryMagic
+      && header.format_version == kEntryFormatVersion && header.engine_tag == engine_tag_
+      && header.data_length > 0 && header.data_length <= max_size_;
+  if (is_valid) {
+    auto length = static_cast<size_t>(header.data_length);
+    entry.data.resize(length);
+    file.read(&entry.data[0], static_cast<std::streamsize>(length));
+    is_valid = static_cast<size_t>(file.gcount()) == length
+        && file.peek() == std::ifstream::traits_type::eof()
+        && Checksum(entry.data) == header.checksum;
+  }
+  file.close();
+  if (!is_valid) {
+    FOOTSTONE_LOG(WARNING) << "CodeCacheStore Load invalid entry, path = " << path;
+    entry.data.clear();
+    unlink(path.c_str());
+    return false;
+  }
+  entry.source_hash = header.source_hash;
+  // 更新修改时间作为最近使用时间，供淘汰使用
+  utime(path.c_str(), nullptr);
+  return true;
+}
+
+bool CodeCacheStore::Store(const std::string& name, uint64_t source_hash, const std::string& data) const {
+  if (data.empty() || data.size() > max_size_ || !PrepareDir()) {
+    return false;
+  }
+  EntryHeader header{};
+  header.magic = kEntryMagic;
+  header.format_version = kEntryFormatVersion;
+  header.engine_tag = engine_tag_;
+  header.source_hash = source_hash;
+  header.data_length = data.size();
+  header.checksum = Checksum(data);
+
+  auto path = GetEntryPath(name);
+  auto temp_path = path + "." + std::to_string(g_temp_file_id.fetch_add(1)) + kTempSuffix;
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    FOOTSTONE_LOG(WARNING) << "CodeCacheStore open failed, path = " << temp_path << ", errno = " << errno;
+    return false;
+  }
+  auto is_success = WriteFully(fd, &header, sizeof(header)) && WriteFully(fd, data.data(), data.size())
+      && fsync(fd) == 0;
+  close(fd);
+  // rename 是原子的，读取方只会看到旧条目或完整的新条目
+  if (!is_success || rename(temp_path.c_str(), path.c_str()) != 0) {
+    FOOTSTONE_LOG(WARNING) << "CodeCacheStore write failed, path = " << path << ", errno = " << errno;
+    unlink(temp_path.c_str());
+    return false;
+  }
+  Trim(path);
+  return true;
+}
+
+void CodeCacheStore::Remove(const std::string& name) const {
+  unlink(GetEntryPath(name).c_str());
+}
+
+std::string CodeCacheStore::GetEntryPath(const std::string& name) const {
+  auto entry_name = name;
+  std::replace(entry_name.begin(), entry_name.end(), '/', '_');
+  char tag[9];
+  snprintf(tag, sizeof(tag), "%08x", engine_tag_);
+  return dir_ + entry_name + "_" + tag + kEntrySuffix;
+}
+
+bool CodeCacheStore::PrepareDir() const {
+  if (dir_.empty()) {
+    return false;
+  }
+  if (mkdir(dir_.c_str(), S_IRWXU) == 0 || errno == EEXIST) {
+    return true;
+  }
+  FOOTSTONE_LOG(WARNING) << "CodeCacheStore mkdir failed, dir = " << dir_ << ", errno = " << errno;
+  return false;
+}
+
+void CodeCacheStore::Trim(const std::string& keep_path) const {
+  struct FileInfo {
+    std::string path;
+    time_t modify_time;
+    size_t size;
+    bool is_entry;
+  };
+  DIR* dir = opendir(dir_.c_str());
+  if (!dir) {
+    return;
+  }
+  std::vector<FileInfo> files;
+  size_t total_size = 0;
+  struct dirent* ent;
+  struct stat st{};
+  while ((ent = readdir(dir)) != nullptr) {
+    std::string file_name = ent->d_name;
+    if (file_name == "." || file_name == ".." || EndsWith(file_name, kTempSuffix)) {
+      continue;
+    }
+    auto path = dir_ + file_name;
+    if (lstat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+      continue;
+    }
+    auto size = static_cast<size_t>(st.st_size);
+    total_size += size;
+    files.push_back({std::move(path), st.st_mtime, size, EndsWith(file_name, kEntrySuffix)});
+  }
+  closedir(dir);
+
+  // 旧版本遗留的非条目文件优先删除，其余按最近使用时间从旧到新淘汰
+  std::sort(files.begin(), files.end(), [](const FileInfo& lhs, const FileInfo& rhs) {
+    if (lhs.is_entry != rhs.is_entry) {
+      return !lhs.is_entry;
+    }
+    return lhs.modify_time < rhs.modify_time;
+  });
+  for (const auto& file: files) {
+    if (total_size <= max_size_ && file.is_entry) {
+      break;
+    }
+    if (file.path == keep_path) {
+      continue;
+    }
+    if (unlink(file.path.c_str()) == 0) {
+      FOOTSTONE_DLOG(INFO) << "CodeCacheStore evict, path = " << file.path;
+      total_size -= file.size;
+    }
+  }
+}
+
+}  // namespace base
+}  // namespace driver
+}  // namespace hippy
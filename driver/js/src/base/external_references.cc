@@ -0,0 +1,67 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "driver/base/external_references.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include "footstone/check.h"
+
+namespace hippy {
+inline namespace driver {
+inline namespace base {
+
+// 注册发生在静态初始化阶段，使用函数内静态变量避免初始化顺序问题
+static std::vector<intptr_t>& GetReferenceTable() {
+  static std::vector<intptr_t> table;
+  return table;
+}
+
+static std::once_flag table_sealed_flag;
+static bool is_table_sealed = false;
+
+void ExternalReferences::Register(intptr_t address) {
+  FOOTSTONE_CHECK(!is_table_sealed) << "external references must be registered during static initialization";
+  auto& table = GetReferenceTable();
+  if (std::find(table.begin(), table.end(), address) == table.end()) {
+    table.push_back(address);
+  }
+}
+
+bool ExternalReferences::Contains(intptr_t address) {
+  auto& table = GetReferenceTable();
+  return std::find(table.begin(), table.end(), address) != table.end();
+}
+
+const intptr_t* ExternalReferences::Get() {
+  std::call_once(table_sealed_flag, []() {
+    is_table_sealed = true;
+    GetReferenceTable().push_back(0);
+  });
+  return GetReferenceTable().data();
+}
+
+}  // namespace base
+}  // namespace driver
+}  // namespace hippy
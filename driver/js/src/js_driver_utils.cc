@@ -27,6 +27,7 @@
 #include <future>
 #include <utility>
 
+#include "driver/base/code_cache_store.h"
 #include "driver/napi/callback_info.h"
 #include "driver/napi/js_ctx.h"
 #include "driver/napi/js_ctx_value.h"
@@ -35,16 +36,19 @@
 #include "footstone/check.h"
 #include "footstone/deserializer.h"
 #include "footstone/hippy_value.h"
+#include "footstone/idle_task.h"
 #include "footstone/logging.h"
 #include "footstone/string_view_utils.h"
 #include "footstone/task.h"
 #include "footstone/task_runner.h"
+#include "footstone/time_point.h"
 #include "footstone/worker_impl.h"
 #include "vfs/file.h"
 
 #ifdef JS_V8
 #include "driver/napi/v8/v8_ctx.h"
 #include "driver/napi/v8/v8_ctx_value.h"
+#include "driver/napi/v8/v8_script_stream.h"
 #include "driver/napi/v8/v8_try_catch.h"
 #include "driver/vm/v8/v8_vm.h"
 #include "driver/napi/v8/serializer.h"
@@ -68,18 +72,26 @@ using HippyFile = hippy::vfs::HippyFile;
 using VMInitParam = hippy::VM::VMInitParam;
 using ScopeWrapper = hippy::ScopeWrapper;
 using CallbackInfo = hippy::CallbackInfo;
+using CodeCacheStore = hippy::CodeCacheStore;
+using IdleTask = footstone::IdleTask;
+using TimeDelta = footstone::TimeDelta;
 
 #ifdef JS_V8
 using V8VM = hippy::V8VM;
+using V8VMInitParam = hippy::V8VMInitParam;
 using V8Ctx = hippy::V8Ctx;
+using V8ScriptStream = hippy::V8ScriptStream;
 #endif
 
 constexpr char kBridgeName[] = "hippyBridge";
 constexpr char kWorkerRunnerName[] = "hippy_worker";
+constexpr char kScriptStreamRunnerName[] = "hippy_script_stream";
 constexpr char kGlobalKey[] = "global";
 constexpr char kHippyKey[] = "Hippy";
 constexpr char kNativeGlobalKey[] = "__HIPPYNATIVEGLOBAL__";
 constexpr char kCallHostKey[] = "hippyCallNatives";
+constexpr TimeDelta kCodeCacheRegenerateDelay = TimeDelta::FromSeconds(3);
+constexpr TimeDelta kCodeCacheIdleTimeout = TimeDelta::FromSeconds(10);
 
 #if defined(JS_V8) && defined(ENABLE_INSPECTOR) && !defined(V8_WITHOUT_INSPECTOR)
 using V8InspectorClientImpl = hippy::inspector::V8InspectorClientImpl;
@@ -92,6 +104,90 @@ using DevtoolsDataSource = hippy::devtools::DevtoolsDataSource;
 static std::unordered_map<int64_t, std::pair<std::shared_ptr<Engine>, uint32_t>> reuse_engine_map;
 static std::mutex engine_mutex;
 
+#ifdef JS_V8
+// 流式解析任务在数据到达前会阻塞线程，使用独立的线程，避免占住 UriLoader 的 worker
+static std::shared_ptr<TaskRunner> GetScriptStreamTaskRunner() {
+  static WorkerManager* worker_manager = new WorkerManager(1);
+  static std::shared_ptr<TaskRunner> runner = worker_manager->CreateTaskRunner(kScriptStreamRunnerName);
+  return runner;
+}
+
+// 首屏逻辑执行完并进入空闲后再生成，code cache 才能覆盖启动阶段执行过的函数
+static void RegenerateCodeCacheAfterIdle(const std::shared_ptr<Scope>& scope,
+                                         const string_view& file_name,
+                                         const std::shared_ptr<CodeCacheStore>& store,
+                                         const std::string& name,
+                                         uint64_t source_hash,
+                                         const std::shared_ptr<TaskRunner>& worker_task_runner) {
+  auto engine = scope->GetEngine().lock();
+  FOOTSTONE_CHECK(engine);
+  auto runner = engine->GetJsTaskRunner();
+  std::weak_ptr<Scope> weak_scope = scope;
+  std::weak_ptr<TaskRunner> weak_runner = runner;
+  runner->PostDelayedTask([weak_scope, weak_runner, file_name, store, name, source_hash, worker_task_runner]() {
+    auto runner = weak_runner.lock();
+    if (!runner) {
+      return;
+    }
+    auto task = std::make_unique<IdleTask>();
+    task->SetTimeout(kCodeCacheIdleTimeout);
+    task->SetUnit([weak_scope, file_name, store, name, source_hash, worker_task_runner](const IdleTask::IdleCbParam&) {
+      auto scope = weak_scope.lock();
+      if (!scope) {
+        return;
+      }
+      auto v8_ctx = std::static_pointer_cast<V8Ctx>(scope->GetContext());
+      std::string cache;
+      if (!v8_ctx->CreateCodeCacheAfterExecute(file_name, cache)) {
+        return;
+      }
+      worker_task_runner->PostTask([store, name, source_hash, cache = std::move(cache)]() {
+        auto flag = store->Store(name, source_hash, cache);
+        FOOTSTONE_LOG(INFO) << "code cache after idle save flag = " << flag << ", size = " << cache.length();
+        FOOTSTONE_USE(flag);
+      });
+    });
+    runner->PostIdleTask(std::move(task));
+  }, kCodeCacheRegenerateDelay);
+}
+#endif
+
+#ifdef JS_V8
+static std::string GetSnapshotTag(const string_view& global_config) {
+  auto u8_global_config = StringViewUtils::ToStdString(StringViewUtils::ConvertEncoding(
+      global_config, string_view::Encoding::Utf8).utf8_value());
+  return std::to_string(std::hash<std::string>{}(u8_global_config));
+}
+
+static bool InitializeScopeFromSnapshot(const std::shared_ptr<Scope>& scope, const string_view& global_config) {
+  auto engine = scope->GetEngine().lock();
+  FOOTSTONE_CHECK(engine);
+  auto vm = std::static_pointer_cast<V8VM>(engine->GetVM());
+  if (!vm->HasSnapshot()) {
+    return false;
+  }
+  auto context = vm->CreateContextFromSnapshot(GetSnapshotTag(global_config));
+  if (!context) {
+    FOOTSTONE_LOG(INFO) << "snapshot does not match global config, fallback to bootstrap";
+    return false;
+  }
+  scope->AttachContext(context);
+  scope->SyncInitializeFromSnapshot();
+  auto flag = context->FinishRestoreFromSnapshot();
+  FOOTSTONE_CHECK(flag) << "snapshot does not match the native initialization, it must be created by the same binary";
+  return true;
+}
+#endif
+
+static uint32_t GetCodeCacheEngineTag() {
+#ifdef JS_V8
+  // 同时包含 V8 版本和影响 code cache 的 flags
+  return v8::ScriptCompiler::CachedDataVersionTag();
+#else
+  return 0;
+#endif
+}
+
 void AsyncInitializeEngine(const std::shared_ptr<Engine>& engine,
                            const std::shared_ptr<TaskRunner>& task_runner,
                            const std::shared_ptr<VMInitParam>& param) {
@@ -236,10 +332,19 @@ void CreateScopeAndAsyncInitialize(const std::shared_ptr<Engine>& engine,
 #ifdef ENABLE_INSPECTOR
     InitDevTools(scope, engine->GetVM(), param->devtools_data_source);
 #endif
-    scope->CreateContext();
-    RegisterGlobalObjectAndGlobalConfig(scope, global_config);
-    scope->SyncInitialize();
+    auto start_time = footstone::TimePoint::Now();
+    auto is_from_snapshot = false;
+#ifdef JS_V8
+    is_from_snapshot = InitializeScopeFromSnapshot(scope, global_config);
+#endif
+    if (!is_from_snapshot) {
+      scope->CreateContext();
+      RegisterGlobalObjectAndGlobalConfig(scope, global_config);
+      scope->SyncInitialize();
+    }
     RegisterCallHostObject(scope, call_host_callback);
+    FOOTSTONE_LOG(INFO) << "scope initialized, is_from_snapshot = " << is_from_snapshot
+                        << ", cost = " << (footstone::TimePoint::Now() - start_time).ToMicroseconds() << "us";
 #if defined(JS_V8) && defined(ENABLE_INSPECTOR) && !defined(V8_WITHOUT_INSPECTOR)
     auto vm = std::static_pointer_cast<V8VM>(engine->GetVM());
     if (vm->IsDebug()) {
@@ -256,6 +361,41 @@ void CreateScopeAndAsyncInitialize(const std::shared_ptr<Engine>& engine,
   });
 }
 
+void JsDriverUtils::CreateSnapshot(const std::shared_ptr<TaskRunner>& task_runner,
+                                   const string_view& global_config,
+                                   std::function<void(byte_string&& blob)>&& callback) {
+#ifdef JS_V8
+  auto param = std::make_shared<V8VMInitParam>();
+  param->type = V8VMInitParam::V8VMInitType::kCreateSnapshot;
+  auto engine = std::make_shared<Engine>();
+  // 不注册 uncaught exception 监听，bootstrap 的异常只体现为生成失败
+  engine->AsyncInitialize(task_runner, param, nullptr);
+  task_runner->PostTask([engine = std::move(engine), global_config, callback = std::move(callback)]() mutable {
+    auto vm = std::static_pointer_cast<V8VM>(engine->GetVM());
+    auto scope = engine->CreateScope();
+    scope->CreateContext();
+    RegisterGlobalObjectAndGlobalConfig(scope, global_config);
+    scope->SyncInitialize();
+    auto context = std::static_pointer_cast<V8Ctx>(scope->GetContext());
+    auto flag = context->AddToSnapshot(vm->GetSnapshotCreator(), GetSnapshotTag(global_config));
+    // 快照中不能残留 Global 句柄，生成前须释放 scope 持有的所有 JS 对象
+    context = nullptr;
+    scope = nullptr;
+    byte_string blob;
+    if (flag) {
+      blob = vm->CreateSnapshotBlob();
+    }
+    FOOTSTONE_LOG(INFO) << "CreateSnapshot flag = " << flag << ", size = " << blob.length();
+    // isolate 由 SnapshotCreator 在当前线程 Enter，须在同一线程释放
+    vm = nullptr;
+    engine = nullptr;
+    callback(std::move(blob));
+  });
+#else
+  callback("");
+#endif
+}
+
 void JsDriverUtils::InitInstance(
     const std::shared_ptr<Engine>& engine,
     const std::shared_ptr<VMInitParam>& param,
@@ -281,48 +421,67 @@ bool JsDriverUtils::RunScript(const std::shared_ptr<Scope>& scope,
                       << ", uri = " << uri
                       << ", is_local_file = " << is_local_file;
   string_view code_cache_content;
-  uint64_t modify_time = 0;
-  string_view code_cache_path;
-  std::future<u8string> read_file_future;
+  std::string code_cache_name;
+  std::shared_ptr<CodeCacheStore> code_cache_store;
+  std::future<CodeCacheStore::Entry> read_file_future;
   auto loader = scope->GetUriLoader().lock();
   FOOTSTONE_CHECK(loader);
   auto& worker_manager = loader->GetWorkerManager();
   auto worker_task_runner = worker_manager->CreateTaskRunner(kWorkerRunnerName);
+  auto has_code_cache = false;
   if (is_use_code_cache) {
-    if (is_local_file) {
-      modify_time = HippyFile::GetFileModifyTime(uri);
-    }
-    code_cache_path = code_cache_dir + file_name + string_view("_") + string_view(std::to_string(modify_time));
-    std::promise<u8string> read_file_promise;
+    // 条目按文件名和引擎版本区分，源码是否一致由条目内记录的源码 hash 判断
+    code_cache_name = StringViewUtils::ToStdString(
+        StringViewUtils::ConvertEncoding(file_name, string_view::Encoding::Utf8).utf8_value());
+    code_cache_store = std::make_shared<CodeCacheStore>(code_cache_dir, GetCodeCacheEngineTag());
+    has_code_cache = code_cache_store->Exists(code_cache_name);
+    std::promise<CodeCacheStore::Entry> read_file_promise;
     read_file_future = read_file_promise.get_future();
-    auto engine = scope->GetEngine().lock();
-    FOOTSTONE_CHECK(engine);
-    auto func = hippy::base::MakeCopyable([p = std::move(read_file_promise), code_cache_path, code_cache_dir]() mutable {
-      u8string content;
-      HippyFile::ReadFile(code_cache_path, content, true);
-      if (content.empty()) {
-        FOOTSTONE_DLOG(INFO) << "Read code cache failed";
-        int ret = HippyFile::RmFullPath(code_cache_dir);
-        FOOTSTONE_DLOG(INFO) << "RmFullPath ret = " << ret;
-        FOOTSTONE_USE(ret);
-      } else {
-        FOOTSTONE_DLOG(INFO) << "Read code cache succ";
-      }
-      p.set_value(std::move(content));
+    auto func = hippy::base::MakeCopyable([p = std::move(read_file_promise), code_cache_store, code_cache_name]() mutable {
+      CodeCacheStore::Entry entry;
+      auto flag = code_cache_store->Load(code_cache_name, entry);
+      FOOTSTONE_DLOG(INFO) << "Read code cache flag = " << flag;
+      FOOTSTONE_USE(flag);
+      p.set_value(std::move(entry));
     });
     worker_task_runner->PostTask(std::move(func));
   }
   UriLoader::RetCode code;
   std::unordered_map<std::string, std::string> meta;
   UriLoader::bytes content;
+#ifdef JS_V8
+  // 没有可用的 code cache 时，在后台线程边加载边解析，code cache 仍和加载并行读取
+  std::shared_ptr<V8ScriptStream> script_stream;
+  if (!has_code_cache) {
+    script_stream = std::static_pointer_cast<V8Ctx>(scope->GetContext())->CreateScriptStream();
+    GetScriptStreamTaskRunner()->PostTask([script_stream]() { script_stream->RunParseTask(); });
+    loader->RequestUntrustedContent(uri, {}, [script_stream](const uint8_t* data, size_t length) {
+      script_stream->Append(data, length);
+    }, code, meta, content);
+    script_stream->Finish();
+  } else {
+    loader->RequestUntrustedContent(uri, {}, code, meta, content);
+  }
+#else
   loader->RequestUntrustedContent(uri, {}, code, meta, content);
+#endif
   auto script_content = string_view::new_from_utf8(content.c_str(), content.length());
   auto read_script_flag = false;
   if (code == UriLoader::RetCode::Success && !StringViewUtils::IsEmpty(script_content)) {
     read_script_flag = true;
   }
+  uint64_t source_hash = 0;
   if (is_use_code_cache) {
-    code_cache_content = read_file_future.get();
+    auto cache_entry = read_file_future.get();
+    source_hash = CodeCacheStore::HashSource(content);
+    if (cache_entry.data.empty()) {
+      FOOTSTONE_DLOG(INFO) << "code cache miss, file_name = " << file_name;
+    } else if (cache_entry.source_hash != source_hash) {
+      FOOTSTONE_LOG(INFO) << "code cache source hash mismatch, file_name = " << file_name;
+    } else {
+      code_cache_content = string_view(reinterpret_cast<const string_view::char8_t_*>(cache_entry.data.c_str()),
+                                       cache_entry.data.length());
+    }
   }
 
   FOOTSTONE_DLOG(INFO) << "uri = " << uri
@@ -332,6 +491,11 @@ bool JsDriverUtils::RunScript(const std::shared_ptr<Scope>& scope,
   if (!read_script_flag || StringViewUtils::IsEmpty(script_content)) {
     FOOTSTONE_LOG(WARNING) << "read_script_flag = " << read_script_flag
                            << ", script content empty, uri = " << uri;
+#ifdef JS_V8
+    if (script_stream) {
+      script_stream->WaitForParse();
+    }
+#endif
     return false;
   }
 
@@ -340,34 +504,41 @@ bool JsDriverUtils::RunScript(const std::shared_ptr<Scope>& scope,
   entry->BundleInfoOfUrl(uri).execute_source_start_ = footstone::TimePoint::SystemNow();
 
 #ifdef JS_V8
-  auto ret = std::static_pointer_cast<V8Ctx>(scope->GetContext())->RunScript(
-      script_content, file_name, is_use_code_cache,&code_cache_content, true);
+  auto v8_ctx = std::static_pointer_cast<V8Ctx>(scope->GetContext());
+  std::shared_ptr<CtxValue> ret;
+  auto is_cache_consumed = !StringViewUtils::IsEmpty(code_cache_content);
+  // handler 不支持分块读取或内容被拦截器改写时，流式解析的结果不可用
+  auto is_streamed = script_stream && script_stream->GetLength() > 0 && script_stream->IsSameContent(content);
+  FOOTSTONE_LOG(INFO) << "RunScript is_streamed = " << is_streamed;
+  if (is_streamed) {
+    ret = v8_ctx->RunScript(script_stream, script_content, file_name, is_use_code_cache, &code_cache_content);
+  } else {
+    if (script_stream) {
+      script_stream->WaitForParse();
+    }
+    ret = v8_ctx->RunScript(script_content, file_name, is_use_code_cache, &code_cache_content, true);
+  }
   if (is_use_code_cache) {
-    if (!StringViewUtils::IsEmpty(code_cache_content)) {
-      auto func = [code_cache_path, code_cache_dir, code_cache_content] {
-        int check_dir_ret = HippyFile::CheckDir(code_cache_dir, F_OK);
-        FOOTSTONE_DLOG(INFO) << "check_parent_dir_ret = " << check_dir_ret;
-        if (check_dir_ret) {
-          HippyFile::CreateDir(code_cache_dir, S_IRWXU);
-        }
-
-        size_t pos = StringViewUtils::FindLastOf(code_cache_path, EXTEND_LITERAL('/'));
-        string_view code_cache_parent_dir = StringViewUtils::SubStr(code_cache_path, 0, pos);
-        int check_parent_dir_ret = HippyFile::CheckDir(code_cache_parent_dir, F_OK);
-        FOOTSTONE_DLOG(INFO) << "check_parent_dir_ret = " << check_parent_dir_ret;
-        if (check_parent_dir_ret) {
-          HippyFile::CreateDir(code_cache_parent_dir, S_IRWXU);
-        }
-
-        auto u8_code_cache_content = StringViewUtils::ToStdString(StringViewUtils::ConvertEncoding(
-            code_cache_content, string_view::Encoding::Utf8).utf8_value());
-        bool save_file_ret = HippyFile::SaveFile(code_cache_path, u8_code_cache_content);
+    // 消费的 cache 被 V8 拒绝时 code_cache_content 会被清空
+    auto is_cache_accepted = is_cache_consumed && !StringViewUtils::IsEmpty(code_cache_content);
+    if (is_cache_consumed && !is_cache_accepted) {
+      worker_task_runner->PostTask([code_cache_store, code_cache_name] {
+        code_cache_store->Remove(code_cache_name);
+      });
+    } else if (!is_cache_consumed && !StringViewUtils::IsEmpty(code_cache_content)) {
+      auto cache = StringViewUtils::ToStdString(code_cache_content.utf8_value());
+      worker_task_runner->PostTask([code_cache_store, code_cache_name, source_hash, cache = std::move(cache)] {
+        auto save_file_ret = code_cache_store->Store(code_cache_name, source_hash, cache);
         FOOTSTONE_LOG(INFO) << "code cache save_file_ret = " << save_file_ret;
         FOOTSTONE_USE(save_file_ret);
-      };
-      auto engine = scope->GetEngine().lock();
-      FOOTSTONE_CHECK(engine);
-      worker_task_runner->PostTask(std::move(func));
+      });
+    }
+    auto engine = scope->GetEngine().lock();
+    FOOTSTONE_CHECK(engine);
+    auto v8_vm = std::static_pointer_cast<V8VM>(engine->GetVM());
+    if (!is_cache_accepted && v8_vm->IsEnableCodeCacheAfterIdle()) {
+      RegenerateCodeCacheAfterIdle(scope, file_name, code_cache_store, code_cache_name, source_hash,
+                                   worker_task_runner);
     }
   }
 #else
@@ -595,7 +766,8 @@ void JsDriverUtils::CallNative(hippy::napi::CallbackInfo& info, const std::funct
   if (info[4]) {
     context->GetValueNumber(info[4], &transfer_type);
   }
-  callback(scope, module_name, fn_name, cb_id_str, transfer_type != 0, buffer_data);
+  // buffer_data 可能有数 MB，直接转移给平台层，不再拷贝
+  callback(scope, module_name, fn_name, cb_id_str, transfer_type != 0, std::move(buffer_data));
 }
 
 void JsDriverUtils::LoadInstance(const std::shared_ptr<Scope>& scope, byte_string&& buffer_data) {
@@ -34,12 +34,18 @@ using string_view = footstone::string_view;
 using StringViewUtils = footstone::StringViewUtils;
 using Ctx = hippy::Ctx;
 using CallbackInfo = hippy::CallbackInfo;
+using TimePoint = footstone::TimePoint;
+using TimeDelta = footstone::TimeDelta;
 
 namespace hippy {
 inline namespace driver {
 inline namespace module {
 
 constexpr char kVSyncKey[] = "frameupdate";
+// frameupdate 事件不带帧间隔，用相邻两帧的间隔估算，超出范围时按 60Hz 处理
+constexpr TimeDelta kDefaultFrameInterval = TimeDelta::FromMicroseconds(16667);
+constexpr TimeDelta kMinFrameInterval = TimeDelta::FromMilliseconds(4);
+constexpr TimeDelta kMaxFrameInterval = TimeDelta::FromMilliseconds(50);
 
 GEN_INVOKE_CB(AnimationFrameModule, RequestAnimationFrame) // NOLINT(cert-err58-cpp)
 GEN_INVOKE_CB(AnimationFrameModule, CancelAnimationFrame) // NOLINT(cert-err58-cpp)
@@ -142,7 +148,23 @@ std::shared_ptr<CtxValue> AnimationFrameModule::BindFunction(std::shared_ptr<Sco
   return object;
 }
 
+void AnimationFrameModule::FeedFrameDeadline(const std::shared_ptr<Scope>& scope) {
+  auto now = TimePoint::Now();
+  auto interval = now - last_frame_time_;
+  if (interval >= kMinFrameInterval && interval <= kMaxFrameInterval) {
+    frame_interval_ = frame_interval_ == TimeDelta::Zero() ? interval : (frame_interval_ * 3 + interval) / 4;
+  } else if (frame_interval_ == TimeDelta::Zero()) {
+    frame_interval_ = kDefaultFrameInterval;
+  }
+  last_frame_time_ = now;
+  auto runner = scope->GetTaskRunner();
+  if (runner) {
+    runner->OnFrameBegin(now, frame_interval_);
+  }
+}
+
 void AnimationFrameModule::UpdateFrame(const std::shared_ptr<Scope>& scope) {
+  FeedFrameDeadline(scope);
   if(!enable_update_frame_) {
     return;
   }
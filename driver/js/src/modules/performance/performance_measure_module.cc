@@ -50,25 +50,8 @@ std::shared_ptr<ClassTemplate<PerformanceMeasure>> RegisterPerformanceMeasure(co
       exception = context->CreateException("illegal constructor");
       return nullptr;
     }
-    string_view name;
-    auto flag = context->GetValueString(arguments[0], &name);
-    if (!flag) {
-      exception = context->CreateException("name error");
-      return nullptr;
-    }
-    int32_t type;
-    flag = context->GetValueNumber(arguments[1], &type);
-    if (!flag || type < 0) {
-      exception = context->CreateException("type error");
-      return nullptr;
-    }
-
-    auto entries = scope->GetPerformance()->GetEntriesByName(name, static_cast<PerformanceEntry::Type>(type));
-    if (entries.empty()) {
-      exception = context->CreateException("entry not found");
-      return nullptr;
-    }
-    return std::static_pointer_cast<PerformanceMeasure>(entries.back());
+    auto entry = reinterpret_cast<PerformanceEntry*>(external)->shared_from_this();
+    return std::static_pointer_cast<PerformanceMeasure>(entry);
   };
 
   PropertyDefine<PerformanceMeasure> name_property_define;
@@ -53,6 +53,20 @@ constexpr char kFunctionGetEntriesByType[] = "getEntriesByType";
 constexpr char kFunctionClearResourceTimings[] = "clearResourceTimings";
 constexpr char kFunctionSetResourceTimingBufferSize[] = "setResourceTimingBufferSize";
 
+std::shared_ptr<CtxValue> CreatePerformanceEntryArray(const std::shared_ptr<Scope>& scope,
+                                                      const std::vector<std::shared_ptr<PerformanceEntry>>& entries) {
+  auto context = scope->GetContext();
+  std::shared_ptr<CtxValue> instances[entries.size()];
+  for (size_t i = 0; i < entries.size(); ++i) {
+    auto entry = entries[i];
+    auto javascript_class = scope->GetJavascriptClass(PerformanceEntry::GetSubTypeString(entry->GetSubType()));
+    std::shared_ptr<CtxValue> argv[] = { context->CreateString(entry->GetName()),
+                                         context->CreateNumber(static_cast<uint32_t>(entry->GetType())) };
+    instances[i] = context->NewInstance(javascript_class, 2, argv, entry.get());
+  }
+  return context->CreateArray(entries.size(), instances);
+}
+
 std::shared_ptr<ClassTemplate<Performance>> RegisterPerformance(const std::weak_ptr<Scope>& weak_scope) {
   ClassTemplate<Performance> class_template;
   class_template.name = "Performance";
@@ -255,15 +269,7 @@ std::shared_ptr<ClassTemplate<Performance>> RegisterPerformance(const std::weak_
     }
     if (argument_count == 1) {
       auto entries = performance->GetEntriesByName(name);
-      std::shared_ptr<CtxValue> instances[entries.size()];
-      for (size_t i = 0; i < entries.size(); ++i) {
-        auto entry = entries[i];
-        auto javascript_class = scope->GetJavascriptClass(PerformanceEntry::GetSubTypeString(entry->GetSubType()));
-        std::shared_ptr<CtxValue> argv[] = { context->CreateString(entry->GetName()),
-                                             context->CreateNumber(static_cast<uint32_t>(entry->GetType())) };
-        instances[i] = context->NewInstance(javascript_class, 2, argv, entry.get());
-      }
-      return context->CreateArray(entries.size(), instances);
+      return CreatePerformanceEntryArray(scope, entries);
     }
     string_view type;
     flag = context->GetValueString(arguments[1], &type);
@@ -277,15 +283,7 @@ std::shared_ptr<ClassTemplate<Performance>> RegisterPerformance(const std::weak_
       return nullptr;
     }
     auto entries = performance->GetEntriesByName(name, entry_type);
-    std::shared_ptr<CtxValue> instances[entries.size()];
-    for (size_t i = 0; i < entries.size(); ++i) {
-      auto entry = entries[i];
-      auto javascript_class = scope->GetJavascriptClass(PerformanceEntry::GetSubTypeString(entry->GetSubType()));
-      std::shared_ptr<CtxValue> argv[] = { context->CreateString(entry->GetName()),
-                                           context->CreateNumber(static_cast<uint32_t>(entry->GetType())) };
-      instances[i] = context->NewInstance(javascript_class, 2, argv, entry.get());
-    }
-    return context->CreateArray(entries.size(), instances);
+    return CreatePerformanceEntryArray(scope, entries);
   };
   class_template.functions.emplace_back(std::move(get_entries_by_name_function_define));
 
@@ -317,15 +315,7 @@ std::shared_ptr<ClassTemplate<Performance>> RegisterPerformance(const std::weak_
       return nullptr;
     }
     auto entries = performance->GetEntriesByType(entry_type);
-    std::shared_ptr<CtxValue> instances[entries.size()];
-    for (size_t i = 0; i < entries.size(); ++i) {
-      auto entry = entries[i];
-      auto javascript_class = scope->GetJavascriptClass(PerformanceEntry::GetSubTypeString(entry->GetSubType()));
-      std::shared_ptr<CtxValue> argv[] = { context->CreateString(entry->GetName()),
-                                           context->CreateNumber(static_cast<uint32_t>(entry->GetType())) };
-      instances[i] = context->NewInstance(javascript_class, 2, argv, entry.get());
-    }
-    return context->CreateArray(entries.size(), instances);
+    return CreatePerformanceEntryArray(scope, entries);
   };
   class_template.functions.emplace_back(std::move(get_entries_by_type_function_define));
 
@@ -388,17 +378,8 @@ std::shared_ptr<ClassTemplate<Performance>> RegisterPerformance(const std::weak_
     if (!scope) {
       return nullptr;
     }
-    auto context = scope->GetContext();
     auto entries = performance->GetEntries();
-    std::shared_ptr<CtxValue> instances[entries.size()];
-    for (size_t i = 0; i < entries.size(); ++i) {
-      auto entry = entries[i];
-      auto javascript_class = scope->GetJavascriptClass(PerformanceEntry::GetSubTypeString(entry->GetSubType()));
-      std::shared_ptr<CtxValue> argv[] = { context->CreateString(entry->GetName()),
-                                           context->CreateNumber(static_cast<uint32_t>(entry->GetType())) };
-      instances[i] = context->NewInstance(javascript_class, 2, argv, entry.get());
-    }
-    return context->CreateArray(entries.size(), instances);
+    return CreatePerformanceEntryArray(scope, entries);
   };
   class_template.functions.emplace_back(std::move(get_entries_function_define));
 
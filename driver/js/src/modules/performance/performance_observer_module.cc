@@ -0,0 +1,250 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2023 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "driver/modules/performance/performance_observer_module.h"
+
+#include "driver/modules/performance/performance_module.h"
+#include "driver/performance/performance.h"
+#include "footstone/string_view.h"
+
+using string_view = footstone::string_view;
+
+namespace hippy {
+inline namespace driver {
+inline namespace module {
+
+constexpr char kPerformanceObserverEntryListName[] = "PerformanceObserverEntryList";
+constexpr char kEntryTypesKey[] = "entryTypes";
+constexpr char kTypeKey[] = "type";
+constexpr char kBufferedKey[] = "buffered";
+
+std::shared_ptr<ClassTemplate<PerformanceObserver>> RegisterPerformanceObserver(const std::weak_ptr<Scope>& weak_scope) {
+  ClassTemplate<PerformanceObserver> class_template;
+  class_template.name = "PerformanceObserver";
+  class_template.constructor = [weak_scope](
+      const std::shared_ptr<CtxValue>& receiver,
+      size_t argument_count,
+      const std::shared_ptr<CtxValue> arguments[],
+      void* external,
+      std::shared_ptr<CtxValue>& exception) -> std::shared_ptr<PerformanceObserver> {
+    auto scope = weak_scope.lock();
+    if (!scope) {
+      return nullptr;
+    }
+    auto context = scope->GetContext();
+    if (argument_count != 1 || !context->IsFunction(arguments[0])) {
+      exception = context->CreateException("PerformanceObserver callback must be function");
+      return nullptr;
+    }
+    // holding chain: scope -> performance -> observer -> CtxValue(function)
+    auto function = arguments[0];
+    return std::make_shared<PerformanceObserver>([weak_scope, function](PerformanceObserver::Entries&& entries) {
+      auto scope = weak_scope.lock();
+      if (!scope) {
+        return;
+      }
+      auto context = scope->GetContext();
+      auto list = std::make_shared<PerformanceObserverEntryList>(std::move(entries));
+      auto list_class = scope->GetJavascriptClass(kPerformanceObserverEntryListName);
+      std::shared_ptr<CtxValue> argv[] = { context->NewInstance(list_class, 0, nullptr, &list) };
+      context->CallFunction(function, context->GetGlobalObject(), 1, argv);
+    });
+  };
+
+  FunctionDefine<PerformanceObserver> observe_function_define;
+  observe_function_define.name = "observe";
+  observe_function_define.callback = [weak_scope](
+      PerformanceObserver* observer,
+      size_t argument_count,
+      const std::shared_ptr<CtxValue> arguments[],
+      std::shared_ptr<CtxValue>& exception) -> std::shared_ptr<CtxValue> {
+    auto scope = weak_scope.lock();
+    if (!scope) {
+      return nullptr;
+    }
+    auto context = scope->GetContext();
+    if (argument_count != 1 || !context->IsObject(arguments[0])) {
+      exception = context->CreateException("observe options error");
+      return nullptr;
+    }
+    auto options = arguments[0];
+    std::vector<PerformanceEntry::Type> types;
+    bool buffered = false;
+    if (context->HasNamedProperty(options, kEntryTypesKey)) {
+      auto entry_types = context->CopyNamedProperty(options, kEntryTypesKey);
+      if (!context->IsArray(entry_types)) {
+        exception = context->CreateException("observe entryTypes error");
+        return nullptr;
+      }
+      auto length = context->GetArrayLength(entry_types);
+      for (uint32_t i = 0; i < length; ++i) {
+        string_view type;
+        if (context->GetValueString(context->CopyArrayElement(entry_types, i), &type)) {
+          types.push_back(PerformanceEntry::GetEntryType(type));
+        }
+      }
+    } else if (context->HasNamedProperty(options, kTypeKey)) {
+      string_view type;
+      if (!context->GetValueString(context->CopyNamedProperty(options, kTypeKey), &type)) {
+        exception = context->CreateException("observe type error");
+        return nullptr;
+      }
+      types.push_back(PerformanceEntry::GetEntryType(type));
+      if (context->HasNamedProperty(options, kBufferedKey)) {
+        context->GetValueBoolean(context->CopyNamedProperty(options, kBufferedKey), &buffered);
+      }
+    } else {
+      exception = context->CreateException("observe options must have entryTypes or type");
+      return nullptr;
+    }
+    scope->GetPerformance()->Observe(observer->shared_from_this(), types, buffered);
+    return nullptr;
+  };
+  class_template.functions.emplace_back(std::move(observe_function_define));
+
+  FunctionDefine<PerformanceObserver> disconnect_function_define;
+  disconnect_function_define.name = "disconnect";
+  disconnect_function_define.callback = [weak_scope](
+      PerformanceObserver* observer,
+      size_t argument_count,
+      const std::shared_ptr<CtxValue> arguments[],
+      std::shared_ptr<CtxValue>& exception) -> std::shared_ptr<CtxValue> {
+    auto scope = weak_scope.lock();
+    if (!scope) {
+      return nullptr;
+    }
+    scope->GetPerformance()->Disconnect(observer->shared_from_this());
+    return nullptr;
+  };
+  class_template.functions.emplace_back(std::move(disconnect_function_define));
+
+  FunctionDefine<PerformanceObserver> take_records_function_define;
+  take_records_function_define.name = "takeRecords";
+  take_records_function_define.callback = [weak_scope](
+      PerformanceObserver* observer,
+      size_t argument_count,
+      const std::shared_ptr<CtxValue> arguments[],
+      std::shared_ptr<CtxValue>& exception) -> std::shared_ptr<CtxValue> {
+    auto scope = weak_scope.lock();
+    if (!scope) {
+      return nullptr;
+    }
+    return CreatePerformanceEntryArray(scope, observer->TakeRecords());
+  };
+  class_template.functions.emplace_back(std::move(take_records_function_define));
+
+  return std::make_shared<ClassTemplate<PerformanceObserver>>(std::move(class_template));
+}
+
+std::shared_ptr<ClassTemplate<PerformanceObserverEntryList>> RegisterPerformanceObserverEntryList(
+    const std::weak_ptr<Scope>& weak_scope) {
+  ClassTemplate<PerformanceObserverEntryList> class_template;
+  class_template.name = kPerformanceObserverEntryListName;
+  class_template.constructor = [weak_scope](
+      const std::shared_ptr<CtxValue>& receiver,
+      size_t argument_count,
+      const std::shared_ptr<CtxValue> arguments[],
+      void* external,
+      std::shared_ptr<CtxValue>& exception) -> std::shared_ptr<PerformanceObserverEntryList> {
+    auto scope = weak_scope.lock();
+    if (!scope) {
+      return nullptr;
+    }
+    auto context = scope->GetContext();
+    if (!external) {
+      exception = context->CreateException("illegal constructor");
+      return nullptr;
+    }
+    return *reinterpret_cast<std::shared_ptr<PerformanceObserverEntryList>*>(external);
+  };
+
+  FunctionDefine<PerformanceObserverEntryList> get_entries_function_define;
+  get_entries_function_define.name = "getEntries";
+  get_entries_function_define.callback = [weak_scope](
+      PerformanceObserverEntryList* list,
+      size_t argument_count,
+      const std::shared_ptr<CtxValue> arguments[],
+      std::shared_ptr<CtxValue>& exception) -> std::shared_ptr<CtxValue> {
+    auto scope = weak_scope.lock();
+    if (!scope) {
+      return nullptr;
+    }
+    return CreatePerformanceEntryArray(scope, list->GetEntries());
+  };
+  class_template.functions.emplace_back(std::move(get_entries_function_define));
+
+  FunctionDefine<PerformanceObserverEntryList> get_entries_by_name_function_define;
+  get_entries_by_name_function_define.name = "getEntriesByName";
+  get_entries_by_name_function_define.callback = [weak_scope](
+      PerformanceObserverEntryList* list,
+      size_t argument_count,
+      const std::shared_ptr<CtxValue> arguments[],
+      std::shared_ptr<CtxValue>& exception) -> std::shared_ptr<CtxValue> {
+    auto scope = weak_scope.lock();
+    if (!scope) {
+      return nullptr;
+    }
+    auto context = scope->GetContext();
+    string_view name;
+    if (argument_count <= 0 || argument_count > 2 || !context->GetValueString(arguments[0], &name)) {
+      exception = context->CreateException("getEntriesByName parameter error");
+      return nullptr;
+    }
+    if (argument_count == 1) {
+      return CreatePerformanceEntryArray(scope, list->GetEntriesByName(name));
+    }
+    string_view type;
+    if (!context->GetValueString(arguments[1], &type)) {
+      exception = context->CreateException("getEntriesByName type error");
+      return nullptr;
+    }
+    return CreatePerformanceEntryArray(scope, list->GetEntriesByName(name, PerformanceEntry::GetEntryType(type)));
+  };
+  class_template.functions.emplace_back(std::move(get_entries_by_name_function_define));
+
+  FunctionDefine<PerformanceObserverEntryList> get_entries_by_type_function_define;
+  get_entries_by_type_function_define.name = "getEntriesByType";
+  get_entries_by_type_function_define.callback = [weak_scope](
+      PerformanceObserverEntryList* list,
+      size_t argument_count,
+      const std::shared_ptr<CtxValue> arguments[],
+      std::shared_ptr<CtxValue>& exception) -> std::shared_ptr<CtxValue> {
+    auto scope = weak_scope.lock();
+    if (!scope) {
+      return nullptr;
+    }
+    auto context = scope->GetContext();
+    string_view type;
+    if (argument_count != 1 || !context->GetValueString(arguments[0], &type)) {
+      exception = context->CreateException("getEntriesByType parameter error");
+      return nullptr;
+    }
+    return CreatePerformanceEntryArray(scope, list->GetEntriesByType(PerformanceEntry::GetEntryType(type)));
+  };
+  class_template.functions.emplace_back(std::move(get_entries_by_type_function_define));
+
+  return std::make_shared<ClassTemplate<PerformanceObserverEntryList>>(std::move(class_template));
+}
+
+}
+}
+}
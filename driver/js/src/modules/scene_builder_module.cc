@@ -22,6 +22,7 @@
 
 #include "driver/modules/scene_builder_module.h"
 
+#include "dom/dom_batch.h"
 #include "dom/node_props.h"
 #include "driver/base/js_convert_utils.h"
 #include "driver/modules/scene_builder_module.h"
@@ -49,6 +50,7 @@ using DomManager = hippy::dom::DomManager;
 using DomNode = hippy::dom::DomNode;
 using RefInfo = hippy::dom::RefInfo;
 using DomInfo = hippy::dom::DomInfo;
+using DomBatch = hippy::dom::DomBatch;
 using RegisterFunction = hippy::base::RegisterFunction;
 using RegisterMap = hippy::base::RegisterMap;
 
@@ -71,6 +73,16 @@ namespace hippy {
 inline namespace driver {
 inline namespace module {
 
+// DomNode and DomInfo live as long as the page, allocate them from the arena of root node if it is still alive
+template <typename T, typename... Args>
+std::shared_ptr<T> MakeDomObject(const std::shared_ptr<Scope>& scope, Args&&... args) {
+  auto root_node = scope->GetRootNode().lock();
+  if (root_node) {
+    return root_node->GetArena()->MakeShared<T>(std::forward<Args>(args)...);
+  }
+  return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
 std::tuple<bool, std::string, int32_t> GetNodeId(const std::shared_ptr<Ctx> &context,
                                                  const std::shared_ptr<CtxValue> &node) {
   // parse id
@@ -287,14 +299,15 @@ CreateNode(const std::shared_ptr<Ctx> &context,
   auto ext = std::make_shared<std::unordered_map<std::string, std::shared_ptr<HippyValue>>>(
       std::move(std::get<3>(props_tuple)));
   FOOTSTONE_CHECK(!scope->GetDomManager().expired());
-  dom_node = std::make_shared<DomNode>(std::get<2>(id_tuple),
-                                       std::get<2>(pid_tuple),
-                                       0,
-                                       std::move(u8_tag_name),
-                                       std::move(u8_view_name),
-                                       style,
-                                       ext,
-                                       scope->GetRootNode());
+  dom_node = MakeDomObject<DomNode>(scope,
+                                    std::get<2>(id_tuple),
+                                    std::get<2>(pid_tuple),
+                                    0,
+                                    std::move(u8_tag_name),
+                                    std::move(u8_view_name),
+                                    style,
+                                    ext,
+                                    scope->GetRootNode());
   return std::make_tuple(true, "", dom_node);
 }
 
@@ -312,8 +325,9 @@ std::tuple<bool, std::string, std::shared_ptr<RefInfo>> CreateRefInfo(
   if (!std::get<0>(relative_to_ref_tuple)) {
     return std::make_tuple(false, std::get<1>(relative_to_ref_tuple), ref_info);
   }
-  ref_info = std::make_shared<RefInfo>(std::get<2>(ref_id_tuple),
-                                       std::get<2>(relative_to_ref_tuple));
+  ref_info = MakeDomObject<RefInfo>(scope,
+                                    std::get<2>(ref_id_tuple),
+                                    std::get<2>(relative_to_ref_tuple));
   return std::make_tuple(true, "", ref_info);
 }
 
@@ -346,13 +360,13 @@ std::tuple<bool, std::string, std::shared_ptr<DomInfo>> CreateDomInfo(
       if (style_diff) {
           bool skip_style_diff;
           context->GetValueBoolean(style_diff, &skip_style_diff);
-          diff_info = std::make_shared<hippy::dom::DiffInfo>(skip_style_diff);
+          diff_info = MakeDomObject<hippy::dom::DiffInfo>(scope, skip_style_diff);
       }
     }
   } else {
     return std::make_tuple(false, "dom info length error.", dom_info);
   }
-  dom_info = std::make_shared<DomInfo>(dom_node, ref_info, diff_info);
+  dom_info = MakeDomObject<DomInfo>(scope, dom_node, ref_info, diff_info);
   return std::make_tuple(true, "", dom_info);
 }
 
@@ -373,7 +387,23 @@ std::tuple<bool, std::string, std::vector<std::shared_ptr<DomInfo>>> HandleJsVal
   return std::make_tuple(true, "", std::move(dom_nodes));
 }
 
-
+// createWithBuffer/updateWithBuffer 的参数为 DomBatch 编码的 ArrayBuffer, 整批节点在 native 一次解码
+bool HandleByteBuffer(const std::shared_ptr<Ctx> &context,
+                      const std::shared_ptr<CtxValue> &buffer,
+                      const std::shared_ptr<Scope> &scope,
+                      std::vector<std::shared_ptr<DomInfo>> &dom_infos) {
+  void* data = nullptr;
+  size_t length = 0;
+  uint32_t type;
+  if (!context->GetByteBuffer(buffer, &data, length, type)) {
+    return false;
+  }
+  auto root_node = scope->GetRootNode().lock();
+  if (!root_node) {
+    return false;
+  }
+  return DomBatch::Decode(reinterpret_cast<const uint8_t*>(data), length, root_node, dom_infos);
+}
 
 void HandleEventListenerInfo(const std::shared_ptr<hippy::napi::Ctx> &context,
                              const size_t argument_count,
@@ -463,6 +493,54 @@ std::shared_ptr<ClassTemplate<SceneBuilder>> RegisterSceneBuilder(const std::wea
   };
   class_template.functions.emplace_back(std::move(update_func_def));
 
+  FunctionDefine<SceneBuilder> create_with_buffer_func_def;
+  create_with_buffer_func_def.name = "createWithBuffer";
+  create_with_buffer_func_def.callback = [weak_scope](
+      SceneBuilder* builder,
+      size_t argument_count,
+      const std::shared_ptr<CtxValue> arguments[],
+      std::shared_ptr<CtxValue>& exception) -> std::shared_ptr<CtxValue> {
+    auto scope = weak_scope.lock();
+    if (!scope) {
+      return nullptr;
+    }
+    auto context = scope->GetContext();
+    std::vector<std::shared_ptr<DomInfo>> dom_infos;
+    if (!HandleByteBuffer(context, arguments[0], scope, dom_infos)) {
+      exception = context->CreateException("invalid node buffer");
+      return nullptr;
+    }
+    bool needSortByIndex = false;
+    if (argument_count == 2) {
+      context->GetValueBoolean(arguments[1], &needSortByIndex);
+    }
+    SceneBuilder::Create(scope->GetDomManager(), scope->GetRootNode(), std::move(dom_infos), needSortByIndex);
+    return nullptr;
+  };
+  class_template.functions.emplace_back(std::move(create_with_buffer_func_def));
+
+  FunctionDefine<SceneBuilder> update_with_buffer_func_def;
+  update_with_buffer_func_def.name = "updateWithBuffer";
+  update_with_buffer_func_def.callback = [weak_scope](
+      SceneBuilder* builder,
+      size_t argument_count,
+      const std::shared_ptr<CtxValue> arguments[],
+      std::shared_ptr<CtxValue>& exception) -> std::shared_ptr<CtxValue> {
+    auto scope = weak_scope.lock();
+    if (!scope) {
+      return nullptr;
+    }
+    auto context = scope->GetContext();
+    std::vector<std::shared_ptr<DomInfo>> dom_infos;
+    if (!HandleByteBuffer(context, arguments[0], scope, dom_infos)) {
+      exception = context->CreateException("invalid node buffer");
+      return nullptr;
+    }
+    SceneBuilder::Update(scope->GetDomManager(), scope->GetRootNode(), std::move(dom_infos));
+    return nullptr;
+  };
+  class_template.functions.emplace_back(std::move(update_with_buffer_func_def));
+
   FunctionDefine<SceneBuilder> move_func_def;
   move_func_def.name = "move";
   move_func_def.callback = [weak_scope](SceneBuilder *builder, size_t argument_count,
@@ -496,8 +574,10 @@ std::shared_ptr<ClassTemplate<SceneBuilder>> RegisterSceneBuilder(const std::wea
         if (length >= 2) {
           auto ref_info_tuple = CreateRefInfo(
               context, context->CopyArrayElement(info, 1), scope);
-          dom_infos.push_back(std::make_shared<DomInfo>(
-              std::make_shared<DomNode>(
+          dom_infos.push_back(MakeDomObject<DomInfo>(
+              scope,
+              MakeDomObject<DomNode>(
+                  scope,
                   std::get<2>(id_tuple),
                   std::get<2>(pid_tuple),
                   scope->GetRootNode()),
@@ -543,8 +623,10 @@ std::shared_ptr<ClassTemplate<SceneBuilder>> RegisterSceneBuilder(const std::wea
 
           return nullptr;
         }
-        dom_infos.push_back(std::make_shared<DomInfo>(
-            std::make_shared<DomNode>(
+        dom_infos.push_back(MakeDomObject<DomInfo>(
+            scope,
+            MakeDomObject<DomNode>(
+                scope,
                 std::get<2>(id_tuple),
                 std::get<2>(pid_tuple),
                 scope->GetRootNode()),
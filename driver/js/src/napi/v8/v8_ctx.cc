@@ -22,15 +22,18 @@
 
 #include "driver/napi/v8/v8_ctx.h"
 
+#include "driver/base/external_references.h"
 #include "driver/base/js_value_wrapper.h"
 #include "driver/napi/v8/v8_ctx_value.h"
 #include "driver/napi/v8/v8_class_definition.h"
+#include "driver/napi/v8/v8_script_stream.h"
 #include "driver/napi/v8/v8_try_catch.h"
 #include "driver/napi/callback_info.h"
 #include "driver/vm/v8/v8_vm.h"
 #include "driver/vm/v8/serializer.h"
 #include "driver/vm/native_source_code.h"
 #include "footstone/check.h"
+#include "footstone/serializer.h"
 #include "footstone/string_view.h"
 #include "footstone/string_view_utils.h"
 
@@ -46,9 +49,32 @@ using CallbackInfo = hippy::CallbackInfo;
 constexpr static int kExternalIndex = 0;
 constexpr static int kNewInstanceExternalIndex = 1;
 constexpr static int kScopeWrapperIndex = 5;
-constexpr static int kExternalDataMapIndex = 6;
+constexpr static int kFunctionWrapperTableIndex = 6;
 //constexpr char kProtoKey[] = "__proto__";
 
+constexpr static int kSnapshotManifestIndex = 0;
+constexpr static uint32_t kSnapshotManifestTagIndex = 0;
+constexpr static uint32_t kSnapshotManifestKindsIndex = 1;
+constexpr static uint32_t kSnapshotManifestTableSizeIndex = 2;
+constexpr static uint32_t kSnapshotManifestLength = 3;
+constexpr static char kSnapshotTemplateKind = 'T';
+constexpr static char kSnapshotClassKind = 'C';
+constexpr static char kSnapshotInstanceKind = 'I';
+
+// 不带 data 的 callback 以函数地址作为 External，生成快照时按 external reference 序列化；
+// 带 data 的 callback 以 function_wrapper_table_ 中的下标作为 Integer
+static FunctionWrapper GetFunctionWrapper(v8::Local<v8::Context> context, v8::Local<v8::Value> data) {
+  FOOTSTONE_CHECK(!data.IsEmpty());
+  if (data->IsExternal()) {
+    return FunctionWrapper(reinterpret_cast<JsCallback>(data.As<v8::External>()->Value()), nullptr);
+  }
+  auto table = reinterpret_cast<std::vector<FunctionWrapper*>*>(
+      context->GetAlignedPointerFromEmbedderData(kFunctionWrapperTableIndex));
+  auto index = data.As<v8::Uint32>()->Value();
+  FOOTSTONE_CHECK(table && index < table->size());
+  return *(*table)[index];
+}
+
 void InvokePropertyCallback(v8::Local<v8::Name> property,
                             const v8::PropertyCallbackInfo<v8::Value>& info) {
   auto isolate = info.GetIsolate();
@@ -61,11 +87,9 @@ void InvokePropertyCallback(v8::Local<v8::Name> property,
   cb_info.SetReceiver(std::make_shared<V8CtxValue>(isolate, info.This()));
   auto name = std::make_shared<V8CtxValue>(isolate, property);
   cb_info.AddValue(name);
-  auto data = info.Data().As<v8::External>();
-  FOOTSTONE_CHECK(!data.IsEmpty());
-  auto* func_wrapper = reinterpret_cast<FunctionWrapper*>(data->Value());
-  FOOTSTONE_CHECK(func_wrapper && func_wrapper->callback);
-  (func_wrapper->callback)(cb_info, func_wrapper->data);
+  auto func_wrapper = GetFunctionWrapper(context, info.Data());
+  FOOTSTONE_CHECK(func_wrapper.callback);
+  (func_wrapper.callback)(cb_info, func_wrapper.data);
   auto exception = std::static_pointer_cast<V8CtxValue>(cb_info.GetExceptionValue()->Get());
   if (exception) {
     const auto& global_value = exception->global_value_;
@@ -109,17 +133,9 @@ static void InvokeJsCallback(const v8::FunctionCallbackInfo<v8::Value>& info) {
   for (int i = 0; i < info.Length(); i++) {
     cb_info.AddValue(std::make_shared<V8CtxValue>(isolate, info[i]));
   }
-  auto data = info.Data().As<v8::External>();
-  FOOTSTONE_CHECK(!data.IsEmpty());
-  auto function_wrapper = reinterpret_cast<FunctionWrapper*>(data->Value());
-  auto js_cb = function_wrapper->callback;
-  auto external_data = function_wrapper->data;
-//  auto external_data_map = reinterpret_cast<std::unordered_map<void*, void*>*>(context->GetAlignedPointerFromEmbedderData(kExternalDataMapIndex));
-//  void* external_data = nullptr;
-//  auto it = external_data_map->find(js_cb_address);
-//  if ( it != external_data_map->end()) {
-//    external_data = it->second;
-//  }
+  auto function_wrapper = GetFunctionWrapper(context, info.Data());
+  auto js_cb = function_wrapper.callback;
+  auto external_data = function_wrapper.data;
   js_cb(cb_info, external_data);
   auto exception = std::static_pointer_cast<V8CtxValue>(cb_info.GetExceptionValue()->Get());
   if (exception) {
@@ -151,26 +167,51 @@ static void InvokeJsCallback(const v8::FunctionCallbackInfo<v8::Value>& info) {
   info.GetReturnValue().Set(ret_value->global_value_);
 }
 
+REGISTER_EXTERNAL_REFERENCES(InvokePropertyCallback)
+REGISTER_EXTERNAL_REFERENCES(InvokeJsCallback)
+
 V8Ctx::V8Ctx(v8::Isolate* isolate) : isolate_(isolate) {
     v8::HandleScope handle_scope(isolate);
     v8::Local<v8::ObjectTemplate> global = v8::ObjectTemplate::New(isolate);
     v8::Local<v8::Context> context = v8::Context::New(isolate, nullptr, global);
     v8::Context::Scope contextScope(context);
 
-    context->SetAlignedPointerInEmbedderData(kExternalDataMapIndex, reinterpret_cast<void*>(&func_external_data_map_));
+    context->SetAlignedPointerInEmbedderData(kFunctionWrapperTableIndex, reinterpret_cast<void*>(&function_wrapper_table_));
 
     global_persistent_.Reset(isolate, global);
     context_persistent_.Reset(isolate, context);
 }
 
+V8Ctx::V8Ctx(v8::Isolate* isolate, v8::Local<v8::Context> context) : isolate_(isolate) {
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(context);
+
+  // 快照中的 embedder data 在生成时已清空
+  context->SetAlignedPointerInEmbedderData(kFunctionWrapperTableIndex, reinterpret_cast<void*>(&function_wrapper_table_));
+
+  context_persistent_.Reset(isolate, context);
+}
+
 v8::Local<v8::FunctionTemplate> V8Ctx::CreateTemplate(const std::unique_ptr<FunctionWrapper>& wrapper) {
-  // func_external_data_map_[reinterpret_cast<void*>(wrapper->cb)] = wrapper->data;
-  // wrapper->cb is a function pointer which can be obtained at compile time
-  return v8::FunctionTemplate::New(isolate_, InvokeJsCallback,
-                                   v8::External::New(isolate_,
-                                                     reinterpret_cast<void*>(wrapper.get())));
+  return v8::FunctionTemplate::New(isolate_, InvokeJsCallback, CreateCallbackData(wrapper));
+}
 
+v8::Local<v8::Value> V8Ctx::CreateCallbackData(const std::unique_ptr<FunctionWrapper>& wrapper) {
+  FOOTSTONE_DCHECK(snapshot_mode_ != SnapshotMode::kReplay);
+  if (!wrapper->data) {
+    auto address = reinterpret_cast<intptr_t>(wrapper->callback);
+    if (snapshot_mode_ == SnapshotMode::kRecord && !ExternalReferences::Contains(address)) {
+      FOOTSTONE_LOG(ERROR) << "callback is not registered by REGISTER_EXTERNAL_REFERENCES, address = " << address;
+      is_snapshot_compatible_ = false;
+    }
+    return v8::External::New(isolate_, reinterpret_cast<void*>(wrapper->callback));
+  }
+  return v8::Integer::NewFromUnsigned(isolate_, AddFunctionWrapper(wrapper));
+}
 
+uint32_t V8Ctx::AddFunctionWrapper(const std::unique_ptr<FunctionWrapper>& wrapper) {
+  function_wrapper_table_.push_back(wrapper.get());
+  return footstone::checked_numeric_cast<size_t, uint32_t>(function_wrapper_table_.size() - 1);
 }
 
 std::shared_ptr<CtxValue> V8Ctx::CreateFunction(const std::unique_ptr<FunctionWrapper>& wrapper) {
@@ -178,6 +219,11 @@ std::shared_ptr<CtxValue> V8Ctx::CreateFunction(const std::unique_ptr<FunctionWr
   auto context = context_persistent_.Get(isolate_);
   v8::Context::Scope context_scope(context);
 
+  if (snapshot_mode_ == SnapshotMode::kRecord && wrapper->data) {
+    // 快照只回放 DefineClass 和 NewInstance，其余带 data 的 callback 在恢复后无法找回
+    FOOTSTONE_LOG(ERROR) << "CreateFunction with data is not supported when creating snapshot";
+    is_snapshot_compatible_ = false;
+  }
   auto function_template = CreateTemplate(wrapper);
   return std::make_shared<V8CtxValue>(isolate_,
                                       function_template->GetFunction(context).ToLocalChecked());
@@ -271,7 +317,12 @@ std::string V8Ctx::GetSerializationBuffer(const std::shared_ptr<CtxValue>& value
   serializer.WriteHeader();
   serializer.WriteValue(handle_value);
   std::pair<uint8_t*, size_t> pair = serializer.Release();
-  return {reinterpret_cast<const char*>(pair.first), pair.second};
+  if (reused_buffer.empty() || pair.first != reinterpret_cast<uint8_t*>(&reused_buffer[0])) {
+    return {reinterpret_cast<const char*>(pair.first), pair.second};
+  }
+  // 序列化结果已经写在 reused_buffer 中，小数据拷贝出来并保留 reused_buffer，大数据直接转移其内存
+  return footstone::value::SerializerHelper::TakeReusedBuffer(reused_buffer, pair.second,
+                                                              Serializer::kMaxReusedBuffersSize);
 }
 
 std::shared_ptr<CtxValue> V8Ctx::GetGlobalObject() {
@@ -397,6 +448,57 @@ std::shared_ptr<CtxValue> V8Ctx::RunScript(const string_view& str_view,
   return InternalRunScript(context, source.ToLocalChecked(), file_name, is_use_code_cache, cache);
 }
 
+std::shared_ptr<V8ScriptStream> V8Ctx::CreateScriptStream() {
+  return std::make_shared<V8ScriptStream>(isolate_);
+}
+
+std::shared_ptr<CtxValue> V8Ctx::RunScript(const std::shared_ptr<V8ScriptStream>& stream,
+                                           const string_view& str_view,
+                                           const string_view& file_name,
+                                           bool is_use_code_cache,
+                                           string_view* cache) {
+  FOOTSTONE_LOG(INFO) << "V8Ctx::RunScript streamed, file_name = " << file_name
+                      << ", is_use_code_cache = " << is_use_code_cache;
+  FOOTSTONE_CHECK(str_view.encoding() == string_view::Encoding::Utf8);
+  // 后台解析结束后才能编译
+  stream->Finish();
+  stream->WaitForParse();
+  v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+  const string_view::u8string& str = str_view.utf8_value();
+  auto source = v8::String::NewFromUtf8(
+      isolate_, reinterpret_cast<const char*>(str.c_str()), v8::NewStringType::kNormal,
+      footstone::checked_numeric_cast<size_t, int>(str.length()));
+  if (source.IsEmpty()) {
+    FOOTSTONE_DLOG(WARNING) << "v8_source empty, file_name = " << file_name;
+    return nullptr;
+  }
+  v8::Local<v8::String> v8_file_name = V8VM::CreateV8String(isolate_, context, file_name);
+#if (V8_MAJOR_VERSION == 8 && V8_MINOR_VERSION == 9 && \
+     V8_BUILD_NUMBER >= 45) || \
+    (V8_MAJOR_VERSION == 8 && V8_MINOR_VERSION > 9) || (V8_MAJOR_VERSION > 8)
+  v8::ScriptOrigin origin(isolate_, v8_file_name);
+#else
+  v8::ScriptOrigin origin(v8_file_name);
+#endif
+  auto script = v8::ScriptCompiler::Compile(context, stream->GetStreamedSource(), source.ToLocalChecked(), origin);
+  if (script.IsEmpty()) {
+    return nullptr;
+  }
+  if (is_use_code_cache && cache) {
+    std::unique_ptr<v8::ScriptCompiler::CachedData> cached_data(
+        v8::ScriptCompiler::CreateCodeCache(script.ToLocalChecked()->GetUnboundScript()));
+    *cache = string_view(cached_data->data, footstone::checked_numeric_cast<int, size_t>(cached_data->length));
+    RetainScriptForCodeCache(file_name, script.ToLocalChecked());
+  }
+  v8::MaybeLocal<v8::Value> v8_maybe_value = script.ToLocalChecked()->Run(context);
+  if (v8_maybe_value.IsEmpty()) {
+    return nullptr;
+  }
+  return std::make_shared<V8CtxValue>(isolate_, v8_maybe_value.ToLocalChecked());
+}
+
 void V8Ctx::SetDefaultContext(const std::shared_ptr<v8::SnapshotCreator>& creator) {
   FOOTSTONE_CHECK(creator);
   v8::HandleScope handle_scope(isolate_);
@@ -404,6 +506,100 @@ void V8Ctx::SetDefaultContext(const std::shared_ptr<v8::SnapshotCreator>& creato
   creator->SetDefaultContext(context);
 }
 
+void V8Ctx::RecordSnapshotItem(char kind, v8::Local<v8::Data> item) {
+  snapshot_item_kinds_.push_back(kind);
+  snapshot_items_.emplace_back(isolate_, item);
+}
+
+template<typename T>
+v8::Local<T> V8Ctx::ReplaySnapshotItem(v8::Local<v8::Context> context, char kind) {
+  FOOTSTONE_CHECK(snapshot_replay_index_ < snapshot_item_kinds_.size()
+                      && snapshot_item_kinds_[snapshot_replay_index_] == kind)
+    << "snapshot replay mismatch, index = " << snapshot_replay_index_ << ", kind = " << kind;
+  auto index = static_cast<size_t>(kSnapshotManifestIndex) + 1 + snapshot_replay_index_;
+  ++snapshot_replay_index_;
+  return context->GetDataFromSnapshotOnce<T>(index).ToLocalChecked();
+}
+
+bool V8Ctx::AddToSnapshot(const std::shared_ptr<v8::SnapshotCreator>& creator, const std::string& snapshot_tag) {
+  FOOTSTONE_CHECK(creator && snapshot_mode_ == SnapshotMode::kRecord);
+  if (!is_snapshot_compatible_) {
+    return false;
+  }
+  // bootstrap 产生的 microtask 须在写入快照前执行完
+  isolate_->PerformMicrotaskCheckpoint();
+  v8::HandleScope handle_scope(isolate_);
+  auto context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+
+  // 进程内的地址不能写入快照，恢复后重新设置
+  for (auto index: {kNewInstanceExternalIndex, kScopeWrapperIndex, kFunctionWrapperTableIndex}) {
+    context->SetAlignedPointerInEmbedderData(index, nullptr);
+  }
+  for (const auto& instance: snapshot_instances_) {
+    instance.Get(isolate_)->SetInternalField(kExternalIndex, v8::Undefined(isolate_));
+  }
+
+  auto manifest = v8::Array::New(isolate_, kSnapshotManifestLength);
+  auto table_size = footstone::checked_numeric_cast<size_t, uint32_t>(function_wrapper_table_.size());
+  auto flag = manifest->Set(context, kSnapshotManifestTagIndex,
+                            V8VM::CreateV8String(isolate_, context, string_view(snapshot_tag))).FromMaybe(false)
+      && manifest->Set(context, kSnapshotManifestKindsIndex,
+                       V8VM::CreateV8String(isolate_, context, string_view(snapshot_item_kinds_))).FromMaybe(false)
+      && manifest->Set(context, kSnapshotManifestTableSizeIndex,
+                       v8::Integer::NewFromUnsigned(isolate_, table_size)).FromMaybe(false);
+  FOOTSTONE_CHECK(flag);
+  auto index = creator->AddData(context, manifest);
+  FOOTSTONE_CHECK(index == kSnapshotManifestIndex);
+  for (const auto& item: snapshot_items_) {
+    creator->AddData(context, v8::Local<v8::Data>::New(isolate_, item));
+  }
+  creator->AddContext(context);
+  snapshot_items_.clear();
+  snapshot_instances_.clear();
+  snapshot_mode_ = SnapshotMode::kNone;
+  return true;
+}
+
+bool V8Ctx::RestoreFromSnapshot(const std::string& snapshot_tag) {
+  v8::HandleScope handle_scope(isolate_);
+  auto context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+
+  v8::Local<v8::Array> manifest;
+  if (!context->GetDataFromSnapshotOnce<v8::Array>(kSnapshotManifestIndex).ToLocal(&manifest)
+      || manifest->Length() != kSnapshotManifestLength) {
+    FOOTSTONE_LOG(ERROR) << "snapshot manifest missing";
+    return false;
+  }
+  auto tag = manifest->Get(context, kSnapshotManifestTagIndex).ToLocalChecked();
+  auto kinds = manifest->Get(context, kSnapshotManifestKindsIndex).ToLocalChecked();
+  auto table_size = manifest->Get(context, kSnapshotManifestTableSizeIndex).ToLocalChecked();
+  if (!tag->IsString() || !kinds->IsString() || !table_size->IsUint32()) {
+    return false;
+  }
+  auto tag_view = StringViewUtils::ConvertEncoding(V8VM::ToStringView(isolate_, context, tag.As<v8::String>()),
+                                                   string_view::Encoding::Utf8);
+  if (StringViewUtils::ToStdString(tag_view.utf8_value()) != snapshot_tag) {
+    FOOTSTONE_LOG(INFO) << "snapshot tag mismatch";
+    return false;
+  }
+  auto kinds_view = StringViewUtils::ConvertEncoding(V8VM::ToStringView(isolate_, context, kinds.As<v8::String>()),
+                                                     string_view::Encoding::Utf8);
+  snapshot_item_kinds_ = StringViewUtils::ToStdString(kinds_view.utf8_value());
+  snapshot_table_size_ = table_size.As<v8::Uint32>()->Value();
+  snapshot_replay_index_ = 0;
+  snapshot_mode_ = SnapshotMode::kReplay;
+  return true;
+}
+
+bool V8Ctx::FinishRestoreFromSnapshot() {
+  FOOTSTONE_CHECK(snapshot_mode_ == SnapshotMode::kReplay);
+  snapshot_mode_ = SnapshotMode::kNone;
+  return snapshot_replay_index_ == snapshot_item_kinds_.size()
+      && function_wrapper_table_.size() == snapshot_table_size_;
+}
+
 std::shared_ptr<CtxValue> V8Ctx::InternalRunScript(
     v8::Local<v8::Context> context,
     v8::Local<v8::String> source,
@@ -430,6 +626,14 @@ std::shared_ptr<CtxValue> V8Ctx::InternalRunScript(
       v8::ScriptCompiler::Source script_source(source, origin, cached_data);
       script = v8::ScriptCompiler::Compile(
           context, &script_source, v8::ScriptCompiler::kConsumeCodeCache);
+      // V8 版本、flags 或源码不匹配时 cache 会被拒绝，清空 cache 通知调用方丢弃该条目
+      if (script_source.GetCachedData()->rejected) {
+        FOOTSTONE_LOG(WARNING) << "code cache rejected, file_name = " << file_name;
+        *cache = string_view();
+        if (!script.IsEmpty()) {
+          RetainScriptForCodeCache(file_name, script.ToLocalChecked());
+        }
+      }
     } else {
       FOOTSTONE_UNREACHABLE();
     }
@@ -440,12 +644,13 @@ std::shared_ptr<CtxValue> V8Ctx::InternalRunScript(
       if (script.IsEmpty()) {
         return nullptr;
       }
-      const v8::ScriptCompiler::CachedData* cached_data =
+      std::unique_ptr<v8::ScriptCompiler::CachedData> cached_data(
           v8::ScriptCompiler::CreateCodeCache(
-              script.ToLocalChecked()->GetUnboundScript());
+              script.ToLocalChecked()->GetUnboundScript()));
       *cache = string_view(cached_data->data,
                                    footstone::checked_numeric_cast<int,
                                                                      size_t>(cached_data->length));
+      RetainScriptForCodeCache(file_name, script.ToLocalChecked());
     } else {
       script = v8::Script::Compile(context, source, &origin);
     }
@@ -463,6 +668,32 @@ std::shared_ptr<CtxValue> V8Ctx::InternalRunScript(
   return std::make_shared<V8CtxValue>(isolate_, v8_value);
 }
 
+void V8Ctx::RetainScriptForCodeCache(const string_view& file_name, v8::Local<v8::Script> script) {
+  if (!is_retain_script_for_code_cache_) {
+    return;
+  }
+  code_cache_script_map_[file_name].Reset(isolate_, script->GetUnboundScript());
+}
+
+bool V8Ctx::CreateCodeCacheAfterExecute(const string_view& file_name, std::string& cache) {
+  auto it = code_cache_script_map_.find(file_name);
+  if (it == code_cache_script_map_.end()) {
+    return false;
+  }
+  v8::HandleScope handle_scope(isolate_);
+  auto unbound_script = it->second.Get(isolate_);
+  code_cache_script_map_.erase(it);
+  std::unique_ptr<v8::ScriptCompiler::CachedData> cached_data(
+      v8::ScriptCompiler::CreateCodeCache(unbound_script));
+  if (!cached_data || cached_data->length <= 0) {
+    return false;
+  }
+  cache.assign(reinterpret_cast<const char*>(cached_data->data),
+               footstone::checked_numeric_cast<int, size_t>(cached_data->length));
+  FOOTSTONE_DLOG(INFO) << "CreateCodeCacheAfterExecute file_name = " << file_name << ", size = " << cache.length();
+  return true;
+}
+
 void V8Ctx::ThrowException(const std::shared_ptr<CtxValue>& exception) {
   v8::HandleScope handle_scope(isolate_);
   auto context = context_persistent_.Get(isolate_);
@@ -1331,6 +1562,13 @@ std::shared_ptr<CtxValue> V8Ctx::NewInstance(const std::shared_ptr<CtxValue>& cl
   auto context = context_persistent_.Get(isolate_);
   v8::Context::Scope context_scope(context);
 
+  if (snapshot_mode_ == SnapshotMode::kReplay) {
+    // 快照中实例的 internal field 已清空，重新指向本次的 native 对象
+    auto instance = ReplaySnapshotItem<v8::Object>(context, kSnapshotInstanceKind);
+    instance->SetInternalField(kExternalIndex, v8::External::New(isolate_, external));
+    return std::make_shared<V8CtxValue>(isolate_, instance);
+  }
+
   auto v8_cls = std::static_pointer_cast<V8CtxValue>(cls);
   auto cls_handle_value = v8::Local<v8::Value>::New(isolate_, v8_cls->global_value_);
   auto function = v8::Local<v8::Function>::Cast(cls_handle_value);
@@ -1349,6 +1587,10 @@ std::shared_ptr<CtxValue> V8Ctx::NewInstance(const std::shared_ptr<CtxValue>& cl
     auto external_value = v8::External::New(isolate_, external);
     instance->SetInternalField(kExternalIndex, external_value);
   }
+  if (snapshot_mode_ == SnapshotMode::kRecord) {
+    RecordSnapshotItem(kSnapshotInstanceKind, instance);
+    snapshot_instances_.emplace_back(isolate_, instance);
+  }
   return std::make_shared<V8CtxValue>(isolate_, instance);
 }
 
@@ -1368,6 +1610,10 @@ std::shared_ptr<CtxValue> V8Ctx::DefineProxy(const std::unique_ptr<FunctionWrapp
   auto context = context_persistent_.Get(isolate_);
   v8::Context::Scope context_scope(context);
 
+  if (snapshot_mode_ == SnapshotMode::kRecord) {
+    FOOTSTONE_LOG(ERROR) << "DefineProxy is not supported when creating snapshot";
+    is_snapshot_compatible_ = false;
+  }
   auto func_tpl = v8::FunctionTemplate::New(isolate_);
   auto obj_tpl = func_tpl->InstanceTemplate();
   obj_tpl->SetHandler(v8::NamedPropertyHandlerConfiguration(InvokePropertyCallback,
@@ -1375,8 +1621,7 @@ std::shared_ptr<CtxValue> V8Ctx::DefineProxy(const std::unique_ptr<FunctionWrapp
                                                             nullptr,
                                                             nullptr,
                                                             nullptr,
-                                                            v8::External::New(isolate_,
-                                                                              reinterpret_cast<void*>(constructor_wrapper.get()))));
+                                                            CreateCallbackData(constructor_wrapper)));
   obj_tpl->SetInternalFieldCount(1);
   return std::make_shared<V8CtxValue>(isolate_, func_tpl->GetFunction(context).ToLocalChecked());
 }
@@ -1390,6 +1635,29 @@ std::shared_ptr<CtxValue> V8Ctx::DefineClass(const string_view& name,
   auto context = context_persistent_.Get(isolate_);
   v8::Context::Scope context_scope(context);
 
+  if (snapshot_mode_ == SnapshotMode::kReplay) {
+    // 与下方 CreateTemplate 的调用顺序保持一致，使快照中模板的下标指向本次的 FunctionWrapper
+    auto add_function_wrapper = [this](const std::unique_ptr<FunctionWrapper>& wrapper) {
+      if (wrapper && wrapper->data) {
+        AddFunctionWrapper(wrapper);
+      }
+    };
+    add_function_wrapper(constructor_wrapper);
+    for (size_t i = 0; i < property_count; i++) {
+      const auto& prop_desc = properties[i];
+      if (prop_desc->getter || prop_desc->setter) {
+        add_function_wrapper(prop_desc->getter);
+        add_function_wrapper(prop_desc->setter);
+      } else {
+        add_function_wrapper(prop_desc->method);
+      }
+    }
+    auto tpl = ReplaySnapshotItem<v8::FunctionTemplate>(context, kSnapshotTemplateKind);
+    template_map_[name] = std::make_shared<V8ClassDefinition>(isolate_, tpl);
+    auto cls = ReplaySnapshotItem<v8::Function>(context, kSnapshotClassKind);
+    return std::make_shared<V8CtxValue>(isolate_, cls);
+  }
+
   auto tpl = CreateTemplate(constructor_wrapper);
   if (parent) {
     auto parent_template = std::static_pointer_cast<V8ClassDefinition>(parent);
@@ -1434,7 +1702,12 @@ std::shared_ptr<CtxValue> V8Ctx::DefineClass(const string_view& name,
 
   template_map_[name] = std::make_shared<V8ClassDefinition>(isolate_, tpl);
 
-  return std::make_shared<V8CtxValue>(isolate_, tpl->GetFunction(context).ToLocalChecked());
+  auto cls = tpl->GetFunction(context).ToLocalChecked();
+  if (snapshot_mode_ == SnapshotMode::kRecord) {
+    RecordSnapshotItem(kSnapshotTemplateKind, tpl);
+    RecordSnapshotItem(kSnapshotClassKind, cls);
+  }
+  return std::make_shared<V8CtxValue>(isolate_, cls);
 }
 
 bool V8Ctx::Equals(const std::shared_ptr<CtxValue>& lhs, const std::shared_ptr<CtxValue>& rhs) {
@@ -1474,7 +1747,7 @@ bool V8Ctx::IsByteBuffer(const std::shared_ptr<CtxValue>& value) {
   if (handle_value.IsEmpty()) {
     return false;
   }
-  return handle_value->IsArrayBuffer();
+  return handle_value->IsArrayBuffer() || handle_value->IsArrayBufferView();
 }
 
 bool V8Ctx::GetByteBuffer(const std::shared_ptr<CtxValue>& value,
@@ -1490,17 +1763,26 @@ bool V8Ctx::GetByteBuffer(const std::shared_ptr<CtxValue>& value,
   if (handle_value.IsEmpty()) {
     return false;
   }
-  if (!handle_value->IsArrayBuffer()) {
+  // TypedArray 与 DataView 直接指向底层 ArrayBuffer 的对应区间，与 JSC 行为一致，不拷贝
+  size_t byte_offset = 0;
+  v8::Local<v8::ArrayBuffer> array_buffer;
+  if (handle_value->IsArrayBuffer()) {
+    array_buffer = v8::Local<v8::ArrayBuffer>::Cast(handle_value);
+    out_length = array_buffer->ByteLength();
+  } else if (handle_value->IsArrayBufferView()) {
+    auto array_buffer_view = v8::Local<v8::ArrayBufferView>::Cast(handle_value);
+    array_buffer = array_buffer_view->Buffer();
+    byte_offset = array_buffer_view->ByteOffset();
+    out_length = array_buffer_view->ByteLength();
+  } else {
     return false;
   }
-  v8::Local<v8::ArrayBuffer> array_buffer = v8::Local<v8::ArrayBuffer>::Cast(handle_value);
 #if V8_MAJOR_VERSION < 9
-  *out_data = array_buffer->GetContents().Data();
-  out_length = array_buffer->ByteLength();
+  auto data = array_buffer->GetContents().Data();
 #else
-  *out_data = array_buffer->GetBackingStore()->Data();
-  out_length = array_buffer->ByteLength();
+  auto data = array_buffer->GetBackingStore()->Data();
 #endif //V8_MAJOR_VERSION < 9
+  *out_data = data ? reinterpret_cast<uint8_t*>(data) + byte_offset : nullptr;
   return true;
 }
 
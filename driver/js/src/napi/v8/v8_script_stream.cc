@@ -0,0 +1,148 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "driver/napi/v8/v8_script_stream.h"
+
+#include <cstring>
+#include <deque>
+#include <string_view>
+
+#include "footstone/logging.h"
+
+namespace hippy {
+inline namespace driver {
+inline namespace napi {
+
+class V8ScriptStream::SourceStream : public v8::ScriptCompiler::ExternalSourceStream {
+ public:
+  SourceStream() : is_finished_(false) {}
+  ~SourceStream() override = default;
+
+  // V8 在后台线程调用，没有数据时阻塞，返回 0 表示数据结束; 返回的内存由 V8 用 delete[] 释放
+  size_t GetMoreData(const uint8_t** src) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !chunks_.empty() || is_finished_; });
+    if (chunks_.empty()) {
+      return 0;
+    }
+    auto chunk = std::move(chunks_.front());
+    chunks_.pop_front();
+    *src = chunk.first.release();
+    return chunk.second;
+  }
+
+  void Push(std::unique_ptr<uint8_t[]> data, size_t length) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (is_finished_) {
+        return;
+      }
+      chunks_.emplace_back(std::move(data), length);
+    }
+    cv_.notify_one();
+  }
+
+  void Finish() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_finished_ = true;
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::pair<std::unique_ptr<uint8_t[]>, size_t>> chunks_;
+  bool is_finished_;
+};
+
+V8ScriptStream::V8ScriptStream(v8::Isolate* isolate) : is_parse_done_(false), length_(0) {
+  auto source_stream = std::make_unique<SourceStream>();
+  source_stream_ = source_stream.get();
+  streamed_source_ = std::make_unique<v8::ScriptCompiler::StreamedSource>(
+      std::move(source_stream), v8::ScriptCompiler::StreamedSource::UTF8);
+#if V8_MAJOR_VERSION >= 9
+  task_.reset(v8::ScriptCompiler::StartStreaming(isolate, streamed_source_.get()));
+#else
+  task_.reset(v8::ScriptCompiler::StartStreamingScript(isolate, streamed_source_.get()));
+#endif
+}
+
+V8ScriptStream::~V8ScriptStream() {
+  Finish();
+}
+
+void V8ScriptStream::Append(const uint8_t* data, size_t length) {
+  if (length == 0) {
+    return;
+  }
+  auto chunk = std::make_unique<uint8_t[]>(length);
+  memcpy(chunk.get(), data, length);
+  auto hash = std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(data), length));
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    length_ += length;
+    chunks_.emplace_back(length, hash);
+  }
+  source_stream_->Push(std::move(chunk), length);
+}
+
+void V8ScriptStream::Finish() {
+  source_stream_->Finish();
+}
+
+void V8ScriptStream::RunParseTask() {
+  if (task_) {
+    task_->Run();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_parse_done_ = true;
+  }
+  cv_.notify_all();
+}
+
+void V8ScriptStream::WaitForParse() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return is_parse_done_; });
+}
+
+bool V8ScriptStream::IsSameContent(const std::string& content) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (length_ != content.length()) {
+    return false;
+  }
+  size_t offset = 0;
+  for (const auto& [length, hash] : chunks_) {
+    if (std::hash<std::string_view>{}(std::string_view(content.data() + offset, length)) != hash) {
+      FOOTSTONE_DLOG(WARNING) << "V8ScriptStream content changed at offset = " << offset;
+      return false;
+    }
+    offset += length;
+  }
+  return true;
+}
+
+}
+}
+}
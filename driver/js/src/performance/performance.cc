@@ -30,26 +30,55 @@
 #include "footstone/logging.h"
 #include "footstone/string_view_utils.h"
 
+using string_view = footstone::string_view;
+
 namespace hippy {
 inline namespace driver {
 inline namespace performance {
 
 const char* kPerfNavigationHippyInit = "hippyInit";
 constexpr uint32_t kMaxSize = 250;
+constexpr uint32_t kMaxMarkSize = 1000;
+constexpr uint32_t kMaxMeasureSize = 1000;
+constexpr uint32_t kMaxFrameSize = 250;
+constexpr uint32_t kMaxNavigationSize = 16;
+constexpr uint32_t kMaxPaintSize = 16;
+
+static inline size_t TypeIndex(PerformanceEntry::Type type) {
+  return static_cast<size_t>(type);
+}
 
-Performance::Performance(): resource_timing_current_buffer_size_(0),
-    resource_timing_max_buffer_size_(kMaxSize),
-    time_origin_(TimePoint::SystemNow()) {}
+static inline string_view ToUtf16(const string_view& name) {
+  return footstone::StringViewUtils::ConvertEncoding(name, string_view::Encoding::Utf16);
+}
+
+static void SortByStartTime(std::vector<std::shared_ptr<PerformanceEntry>>& entries) {
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const std::shared_ptr<PerformanceEntry>& lhs, const std::shared_ptr<PerformanceEntry>& rhs) {
+                     return lhs->GetStartTime() < rhs->GetStartTime();
+                   });
+}
+
+Performance::Performance(): is_flush_pending_(false), time_origin_(TimePoint::SystemNow()) {
+  auto ignore = [](const PerformanceEntryBuffer::Slot&) {};
+  buffers_[TypeIndex(PerformanceEntry::Type::kFrame)].Resize(kMaxFrameSize, ignore);
+  buffers_[TypeIndex(PerformanceEntry::Type::kNavigation)].Resize(kMaxNavigationSize, ignore);
+  buffers_[TypeIndex(PerformanceEntry::Type::kResource)].Resize(kMaxSize, ignore);
+  buffers_[TypeIndex(PerformanceEntry::Type::kMark)].Resize(kMaxMarkSize, ignore);
+  buffers_[TypeIndex(PerformanceEntry::Type::kMeasure)].Resize(kMaxMeasureSize, ignore);
+  buffers_[TypeIndex(PerformanceEntry::Type::kPaint)].Resize(kMaxPaintSize, ignore);
+}
+
+void Performance::SetResourceTimingBufferSize(uint32_t max_size) {
+  buffers_[TypeIndex(PerformanceEntry::Type::kResource)].Resize(max_size, [this](const PerformanceEntryBuffer::Slot& slot) {
+    ReleaseName(slot.name_id);
+  });
+}
 
 std::shared_ptr<PerformanceNavigationTiming> Performance::PerformanceNavigation(const string_view& name) {
-  auto u16n = footstone::StringViewUtils::ConvertEncoding(name, string_view::Encoding::Utf16);
-  auto name_iterator = name_map_.find(u16n);
-  if (name_iterator != name_map_.end()) {
-    for (auto& entry : name_iterator->second) {
-      if (entry->GetType() == PerformanceEntry::Type::kNavigation) {
-        return std::static_pointer_cast<PerformanceNavigationTiming>(entry);
-      }
-    }
+  auto exist_entry = FindLastEntry(name, PerformanceEntry::Type::kNavigation);
+  if (exist_entry) {
+    return std::static_pointer_cast<PerformanceNavigationTiming>(exist_entry);
   }
 
   auto entry = std::make_shared<PerformanceNavigationTiming>(name);
@@ -61,14 +90,9 @@ std::shared_ptr<PerformanceNavigationTiming> Performance::PerformanceNavigation(
 
 std::shared_ptr<PerformancePaintTiming> Performance::PerformancePaint(const PerformancePaintTiming::Type& type) {
   auto name = (type == PerformancePaintTiming::Type::kFirstPaint ? "first-paint" : "first-contentful-paint");
-  auto u16n = footstone::StringViewUtils::ConvertEncoding(name, string_view::Encoding::Utf16);
-  auto name_iterator = name_map_.find(u16n);
-  if (name_iterator != name_map_.end()) {
-    for (auto& entry : name_iterator->second) {
-      if (entry->GetType() == PerformanceEntry::Type::kPaint) {
-        return std::static_pointer_cast<PerformancePaintTiming>(entry);
-      }
-    }
+  auto exist_entry = FindLastEntry(name, PerformanceEntry::Type::kPaint);
+  if (exist_entry) {
+    return std::static_pointer_cast<PerformancePaintTiming>(exist_entry);
   }
 
   auto entry = std::make_shared<PerformancePaintTiming>(type);
@@ -79,21 +103,15 @@ std::shared_ptr<PerformancePaintTiming> Performance::PerformancePaint(const Perf
 }
 
 std::shared_ptr<PerformanceResourceTiming> Performance::PerformanceResource(const string_view& name) {
-  auto u16n = footstone::StringViewUtils::ConvertEncoding(name, string_view::Encoding::Utf16);
-  auto name_iterator = name_map_.find(u16n);
-  if (name_iterator != name_map_.end()) {
-    for (auto& entry : name_iterator->second) {
-      if (entry->GetType() == PerformanceEntry::Type::kResource) {
-        return std::static_pointer_cast<PerformanceResourceTiming>(entry);
-      }
-    }
+  auto exist_entry = FindLastEntry(name, PerformanceEntry::Type::kResource);
+  if (exist_entry) {
+    return std::static_pointer_cast<PerformanceResourceTiming>(exist_entry);
   }
 
+  // 缓冲区已满时条目不再进入缓冲区，但仍然返回给调用方填充，并投递给观察者
   auto entry = std::make_shared<PerformanceResourceTiming>(name);
-  if (InsertEntry(entry)) {
-    return entry;
-  }
-  return nullptr;
+  InsertEntry(entry);
+  return entry;
 }
 
 void Performance::Mark(const Performance::string_view& name) {
@@ -118,11 +136,7 @@ bool Performance::Measure(const Performance::string_view &name) {
 
 bool Performance::Measure(const Performance::string_view &name,
                           const Performance::string_view &start_mark) {
-  auto entries = GetEntriesByName(start_mark, PerformanceEntry::Type::kMark);
-  if (entries.empty()) {
-    return false;
-  }
-  auto start_mark_entry = entries.back();
+  auto start_mark_entry = FindLastEntry(start_mark, PerformanceEntry::Type::kMark);
   if (!start_mark_entry) {
     return false;
   }
@@ -135,19 +149,11 @@ bool Performance::Measure(const Performance::string_view &name,
 bool Performance::Measure(const Performance::string_view& name,
                           const Performance::string_view& start_mark,
                           const Performance::string_view& end_mark) {
-  auto start_entries = GetEntriesByName(start_mark, PerformanceEntry::Type::kMark);
-  if (start_entries.empty()) {
-    return false;
-  }
-  auto start_mark_entry = start_entries.back();
+  auto start_mark_entry = FindLastEntry(start_mark, PerformanceEntry::Type::kMark);
   if (!start_mark_entry) {
     return false;
   }
-  auto end_entries = GetEntriesByName(end_mark, PerformanceEntry::Type::kMark);
-  if (end_entries.empty()) {
-    return false;
-  }
-  auto end_mark_entry = end_entries.back();
+  auto end_mark_entry = FindLastEntry(end_mark, PerformanceEntry::Type::kMark);
   if (!end_mark_entry) {
     return false;
   }
@@ -155,31 +161,6 @@ bool Performance::Measure(const Performance::string_view& name,
   return true;
 }
 
-bool Performance::InsertEntry(const std::shared_ptr<PerformanceEntry>& entry) {
-  if (entry->GetType() == PerformanceEntry::Type::kResource) {
-    if (resource_timing_current_buffer_size_ >= resource_timing_max_buffer_size_) {
-      return false;
-    }
-    ++resource_timing_current_buffer_size_;
-  }
-  auto name = entry->GetName();
-  auto u16n = footstone::StringViewUtils::ConvertEncoding(name, string_view::Encoding::Utf16);
-  auto name_iterator = name_map_.find(u16n);
-  if (name_iterator == name_map_.end()) {
-    name_map_[u16n] = { entry };
-  } else {
-    name_map_[u16n].push_back(entry);
-  }
-  auto type = entry->GetType();
-  auto type_iterator = type_map_.find(type);
-  if (type_iterator == type_map_.end()) {
-    type_map_[type] = { entry };
-  } else {
-    type_map_[type].push_back(entry);
-  }
-  return true;
-}
-
 bool Performance::Measure(const Performance::string_view& name,
                           const std::shared_ptr<PerformanceEntry>& start_mark,
                           const std::shared_ptr<PerformanceEntry>& end_mark) {
@@ -190,117 +171,212 @@ bool Performance::Measure(const Performance::string_view& name,
   return InsertEntry(entry);
 }
 
+bool Performance::InsertEntry(const std::shared_ptr<PerformanceEntry>& entry) {
+  auto type = entry->GetType();
+  FOOTSTONE_DCHECK(type != PerformanceEntry::Type::kError);
+  NotifyObservers(entry);
+  auto& buffer = buffers_[TypeIndex(type)];
+  // resource 与浏览器行为一致，缓冲区满后丢弃新条目；其余类型覆盖最旧的条目
+  if (type == PerformanceEntry::Type::kResource && buffer.IsFull()) {
+    return false;
+  }
+  auto evicted = buffer.Push(InternName(entry->GetName()), entry);
+  if (evicted.entry) {
+    ReleaseName(evicted.name_id);
+  }
+  return true;
+}
+
+std::shared_ptr<PerformanceEntry> Performance::FindLastEntry(const Performance::string_view& name,
+                                                             PerformanceEntry::Type type) {
+  uint32_t name_id;
+  if (!FindNameId(name, name_id)) {
+    return nullptr;
+  }
+  const auto& buffer = buffers_[TypeIndex(type)];
+  for (auto i = buffer.GetSize(); i > 0; --i) {
+    const auto& slot = buffer.At(i - 1);
+    if (slot.name_id == name_id) {
+      return slot.entry;
+    }
+  }
+  return nullptr;
+}
+
 std::vector<std::shared_ptr<PerformanceEntry>> Performance::GetEntriesByName(const Performance::string_view& name) {
-  auto u16n = footstone::StringViewUtils::ConvertEncoding(name, string_view::Encoding::Utf16);
-  auto iterator = name_map_.find(u16n);
-  if (iterator == name_map_.end()) {
-    return {};
+  std::vector<std::shared_ptr<PerformanceEntry>> ret;
+  uint32_t name_id;
+  if (!FindNameId(name, name_id)) {
+    return ret;
   }
-  return iterator->second;
+  for (const auto& buffer: buffers_) {
+    for (size_t i = 0; i < buffer.GetSize(); ++i) {
+      const auto& slot = buffer.At(i);
+      if (slot.name_id == name_id) {
+        ret.push_back(slot.entry);
+      }
+    }
+  }
+  SortByStartTime(ret);
+  return ret;
 }
 
 std::vector<std::shared_ptr<PerformanceEntry>> Performance::GetEntriesByName(const Performance::string_view& name,
                                                                              PerformanceEntry::Type type) {
-  auto u16n = footstone::StringViewUtils::ConvertEncoding(name, string_view::Encoding::Utf16);
-  auto iterator = name_map_.find(u16n);
-  if (iterator == name_map_.end()) {
-    return {};
-  }
-  auto array = iterator->second;
-  auto array_iterator = std::find_if(array.begin(), array.end(),
-                                  [type](const std::shared_ptr<PerformanceEntry>& entry) {
-    return entry->GetType() == type;
-  });
-  if (array_iterator == array.end()) {
-    return {};
+  std::vector<std::shared_ptr<PerformanceEntry>> ret;
+  uint32_t name_id;
+  if (type == PerformanceEntry::Type::kError || !FindNameId(name, name_id)) {
+    return ret;
+  }
+  const auto& buffer = buffers_[TypeIndex(type)];
+  for (size_t i = 0; i < buffer.GetSize(); ++i) {
+    const auto& slot = buffer.At(i);
+    if (slot.name_id == name_id) {
+      ret.push_back(slot.entry);
+    }
   }
-  return std::vector<std::shared_ptr<PerformanceEntry>>(array_iterator, array.end());
+  return ret;
 }
 
 std::vector<std::shared_ptr<PerformanceEntry>> Performance::GetEntriesByType(PerformanceEntry::Type type) {
-  auto iterator = type_map_.find(type);
-  if (iterator == type_map_.end()) {
-    return {};
+  std::vector<std::shared_ptr<PerformanceEntry>> ret;
+  if (type == PerformanceEntry::Type::kError) {
+    return ret;
+  }
+  const auto& buffer = buffers_[TypeIndex(type)];
+  ret.reserve(buffer.GetSize());
+  for (size_t i = 0; i < buffer.GetSize(); ++i) {
+    ret.push_back(buffer.At(i).entry);
   }
-  return iterator->second;
+  return ret;
 }
 
-void Performance::RemoveEntry(const Performance::string_view& name) {
-  auto u16n = footstone::StringViewUtils::ConvertEncoding(name, string_view::Encoding::Utf16);
-  auto name_iterator = name_map_.find(u16n);
-  if (name_iterator == name_map_.end()) {
+void Performance::RemoveEntry(PerformanceEntry::Type type) {
+  buffers_[TypeIndex(type)].Clear([this](const PerformanceEntryBuffer::Slot& slot) {
+    ReleaseName(slot.name_id);
+  });
+}
+
+void Performance::RemoveEntry(const Performance::string_view& name, PerformanceEntry::Type type) {
+  uint32_t name_id;
+  if (!FindNameId(name, name_id)) {
     return;
   }
-  for (const auto& entry: name_iterator->second) {
-    auto type_iterator = type_map_.find(entry->GetType());
-    FOOTSTONE_CHECK(type_iterator != type_map_.end());
-    auto array = type_iterator->second;
-    auto erase_iterator = std::remove_if(array.begin(), array.end(),
-                                      [u16n](const std::shared_ptr<PerformanceEntry>& item) {
-      auto u16n2 = footstone::StringViewUtils::ConvertEncoding(item->GetName(), string_view::Encoding::Utf16);
-      return u16n2 == u16n;
-    });
-    if (entry->GetType() == PerformanceEntry::Type::kResource) {
-      auto count = std::distance(erase_iterator, array.end());
-      resource_timing_current_buffer_size_ -= static_cast<uint32_t>(count);
-      FOOTSTONE_CHECK(resource_timing_current_buffer_size_ >= 0);
-    }
-    array.erase(erase_iterator, array.end());
+  buffers_[TypeIndex(type)].RemoveIf([name_id](const PerformanceEntryBuffer::Slot& slot) {
+    return slot.name_id == name_id;
+  }, [this](const PerformanceEntryBuffer::Slot& slot) {
+    ReleaseName(slot.name_id);
+  });
+}
+
+uint32_t Performance::InternName(const Performance::string_view& name) {
+  auto u16n = ToUtf16(name);
+  auto iterator = name_ids_.find(u16n);
+  if (iterator != name_ids_.end()) {
+    ++names_[iterator->second].ref_count;
+    return iterator->second;
   }
-  name_map_.erase(name_iterator);
+  uint32_t name_id;
+  if (free_name_ids_.empty()) {
+    name_id = static_cast<uint32_t>(names_.size());
+    names_.emplace_back();
+  } else {
+    name_id = free_name_ids_.back();
+    free_name_ids_.pop_back();
+  }
+  iterator = name_ids_.emplace(std::move(u16n), name_id).first;
+  // unordered_map 的元素地址在 rehash 后保持不变
+  names_[name_id] = {&iterator->first, 1};
+  return name_id;
 }
 
-void Performance::RemoveEntry(PerformanceEntry::Type type) {
-  auto type_iterator = type_map_.find(type);
-  if (type_iterator == type_map_.end()) {
+bool Performance::FindNameId(const Performance::string_view& name, uint32_t& name_id) const {
+  auto iterator = name_ids_.find(ToUtf16(name));
+  if (iterator == name_ids_.end()) {
+    return false;
+  }
+  name_id = iterator->second;
+  return true;
+}
+
+void Performance::ReleaseName(uint32_t name_id) {
+  FOOTSTONE_DCHECK(name_id < names_.size() && names_[name_id].ref_count > 0);
+  auto& interned_name = names_[name_id];
+  if (--interned_name.ref_count > 0) {
     return;
   }
-  for (const auto& entry: type_iterator->second) {
-    auto u16n = footstone::StringViewUtils::ConvertEncoding(entry->GetName(), string_view::Encoding::Utf16);
-    auto name_iterator = name_map_.find(u16n);
-    FOOTSTONE_CHECK(name_iterator != name_map_.end());
-    auto array = name_iterator->second;
-    array.erase(std::remove_if(array.begin(), array.end(),
-                            [type](const std::shared_ptr<PerformanceEntry>& item) {
-      return item->GetType() == type;
-    }), array.end());
+  name_ids_.erase(*interned_name.name);
+  interned_name.name = nullptr;
+  free_name_ids_.push_back(name_id);
+}
+
+void Performance::Observe(const std::shared_ptr<PerformanceObserver>& observer,
+                          const std::vector<PerformanceEntry::Type>& types,
+                          bool buffered) {
+  for (auto type: types) {
+    observer->AddEntryType(type);
+    if (buffered && type != PerformanceEntry::Type::kError) {
+      ForEachEntry(type, [&observer](const std::shared_ptr<PerformanceEntry>& entry) {
+        observer->Enqueue(entry);
+      });
+    }
+  }
+  if (std::find(observers_.begin(), observers_.end(), observer) == observers_.end()) {
+    observers_.push_back(observer);
   }
-  if (type == PerformanceEntry::Type::kResource) {
-    resource_timing_current_buffer_size_ = 0;
+  if (buffered) {
+    FlushObservers();
   }
-  type_map_.erase(type_iterator);
 }
 
-void Performance::RemoveEntry(const Performance::string_view& name, PerformanceEntry::Type type) {
-  auto u16n = footstone::StringViewUtils::ConvertEncoding(name, string_view::Encoding::Utf16);
-  auto name_iterator = name_map_.find(u16n);
-  if (name_iterator == name_map_.end()) {
-    return;
+void Performance::Disconnect(const std::shared_ptr<PerformanceObserver>& observer) {
+  observer->ClearEntryTypes();
+  observer->TakeRecords();
+  observers_.erase(std::remove(observers_.begin(), observers_.end(), observer), observers_.end());
+}
+
+void Performance::ClearObservers() {
+  observers_.clear();
+}
+
+void Performance::NotifyObservers(const std::shared_ptr<PerformanceEntry>& entry) {
+  auto is_enqueued = false;
+  for (const auto& observer: observers_) {
+    if (observer->IsObserving(entry->GetType())) {
+      observer->Enqueue(entry);
+      is_enqueued = true;
+    }
+  }
+  if (is_enqueued) {
+    FlushObservers();
   }
+}
 
-  auto name_array = name_iterator->second;
-  name_array.erase(std::remove_if(name_array.begin(), name_array.end(),
-                               [&type_map = type_map_, &size = resource_timing_current_buffer_size_, u16n, type](
-                                   const std::shared_ptr<PerformanceEntry>& entry) {
-    if (entry->GetType() != type) {
-      return false;
+void Performance::FlushObservers() {
+  auto runner = task_runner_.lock();
+  if (!runner) {
+    auto observers = observers_;
+    for (const auto& observer: observers) {
+      observer->Notify();
     }
-    auto type_iterator = type_map.find(type);
-    FOOTSTONE_CHECK(type_iterator != type_map.end());
-    auto type_array = type_iterator->second;
-    auto erase_iterator = std::remove_if(type_array.begin(), type_array.end(),
-                                      [u16n](const std::shared_ptr<PerformanceEntry>& item) {
-      auto u16n2 = footstone::StringViewUtils::ConvertEncoding(item->GetName(), string_view::Encoding::Utf16);
-      return u16n2 == u16n;
-    });
-    if (type == PerformanceEntry::Type::kResource) {
-      auto count = std::distance(erase_iterator, type_array.end());
-      size -= static_cast<uint32_t>(count);
-      FOOTSTONE_CHECK(size >= 0);
+    return;
+  }
+  if (is_flush_pending_) {
+    return;
+  }
+  is_flush_pending_ = true;
+  // 同一任务内产生的条目合并为一次回调
+  runner->PostTask([weak_performance = weak_from_this()]() {
+    auto performance = weak_performance.lock();
+    if (!performance) {
+      return;
+    }
+    performance->is_flush_pending_ = false;
+    auto observers = performance->observers_;
+    for (const auto& observer: observers) {
+      observer->Notify();
     }
-    type_array.erase(erase_iterator, type_array.end());
-    return true;
-  }), name_array.end());
+  });
 }
 
 Performance::TimePoint Performance::Now() {
@@ -320,22 +396,18 @@ void Performance::ClearResourceTimings() {
 }
 
 std::vector<std::shared_ptr<PerformanceEntry>> Performance::GetEntries() {
+  size_t size = 0;
+  for (const auto& buffer: buffers_) {
+    size += buffer.GetSize();
+  }
   std::vector<std::shared_ptr<PerformanceEntry>> ret;
-  for (auto [ key, value ]: type_map_) {
-    if (!ret.empty()) {
-      std::vector<std::shared_ptr<PerformanceEntry>> merged_ret;
-      std::merge(ret.begin(), ret.end(), value.begin(), value.end(), std::back_inserter(merged_ret),
-                 [](const std::shared_ptr<PerformanceEntry>& lhs, const std::shared_ptr<PerformanceEntry>& rhs) {
-                   if (lhs && rhs) {
-                     return lhs->GetStartTime() < rhs->GetStartTime();
-                   }
-                   return true;
-                 });
-      ret = merged_ret;
-    } else {
-      ret = value;
+  ret.reserve(size);
+  for (const auto& buffer: buffers_) {
+    for (size_t i = 0; i < buffer.GetSize(); ++i) {
+      ret.push_back(buffer.At(i).entry);
     }
   }
+  SortByStartTime(ret);
   return ret;
 }
 
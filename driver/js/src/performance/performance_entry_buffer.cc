@@ -0,0 +1,55 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2023 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "driver/performance/performance_entry_buffer.h"
+
+#include "footstone/check.h"
+
+namespace hippy {
+inline namespace driver {
+inline namespace performance {
+
+PerformanceEntryBuffer::Slot PerformanceEntryBuffer::Push(uint32_t name_id,
+                                                          const std::shared_ptr<PerformanceEntry>& entry) {
+  FOOTSTONE_DCHECK(capacity_ > 0);
+  Slot evicted;
+  if (capacity_ == 0) {
+    return evicted;
+  }
+  if (slots_.empty()) {
+    slots_.resize(capacity_);
+  }
+  if (size_ < capacity_) {
+    SlotAt(size_) = {name_id, entry};
+    ++size_;
+  } else {
+    auto& slot = slots_[head_];
+    evicted = std::move(slot);
+    slot = {name_id, entry};
+    head_ = (head_ + 1) % capacity_;
+  }
+  return evicted;
+}
+
+}
+}
+}
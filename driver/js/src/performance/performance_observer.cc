@@ -0,0 +1,94 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2023 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "driver/performance/performance_observer.h"
+
+#include "footstone/string_view_utils.h"
+
+namespace hippy {
+inline namespace driver {
+inline namespace performance {
+
+PerformanceObserver::PerformanceObserver(Callback callback): callback_(std::move(callback)), type_mask_(0) {}
+
+void PerformanceObserver::AddEntryType(PerformanceEntry::Type type) {
+  if (type == PerformanceEntry::Type::kError) {
+    return;
+  }
+  type_mask_ |= TypeBit(type);
+}
+
+void PerformanceObserver::Enqueue(const std::shared_ptr<PerformanceEntry>& entry) {
+  records_.push_back(entry);
+}
+
+PerformanceObserver::Entries PerformanceObserver::TakeRecords() {
+  Entries records;
+  records.swap(records_);
+  return records;
+}
+
+void PerformanceObserver::Notify() {
+  if (records_.empty() || !callback_) {
+    return;
+  }
+  callback_(TakeRecords());
+}
+
+PerformanceObserverEntryList::Entries PerformanceObserverEntryList::GetEntriesByName(const string_view& name) const {
+  auto u16n = footstone::StringViewUtils::ConvertEncoding(name, string_view::Encoding::Utf16);
+  Entries ret;
+  for (const auto& entry: entries_) {
+    if (footstone::StringViewUtils::ConvertEncoding(entry->GetName(), string_view::Encoding::Utf16) == u16n) {
+      ret.push_back(entry);
+    }
+  }
+  return ret;
+}
+
+PerformanceObserverEntryList::Entries PerformanceObserverEntryList::GetEntriesByName(
+    const string_view& name, PerformanceEntry::Type type) const {
+  auto u16n = footstone::StringViewUtils::ConvertEncoding(name, string_view::Encoding::Utf16);
+  Entries ret;
+  for (const auto& entry: entries_) {
+    if (entry->GetType() == type
+        && footstone::StringViewUtils::ConvertEncoding(entry->GetName(), string_view::Encoding::Utf16) == u16n) {
+      ret.push_back(entry);
+    }
+  }
+  return ret;
+}
+
+PerformanceObserverEntryList::Entries PerformanceObserverEntryList::GetEntriesByType(
+    PerformanceEntry::Type type) const {
+  Entries ret;
+  for (const auto& entry: entries_) {
+    if (entry->GetType() == type) {
+      ret.push_back(entry);
+    }
+  }
+  return ret;
+}
+
+}
+}
+}
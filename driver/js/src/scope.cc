@@ -42,6 +42,7 @@
 #include "driver/modules/performance/performance_measure_module.h"
 #include "driver/modules/performance/performance_module.h"
 #include "driver/modules/performance/performance_navigation_timing_module.h"
+#include "driver/modules/performance/performance_observer_module.h"
 #include "driver/modules/performance/performance_paint_timing_module.h"
 #include "driver/modules/performance/performance_resource_timing_module.h"
 #include "driver/modules/scene_builder_module.h"
@@ -118,7 +119,7 @@ static void InternalBindingCallback(hippy::napi::CallbackInfo& info, void* data)
   info.GetReturnValue()->Set(js_object);
 }
 
-// REGISTER_EXTERNAL_REFERENCES(InternalBindingCallback)
+REGISTER_EXTERNAL_REFERENCES(InternalBindingCallback)
 
 Scope::Scope(std::weak_ptr<Engine> engine,
              std::string name)
@@ -126,10 +127,16 @@ Scope::Scope(std::weak_ptr<Engine> engine,
       context_(nullptr),
       name_(std::move(name)),
       call_ui_function_callback_id_(0),
-      performance_(std::make_shared<Performance>()) {}
+      performance_(std::make_shared<Performance>()) {
+  auto the_engine = engine_.lock();
+  if (the_engine) {
+    performance_->SetTaskRunner(the_engine->GetJsTaskRunner());
+  }
+}
 
 Scope::~Scope() {
   FOOTSTONE_DLOG(INFO) << "~Scope";
+  performance_->ClearObservers();
 #ifdef JS_JSC
 /*
  * JSObjectFinalizeCallback will be called when you call JSContextGroupRelease, so it is necessary to hold the wrapper when ctx is destroyed.
@@ -184,10 +191,19 @@ void Scope::SyncInitialize() {
   Bootstrap();
 }
 
+void Scope::SyncInitializeFromSnapshot() {
+  RegisterJavascriptClasses();
+  BindModule();
+}
+
 void Scope::CreateContext() {
   auto engine = engine_.lock();
   FOOTSTONE_CHECK(engine);
-  context_ = engine->GetVM()->CreateContext();
+  AttachContext(engine->GetVM()->CreateContext());
+}
+
+void Scope::AttachContext(const std::shared_ptr<Ctx>& context) {
+  context_ = context;
   FOOTSTONE_CHECK(context_);
   wrapper_ = std::make_unique<ScopeWrapper>(weak_from_this());
   context_->SetExternalData(wrapper_.get());
@@ -347,6 +363,22 @@ void Scope::RegisterJavascriptClasses() {
                         context_->CreateString(key),
                         performance_paint_timing_class,
                         PropertyAttribute::ReadOnly);
+
+  auto performance_observer = hippy::RegisterPerformanceObserver(weak_scope);
+  auto performance_observer_class = DefineClass(performance_observer);
+  key = performance_observer->name;
+  SaveClassTemplate(key, std::move(performance_observer));
+  SetJavascriptClass(key, performance_observer_class);
+  context_->SetProperty(global_object,
+                        context_->CreateString(key),
+                        performance_observer_class,
+                        PropertyAttribute::ReadOnly);
+
+  auto performance_observer_entry_list = hippy::RegisterPerformanceObserverEntryList(weak_scope);
+  auto performance_observer_entry_list_class = DefineClass(performance_observer_entry_list);
+  key = performance_observer_entry_list->name;
+  SaveClassTemplate(key, std::move(performance_observer_entry_list));
+  SetJavascriptClass(key, performance_observer_entry_list_class);
 }
 
 hippy::dom::EventListenerInfo Scope::AddListener(const EventListenerInfo& event_listener_info) {
@@ -22,8 +22,6 @@
 
 #include "driver/vm/v8/serializer.h"
 
-const int kMaxReusedBuffersSize = 128 * 1024;  // 128k
-
 Serializer::Serializer(v8::Isolate* isolate,
                        v8::Local<v8::Context> context,
                        std::string& reused_buffer)
@@ -24,6 +24,7 @@
 
 #include "v8/libplatform/libplatform.h"
 
+#include "driver/base/external_references.h"
 #include "footstone/check.h"
 #include "footstone/string_view.h"
 #include "footstone/string_view_utils.h"
@@ -94,13 +95,28 @@ V8VM::V8VM(const std::shared_ptr<V8VMInitParam>& param) : VM(param) {
 #endif    
     }
   }
-  create_params_.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
-  if (param) {
-    create_params_.constraints.ConfigureDefaultsFromHeapSize(param->initial_heap_size_in_bytes,
-                                                             param->maximum_heap_size_in_bytes);
+  if (param && param->type == V8VMInitParam::V8VMInitType::kCreateSnapshot) {
+    // SnapshotCreator 持有并 Enter 了 isolate，析构时负责 Exit 和 Dispose
+    snapshot_creator_ = std::make_shared<v8::SnapshotCreator>(ExternalReferences::Get());
+    isolate_ = snapshot_creator_->GetIsolate();
+  } else {
+    create_params_.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
+    if (param) {
+      create_params_.constraints.ConfigureDefaultsFromHeapSize(param->initial_heap_size_in_bytes,
+                                                               param->maximum_heap_size_in_bytes);
+      if (param->type == V8VMInitParam::V8VMInitType::kUseSnapshot) {
+        if (param->snapshot_blob && param->snapshot_blob->IsValid()) {
+          snapshot_blob_ = param->snapshot_blob;
+          create_params_.snapshot_blob = snapshot_blob_.get();
+          create_params_.external_references = ExternalReferences::Get();
+        } else {
+          FOOTSTONE_LOG(WARNING) << "snapshot blob is invalid, ignore it";
+        }
+      }
+    }
+    isolate_ = v8::Isolate::New(create_params_);
+    isolate_->Enter();
   }
-  isolate_ = v8::Isolate::New(create_params_);
-  isolate_->Enter();
   isolate_->SetCaptureStackTraceForUncaughtExceptions(true);
   if (param && param->near_heap_limit_callback) {
     isolate_->AddNearHeapLimitCallback(param->near_heap_limit_callback,
@@ -108,10 +124,12 @@ V8VM::V8VM(const std::shared_ptr<V8VMInitParam>& param) : VM(param) {
   }
 
   enable_v8_serialization_ = param->enable_v8_serialization;
+  enable_code_cache_after_idle_ = param->enable_code_cache_after_idle;
   FOOTSTONE_DLOG(INFO) << "V8VM end";
 }
 
 constexpr static int kScopeWrapperIndex = 5;
+constexpr static size_t kSnapshotContextIndex = 0;
 
 
 static void UncaughtExceptionMessageCallback(v8::Local<v8::Message> message, v8::Local<v8::Value> data) {
@@ -147,6 +165,10 @@ V8VM::~V8VM() {
 #if defined(ENABLE_INSPECTOR) && !defined(V8_WITHOUT_INSPECTOR)
   inspector_client_ = nullptr;
 #endif
+  if (snapshot_creator_) {
+    snapshot_creator_ = nullptr;
+    return;
+  }
   isolate_->Exit();
   isolate_->Dispose();
   delete create_params_.array_buffer_allocator;
@@ -167,7 +189,48 @@ void V8VM::PlatformDestroy() {
 
 std::shared_ptr<Ctx> V8VM::CreateContext() {
   FOOTSTONE_DLOG(INFO) << "CreateContext";
-  return std::make_shared<V8Ctx>(isolate_);
+  auto ctx = std::make_shared<V8Ctx>(isolate_);
+  if (snapshot_creator_) {
+    ctx->RecordForSnapshot();
+  } else {
+    ctx->SetRetainScriptForCodeCache(enable_code_cache_after_idle_);
+  }
+  return ctx;
+}
+
+std::shared_ptr<V8Ctx> V8VM::CreateContextFromSnapshot(const std::string& snapshot_tag) {
+  if (!snapshot_blob_) {
+    return nullptr;
+  }
+  FOOTSTONE_DLOG(INFO) << "CreateContextFromSnapshot";
+  v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context;
+  if (!v8::Context::FromSnapshot(isolate_, kSnapshotContextIndex).ToLocal(&context)) {
+    FOOTSTONE_LOG(ERROR) << "deserialize context from snapshot failed";
+    return nullptr;
+  }
+  auto ctx = std::make_shared<V8Ctx>(isolate_, context);
+  if (!ctx->RestoreFromSnapshot(snapshot_tag)) {
+    return nullptr;
+  }
+  ctx->SetRetainScriptForCodeCache(enable_code_cache_after_idle_);
+  return ctx;
+}
+
+std::string V8VM::CreateSnapshotBlob() {
+  FOOTSTONE_CHECK(snapshot_creator_);
+  {
+    v8::HandleScope handle_scope(isolate_);
+    // 默认 context 保持未初始化，global config 与快照不一致时 v8::Context::New 仍能得到干净的 context
+    snapshot_creator_->SetDefaultContext(v8::Context::New(isolate_));
+  }
+  auto blob = snapshot_creator_->CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kKeep);
+  if (!blob.data) {
+    return "";
+  }
+  std::string ret(blob.data, footstone::checked_numeric_cast<int, size_t>(blob.raw_size));
+  delete[] blob.data;
+  return ret;
 }
 
 string_view V8VM::ToStringView(v8::Isolate* isolate,
@@ -1259,8 +1259,7 @@ static NSString *const hippyOnNightModeChangedParam2 = @"RootViewTag";
     if (!rootNode) {
         return;
     }
-    std::string string(reinterpret_cast<const char *>([data bytes]), [data length]);
-    domManager->SetSnapShot(rootNode, string);
+    domManager->SetSnapShot(rootNode, reinterpret_cast<const uint8_t *>([data bytes]), [data length]);
 }
 
 
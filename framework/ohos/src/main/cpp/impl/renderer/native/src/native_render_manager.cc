@@ -66,7 +66,7 @@ constexpr char kNumberOfLines[] = "numberOfLines";
   do {                                                \
     FOOTSTONE_DCHECK(NODE != nullptr);                \
     if (STYLES->find(FIND_STYLE) != STYLES->end()) {  \
-      NODE->MarkDirty();                              \
+      NODE->MarkLayoutNodeDirty();                    \
       return;                                         \
     }                                                 \
   } while (0)
@@ -1144,21 +1144,21 @@ void NativeRenderManager::MarkTextDirty(std::weak_ptr<RootNode> weak_root_node,
     if (node) {
       auto diff_style = node->GetDiffStyle();
       if (diff_style) {
-        MARK_DIRTY_PROPERTY(diff_style, kFontStyle, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kLetterSpacing, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kColor, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kFontSize, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kFontFamily, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kFontWeight, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kTextDecorationLine, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kTextShadowOffset, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kTextShadowRadius, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kTextShadowColor, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kLineHeight, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kTextAlign, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kText, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kEnableScale, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kNumberOfLines, node->GetLayoutNode());
+        MARK_DIRTY_PROPERTY(diff_style, kFontStyle, node);
+        MARK_DIRTY_PROPERTY(diff_style, kLetterSpacing, node);
+        MARK_DIRTY_PROPERTY(diff_style, kColor, node);
+        MARK_DIRTY_PROPERTY(diff_style, kFontSize, node);
+        MARK_DIRTY_PROPERTY(diff_style, kFontFamily, node);
+        MARK_DIRTY_PROPERTY(diff_style, kFontWeight, node);
+        MARK_DIRTY_PROPERTY(diff_style, kTextDecorationLine, node);
+        MARK_DIRTY_PROPERTY(diff_style, kTextShadowOffset, node);
+        MARK_DIRTY_PROPERTY(diff_style, kTextShadowRadius, node);
+        MARK_DIRTY_PROPERTY(diff_style, kTextShadowColor, node);
+        MARK_DIRTY_PROPERTY(diff_style, kLineHeight, node);
+        MARK_DIRTY_PROPERTY(diff_style, kTextAlign, node);
+        MARK_DIRTY_PROPERTY(diff_style, kText, node);
+        MARK_DIRTY_PROPERTY(diff_style, kEnableScale, node);
+        MARK_DIRTY_PROPERTY(diff_style, kNumberOfLines, node);
       }
     }
   }
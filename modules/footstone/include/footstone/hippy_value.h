@@ -50,6 +50,8 @@ class HippyValue final {
 
   HippyValue() {}
   HippyValue(const HippyValue& source);
+  // 移动后 source 仍是同类型的空值
+  HippyValue(HippyValue&& source) noexcept;
 
   /**
    * @brief 构造 int32_t 类型的 dom value
@@ -123,7 +125,7 @@ class HippyValue final {
    * @brief 移动构造 array 类型的 dom value
    * @param array_value HippyValueArrayType 的对象
    */
-  explicit HippyValue(HippyValueArrayType&& array_value) : type_(Type::kArray), arr_(array_value) {}
+  explicit HippyValue(HippyValueArrayType&& array_value) : type_(Type::kArray), arr_(std::move(array_value)) {}
 
   /**
    * @brief 移动构造 array 类型的 dom value
@@ -133,6 +135,7 @@ class HippyValue final {
   ~HippyValue();
 
   HippyValue& operator=(const HippyValue& rhs) noexcept;
+  HippyValue& operator=(HippyValue&& rhs) noexcept;
   HippyValue& operator=(const int32_t rhs) noexcept;
   HippyValue& operator=(const uint32_t rhs) noexcept;
   HippyValue& operator=(const double rhs) noexcept;
@@ -24,13 +24,14 @@
 #include <cstdint>
 #include <functional>
 
+#include "footstone/mpsc_queue.h"
 #include "footstone/time_delta.h"
 #include "footstone/time_point.h"
 
 namespace footstone {
 inline namespace runner {
 
-class IdleTask {
+class IdleTask : public MpscQueueNode {
  public:
   struct IdleCbParam {
     bool did_time_out;
@@ -0,0 +1,119 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace footstone {
+inline namespace runner {
+
+template <typename T>
+class MpscQueue;
+
+class MpscQueueNode {
+ private:
+  template <typename T>
+  friend class MpscQueue;
+
+  std::atomic<MpscQueueNode*> mpsc_next_{nullptr};
+};
+
+/*
+ * 无锁多生产者单消费者队列 (Dmitry Vyukov 的侵入式 MPSC 队列)
+ * Push 可以在任意线程调用, 只需要一次原子交换; Pop 和 Clear 同一时刻只能有一个线程调用.
+ * 生产者正在入队时 Pop 可能暂时返回 nullptr, 生产者入队完成后会通知消费者, 因此不会丢任务.
+ */
+template <typename T>
+class MpscQueue {
+  static_assert(std::is_base_of_v<MpscQueueNode, T>, "T must derive from MpscQueueNode");
+
+ public:
+  MpscQueue() : head_(&stub_), tail_(&stub_) {}
+  ~MpscQueue() { Clear(); }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  void Push(std::unique_ptr<T> item) {
+    size_.fetch_add(1, std::memory_order_relaxed);
+    PushNode(item.release());
+  }
+
+  std::unique_ptr<T> Pop() {
+    MpscQueueNode* tail = tail_;
+    MpscQueueNode* next = tail->mpsc_next_.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return nullptr;
+      }
+      tail_ = next;
+      tail = next;
+      next = next->mpsc_next_.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+      tail_ = next;
+      return Release(tail);
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+      // 生产者已交换 head_ 但还未链接 next
+      return nullptr;
+    }
+    PushNode(&stub_);
+    next = tail->mpsc_next_.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      tail_ = next;
+      return Release(tail);
+    }
+    return nullptr;
+  }
+
+  void Clear() {
+    while (Pop()) {
+    }
+  }
+
+  // 近似值, 生产者入队过程中可能大于实际可出队的数量
+  inline size_t Size() const { return size_.load(std::memory_order_relaxed); }
+  inline bool IsEmpty() const { return Size() == 0; }
+
+ private:
+  void PushNode(MpscQueueNode* node) {
+    node->mpsc_next_.store(nullptr, std::memory_order_relaxed);
+    MpscQueueNode* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->mpsc_next_.store(node, std::memory_order_release);
+  }
+
+  std::unique_ptr<T> Release(MpscQueueNode* node) {
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    return std::unique_ptr<T>(static_cast<T*>(node));
+  }
+
+  std::atomic<MpscQueueNode*> head_;
+  MpscQueueNode* tail_;
+  MpscQueueNode stub_;
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace runner
+}  // namespace footstone
@@ -0,0 +1,66 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace footstone {
+inline namespace runner {
+
+class Worker;
+
+/*
+ * work stealing 模式下的调度器，由 WorkerManager 创建并注册其可调度的 Worker
+ * 1. 空闲的 Worker 从正在运行任务的 Worker 上窃取一个有待执行任务的 TaskRunner 分组
+ * 2. 只窃取可调度且未指定 group_id 的分组，正在运行的分组不会被窃取，因此同一个 TaskRunner 的任务依然串行执行
+ * 3. 任务被 post 到正在运行任务的 Worker 时，唤醒一个空闲的 Worker 来窃取
+ */
+class Scheduler {
+ public:
+  Scheduler() = default;
+  ~Scheduler() = default;
+
+  Scheduler(Scheduler&) = delete;
+  Scheduler& operator=(Scheduler&) = delete;
+
+  void AddWorker(const std::shared_ptr<Worker>& worker);
+  void RemoveWorker(const std::shared_ptr<Worker>& worker);
+  bool Steal(const std::shared_ptr<Worker>& thief);
+  void WakeUpIdleWorker(const Worker* busy_worker);
+
+  inline bool HasWaitingWorker() const { return waiting_count_.load(std::memory_order_relaxed) > 0; }
+  inline void OnWorkerWait() { waiting_count_.fetch_add(1, std::memory_order_relaxed); }
+  inline void OnWorkerWake() { waiting_count_.fetch_sub(1, std::memory_order_relaxed); }
+  inline uint64_t GetStealCount() const { return steal_count_.load(std::memory_order_relaxed); }
+
+ private:
+  std::vector<std::weak_ptr<Worker>> workers_;
+  std::mutex mutex_;
+  std::atomic<int32_t> waiting_count_{0};
+  std::atomic<uint32_t> next_victim_{0};
+  std::atomic<uint64_t> steal_count_{0};
+};
+
+}  // namespace runner
+}  // namespace footstone
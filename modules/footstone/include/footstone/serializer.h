@@ -76,6 +76,21 @@ class SerializerHelper {
       free(pair.first);
     }
   }
+
+  /**
+   * @brief 取出写在复用缓冲区 reused_buffer 开头的 length 字节序列化结果.
+   * 不超过 max_reused_size 时拷贝出来, reused_buffer 保留原有内存和长度供下次序列化直接写入;
+   * 超过时直接接管其内存, 避免拷贝大块数据, reused_buffer 置空, 下次按需重新分配
+   */
+  static std::string TakeReusedBuffer(std::string& reused_buffer, size_t length, size_t max_reused_size) {
+    if (length <= max_reused_size) {
+      return reused_buffer.substr(0, length);
+    }
+    std::string buffer;
+    buffer.swap(reused_buffer);
+    buffer.resize(length);
+    return buffer;
+  }
 };
 
 class Serializer {
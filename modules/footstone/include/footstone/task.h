@@ -21,20 +21,31 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 
+#include "footstone/mpsc_queue.h"
+#include "footstone/time_point.h"
+
 namespace footstone {
 inline namespace runner {
 
-class Task {
+// Task 直接作为 TaskRunner 无锁队列的节点, 其内存由按线程缓存的内存池分配
+class Task : public MpscQueueNode {
  public:
   Task();
   explicit Task(std::function<void()> unit);
   ~Task() = default;
 
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   inline uint32_t GetId() { return id_; }
   inline void SetExecUnit(std::function<void()> unit) { unit_ = unit; }
+  // 仅在开启 TaskRunnerStatistics 时记录，用于计算 task 从可运行到开始运行的等待时间
+  inline time::TimePoint GetReadyTime() { return ready_time_; }
+  inline void SetReadyTime(time::TimePoint ready_time) { ready_time_ = ready_time; }
   inline void Run() {
     if (unit_) {
       unit_();
@@ -46,6 +57,7 @@ class Task {
 
   std::atomic<uint32_t> id_{};
   std::function<void()> unit_;  // A unit of work to be processed
+  time::TimePoint ready_time_;
 };
 
 }  // namespace runner
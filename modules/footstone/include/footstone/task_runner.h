@@ -30,9 +30,12 @@
 
 #include "footstone/idle_task.h"
 #include "footstone/macros.h"
+#include "footstone/mpsc_queue.h"
 #include "footstone/task.h"
+#include "footstone/task_runner_statistics.h"
 #include "footstone/time_delta.h"
 #include "footstone/time_point.h"
+#include "footstone/timer_wheel.h"
 #include "footstone/worker.h"
 
 
@@ -63,20 +66,14 @@ class TaskRunner {
   void PostTask(std::unique_ptr<Task> task);
   template<typename F, typename... Args>
   void PostTask(F &&f, Args... args) {
-    auto packaged_task = std::make_shared<std::packaged_task<std::invoke_result_t<F, Args...>()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-    auto task = std::make_unique<Task>([packaged_task]() { (*packaged_task)(); });
-    PostTask(std::move(task));
+    PostTask(std::make_unique<Task>(MakeExecUnit(std::forward<F>(f), std::forward<Args>(args)...)));
   }
 
   void PostDelayedTask(std::unique_ptr<Task> task, TimeDelta delay);
 
   template<typename F, typename... Args>
   void PostDelayedTask(F &&f, TimeDelta delay, Args... args) {
-    auto packaged_task = std::make_shared<std::packaged_task<std::invoke_result_t<F, Args...>()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-    auto task = std::make_unique<Task>([packaged_task]() { (*packaged_task)(); });
-    PostDelayedTask(std::move(task), delay);
+    PostDelayedTask(std::make_unique<Task>(MakeExecUnit(std::forward<F>(f), std::forward<Args>(args)...)), delay);
   }
   TimeDelta GetNextTimeDelta(TimePoint now);
 
@@ -87,7 +84,8 @@ class TaskRunner {
   void RunnerDestroySpecifics();
 
   inline void SetWorker(std::weak_ptr<Worker> worker) {
-    worker_ = worker;
+    std::lock_guard<std::mutex> lock(worker_mutex_);
+    worker_ = std::move(worker);
   }
   inline uint32_t GetPriority() { return priority_; }
   inline uint32_t GetId() { return id_; }
@@ -104,42 +102,75 @@ class TaskRunner {
   }
   inline void SetTime(TimeDelta time) { time_ = time; }
   inline bool IsSchedulable() { return is_schedulable_; }
+  // 按 name 聚合的调度统计，需通过 TaskRunnerStatistics::SetEnabled 开启
+  inline const std::shared_ptr<TaskRunnerStatistics>& GetStatistics() { return statistics_; }
 
   // 必须要在 task 运行时调用 GetCurrentTaskRunner 才能得到正确的 Runner，task 运行之外调用将会abort
   static std::shared_ptr<TaskRunner> GetCurrentTaskRunner();
 
   void PostIdleTask(std::unique_ptr<IdleTask> task);
+  // vsync 来源(如 AnimationFrameModule)在每帧开始时调用。之后 idle task 只在当前帧剩余时间内运行，
+  // 且每帧累计运行时间不超过 idle budget；超过两个帧间隔没有新帧时视为长空闲期，与未设置帧时一样最多给 50ms
+  void OnFrameBegin(TimePoint frame_time, TimeDelta frame_interval);
+  // 每帧留给 idle task 的时间，默认为帧间隔的一半
+  void SetIdleBudget(TimeDelta idle_budget);
  private:
   friend class Worker;
   friend class Scheduler;
   friend class WorkerManager;
   friend class IdleTimer;
 
-  inline const std::weak_ptr<Worker>& GetWorker() {
+  struct DelayedTask : public MpscQueueNode {
+    TimePoint deadline;
+    std::unique_ptr<Task> task;
+  };
+
+  // 可拷贝的可调用对象直接放入 std::function, 只能移动的通过 shared_ptr 包装
+  template<typename F, typename... Args>
+  static std::function<void()> MakeExecUnit(F &&f, Args&&... args) {
+    auto unit = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
+    if constexpr (std::is_copy_constructible_v<decltype(unit)>) {
+      return unit;
+    } else {
+      auto shared_unit = std::make_shared<decltype(unit)>(std::move(unit));
+      return [shared_unit]() { (*shared_unit)(); };
+    }
+  }
+
+  // work stealing 模式下 runner 会在 Worker 间迁移，worker_ 的读写由 worker_mutex_ 保护
+  inline std::weak_ptr<Worker> GetWorker() {
+    std::lock_guard<std::mutex> lock(worker_mutex_);
     return worker_;
   }
+  inline bool HasPendingTask() { return !task_queue_.IsEmpty(); }
   void NotifyWorker();
-  std::unique_ptr<Task> popTaskFromDelayedQueueNoLock(TimePoint now);
+  // 将新 post 的延迟任务放入时间轮, 需持有 consumer_mutex_
+  void DrainDelayedTasksNoLock();
   std::unique_ptr<Task> PopTask();
-  // 友元IdleTimer调用
-  std::unique_ptr<IdleTask> PopIdleTask();
-  std::unique_ptr<Task> GetTopDelayTask();
+  // 返回当前空闲时段可运行的 idle task，time_remaining 为其可用时间；时间不足时 task 留到下一个空闲时段
+  std::unique_ptr<IdleTask> PopIdleTask(TimePoint now, TimeDelta& time_remaining);
+  // 将 idle task 的运行时间记入当前帧的 idle budget
+  void AddIdleTime(TimeDelta time);
+  // 返回当前空闲时段的截止时间，next_idle_time 为下一次有足够时间运行 idle task 的时间
+  TimePoint GetIdleDeadlineNoLock(TimePoint now, TimePoint& next_idle_time);
   std::unique_ptr<Task> GetNext();
 
-  std::queue<std::unique_ptr<Task>> task_queue_;
-  std::mutex queue_mutex_;
-  std::queue<std::unique_ptr<IdleTask>> idle_task_queue_;
-  std::mutex idle_mutex_;
-  using DelayedEntry = std::pair<TimePoint, std::unique_ptr<Task>>;
-  struct DelayedEntryCompare {
-    bool operator()(const DelayedEntry &left, const DelayedEntry &right) const {
-      return left.first > right.first;
-    }
-  };
-  std::priority_queue<DelayedEntry, std::vector<DelayedEntry>, DelayedEntryCompare>
-      delayed_task_queue_;
-  std::mutex delay_mutex_;
+  // 任意线程无锁入队, 出队只在 worker 线程进行; runner 迁移或 Clear 时由 consumer_mutex_ 保证单消费者
+  MpscQueue<Task> task_queue_;
+  MpscQueue<IdleTask> idle_task_queue_;
+  MpscQueue<DelayedTask> pending_delayed_tasks_;
+  TimerWheel delayed_tasks_;
+  std::unique_ptr<IdleTask> deferred_idle_task_; // 等待下一个空闲时段的 idle task
+  TimePoint frame_time_;
+  TimeDelta frame_interval_; // 为 0 表示没有 vsync 来源
+  TimeDelta idle_budget_;
+  TimePoint idle_frame_end_; // frame_idle_time_ 所属帧的结束时间
+  TimeDelta frame_idle_time_; // 当前帧已用于 idle task 的时间
+  std::vector<std::unique_ptr<Task>> expired_tasks_;
+  std::mutex consumer_mutex_;
   std::weak_ptr<Worker> worker_;
+  std::mutex worker_mutex_;
+  std::shared_ptr<TaskRunnerStatistics> statistics_;
   std::string name_;
   bool has_sub_runner_;
   uint32_t priority_;
@@ -0,0 +1,122 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "footstone/time_delta.h"
+#include "footstone/time_point.h"
+
+namespace footstone {
+inline namespace runner {
+
+/*
+ * 以 2 的幂划分桶的耗时直方图，第 i 个桶记录 [2^(i-1), 2^i) 微秒的样本，最后一个桶记录更长的样本
+ * 同名的 TaskRunner 共用一份统计，可能被多个 Worker 同时写入，其他线程可以随时读取
+ */
+class TimeHistogram {
+ public:
+  using TimeDelta = time::TimeDelta;
+
+  static constexpr size_t kBucketCount = 24;
+
+  void Record(TimeDelta delta);
+  void Reset();
+
+  inline uint64_t GetCount() const { return count_.load(std::memory_order_relaxed); }
+  inline TimeDelta GetMax() const {
+    return TimeDelta::FromMicroseconds(static_cast<int64_t>(max_us_.load(std::memory_order_relaxed)));
+  }
+  TimeDelta GetMean() const;
+  // 返回样本所在桶的上界，精度为 2 倍
+  TimeDelta GetPercentile(double percentile) const;
+  std::array<uint64_t, kBucketCount> GetBuckets() const;
+  static TimeDelta GetBucketUpperBound(size_t index);
+
+ private:
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_us_{0};
+  std::atomic<uint64_t> max_us_{0};
+};
+
+/*
+ * 按 TaskRunner 名称聚合的调度统计，默认关闭，关闭时 post 和运行 task 只多一次原子读
+ * wait: task 可以运行(post 或延迟任务到期)到开始运行的时间
+ * run: task 运行耗时
+ * max_queue_depth: 即时任务队列长度的最高水位
+ */
+class TaskRunnerStatistics {
+ public:
+  using TimePoint = time::TimePoint;
+  using TimeDelta = time::TimeDelta;
+
+  struct LongTask {
+    TimePoint start;
+    TimeDelta wait;
+    TimeDelta duration;
+  };
+
+  static constexpr size_t kMaxLongTaskCount = 64;
+
+  explicit TaskRunnerStatistics(std::string name);
+
+  static inline bool IsEnabled() { return is_enabled_.load(std::memory_order_relaxed); }
+  static void SetEnabled(bool is_enabled);
+  static void SetLongTaskThreshold(TimeDelta threshold);
+  static TimeDelta GetLongTaskThreshold();
+  static std::shared_ptr<TaskRunnerStatistics> GetOrCreate(const std::string& name);
+  // 释放 TaskRunner 持有的统计，没有其他同名 TaskRunner 引用时从全局表中移除
+  static void Release(std::shared_ptr<TaskRunnerStatistics>& statistics);
+  static std::vector<std::shared_ptr<TaskRunnerStatistics>> GetAll();
+  static void ResetAll();
+
+  void RecordQueueDepth(size_t depth);
+  void RecordTask(TimePoint start, TimeDelta wait, TimeDelta duration);
+  void Reset();
+
+  inline const std::string& GetName() const { return name_; }
+  inline const TimeHistogram& GetWaitHistogram() const { return wait_histogram_; }
+  inline const TimeHistogram& GetRunHistogram() const { return run_histogram_; }
+  inline size_t GetMaxQueueDepth() const { return max_queue_depth_.load(std::memory_order_relaxed); }
+  std::vector<LongTask> GetLongTasks();
+
+ private:
+  static std::atomic<bool> is_enabled_;
+  static std::atomic<int64_t> long_task_threshold_ns_;
+
+  std::string name_;
+  TimeHistogram wait_histogram_;
+  TimeHistogram run_histogram_;
+  std::atomic<size_t> max_queue_depth_{0};
+  std::deque<LongTask> long_tasks_;
+  std::mutex long_task_mutex_;
+};
+
+}  // namespace runner
+}  // namespace footstone
@@ -0,0 +1,87 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "footstone/task.h"
+#include "footstone/time_delta.h"
+#include "footstone/time_point.h"
+
+namespace footstone {
+inline namespace runner {
+
+/*
+ * 分层时间轮, 用于 TaskRunner 的延迟任务. 精度为 1ms, 第 0 层 256 个槽, 其余 4 层各 64 个槽,
+ * 共覆盖 2^32ms, 更远的任务先放在最高层, 到期前会被重新放置. 添加和到期均为 O(1),
+ * 高层的任务在所在槽对应的时间到来时整体下沉到低层.
+ * 非线程安全, 由 TaskRunner 在消费者线程中使用.
+ */
+class TimerWheel {
+ public:
+  using TimePoint = time::TimePoint;
+  using TimeDelta = time::TimeDelta;
+
+  static constexpr uint32_t kRootBits = 8;
+  static constexpr uint32_t kRootSize = 1 << kRootBits;
+  static constexpr uint32_t kLevelBits = 6;
+  static constexpr uint32_t kLevelSize = 1 << kLevelBits;
+  static constexpr uint32_t kLevelCount = 4;
+  static constexpr TimeDelta kTick = TimeDelta::FromMilliseconds(1);
+
+  explicit TimerWheel(TimePoint base = TimePoint::Now());
+
+  void Add(std::unique_ptr<Task> task, TimePoint deadline);
+  // 将 now 之前到期的任务按到期时间顺序追加到 expired
+  void Advance(TimePoint now, std::vector<std::unique_ptr<Task>>& expired);
+  // 下一次需要调用 Advance 的时间点 (任务到期或高层槽下沉), 为空时返回 TimePoint::Max()
+  TimePoint GetNextDeadline() const;
+  void Clear();
+  inline size_t Size() const { return size_; }
+  inline bool IsEmpty() const { return size_ == 0; }
+
+ private:
+  struct Entry {
+    uint64_t tick;
+    std::unique_ptr<Task> task;
+  };
+  using Slot = std::vector<Entry>;
+
+  static inline uint32_t GetLevelShift(uint32_t level) { return kRootBits + kLevelBits * level; }
+
+  uint64_t ToTick(TimePoint deadline) const;
+  void Insert(Entry&& entry);
+  void Cascade(uint32_t level, uint32_t index);
+
+  TimePoint base_;
+  uint64_t current_tick_ = 0;  // 下一个待处理的 tick
+  size_t size_ = 0;
+  std::array<Slot, kRootSize> root_slots_;
+  std::array<uint64_t, kRootSize / 64> root_bitmap_{};
+  std::array<std::array<Slot, kLevelSize>, kLevelCount> level_slots_;
+  std::array<uint64_t, kLevelCount> level_bitmap_{};
+};
+
+}  // namespace runner
+}  // namespace footstone
@@ -20,10 +20,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <mutex>
 #include <queue>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -38,6 +40,7 @@ inline namespace runner {
 
 class WorkerManager;
 class TaskRunner;
+class Scheduler;
 
 /*
  * Worker是TaskRunner的运行载体，可用Thread实现，也可以用Lopper实现
@@ -87,6 +90,17 @@ class Worker {
   friend class TaskRunner;
   friend class Scheduler;
 
+  // 分组按 priority * 运行时间排序，值越小优先级越高，seq 保证相同权重时维持加入顺序
+  struct GroupOrder {
+    int64_t weight;
+    uint64_t seq;
+    std::list<std::vector<std::shared_ptr<TaskRunner>>>::iterator group;
+
+    bool operator<(const GroupOrder& other) const {
+      return weight < other.weight || (weight == other.weight && seq < other.seq);
+    }
+  };
+
   static uint32_t GetCurrentWorkerId();
   // 该方法只允许在task运行中调用，如果在task之外调用则会返回nullptr
   static std::shared_ptr<TaskRunner> GetCurrentTaskRunner();
@@ -95,7 +109,12 @@ class Worker {
   void AddImmediateTask(std::unique_ptr<Task> task);
   bool HasUnschedulableRunner();
   void BalanceNoLock();
-  void SortNoLock();
+  // running_group_list_ 结构变化后重建排序，否则每个 task 运行后只需 O(log n) 调整运行分组的位置
+  void RebuildOrderNoLock();
+  void UpdateRunningOrderNoLock();
+  bool HasPendingGroupNoLock(std::set<GroupOrder>::iterator begin);
+  // 供 Scheduler 调用，返回一个可被其他 Worker 窃取的分组，没有则返回空
+  std::vector<std::shared_ptr<TaskRunner>> StealGroup();
 
   int32_t WorkerKeyCreate(uint32_t task_runner_id, const std::function<void(void *)>& destruct);
   bool WorkerKeyDelete(uint32_t task_runner_id, int32_t key);
@@ -114,6 +133,11 @@ class Worker {
   std::string name_;
   std::list<std::vector<std::shared_ptr<TaskRunner>>> running_group_list_;
   std::list<std::vector<std::shared_ptr<TaskRunner>>> pending_group_list_;
+  std::set<GroupOrder> running_order_; // running_group_list_ 的优先级索引
+  std::set<GroupOrder>::iterator running_order_it_; // 当前运行分组在 running_order_ 中的位置
+  const std::vector<std::shared_ptr<TaskRunner>>* running_group_; // 正在运行 task 的分组，不可被窃取
+  uint64_t order_seq_;
+  bool is_order_dirty_;
   std::mutex running_mutex_; // 容器不是线程安全，锁住running_group_
   std::mutex pending_mutex_; // 锁住pending_group_
   std::map<uint32_t, std::array<Worker::WorkerKey, Worker::kWorkerKeysMax>> worker_key_map_;
@@ -134,6 +158,9 @@ class Worker {
   bool is_schedulable_;
   uint32_t group_id_;
   std::unique_ptr<Driver> driver_;
+  std::shared_ptr<Scheduler> scheduler_; // 仅 work stealing 模式下设置
+  std::atomic<bool> is_busy_;
+  std::atomic<bool> is_waiting_;
 };
 
 }  // namespace runner
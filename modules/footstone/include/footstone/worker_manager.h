@@ -22,6 +22,7 @@
 
 #include <mutex>
 
+#include "footstone/scheduler.h"
 #include "footstone/task_runner.h"
 #include "footstone/worker.h"
 
@@ -30,7 +31,8 @@ inline namespace runner {
 
 class WorkerManager {
  public:
-  explicit WorkerManager(uint32_t size);
+  // is_work_stealing 为 true 时空闲的 Worker 会从忙碌的 Worker 上窃取可调度的 TaskRunner
+  explicit WorkerManager(uint32_t size, bool is_work_stealing = false);
   ~WorkerManager();
 
   WorkerManager(WorkerManager&) = delete;
@@ -45,8 +47,12 @@ class WorkerManager {
   void AddTaskRunner(std::shared_ptr<TaskRunner> runner);
   void RemoveTaskRunner(const std::shared_ptr<TaskRunner>& runner);
 
+  inline bool IsWorkStealing() { return scheduler_ != nullptr; }
+  inline uint64_t GetStealCount() { return scheduler_ ? scheduler_->GetStealCount() : 0; }
+
  private:
   friend class Profile;
+  friend class Scheduler;
   static void MoveTaskRunnerSpecificNoLock(uint32_t runner_id,
                                            const std::shared_ptr<Worker>& from,
                                            const std::shared_ptr<Worker>& to);
@@ -55,9 +61,11 @@ class WorkerManager {
   static void UpdateWorkerSpecific(const std::shared_ptr<Worker>& worker,
                             const std::vector<std::shared_ptr<TaskRunner>>& group);
   void Balance(int32_t increase_worker_count);
+  void AddSchedulableWorker(const std::shared_ptr<Worker>& worker);
 
   std::vector<std::shared_ptr<Worker>> workers_;
   std::vector<std::shared_ptr<TaskRunner>> runners_;
+  std::shared_ptr<Scheduler> scheduler_;
 
   int32_t index_;
   uint32_t size_;
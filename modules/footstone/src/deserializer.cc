@@ -35,6 +35,16 @@ using string_view = footstone::stringview::string_view;
 using StringViewUtils = footstone::stringview::StringViewUtils;
 constexpr uint32_t kSupportedVersion = 15;
 
+// ASCII 的 Latin1 字符串与 UTF-8 相同，无需转换编码
+static bool IsAscii(const uint8_t* data, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    if (data[i] >= 0x80) {
+      return false;
+    }
+  }
+  return true;
+}
+
 Deserializer::Deserializer(const std::vector<const uint8_t>& data)
     : position_(&data[0]), end_(&data[0] + data.size()) {}
 
@@ -134,11 +144,8 @@ bool Deserializer::ReadUtf8String(std::string& value) {
   utf8_length = ReadVarint<uint32_t>();
   if (utf8_length > static_cast<uint32_t>(end_ - position_)) return false;
 
-  const uint8_t* start = const_cast<uint8_t*>(position_);
+  value.assign(reinterpret_cast<const char*>(position_), utf8_length);
   position_ += utf8_length;
-  string_view string_view(reinterpret_cast<const string_view::char8_t_ *>(start), utf8_length);
-  value = StringViewUtils::ToStdString(StringViewUtils::ConvertEncoding(
-      string_view, string_view::Encoding::Utf8).utf8_value());
   return true;
 }
 
@@ -147,11 +154,8 @@ bool Deserializer::ReadUtf8String(HippyValue& hippy_value) {
   utf8_length = ReadVarint<uint32_t>();
   if (utf8_length > static_cast<uint32_t>(end_ - position_)) return false;
 
-  const uint8_t* start = position_;
+  hippy_value = HippyValue(std::string(reinterpret_cast<const char*>(position_), utf8_length));
   position_ += utf8_length;
-  string_view string_view(reinterpret_cast<const string_view::char8_t_ *>(start), utf8_length);
-  hippy_value = StringViewUtils::ToStdString(StringViewUtils::ConvertEncoding(
-      string_view, string_view::Encoding::Utf8).utf8_value());
   return true;
 }
 
@@ -161,6 +165,11 @@ bool Deserializer::ReadOneByteString(std::string& value) {
   if (one_byte_length > static_cast<uint32_t>(end_ - position_)) return false;
 
   const char* start = reinterpret_cast<char*>(const_cast<uint8_t*>(position_));
+  if (IsAscii(position_, one_byte_length)) {
+    value.assign(start, one_byte_length);
+    position_ += one_byte_length;
+    return true;
+  }
   position_ += one_byte_length;
   string_view string_view(start, one_byte_length);
   value = StringViewUtils::ToStdString(StringViewUtils::ConvertEncoding(
@@ -174,6 +183,11 @@ bool Deserializer::ReadOneByteString(HippyValue& hippy_value) {
   if (one_byte_length > static_cast<uint32_t>(end_ - position_)) return false;
 
   const char* start = reinterpret_cast<char*>(const_cast<uint8_t*>(position_));
+  if (IsAscii(position_, one_byte_length)) {
+    hippy_value = HippyValue(std::string(start, one_byte_length));
+    position_ += one_byte_length;
+    return true;
+  }
   position_ += one_byte_length;
   string_view string_view(start, one_byte_length);
   hippy_value = StringViewUtils::ToStdString(StringViewUtils::ConvertEncoding(
@@ -209,7 +223,7 @@ bool Deserializer::ReadTwoByteString(HippyValue& hippy_value) {
 
 bool Deserializer::ReadDenseJSArray(HippyValue& hippy_value) {
   uint32_t length = ReadVarint<uint32_t>();
-  FOOTSTONE_DCHECK(length <= static_cast<uint32_t>(end_ - position_));
+  if (length > static_cast<uint32_t>(end_ - position_)) return false;
 
   HippyValue::HippyValueArrayType array;
   array.resize(length);
@@ -222,9 +236,7 @@ bool Deserializer::ReadDenseJSArray(HippyValue& hippy_value) {
       continue;
     }
 
-    HippyValue value;
-    ReadObject(value);
-    array[i] = value;
+    if (!ReadObject(array[i])) return false;
   }
 
   uint32_t num_properties;
@@ -237,7 +249,7 @@ bool Deserializer::ReadDenseJSArray(HippyValue& hippy_value) {
   if (num_properties != expected_num_properties) return false;
   if (length != expected_length) return false;
 
-  hippy_value = array;
+  hippy_value = HippyValue(std::move(array));
   return true;
 }
 
@@ -253,7 +265,7 @@ bool Deserializer::ReadJSObject(HippyValue& hippy_value) {
     return false;
   }
 
-  hippy_value = object;
+  hippy_value = HippyValue(std::move(object));
   return true;
 }
 
@@ -271,7 +283,8 @@ T Deserializer::ReadVarint() {
   unsigned shift = 0;
   bool has_another_byte;
   do {
-    FOOTSTONE_DCHECK(end_ > position_);
+    // 数据截断时停在末尾, 由后续读取返回失败
+    if (position_ >= end_) break;
     uint8_t byte = *position_;
     if (shift < sizeof(T) * 8) {
       value |= static_cast<T>(byte & 0x7F) << shift;
@@ -299,7 +312,7 @@ T Deserializer::ReadZigZag() {
 bool Deserializer::ReadObject(HippyValue& value) {
   bool ret = false;
   SerializationTag tag;
-  ReadTag(tag);
+  if (!ReadTag(tag)) return false;
   switch (tag) {
     case SerializationTag::kUndefined: {
       value = HippyValue::Undefined();
@@ -363,7 +376,6 @@ bool Deserializer::ReadObject(HippyValue& value) {
 
 bool Deserializer::ReadObjectProperties(HippyValueObjectType& property, uint32_t& number_properties, SerializationTag end_tag) {
   uint32_t number = 0;
-  HippyValue::HippyValueObjectType object;
   bool ret = true;
 
   // Slow path.
@@ -386,8 +398,7 @@ bool Deserializer::ReadObjectProperties(HippyValueObjectType& property, uint32_t
         FOOTSTONE_DLOG(WARNING) << "error key type:" + std::to_string(static_cast<int>(key.GetType()));
         return false;
       }
-      object.insert(std::pair<std::string, HippyValue>(key.ToStringChecked(), value));
-      property = object;
+      property.emplace(std::move(key.ToStringChecked()), std::move(value));
     }
     number++;
   }
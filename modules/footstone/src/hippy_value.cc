@@ -111,6 +111,28 @@ HippyValue::HippyValue(const HippyValue& source) : type_(source.type_), number_t
   }
 }
 
+HippyValue::HippyValue(HippyValue&& source) noexcept : type_(source.type_), number_type_(source.number_type_) {
+  switch (type_) {
+    case HippyValue::Type::kBoolean:
+      b_ = source.b_;
+      break;
+    case HippyValue::Type::kNumber:
+      num_ = source.num_;
+      break;
+    case HippyValue::Type::kString:
+      new (&str_) std::string(std::move(source.str_));
+      break;
+    case HippyValue::Type::kObject:
+      new (&obj_) HippyValueObjectType(std::move(source.obj_));
+      break;
+    case HippyValue::Type::kArray:
+      new (&arr_) HippyValueArrayType(std::move(source.arr_));
+      break;
+    default:
+      break;
+  }
+}
+
 HippyValue::~HippyValue() { Deallocate(); }
 
 HippyValue& HippyValue::operator=(const HippyValue& rhs) noexcept {
@@ -178,6 +200,35 @@ HippyValue& HippyValue::operator=(const HippyValue& rhs) noexcept {
   return *this;
 }
 
+HippyValue& HippyValue::operator=(HippyValue&& rhs) noexcept {
+  if (this == &rhs) {
+    return *this;
+  }
+  Deallocate();
+  type_ = rhs.type_;
+  number_type_ = rhs.number_type_;
+  switch (type_) {
+    case HippyValue::Type::kBoolean:
+      b_ = rhs.b_;
+      break;
+    case HippyValue::Type::kNumber:
+      num_ = rhs.num_;
+      break;
+    case HippyValue::Type::kString:
+      new (&str_) std::string(std::move(rhs.str_));
+      break;
+    case HippyValue::Type::kObject:
+      new (&obj_) HippyValueObjectType(std::move(rhs.obj_));
+      break;
+    case HippyValue::Type::kArray:
+      new (&arr_) HippyValueArrayType(std::move(rhs.arr_));
+      break;
+    default:
+      break;
+  }
+  return *this;
+}
+
 HippyValue& HippyValue::operator=(const int32_t rhs) noexcept {
   Deallocate();
   type_ = HippyValue::Type::kNumber;
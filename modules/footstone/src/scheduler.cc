@@ -0,0 +1,100 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "include/footstone/scheduler.h"
+
+#include <utility>
+
+#include "include/footstone/task_runner.h"
+#include "include/footstone/worker.h"
+#include "include/footstone/worker_manager.h"
+
+namespace footstone {
+inline namespace runner {
+
+void Scheduler::AddWorker(const std::shared_ptr<Worker>& worker) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  workers_.push_back(worker);
+}
+
+void Scheduler::RemoveWorker(const std::shared_ptr<Worker>& worker) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = workers_.begin(); it != workers_.end(); ++it) {
+    if (it->lock() == worker) {
+      workers_.erase(it);
+      break;
+    }
+  }
+}
+
+bool Scheduler::Steal(const std::shared_ptr<Worker>& thief) {
+  std::vector<std::shared_ptr<Worker>> victims;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    victims.reserve(workers_.size());
+    for (const auto& weak_worker : workers_) {
+      auto worker = weak_worker.lock();
+      if (worker && worker != thief) {
+        victims.push_back(std::move(worker));
+      }
+    }
+  }
+  if (victims.empty()) {
+    return false;
+  }
+  // 轮转起始位置，避免多个空闲 Worker 同时争抢同一个 Worker
+  auto start = next_victim_.fetch_add(1, std::memory_order_relaxed);
+  for (size_t i = 0; i < victims.size(); ++i) {
+    const auto& victim = victims[(start + i) % victims.size()];
+    auto group = victim->StealGroup();
+    if (group.empty()) {
+      continue;
+    }
+    for (auto& runner : group) {
+      WorkerManager::MoveTaskRunnerSpecificNoLock(runner->GetId(), victim, thief);
+      runner->SetWorker(thief);
+    }
+    thief->Bind(std::move(group));
+    steal_count_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+void Scheduler::WakeUpIdleWorker(const Worker* busy_worker) {
+  if (!HasWaitingWorker()) {
+    return;
+  }
+  // 锁被占用时不排队等待，忙碌的 Worker 取下一个任务时若仍有待运行的分组会再次唤醒
+  std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return;
+  }
+  for (const auto& weak_worker : workers_) {
+    auto worker = weak_worker.lock();
+    if (worker && worker.get() != busy_worker && worker->is_waiting_.load(std::memory_order_relaxed)) {
+      worker->driver_->Notify();
+      return;
+    }
+  }
+}
+
+}  // namespace runner
+}  // namespace footstone
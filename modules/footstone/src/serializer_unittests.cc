@@ -0,0 +1,59 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include "footstone/serializer.h"
+
+namespace footstone {
+inline namespace value {
+inline namespace testing {
+
+constexpr size_t kMaxReusedSize = 1024;
+
+TEST(SerializerHelperTest, SmallResultKeepsReusedBuffer) {
+  std::string reused_buffer(kMaxReusedSize, 'x');
+  reused_buffer.replace(0, 5, "hello");
+  auto data = reused_buffer.data();
+  auto result = SerializerHelper::TakeReusedBuffer(reused_buffer, 5, kMaxReusedSize);
+  EXPECT_EQ(result, "hello");
+  // 下次序列化直接写入原有内存，不重新分配
+  EXPECT_EQ(reused_buffer.data(), data);
+  EXPECT_EQ(reused_buffer.size(), kMaxReusedSize);
+
+  result = SerializerHelper::TakeReusedBuffer(reused_buffer, kMaxReusedSize, kMaxReusedSize);
+  EXPECT_EQ(result.size(), kMaxReusedSize);
+  EXPECT_EQ(reused_buffer.data(), data);
+}
+
+TEST(SerializerHelperTest, LargeResultTakesOverReusedBuffer) {
+  std::string reused_buffer(kMaxReusedSize * 4, 'x');
+  auto data = reused_buffer.data();
+  auto result = SerializerHelper::TakeReusedBuffer(reused_buffer, kMaxReusedSize * 3, kMaxReusedSize);
+  EXPECT_EQ(result.data(), data);
+  EXPECT_EQ(result.size(), kMaxReusedSize * 3);
+  EXPECT_TRUE(reused_buffer.empty());
+}
+
+}  // namespace testing
+}  // namespace value
+}  // namespace footstone
@@ -22,13 +22,138 @@
 
 #include "include/footstone/task.h"
 
+#include <mutex>
+#include <new>
 #include <utility>
 
 namespace footstone {
 inline namespace runner {
 
+namespace {
+
+// 每个线程最多缓存的空闲 Task 内存块数, 超出一半归还到全局池; 全局池超出上限后直接释放
+constexpr size_t kThreadCacheCapacity = 256;
+constexpr size_t kGlobalPoolCapacity = 4096;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+// Task 通常在 post 的线程分配而在 worker 线程释放, 内存块经全局池在线程间流转
+class GlobalTaskPool {
+ public:
+  void Push(FreeBlock* first, FreeBlock* last, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (count_ + count > kGlobalPoolCapacity) {
+      while (first != nullptr) {
+        auto next = first == last ? nullptr : first->next;
+        ::operator delete(first);
+        first = next;
+      }
+      return;
+    }
+    last->next = head_;
+    head_ = first;
+    count_ += count;
+  }
+
+  FreeBlock* Pop(size_t max_count, size_t& count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FreeBlock* first = head_;
+    FreeBlock* last = nullptr;
+    count = 0;
+    while (head_ != nullptr && count < max_count) {
+      last = head_;
+      head_ = head_->next;
+      ++count;
+    }
+    if (last != nullptr) {
+      last->next = nullptr;
+    }
+    count_ -= count;
+    return count == 0 ? nullptr : first;
+  }
+
+ private:
+  std::mutex mutex_;
+  FreeBlock* head_ = nullptr;
+  size_t count_ = 0;
+};
+
+// Task 可能在静态对象析构阶段释放, 全局池不析构
+GlobalTaskPool& GetGlobalTaskPool() {
+  static auto* pool = new GlobalTaskPool();
+  return *pool;
+}
+
+thread_local FreeBlock* tls_free_head = nullptr;
+thread_local size_t tls_free_count = 0;
+thread_local bool tls_cache_destroyed = false;
+
+struct ThreadCacheFlusher {
+  ~ThreadCacheFlusher() {
+    if (tls_free_head != nullptr) {
+      auto last = tls_free_head;
+      while (last->next != nullptr) {
+        last = last->next;
+      }
+      GetGlobalTaskPool().Push(tls_free_head, last, tls_free_count);
+    }
+    tls_free_head = nullptr;
+    tls_free_count = 0;
+    tls_cache_destroyed = true;
+  }
+};
+
+thread_local ThreadCacheFlusher tls_cache_flusher;
+
+}  // namespace
+
 std::atomic<uint32_t> Task::g_next_task_id = 1;
 
+void* Task::operator new(size_t size) {
+  if (size != sizeof(Task) || tls_cache_destroyed) {
+    return ::operator new(size);
+  }
+  if (tls_free_head == nullptr) {
+    (void)&tls_cache_flusher;  // 首次使用时注册线程退出时的归还
+    tls_free_head = GetGlobalTaskPool().Pop(kThreadCacheCapacity / 2, tls_free_count);
+    if (tls_free_head == nullptr) {
+      return ::operator new(size);
+    }
+  }
+  auto block = tls_free_head;
+  tls_free_head = block->next;
+  --tls_free_count;
+  return block;
+}
+
+void Task::operator delete(void* ptr, size_t size) {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (size != sizeof(Task) || tls_cache_destroyed) {
+    ::operator delete(ptr);
+    return;
+  }
+  (void)&tls_cache_flusher;
+  auto block = static_cast<FreeBlock*>(ptr);
+  block->next = tls_free_head;
+  tls_free_head = block;
+  if (++tls_free_count <= kThreadCacheCapacity) {
+    return;
+  }
+  // 归还一半到全局池
+  auto first = tls_free_head;
+  auto last = first;
+  for (size_t i = 1; i < kThreadCacheCapacity / 2; ++i) {
+    last = last->next;
+  }
+  tls_free_head = last->next;
+  tls_free_count -= kThreadCacheCapacity / 2;
+  GetGlobalTaskPool().Push(first, last, kThreadCacheCapacity / 2);
+}
+
 Task::Task() : Task(nullptr) {}
 
 Task::Task(std::function<void()> exec_unit) : unit_(std::move(exec_unit)) {
@@ -20,6 +20,7 @@
 
 #include "include/footstone/task_runner.h"
 
+#include <algorithm>
 #include <atomic>
 #include <array>
 #include <utility>
@@ -34,6 +35,12 @@ using IdleCbParam = IdleTask::IdleCbParam;
 
 std::atomic<uint32_t> global_task_runner_id{1};
 
+// 与 requestIdleCallback 规范一致，没有帧时单次空闲期最长 50ms
+constexpr TimeDelta kMaxIdlePeriod = TimeDelta::FromMilliseconds(50);
+// 剩余时间不足时不运行未超时的 idle task，避免切片过碎
+constexpr TimeDelta kMinIdleSlice = TimeDelta::FromMilliseconds(1);
+constexpr int64_t kFrameStallCount = 2;
+
 TaskRunner::TaskRunner(uint32_t group_id, uint32_t priority, bool is_schedulable, std::string name):
       name_(std::move(name)),
       has_sub_runner_(false),
@@ -42,46 +49,36 @@ TaskRunner::TaskRunner(uint32_t group_id, uint32_t priority, bool is_schedulable
       time_(TimeDelta::Zero()),
       is_schedulable_(is_schedulable) {
   id_ = global_task_runner_id.fetch_add(1);
+  statistics_ = TaskRunnerStatistics::GetOrCreate(name_);
 }
 
 TaskRunner::TaskRunner(std::string name): TaskRunner(
     kDefaultGroupId, kDefaultPriority, true, std::move(name)) {}
 
 TaskRunner::~TaskRunner() {
-  std::shared_ptr<Worker> worker = worker_.lock();
+  std::shared_ptr<Worker> worker = GetWorker().lock();
   if (worker) {
     worker->WorkerDestroySpecific(id_);
   }
+  TaskRunnerStatistics::Release(statistics_);
 }
 
 void TaskRunner::Clear() {
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    while (!task_queue_.empty()) {
-      task_queue_.pop();
-    }
-  }
-  {
-    std::lock_guard<std::mutex> lock(delay_mutex_);
-    while (!delayed_task_queue_.empty()) {
-      delayed_task_queue_.pop();
-    }
-  }
-  {
-    std::lock_guard<std::mutex> lock(idle_mutex_);
-    while (!idle_task_queue_.empty()) {
-      delayed_task_queue_.pop();
-    }
-  }
+  std::lock_guard<std::mutex> lock(consumer_mutex_);
+  task_queue_.Clear();
+  pending_delayed_tasks_.Clear();
+  delayed_tasks_.Clear();
+  idle_task_queue_.Clear();
+  deferred_idle_task_ = nullptr;
 }
 
 bool TaskRunner::AddSubTaskRunner(const std::shared_ptr<TaskRunner>& sub_runner,
                                   bool is_task_running) {
-  std::shared_ptr<Worker> worker = worker_.lock();
+  std::shared_ptr<Worker> worker = GetWorker().lock();
   if (!worker) {
     return false;
   }
-  sub_runner->SetWorker(worker_);
+  sub_runner->SetWorker(GetWorker());
   worker->BindGroup(id_, sub_runner);
   has_sub_runner_ = true;
   if (is_task_running) {
@@ -97,7 +94,7 @@ bool TaskRunner::RemoveSubTaskRunner(const std::shared_ptr<TaskRunner>& sub_runn
   if (!has_sub_runner_ || !sub_runner) {
     return false;
   }
-  std::shared_ptr<Worker> worker = worker_.lock();
+  std::shared_ptr<Worker> worker = GetWorker().lock();
   if (!worker) {
     return false;
   }
@@ -108,120 +105,146 @@ bool TaskRunner::RemoveSubTaskRunner(const std::shared_ptr<TaskRunner>& sub_runn
 }
 
 void TaskRunner::PostTask(std::unique_ptr<Task> task) {
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    task_queue_.push(std::move(task));
+  if (TaskRunnerStatistics::IsEnabled()) {
+    task->SetReadyTime(TimePoint::Now());
+    task_queue_.Push(std::move(task));
+    statistics_->RecordQueueDepth(task_queue_.Size());
+  } else {
+    task_queue_.Push(std::move(task));
   }
   NotifyWorker();
 }
 
 void TaskRunner::PostDelayedTask(std::unique_ptr<Task> task, TimeDelta delay) {
-  {
-    std::lock_guard<std::mutex> lock(delay_mutex_);
-
-    TimePoint deadline = TimePoint::Now() + delay;
-    delayed_task_queue_.push(std::make_pair(deadline, std::move(task)));
+  auto delayed_task = std::make_unique<DelayedTask>();
+  auto now = TimePoint::Now();
+  delayed_task->deadline = delay >= TimePoint::Max() - now ? TimePoint::Max() : now + delay;
+  if (TaskRunnerStatistics::IsEnabled()) {
+    task->SetReadyTime(delayed_task->deadline);
   }
+  delayed_task->task = std::move(task);
+  pending_delayed_tasks_.Push(std::move(delayed_task));
   NotifyWorker();
 }
 
 void TaskRunner::PostIdleTask(std::unique_ptr<IdleTask> task) {
-  {
-    std::lock_guard<std::mutex> lock(idle_mutex_);
-    idle_task_queue_.push(std::move(task));
-  }
+  idle_task_queue_.Push(std::move(task));
   NotifyWorker();
 }
 
 std::unique_ptr<Task> TaskRunner::PopTask() {
-  std::lock_guard<std::mutex> lock(queue_mutex_);
+  std::lock_guard<std::mutex> lock(consumer_mutex_);
+  return task_queue_.Pop();
+}
 
-  if (!task_queue_.empty()) {
-    std::unique_ptr<Task> result = std::move(task_queue_.front());
-    task_queue_.pop();
-    return result;
+std::unique_ptr<IdleTask> TaskRunner::PopIdleTask(TimePoint now, TimeDelta& time_remaining) {
+  std::lock_guard<std::mutex> lock(consumer_mutex_);
+  if (!deferred_idle_task_) {
+    deferred_idle_task_ = idle_task_queue_.Pop();
+    if (!deferred_idle_task_) {
+      return nullptr;
+    }
   }
-
-  return nullptr;
+  TimePoint next_idle_time;
+  auto deadline = GetIdleDeadlineNoLock(now, next_idle_time);
+  time_remaining = deadline > now ? deadline - now : TimeDelta::Zero();
+  bool did_time_out = now - deferred_idle_task_->GetBeginTime() > deferred_idle_task_->GetTimeout();
+  if (time_remaining < kMinIdleSlice && !did_time_out) {
+    return nullptr;
+  }
+  return std::move(deferred_idle_task_);
 }
 
-std::unique_ptr<IdleTask> TaskRunner::PopIdleTask() {
-  std::lock_guard<std::mutex> lock(idle_mutex_);
+void TaskRunner::AddIdleTime(TimeDelta time) {
+  std::lock_guard<std::mutex> lock(consumer_mutex_);
+  frame_idle_time_ = frame_idle_time_ + time;
+}
 
-  if (!idle_task_queue_.empty()) {
-    std::unique_ptr<IdleTask> result = std::move(idle_task_queue_.front());
-    idle_task_queue_.pop();
-    return result;
-  }
+void TaskRunner::OnFrameBegin(TimePoint frame_time, TimeDelta frame_interval) {
+  std::lock_guard<std::mutex> lock(consumer_mutex_);
+  frame_time_ = frame_time;
+  frame_interval_ = frame_interval;
+}
 
-  return nullptr;
+void TaskRunner::SetIdleBudget(TimeDelta idle_budget) {
+  std::lock_guard<std::mutex> lock(consumer_mutex_);
+  idle_budget_ = idle_budget;
 }
 
-std::unique_ptr<Task> TaskRunner::GetTopDelayTask() {
-  std::lock_guard<std::mutex> lock(delay_mutex_);
+TimePoint TaskRunner::GetIdleDeadlineNoLock(TimePoint now, TimePoint& next_idle_time) {
+  next_idle_time = now;
+  if (frame_interval_ <= TimeDelta::Zero()) {
+    return now + kMaxIdlePeriod;
+  }
+  auto elapsed = now > frame_time_ ? now - frame_time_ : TimeDelta::Zero();
+  if (elapsed >= frame_interval_ * kFrameStallCount) {
+    return now + kMaxIdlePeriod;
+  }
+  // vsync 任务可能晚于帧实际开始的时间到达，按帧间隔推算当前帧的结束时间
+  auto frame_end = frame_time_ + frame_interval_ * (elapsed / frame_interval_ + 1);
+  if (frame_end != idle_frame_end_) {
+    idle_frame_end_ = frame_end;
+    frame_idle_time_ = TimeDelta::Zero();
+  }
+  auto budget = idle_budget_ > TimeDelta::Zero() ? idle_budget_ : frame_interval_ / 2;
+  auto deadline = budget > frame_idle_time_ ? std::min(frame_end, now + (budget - frame_idle_time_)) : now;
+  if (deadline - now < kMinIdleSlice) {
+    next_idle_time = frame_end;
+  }
+  return deadline;
+}
 
-  if (task_queue_.empty() && !delayed_task_queue_.empty()) {
-    std::unique_ptr<Task> result =
-        std::move(const_cast<DelayedEntry&>(delayed_task_queue_.top()).second);
-    return result;
+void TaskRunner::DrainDelayedTasksNoLock() {
+  while (auto delayed_task = pending_delayed_tasks_.Pop()) {
+    delayed_tasks_.Add(std::move(delayed_task->task), delayed_task->deadline);
   }
-  return nullptr;
 }
 
 std::unique_ptr<Task> TaskRunner::GetNext() {
-  TimePoint now = TimePoint::Now();
-  std::unique_ptr<Task> task = popTaskFromDelayedQueueNoLock(now);
-  {
-    std::scoped_lock lock(queue_mutex_, delay_mutex_);
-    while (task) {
-      task_queue_.push(std::move(task));
-      task = popTaskFromDelayedQueueNoLock(now);
+  std::lock_guard<std::mutex> lock(consumer_mutex_);
+  DrainDelayedTasksNoLock();
+  if (!delayed_tasks_.IsEmpty()) {
+    // 到期的延迟任务排在已有的即时任务之后
+    delayed_tasks_.Advance(TimePoint::Now(), expired_tasks_);
+    for (auto& task : expired_tasks_) {
+      task_queue_.Push(std::move(task));
     }
-  }
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    if (!task_queue_.empty()) {
-      auto result = std::move(task_queue_.front());
-      task_queue_.pop();
-      return result;
+    if (!expired_tasks_.empty() && TaskRunnerStatistics::IsEnabled()) {
+      statistics_->RecordQueueDepth(task_queue_.Size());
     }
+    expired_tasks_.clear();
   }
-  return nullptr;
+  return task_queue_.Pop();
 }
 
 TimeDelta TaskRunner::GetNextTimeDelta(TimePoint now) {
-  std::unique_lock<std::mutex> lock(delay_mutex_);
-  if (!delayed_task_queue_.empty()) {
-    const DelayedEntry& delayed_task = delayed_task_queue_.top();
-    return delayed_task.first - now;
-  } else {
+  std::lock_guard<std::mutex> lock(consumer_mutex_);
+  DrainDelayedTasksNoLock();
+  auto deadline = delayed_tasks_.GetNextDeadline();
+  if (deferred_idle_task_) {
+    // idle task 需要在下一个空闲时段或超时后唤醒
+    TimePoint next_idle_time;
+    GetIdleDeadlineNoLock(now, next_idle_time);
+    deadline = std::min(deadline, next_idle_time);
+    auto timeout = deferred_idle_task_->GetTimeout();
+    if (timeout < TimePoint::Max() - deferred_idle_task_->GetBeginTime()) {
+      deadline = std::min(deadline, deferred_idle_task_->GetBeginTime() + timeout);
+    }
+  }
+  if (deadline == TimePoint::Max()) {
     return TimeDelta::Max();
   }
+  return deadline - now;
 }
 
 void TaskRunner::NotifyWorker() {
-  auto worker = worker_.lock();
+  auto worker = GetWorker().lock();
   if (!worker) {
     return;
   }
   worker->Notify();
 }
 
-std::unique_ptr<Task> TaskRunner::popTaskFromDelayedQueueNoLock(TimePoint now) {
-  if (delayed_task_queue_.empty()) {
-    return nullptr;
-  }
-
-  const DelayedEntry& deadline_and_task = delayed_task_queue_.top();
-  if (deadline_and_task.first > now) {
-    return nullptr;
-  }
-
-  std::unique_ptr<Task> result = std::move(const_cast<DelayedEntry&>(deadline_and_task).second);
-  delayed_task_queue_.pop();
-  return result;
-}
-
 std::shared_ptr<TaskRunner> TaskRunner::GetCurrentTaskRunner() {
   return Worker::GetCurrentTaskRunner();
 }
@@ -229,7 +252,7 @@ std::shared_ptr<TaskRunner> TaskRunner::GetCurrentTaskRunner() {
 int32_t TaskRunner::RunnerKeyCreate(const std::function<void(void*)>& destruct) {
   FOOTSTONE_CHECK(Worker::IsTaskRunning()) << "RunnerKeyCreate cannot be run outside of the task";
   auto task_runner_id = Worker::GetCurrentTaskRunner()->GetId();
-  std::shared_ptr<Worker> worker = worker_.lock();
+  std::shared_ptr<Worker> worker = GetWorker().lock();
   FOOTSTONE_CHECK(worker); // task在运行，理论worker应该还在
   return worker->WorkerKeyCreate(task_runner_id, destruct);
 }
@@ -237,7 +260,7 @@ int32_t TaskRunner::RunnerKeyCreate(const std::function<void(void*)>& destruct)
 bool TaskRunner::RunnerKeyDelete(int32_t key) {
   FOOTSTONE_CHECK(Worker::IsTaskRunning()) << "RunnerKeyDelete cannot be run outside of the task";
   auto task_runner_id = Worker::GetCurrentTaskRunner()->GetId();
-  std::shared_ptr<Worker> worker = worker_.lock();
+  std::shared_ptr<Worker> worker = GetWorker().lock();
   FOOTSTONE_CHECK(worker);
   return worker->WorkerKeyDelete(task_runner_id, key);
 }
@@ -245,7 +268,7 @@ bool TaskRunner::RunnerKeyDelete(int32_t key) {
 bool TaskRunner::RunnerSetSpecific(int32_t key, void* p) {
   FOOTSTONE_CHECK(Worker::IsTaskRunning()) << "RunnerSetSpecific cannot be run outside of the task";
   auto task_runner_id = Worker::GetCurrentTaskRunner()->GetId();
-  std::shared_ptr<Worker> worker = worker_.lock();
+  std::shared_ptr<Worker> worker = GetWorker().lock();
   FOOTSTONE_CHECK(worker);
   return worker->WorkerSetSpecific(task_runner_id, key, p);
 }
@@ -253,7 +276,7 @@ bool TaskRunner::RunnerSetSpecific(int32_t key, void* p) {
 void* TaskRunner::RunnerGetSpecific(int32_t key) {
   FOOTSTONE_CHECK(Worker::IsTaskRunning()) << "RunnerGetSpecific cannot be run outside of the task";
   auto task_runner_id = Worker::GetCurrentTaskRunner()->GetId();
-  std::shared_ptr<Worker> worker = worker_.lock();
+  std::shared_ptr<Worker> worker = GetWorker().lock();
   FOOTSTONE_CHECK(worker);
   return worker->WorkerGetSpecific(task_runner_id, key);
 }
@@ -261,7 +284,7 @@ void* TaskRunner::RunnerGetSpecific(int32_t key) {
 void TaskRunner::RunnerDestroySpecifics() {
   FOOTSTONE_CHECK(Worker::IsTaskRunning()) << "RunnerDestroySpecifics cannot be run outside of the task";
   auto task_runner_id = Worker::GetCurrentTaskRunner()->GetId();
-  std::shared_ptr<Worker> worker = worker_.lock();
+  std::shared_ptr<Worker> worker = GetWorker().lock();
   FOOTSTONE_CHECK(worker);
   return worker->WorkerDestroySpecific(task_runner_id);
 }
@@ -0,0 +1,223 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "include/footstone/task_runner_statistics.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+namespace footstone {
+inline namespace runner {
+
+// 与 Web Performance API 的 long task 保持一致
+constexpr int64_t kDefaultLongTaskThresholdMs = 50;
+
+std::atomic<bool> TaskRunnerStatistics::is_enabled_{false};
+std::atomic<int64_t> TaskRunnerStatistics::long_task_threshold_ns_{
+    TimeDelta::FromMilliseconds(kDefaultLongTaskThresholdMs).ToNanoseconds()};
+
+namespace {
+
+struct StatisticsRegistry {
+  std::mutex mutex;
+  // 同名 TaskRunner 共享统计，最后一个 TaskRunner 析构时移除
+  std::unordered_map<std::string, std::weak_ptr<TaskRunnerStatistics>> statistics;
+};
+
+StatisticsRegistry& GetRegistry() {
+  // 不析构，避免进程退出时 worker 线程仍在访问
+  static auto* registry = new StatisticsRegistry();
+  return *registry;
+}
+
+size_t GetBucketIndex(uint64_t us) {
+  if (us == 0) {
+    return 0;
+  }
+  auto index = static_cast<size_t>(64 - __builtin_clzll(us));
+  return std::min(index, TimeHistogram::kBucketCount - 1);
+}
+
+template<typename T>
+void UpdateMax(std::atomic<T>& max_value, T value) {
+  auto current = max_value.load(std::memory_order_relaxed);
+  while (value > current && !max_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+void TimeHistogram::Record(TimeDelta delta) {
+  auto us = static_cast<uint64_t>(std::max<int64_t>(delta.ToMicroseconds(), 0));
+  buckets_[GetBucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_us_.fetch_add(us, std::memory_order_relaxed);
+  UpdateMax(max_us_, us);
+}
+
+void TimeHistogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_us_.store(0, std::memory_order_relaxed);
+  max_us_.store(0, std::memory_order_relaxed);
+}
+
+TimeHistogram::TimeDelta TimeHistogram::GetMean() const {
+  auto count = GetCount();
+  if (count == 0) {
+    return TimeDelta::Zero();
+  }
+  return TimeDelta::FromMicroseconds(static_cast<int64_t>(sum_us_.load(std::memory_order_relaxed) / count));
+}
+
+TimeHistogram::TimeDelta TimeHistogram::GetPercentile(double percentile) const {
+  auto buckets = GetBuckets();
+  uint64_t total = 0;
+  for (auto count : buckets) {
+    total += count;
+  }
+  if (total == 0) {
+    return TimeDelta::Zero();
+  }
+  auto target = static_cast<uint64_t>(static_cast<double>(total) * std::clamp(percentile, 0.0, 1.0));
+  uint64_t accumulated = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    accumulated += buckets[i];
+    if (accumulated >= target && buckets[i] > 0) {
+      return std::min(GetBucketUpperBound(i), GetMax());
+    }
+  }
+  return GetMax();
+}
+
+std::array<uint64_t, TimeHistogram::kBucketCount> TimeHistogram::GetBuckets() const {
+  std::array<uint64_t, kBucketCount> buckets{};
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  return buckets;
+}
+
+TimeHistogram::TimeDelta TimeHistogram::GetBucketUpperBound(size_t index) {
+  if (index + 1 >= kBucketCount) {
+    return TimeDelta::Max();
+  }
+  return TimeDelta::FromMicroseconds(int64_t{1} << index);
+}
+
+TaskRunnerStatistics::TaskRunnerStatistics(std::string name) : name_(std::move(name)) {}
+
+void TaskRunnerStatistics::SetEnabled(bool is_enabled) {
+  is_enabled_.store(is_enabled, std::memory_order_relaxed);
+}
+
+void TaskRunnerStatistics::SetLongTaskThreshold(TimeDelta threshold) {
+  long_task_threshold_ns_.store(threshold.ToNanoseconds(), std::memory_order_relaxed);
+}
+
+TaskRunnerStatistics::TimeDelta TaskRunnerStatistics::GetLongTaskThreshold() {
+  return TimeDelta::FromNanoseconds(long_task_threshold_ns_.load(std::memory_order_relaxed));
+}
+
+std::shared_ptr<TaskRunnerStatistics> TaskRunnerStatistics::GetOrCreate(const std::string& name) {
+  auto& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto& weak_statistics = registry.statistics[name];
+  auto statistics = weak_statistics.lock();
+  if (!statistics) {
+    statistics = std::make_shared<TaskRunnerStatistics>(name);
+    weak_statistics = statistics;
+  }
+  return statistics;
+}
+
+void TaskRunnerStatistics::Release(std::shared_ptr<TaskRunnerStatistics>& statistics) {
+  if (!statistics) {
+    return;
+  }
+  auto name = statistics->GetName();
+  auto& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  statistics = nullptr;
+  auto it = registry.statistics.find(name);
+  if (it != registry.statistics.end() && it->second.expired()) {
+    registry.statistics.erase(it);
+  }
+}
+
+std::vector<std::shared_ptr<TaskRunnerStatistics>> TaskRunnerStatistics::GetAll() {
+  auto& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::vector<std::shared_ptr<TaskRunnerStatistics>> ret;
+  ret.reserve(registry.statistics.size());
+  for (const auto& [name, weak_statistics] : registry.statistics) {
+    auto statistics = weak_statistics.lock();
+    if (statistics) {
+      ret.push_back(std::move(statistics));
+    }
+  }
+  std::sort(ret.begin(), ret.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs->GetName() < rhs->GetName();
+  });
+  return ret;
+}
+
+void TaskRunnerStatistics::ResetAll() {
+  for (const auto& statistics : GetAll()) {
+    statistics->Reset();
+  }
+}
+
+void TaskRunnerStatistics::RecordQueueDepth(size_t depth) {
+  // 多个线程同时 post，需要 CAS 更新最高水位
+  UpdateMax(max_queue_depth_, depth);
+}
+
+void TaskRunnerStatistics::RecordTask(TimePoint start, TimeDelta wait, TimeDelta duration) {
+  wait_histogram_.Record(wait);
+  run_histogram_.Record(duration);
+  if (duration.ToNanoseconds() < long_task_threshold_ns_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(long_task_mutex_);
+  if (long_tasks_.size() >= kMaxLongTaskCount) {
+    long_tasks_.pop_front();
+  }
+  long_tasks_.push_back({start, wait, duration});
+}
+
+void TaskRunnerStatistics::Reset() {
+  wait_histogram_.Reset();
+  run_histogram_.Reset();
+  max_queue_depth_.store(0, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(long_task_mutex_);
+  long_tasks_.clear();
+}
+
+std::vector<TaskRunnerStatistics::LongTask> TaskRunnerStatistics::GetLongTasks() {
+  std::lock_guard<std::mutex> lock(long_task_mutex_);
+  return {long_tasks_.begin(), long_tasks_.end()};
+}
+
+}  // namespace runner
+}  // namespace footstone
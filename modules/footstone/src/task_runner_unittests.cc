@@ -0,0 +1,393 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "footstone/mpsc_queue.h"
+#include "footstone/task_runner.h"
+#include "footstone/task_runner_statistics.h"
+#include "footstone/timer_wheel.h"
+#include "footstone/worker_manager.h"
+
+namespace footstone {
+inline namespace runner {
+inline namespace testing {
+
+using TimeDelta = time::TimeDelta;
+using TimePoint = time::TimePoint;
+
+struct CountedTask : public MpscQueueNode {
+  uint32_t producer;
+  uint32_t sequence;
+  CountedTask(uint32_t producer, uint32_t sequence) : producer(producer), sequence(sequence) {}
+};
+
+TEST(MpscQueueTest, KeepsPerProducerOrder) {
+  constexpr uint32_t kProducerCount = 4;
+  constexpr uint32_t kItemsPerProducer = 20000;
+  MpscQueue<CountedTask> queue;
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < kProducerCount; ++p) {
+    producers.emplace_back([&queue, p]() {
+      for (uint32_t i = 0; i < kItemsPerProducer; ++i) {
+        queue.Push(std::make_unique<CountedTask>(p, i));
+      }
+    });
+  }
+  std::vector<uint32_t> next_sequence(kProducerCount, 0);
+  uint32_t popped = 0;
+  while (popped < kProducerCount * kItemsPerProducer) {
+    auto item = queue.Pop();
+    if (!item) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(item->sequence, next_sequence[item->producer]);
+    ++next_sequence[item->producer];
+    ++popped;
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_EQ(queue.Pop(), nullptr);
+}
+
+std::unique_ptr<Task> MakeRecordingTask(std::vector<int>& order, int value) {
+  return std::make_unique<Task>([&order, value]() { order.push_back(value); });
+}
+
+TEST(TimerWheelTest, ExpiresInDeadlineOrder) {
+  auto base = TimePoint::Now();
+  TimerWheel wheel(base);
+  std::vector<int> order;
+  // 覆盖第 0 层, 第 1 层和更高层
+  wheel.Add(MakeRecordingTask(order, 3), base + TimeDelta::FromMilliseconds(70000));
+  wheel.Add(MakeRecordingTask(order, 2), base + TimeDelta::FromMilliseconds(300));
+  wheel.Add(MakeRecordingTask(order, 1), base + TimeDelta::FromMilliseconds(5));
+  wheel.Add(MakeRecordingTask(order, 0), base - TimeDelta::FromMilliseconds(5));
+  EXPECT_EQ(wheel.Size(), 4);
+  EXPECT_EQ(wheel.GetNextDeadline(), base);
+
+  std::vector<std::unique_ptr<Task>> expired;
+  auto run_until = [&wheel, &expired, base](int64_t ms) {
+    wheel.Advance(base + TimeDelta::FromMilliseconds(ms), expired);
+    for (auto& task : expired) {
+      task->Run();
+    }
+    expired.clear();
+  };
+  run_until(4);
+  EXPECT_EQ(order, std::vector<int>{0});
+  EXPECT_EQ(wheel.GetNextDeadline(), base + TimeDelta::FromMilliseconds(5));
+  run_until(299);
+  EXPECT_EQ(order, (std::vector<int>{0, 1}));
+  EXPECT_LE(wheel.GetNextDeadline(), base + TimeDelta::FromMilliseconds(300));
+  run_until(300);
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+  run_until(69999);
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+  EXPECT_LE(wheel.GetNextDeadline(), base + TimeDelta::FromMilliseconds(70000));
+  run_until(70000);
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
+  EXPECT_TRUE(wheel.IsEmpty());
+  EXPECT_EQ(wheel.GetNextDeadline(), TimePoint::Max());
+}
+
+TEST(TimerWheelTest, NeverExpiresEarly) {
+  auto base = TimePoint::Now();
+  TimerWheel wheel(base);
+  std::vector<int> order;
+  for (int i = 0; i < 2000; ++i) {
+    wheel.Add(MakeRecordingTask(order, i), base + TimeDelta::FromMicroseconds(i * 997 + 1));
+  }
+  std::vector<std::unique_ptr<Task>> expired;
+  for (int64_t us = 0; us <= 2000 * 997 + 1000; us += 250) {
+    wheel.Advance(base + TimeDelta::FromMicroseconds(us), expired);
+    for (auto& task : expired) {
+      task->Run();
+    }
+    expired.clear();
+    for (auto value : order) {
+      ASSERT_LE(value * 997 + 1, us);
+    }
+  }
+  ASSERT_EQ(order.size(), 2000);
+  EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+}
+
+TEST(TaskRunnerTest, RunsImmediateAndDelayedTasks) {
+  auto worker_manager = std::make_shared<WorkerManager>(1);
+  auto runner = worker_manager->CreateTaskRunner("task_runner_test");
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<int> order;
+  auto record = [&](int value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(value);
+    cv.notify_all();
+  };
+  runner->PostDelayedTask([&record]() { record(2); }, TimeDelta::FromMilliseconds(30));
+  runner->PostDelayedTask([&record]() { record(1); }, TimeDelta::FromMilliseconds(10));
+  runner->PostTask([&record]() { record(0); });
+  std::unique_lock<std::mutex> lock(mutex);
+  EXPECT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&order]() { return order.size() == 3; }));
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+  lock.unlock();
+  worker_manager->RemoveTaskRunner(runner);
+  worker_manager->Terminate();
+}
+
+TEST(TaskRunnerTest, StatisticsRecordsLatencyAndLongTasks) {
+  auto worker_manager = std::make_shared<WorkerManager>(1);
+  auto runner = worker_manager->CreateTaskRunner("statistics_test");
+  auto statistics = runner->GetStatistics();
+  ASSERT_NE(statistics, nullptr);
+  EXPECT_EQ(statistics, TaskRunnerStatistics::GetOrCreate("statistics_test"));
+  statistics->Reset();
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  int done = 0;
+  auto finish = [&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++done;
+    cv.notify_all();
+  };
+  auto wait_for = [&](int count) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return cv.wait_for(lock, std::chrono::seconds(5), [&]() { return done == count; });
+  };
+
+  // 关闭时不记录
+  runner->PostTask(finish);
+  ASSERT_TRUE(wait_for(1));
+  EXPECT_EQ(statistics->GetRunHistogram().GetCount(), 0);
+
+  TaskRunnerStatistics::SetEnabled(true);
+  TaskRunnerStatistics::SetLongTaskThreshold(TimeDelta::FromMilliseconds(20));
+  // 第一个 task 阻塞 worker，后面的 task 在队列中堆积
+  runner->PostTask([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    finish();
+  });
+  for (int i = 0; i < 9; ++i) {
+    runner->PostTask(finish);
+  }
+  runner->PostDelayedTask(finish, TimeDelta::FromMilliseconds(5));
+  ASSERT_TRUE(wait_for(12));
+  TaskRunnerStatistics::SetEnabled(false);
+  TaskRunnerStatistics::SetLongTaskThreshold(TimeDelta::FromMilliseconds(50));
+
+  EXPECT_EQ(statistics->GetRunHistogram().GetCount(), 11);
+  EXPECT_EQ(statistics->GetWaitHistogram().GetCount(), 11);
+  EXPECT_GE(statistics->GetMaxQueueDepth(), 2);
+  EXPECT_GE(statistics->GetRunHistogram().GetMax(), TimeDelta::FromMilliseconds(29));
+  // 排在长任务之后的 task 至少等待了长任务的大部分时间
+  EXPECT_GE(statistics->GetWaitHistogram().GetMax(), TimeDelta::FromMilliseconds(20));
+  EXPECT_GE(statistics->GetWaitHistogram().GetPercentile(0.9), TimeDelta::FromMilliseconds(16));
+  auto long_tasks = statistics->GetLongTasks();
+  ASSERT_EQ(long_tasks.size(), 1);
+  EXPECT_GE(long_tasks[0].duration, TimeDelta::FromMilliseconds(29));
+
+  statistics->Reset();
+  EXPECT_EQ(statistics->GetRunHistogram().GetCount(), 0);
+  EXPECT_EQ(statistics->GetMaxQueueDepth(), 0);
+  EXPECT_TRUE(statistics->GetLongTasks().empty());
+  worker_manager->RemoveTaskRunner(runner);
+  worker_manager->Terminate();
+}
+
+TEST(TaskRunnerTest, StatisticsRemovedWithLastRunner) {
+  auto has_statistics = [](const std::string& name) {
+    auto all = TaskRunnerStatistics::GetAll();
+    return std::any_of(all.begin(), all.end(), [&name](const auto& statistics) {
+      return statistics->GetName() == name;
+    });
+  };
+  auto first = std::make_shared<TaskRunner>("statistics_release_test");
+  auto second = std::make_shared<TaskRunner>("statistics_release_test");
+  EXPECT_EQ(first->GetStatistics(), second->GetStatistics());
+  EXPECT_TRUE(has_statistics("statistics_release_test"));
+  first = nullptr;
+  EXPECT_TRUE(has_statistics("statistics_release_test"));
+  second = nullptr;
+  EXPECT_FALSE(has_statistics("statistics_release_test"));
+}
+
+TEST(TaskRunnerTest, TimeHistogramPercentile) {
+  TimeHistogram histogram;
+  for (int i = 0; i < 90; ++i) {
+    histogram.Record(TimeDelta::FromMicroseconds(3));
+  }
+  for (int i = 0; i < 10; ++i) {
+    histogram.Record(TimeDelta::FromMilliseconds(10));
+  }
+  EXPECT_EQ(histogram.GetCount(), 100);
+  EXPECT_EQ(histogram.GetPercentile(0.5), TimeDelta::FromMicroseconds(4));
+  EXPECT_EQ(histogram.GetPercentile(0.9), TimeDelta::FromMicroseconds(4));
+  EXPECT_EQ(histogram.GetPercentile(0.99), TimeDelta::FromMilliseconds(10));
+  EXPECT_EQ(histogram.GetMax(), TimeDelta::FromMilliseconds(10));
+  EXPECT_EQ(histogram.GetMean(), TimeDelta::FromMicroseconds((90 * 3 + 10 * 10000) / 100));
+}
+
+TEST(TaskRunnerTest, IdleTaskWithoutFrameIsCapped) {
+  auto worker_manager = std::make_shared<WorkerManager>(1);
+  auto runner = worker_manager->CreateTaskRunner("idle_no_frame_test");
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+  IdleTask::IdleCbParam result{};
+  runner->PostIdleTask(std::make_unique<IdleTask>([&](const IdleTask::IdleCbParam& param) {
+    std::lock_guard<std::mutex> lock(mutex);
+    result = param;
+    done = true;
+    cv.notify_all();
+  }, TimeDelta::Max()));
+  std::unique_lock<std::mutex> lock(mutex);
+  ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&]() { return done; }));
+  EXPECT_FALSE(result.did_time_out);
+  EXPECT_GT(result.res_time, TimeDelta::Zero());
+  EXPECT_LE(result.res_time, TimeDelta::FromMilliseconds(50));
+  lock.unlock();
+  worker_manager->RemoveTaskRunner(runner);
+  worker_manager->Terminate();
+}
+
+TEST(TaskRunnerTest, IdleTaskRespectsFrameBudget) {
+  auto worker_manager = std::make_shared<WorkerManager>(1);
+  auto runner = worker_manager->CreateTaskRunner("idle_frame_test");
+  constexpr auto kInterval = TimeDelta::FromMilliseconds(100);
+  constexpr auto kBudget = TimeDelta::FromMilliseconds(10);
+  auto frame_time = TimePoint::Now();
+  runner->OnFrameBegin(frame_time, kInterval);
+  runner->SetIdleBudget(kBudget);
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<IdleTask::IdleCbParam> params;
+  std::vector<TimePoint> run_times;
+  auto record = [&](const IdleTask::IdleCbParam& param) {
+    std::lock_guard<std::mutex> lock(mutex);
+    params.push_back(param);
+    run_times.push_back(TimePoint::Now());
+    cv.notify_all();
+  };
+  // 第一个 task 用完本帧的 budget
+  runner->PostIdleTask(std::make_unique<IdleTask>([&](const IdleTask::IdleCbParam& param) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(12));
+    record(param);
+  }, TimeDelta::Max()));
+  // 第二个 task 没有超时，应推迟到下一帧
+  runner->PostIdleTask(std::make_unique<IdleTask>(record, TimeDelta::Max()));
+  std::unique_lock<std::mutex> lock(mutex);
+  ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&]() { return params.size() == 2; }));
+  EXPECT_LE(params[0].res_time, kBudget);
+  EXPECT_FALSE(params[1].did_time_out);
+  EXPECT_GE(run_times[1], frame_time + kInterval);
+  EXPECT_LE(params[1].res_time, kBudget);
+  lock.unlock();
+  worker_manager->RemoveTaskRunner(runner);
+  worker_manager->Terminate();
+}
+
+TEST(TaskRunnerTest, DeferredIdleTaskRunsOnTimeout) {
+  auto worker_manager = std::make_shared<WorkerManager>(1);
+  auto runner = worker_manager->CreateTaskRunner("idle_timeout_test");
+  constexpr auto kInterval = TimeDelta::FromMilliseconds(200);
+  auto frame_time = TimePoint::Now();
+  runner->OnFrameBegin(frame_time, kInterval);
+  // budget 小于最小切片，本帧内不会有空闲时段
+  runner->SetIdleBudget(TimeDelta::FromMicroseconds(500));
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+  IdleTask::IdleCbParam result{};
+  TimePoint run_time;
+  runner->PostIdleTask(std::make_unique<IdleTask>([&](const IdleTask::IdleCbParam& param) {
+    std::lock_guard<std::mutex> lock(mutex);
+    result = param;
+    run_time = TimePoint::Now();
+    done = true;
+    cv.notify_all();
+  }, TimeDelta::FromMilliseconds(20)));
+  std::unique_lock<std::mutex> lock(mutex);
+  ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&]() { return done; }));
+  EXPECT_TRUE(result.did_time_out);
+  EXPECT_LT(run_time, frame_time + kInterval);
+  lock.unlock();
+  worker_manager->RemoveTaskRunner(runner);
+  worker_manager->Terminate();
+}
+
+uint32_t PostFromProducers(uint32_t producer_count, uint32_t tasks_per_producer) {
+  auto worker_manager = std::make_shared<WorkerManager>(1);
+  auto runner = worker_manager->CreateTaskRunner("concurrent_post_test");
+  std::atomic<uint32_t> counter{0};
+  std::mutex mutex;
+  std::condition_variable cv;
+  auto total = producer_count * tasks_per_producer;
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < producer_count; ++p) {
+    producers.emplace_back([&, tasks_per_producer]() {
+      for (uint32_t i = 0; i < tasks_per_producer; ++i) {
+        runner->PostTask([&]() {
+          if (counter.fetch_add(1, std::memory_order_relaxed) + 1 == total) {
+            std::lock_guard<std::mutex> lock(mutex);
+            cv.notify_all();
+          }
+        });
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait_for(lock, std::chrono::seconds(30), [&]() { return counter.load() == total; });
+  }
+  worker_manager->RemoveTaskRunner(runner);
+  worker_manager->Terminate();
+  return counter.load();
+}
+
+TEST(TaskRunnerTest, ConcurrentProducersRunEveryTask) {
+  constexpr uint32_t kTaskCount = 40000;
+  for (uint32_t producer_count : {1, 4, 8}) {
+    EXPECT_EQ(PostFromProducers(producer_count, kTaskCount / producer_count), kTaskCount) << producer_count;
+    TaskRunnerStatistics::SetEnabled(true);
+    EXPECT_EQ(PostFromProducers(producer_count, kTaskCount / producer_count), kTaskCount) << producer_count;
+    TaskRunnerStatistics::SetEnabled(false);
+  }
+}
+
+}  // namespace testing
+}  // namespace runner
+}  // namespace footstone
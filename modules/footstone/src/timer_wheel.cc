@@ -0,0 +1,190 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "include/footstone/timer_wheel.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace footstone {
+inline namespace runner {
+
+namespace {
+
+constexpr uint64_t kMaxTickDelta = (static_cast<uint64_t>(1) << 32) - 1;
+
+inline int CountTrailingZeros(uint64_t value) { return __builtin_ctzll(value); }
+
+// 从 start 开始循环查找 64 位 bitmap 中第一个置位的偏移, 不存在时返回 -1
+inline int FindNextSetOffset(uint64_t bitmap, uint32_t start) {
+  if (bitmap == 0) {
+    return -1;
+  }
+  start &= 63;
+  uint64_t rotated = start == 0 ? bitmap : (bitmap >> start) | (bitmap << (64 - start));
+  return CountTrailingZeros(rotated);
+}
+
+}  // namespace
+
+TimerWheel::TimerWheel(TimePoint base) : base_(base) {}
+
+uint64_t TimerWheel::ToTick(TimePoint deadline) const {
+  if (deadline <= base_) {
+    return 0;
+  }
+  auto delta = deadline - base_;
+  // 向上取整, 保证任务不会提前执行
+  auto tick = static_cast<uint64_t>(delta / kTick);
+  return (delta % kTick) == TimeDelta::Zero() ? tick : tick + 1;
+}
+
+void TimerWheel::Add(std::unique_ptr<Task> task, TimePoint deadline) {
+  Insert({ToTick(deadline), std::move(task)});
+  ++size_;
+}
+
+void TimerWheel::Insert(Entry&& entry) {
+  auto tick = std::max(entry.tick, current_tick_);
+  auto delta = tick - current_tick_;
+  if (delta < kRootSize) {
+    auto index = tick & (kRootSize - 1);
+    root_bitmap_[index >> 6] |= static_cast<uint64_t>(1) << (index & 63);
+    root_slots_[index].push_back(std::move(entry));
+    return;
+  }
+  if (delta > kMaxTickDelta) {
+    tick = current_tick_ + kMaxTickDelta;
+    delta = kMaxTickDelta;
+  }
+  for (uint32_t level = 0; level < kLevelCount; ++level) {
+    auto shift = GetLevelShift(level);
+    if (level + 1 == kLevelCount || delta < (static_cast<uint64_t>(1) << (shift + kLevelBits))) {
+      auto index = (tick >> shift) & (kLevelSize - 1);
+      level_bitmap_[level] |= static_cast<uint64_t>(1) << index;
+      level_slots_[level][index].push_back(std::move(entry));
+      return;
+    }
+  }
+}
+
+void TimerWheel::Cascade(uint32_t level, uint32_t index) {
+  if ((level_bitmap_[level] & (static_cast<uint64_t>(1) << index)) == 0) {
+    return;
+  }
+  level_bitmap_[level] &= ~(static_cast<uint64_t>(1) << index);
+  auto entries = std::move(level_slots_[level][index]);
+  level_slots_[level][index].clear();
+  for (auto& entry : entries) {
+    Insert(std::move(entry));
+  }
+}
+
+void TimerWheel::Advance(TimePoint now, std::vector<std::unique_ptr<Task>>& expired) {
+  if (now < base_) {
+    return;
+  }
+  auto now_tick = static_cast<uint64_t>((now - base_) / kTick);
+  while (current_tick_ <= now_tick) {
+    if (size_ == 0) {
+      current_tick_ = now_tick + 1;
+      return;
+    }
+    auto index = current_tick_ & (kRootSize - 1);
+    if (index == 0) {
+      for (uint32_t level = 0; level < kLevelCount; ++level) {
+        auto level_index = (current_tick_ >> GetLevelShift(level)) & (kLevelSize - 1);
+        Cascade(level, static_cast<uint32_t>(level_index));
+        if (level_index != 0) {
+          break;
+        }
+      }
+    }
+    if (root_bitmap_[index >> 6] & (static_cast<uint64_t>(1) << (index & 63))) {
+      root_bitmap_[index >> 6] &= ~(static_cast<uint64_t>(1) << (index & 63));
+      for (auto& entry : root_slots_[index]) {
+        expired.push_back(std::move(entry.task));
+      }
+      size_ -= root_slots_[index].size();
+      root_slots_[index].clear();
+    }
+    // 第 0 层剩余部分为空时直接跳到下一次下沉
+    uint64_t next_tick = current_tick_ + 1;
+    bool root_empty = std::all_of(root_bitmap_.begin(), root_bitmap_.end(), [](uint64_t bits) { return bits == 0; });
+    if (root_empty) {
+      next_tick = (current_tick_ | (kRootSize - 1)) + 1;
+    }
+    current_tick_ = std::min(next_tick, now_tick + 1);
+  }
+}
+
+TimerWheel::TimePoint TimerWheel::GetNextDeadline() const {
+  if (size_ == 0) {
+    return TimePoint::Max();
+  }
+  auto next_tick = std::numeric_limits<uint64_t>::max();
+  // 第 0 层每个槽只对应一个 tick
+  auto root_index = static_cast<uint32_t>(current_tick_ & (kRootSize - 1));
+  for (uint32_t i = 0; i <= kRootSize / 64; ++i) {
+    auto word = ((root_index >> 6) + i) % (kRootSize / 64);
+    auto bits = root_bitmap_[word];
+    if (i == 0) {
+      bits &= ~static_cast<uint64_t>(0) << (root_index & 63);
+    } else if (i == kRootSize / 64) {
+      bits &= (root_index & 63) == 0 ? 0 : ~(~static_cast<uint64_t>(0) << (root_index & 63));
+    }
+    if (bits != 0) {
+      auto index = word * 64 + static_cast<uint32_t>(CountTrailingZeros(bits));
+      next_tick = current_tick_ + ((index - root_index) & (kRootSize - 1));
+      break;
+    }
+  }
+  // 高层的槽在其对应时间段开始时下沉
+  for (uint32_t level = 0; level < kLevelCount; ++level) {
+    if (level_bitmap_[level] == 0) {
+      continue;
+    }
+    auto shift = GetLevelShift(level);
+    auto current = current_tick_ >> shift;
+    uint32_t start = (current_tick_ & ((static_cast<uint64_t>(1) << shift) - 1)) == 0 ? 0 : 1;
+    auto offset = FindNextSetOffset(level_bitmap_[level], static_cast<uint32_t>((current + start) & (kLevelSize - 1)));
+    auto cascade_tick = (current + start + static_cast<uint64_t>(offset)) << shift;
+    next_tick = std::min(next_tick, cascade_tick);
+  }
+  return base_ + kTick * static_cast<int64_t>(next_tick);
+}
+
+void TimerWheel::Clear() {
+  for (auto& slot : root_slots_) {
+    slot.clear();
+  }
+  for (auto& level : level_slots_) {
+    for (auto& slot : level) {
+      slot.clear();
+    }
+  }
+  root_bitmap_.fill(0);
+  level_bitmap_.fill(0);
+  size_ = 0;
+}
+
+}  // namespace runner
+}  // namespace footstone
@@ -29,6 +29,7 @@
 #include "include/footstone/check.h"
 #include "include/footstone/cv_driver.h"
 #include "include/footstone/logging.h"
+#include "include/footstone/scheduler.h"
 #include "include/footstone/worker_manager.h"
 
 #ifdef ANDROID
@@ -49,6 +50,9 @@ thread_local std::vector<std::shared_ptr<TaskRunner>> curr_group;
 Worker::Worker(std::string name, bool is_schedulable, std::unique_ptr<Driver> driver)
     : thread_(),
       name_(std::move(name)),
+      running_group_(nullptr),
+      order_seq_(0),
+      is_order_dirty_(false),
       min_wait_time_(TimeDelta::Max()),
       next_task_time_(TimePoint::Max()),
       need_balance_(false),
@@ -56,7 +60,10 @@ Worker::Worker(std::string name, bool is_schedulable, std::unique_ptr<Driver> dr
       has_migration_data_(false),
       is_schedulable_(is_schedulable),
       group_id_(0),
-      driver_(std::move(driver)) {
+      driver_(std::move(driver)),
+      scheduler_(nullptr),
+      is_busy_(false),
+      is_waiting_(false) {
 }
 
 Worker::~Worker() {
@@ -89,9 +96,12 @@ void Worker::BalanceNoLock() {
   }
 
   TimeDelta time;  // default 0
+  if (is_order_dirty_) {
+    RebuildOrderNoLock();
+  }
   auto running_it = running_group_list_.begin();
-  if (running_it != running_group_list_.end()) {
-    time = running_it->front()->GetTime();
+  if (!running_order_.empty()) {
+    time = running_order_.begin()->group->front()->GetTime();
   }
   // 等待队列初始化为当前优先级最高taskRunner运行时间
   for (auto &group : pending_group_list_) {
@@ -101,6 +111,7 @@ void Worker::BalanceNoLock() {
   }
   // 新的taskRunner插入到最高优先级之后，既可以保证原有队列执行顺序不变，又可以使得未执行的TaskRunner优先级高
   running_group_list_.splice(running_it, pending_group_list_);
+  is_order_dirty_ = true;
 }
 
 bool Worker::RunTask() {
@@ -108,13 +119,27 @@ bool Worker::RunTask() {
   if (!task) {
     return false;
   }
+  // 只统计来自 TaskRunner 的 task，迁移等内部 task 不计入
+  auto runner = running_group_ ? local_runner : nullptr;
   TimePoint begin = TimePoint::Now();
   is_task_running = true;
   task->Run();
   is_task_running = false;
+  auto time = TimePoint::Now() - begin;
   for (auto &it : curr_group) {
-    it->AddTime(TimePoint::Now() - begin);
+    it->AddTime(time);
+  }
+  if (runner && TaskRunnerStatistics::IsEnabled() && task->GetReadyTime() != TimePoint()) {
+    runner->GetStatistics()->RecordTask(begin, begin - task->GetReadyTime(), time);
+  }
+  {
+    std::lock_guard<std::mutex> lock(running_mutex_);
+    if (running_group_) {
+      UpdateRunningOrderNoLock();
+      running_group_ = nullptr;
+    }
   }
+  is_busy_.store(false, std::memory_order_relaxed);
   return true;
 }
 
@@ -136,23 +161,38 @@ void Worker::Start(bool in_new_thread) {
   }
 }
 
-void Worker::SortNoLock() { // sort后优先级越高的TaskRunner分组距离队列头部越近
-  if (!running_group_list_.empty()) {
-    running_group_list_.sort([](const auto &lhs, const auto &rhs) {
-      FOOTSTONE_CHECK(!lhs.empty() && !rhs.empty());
-      // 运行时间越短优先级越高，priority越小优先级越高
-      int64_t left = lhs[0]->GetPriority() * lhs[0]->GetTime().ToNanoseconds();
-      int64_t right = rhs[0]->GetPriority() * rhs[0]->GetTime().ToNanoseconds();
-      if (left < right) {
-        return true;
-      }
-      return false;
-    });
+int64_t GetGroupWeight(const std::vector<std::shared_ptr<TaskRunner>>& group) {
+  FOOTSTONE_CHECK(!group.empty());
+  // 运行时间越短优先级越高，priority越小优先级越高
+  return group[0]->GetPriority() * group[0]->GetTime().ToNanoseconds();
+}
+
+void Worker::RebuildOrderNoLock() {
+  running_order_.clear();
+  order_seq_ = 0;
+  for (auto group_it = running_group_list_.begin(); group_it != running_group_list_.end(); ++group_it) {
+    running_order_.insert(GroupOrder{GetGroupWeight(*group_it), order_seq_++, group_it});
   }
+  is_order_dirty_ = false;
+}
+
+void Worker::UpdateRunningOrderNoLock() {
+  // 运行期间分组被移除或有新分组加入时，下次取任务会整体重建
+  if (is_order_dirty_) {
+    return;
+  }
+  auto order = *running_order_it_;
+  running_order_.erase(running_order_it_);
+  order.weight = GetGroupWeight(*order.group);
+  running_order_.insert(order);
 }
 
 void Worker::Notify() {
   driver_->Notify();
+  // 仅 work stealing 模式下，自身正忙且确有 Worker 在等待时才唤醒它来窃取新任务，其余情况 post 不碰 Scheduler 的锁
+  if (scheduler_ && is_busy_.load(std::memory_order_relaxed) && scheduler_->HasWaitingWorker()) {
+    scheduler_->WakeUpIdleWorker(this);
+  }
 }
 
 void Worker::Terminate() {
@@ -192,6 +232,7 @@ void Worker::BindGroup(uint32_t father_id, const std::shared_ptr<TaskRunner> &ch
     }
   }
   group_it->push_back(child);
+  is_order_dirty_ = true;
 }
 
 void Worker::Bind(std::vector<std::shared_ptr<TaskRunner>> group) {
@@ -239,6 +280,9 @@ void Worker::UnBind(const std::shared_ptr<TaskRunner> &runner) {
   {
     std::lock_guard<std::mutex> running_lock(running_mutex_);
     has_found = EraseRunnerNoLock(running_group_list_, runner);
+    if (has_found) {
+      is_order_dirty_ = true;
+    }
   }
 
   if (!has_found) {
@@ -259,6 +303,7 @@ std::list<std::vector<std::shared_ptr<TaskRunner>>> Worker::UnBind() {
   {
     std::lock_guard<std::mutex> lock(running_mutex_);
     ret.splice(ret.end(), running_group_list_);
+    is_order_dirty_ = true;
   }
   {
     std::lock_guard<std::mutex> lock(pending_mutex_);
@@ -296,6 +341,7 @@ std::list<std::vector<std::shared_ptr<TaskRunner>>> Worker::RetainActiveAndUnsch
       }
       ret.splice(ret.end(), running_group_list_, group_it);
     }
+    is_order_dirty_ = true;
   }
   {
     std::lock_guard<std::mutex> lock(pending_mutex_);
@@ -322,6 +368,7 @@ std::list<std::vector<std::shared_ptr<TaskRunner>>> Worker::Retain(
 
   std::list<std::vector<std::shared_ptr<TaskRunner>>> ret(std::move(running_group_list_));
   running_group_list_ = {group};
+  is_order_dirty_ = true;
   return ret;
 }
 
@@ -331,6 +378,44 @@ void Worker::AddImmediateTask(std::unique_ptr<Task> task) {
   immediate_task_queue_.push(std::move(task));
 }
 
+bool Worker::HasPendingGroupNoLock(std::set<GroupOrder>::iterator begin) {
+  for (auto order_it = begin; order_it != running_order_.end(); ++order_it) {
+    if (order_it->group->back()->HasPendingTask()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<std::shared_ptr<TaskRunner>> Worker::StealGroup() {
+  // 不阻塞被窃取的 Worker，拿不到锁就放弃
+  std::unique_lock<std::mutex> lock(running_mutex_, std::try_to_lock);
+  if (!lock.owns_lock() || !is_schedulable_ || !running_group_) {
+    return {};
+  }
+  for (auto group_it = running_group_list_.begin(); group_it != running_group_list_.end(); ++group_it) {
+    if (&*group_it == running_group_) {
+      continue;
+    }
+    bool is_stealable = true;
+    for (auto &runner : *group_it) {
+      // 指定了 group_id 的 TaskRunner 必须留在同一个 Worker
+      if (!runner->IsSchedulable() || runner->GetGroupId() != kDefaultGroupId) {
+        is_stealable = false;
+        break;
+      }
+    }
+    if (!is_stealable || !group_it->back()->HasPendingTask()) {
+      continue;
+    }
+    auto group = std::move(*group_it);
+    running_group_list_.erase(group_it);
+    is_order_dirty_ = true;
+    return group;
+  }
+  return {};
+}
+
 template <class F>
 auto MakeCopyable(F&& f) {
   auto s = std::make_shared<std::decay_t<F>>(std::forward<F>(f));
@@ -350,9 +435,6 @@ std::unique_ptr<Task> Worker::GetNextTask() {
       immediate_task_queue_.pop();
       return task;
     }
-    if (running_group_list_.size() > 1) {
-      SortNoLock();
-    }
   }
 
   if (need_balance_) {
@@ -367,44 +449,83 @@ std::unique_ptr<Task> Worker::GetNextTask() {
   min_wait_time_ = TimeDelta::Max();
   TimePoint now = TimePoint::Now();
   std::unique_ptr<IdleTask> idle_task;
-  for (auto &running_group : running_group_list_) {
-    auto runner = running_group.back(); // group栈顶会阻塞下面的taskRunner执行
-    auto task = runner->GetNext();
-    if (task) {
-      curr_group = running_group; // curr_group只会在当前线程获取，因此不需要加锁
-      local_runner = runner;
-      return task;
-    } else {
-      if (!idle_task) {
-        idle_task = running_group.front()->PopIdleTask();
-      }
-      last_wait_time = running_group.front()->GetNextTimeDelta(now);
-      if (min_wait_time_ > last_wait_time) {
-        min_wait_time_ = last_wait_time;
-        next_task_time_ = now + min_wait_time_;
+  std::shared_ptr<TaskRunner> idle_runner;
+  TimeDelta idle_time;
+  {
+    std::unique_lock<std::mutex> lock(running_mutex_);
+    if (is_order_dirty_) {
+      RebuildOrderNoLock();
+    }
+    for (auto order_it = running_order_.begin(); order_it != running_order_.end(); ++order_it) {
+      auto &running_group = *order_it->group;
+      auto runner = running_group.back(); // group栈顶会阻塞下面的taskRunner执行
+      auto task = runner->GetNext();
+      if (task) {
+        curr_group = running_group; // curr_group只会在当前线程获取，因此不需要加锁
+        local_runner = runner;
+        running_group_ = &running_group;
+        running_order_it_ = order_it;
+        is_busy_.store(true, std::memory_order_relaxed);
+        // 还有其他分组在排队时唤醒空闲的 Worker 来窃取
+        if (scheduler_ && scheduler_->HasWaitingWorker() && HasPendingGroupNoLock(std::next(order_it))) {
+          lock.unlock();
+          scheduler_->WakeUpIdleWorker(this);
+        }
+        return task;
+      } else {
+        if (!idle_task) {
+          idle_task = running_group.front()->PopIdleTask(now, idle_time);
+          if (idle_task) {
+            idle_runner = running_group.front();
+          }
+        }
+        last_wait_time = running_group.front()->GetNextTimeDelta(now);
+        if (min_wait_time_ > last_wait_time) {
+          min_wait_time_ = last_wait_time;
+          next_task_time_ = now + min_wait_time_;
+        }
       }
     }
   }
   if (idle_task) {
+    // 可用时间不超过帧截止时间、本帧 idle budget 和下一个延迟任务的到期时间
+    auto res_time = std::max(std::min(min_wait_time_, idle_time), TimeDelta::Zero());
     auto wrapper_idle_task = std::make_unique<Task>(
         MakeCopyable([begin_time = idle_task->GetBeginTime(),
                       timeout = idle_task->GetTimeout(),
                       task = std::move(idle_task),
-                      time = min_wait_time_]() {
-          auto now = TimePoint::Now();
-          bool did_time_out = now - begin_time > timeout;
+                      weak_runner = std::weak_ptr<TaskRunner>(idle_runner),
+                      time = res_time]() {
+          auto run_time = TimePoint::Now();
+          bool did_time_out = run_time - begin_time > timeout;
           IdleTask::IdleCbParam param = {
               .did_time_out = did_time_out,
               .res_time = time
           };
           task->Run(param);
+          auto runner = weak_runner.lock();
+          if (runner) {
+            runner->AddIdleTime(TimePoint::Now() - run_time);
+          }
         }));
     return wrapper_idle_task;
   }
   if (driver_->IsTerminated()) {
     return nullptr;
   }
-  driver_->WaitFor(min_wait_time_);
+  if (!scheduler_) {
+    driver_->WaitFor(min_wait_time_);
+    return nullptr;
+  }
+  // 先标记为等待状态再窃取，窃取失败后进入等待期间 post 到忙碌 Worker 的任务可以唤醒当前 Worker
+  is_waiting_.store(true, std::memory_order_relaxed);
+  scheduler_->OnWorkerWait();
+  auto self = GetSelf().lock();
+  if (!self || !scheduler_->Steal(self)) {
+    driver_->WaitFor(min_wait_time_);
+  }
+  scheduler_->OnWorkerWake();
+  is_waiting_.store(false, std::memory_order_relaxed);
   return nullptr;
 }
 
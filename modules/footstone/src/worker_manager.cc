@@ -31,7 +31,10 @@
 namespace footstone {
 inline namespace runner {
 
-WorkerManager::WorkerManager(uint32_t size) : index_(0), size_(size) { CreateWorkers(size); }
+WorkerManager::WorkerManager(uint32_t size, bool is_work_stealing)
+    : scheduler_(is_work_stealing ? std::make_shared<Scheduler>() : nullptr), index_(0), size_(size) {
+  CreateWorkers(size);
+}
 
 WorkerManager::~WorkerManager() = default;
 
@@ -45,11 +48,21 @@ void WorkerManager::CreateWorkers(uint32_t size) {
   std::shared_ptr<Worker> worker;
   for (uint32_t i = 0; i < size; ++i) {
     worker = std::make_shared<WorkerImpl>();
+    AddSchedulableWorker(worker);
     worker->Start();
     workers_.push_back(worker);
   }
 }
 
+// 必须在 Worker 启动前调用
+void WorkerManager::AddSchedulableWorker(const std::shared_ptr<Worker>& worker) {
+  if (!scheduler_ || !worker->is_schedulable_) {
+    return;
+  }
+  worker->scheduler_ = scheduler_;
+  scheduler_->AddWorker(worker);
+}
+
 void WorkerManager::MoveTaskRunnerSpecificNoLock(uint32_t runner_id,
                                                  const std::shared_ptr<Worker> &from,
                                                  const std::shared_ptr<Worker> &to) {
@@ -94,6 +107,7 @@ void WorkerManager::Resize(uint32_t size) {
 }
 
 void WorkerManager::AddWorker(const std::shared_ptr<Worker>& worker) {
+  // 外部传入的 Worker 已经在运行，且可能运行外部任务，不参与 work stealing
   workers_.push_back(worker);
   Balance(1);
 }
@@ -135,7 +149,7 @@ void WorkerManager::Balance(int32_t increase_worker_count) {
       for (auto &item : list) {
         for (auto &runner: item) {
           auto id = runner->GetId();
-          auto orig_worker = runner->worker_.lock();
+          auto orig_worker = runner->GetWorker().lock();
           FOOTSTONE_CHECK(orig_worker);
           WorkerManager::MoveTaskRunnerSpecificNoLock(id, orig_worker, worker);
         }
@@ -180,18 +194,21 @@ void WorkerManager::Balance(int32_t increase_worker_count) {
       for (auto &vec_it : group) {
         const auto &runner = vec_it;
         auto id = runner->GetId();
-        auto orig_worker = runner->worker_.lock();
+        auto orig_worker = runner->GetWorker().lock();
         if (orig_worker) {
           new_worker->UpdateSpecificKeys(id, orig_worker->GetMovedSpecificKeys(id));
           new_worker->UpdateSpecific(id, orig_worker->GetMovedSpecific(id));
         }
-        runner->worker_ = new_worker;
+        runner->SetWorker(new_worker);
       }
       index_ = (index_ == size - 1) ? 0 : (1 + index_);
       ++it;
     }
     for (auto i = size_ - 1; static_cast<int32_t>(i) > size - 1; --i) {
       // handle running runner on thread
+      if (scheduler_) {
+        scheduler_->RemoveWorker(workers_[i]);
+      }
       workers_[i]->Terminate();
       workers_.pop_back();
     }
@@ -225,7 +242,7 @@ void WorkerManager::Balance(int32_t increase_worker_count) {
       for (auto &item : list) {
         for (auto &runner: item) {
           auto id = runner->GetId();
-          auto orig_worker = runner->worker_.lock();
+          auto orig_worker = runner->GetWorker().lock();
           FOOTSTONE_CHECK(orig_worker);
           WorkerManager::MoveTaskRunnerSpecificNoLock(id, orig_worker, worker);
         }
@@ -252,7 +269,7 @@ std::shared_ptr<TaskRunner> WorkerManager::CreateTaskRunner(uint32_t group_id,
     if (group_id != kDefaultGroupId) {
       for (const auto &worker: workers_) {
         if (worker->GetGroupId() == group_id) {
-          task_runner->worker_ = worker;
+          task_runner->SetWorker(worker);
           worker->Bind(std::vector<std::shared_ptr<TaskRunner>>{task_runner});
           return task_runner;
         }
@@ -263,7 +280,7 @@ std::shared_ptr<TaskRunner> WorkerManager::CreateTaskRunner(uint32_t group_id,
         worker = workers_[static_cast<size_t>(index_)];
         index_ = (index_ == static_cast<int32_t>(size_ - 1)) ? 0 : (1 + index_);
       }
-      task_runner->worker_ = worker;
+      task_runner->SetWorker(worker);
       worker->Bind(std::vector<std::shared_ptr<TaskRunner>>{task_runner});
     } else {
       AddTaskRunner(task_runner);
@@ -285,7 +302,7 @@ void WorkerManager::AddTaskRunner(std::shared_ptr<TaskRunner> runner) {
   std::lock_guard<std::mutex> lock(mutex_);
   auto worker = workers_[static_cast<size_t>(index_)];
   for (auto &r : group) {
-    r->worker_ = worker;
+    r->SetWorker(worker);
   }
   worker->Bind(group);
   UpdateWorkerSpecific(worker, group);
@@ -295,7 +312,7 @@ void WorkerManager::AddTaskRunner(std::shared_ptr<TaskRunner> runner) {
 void WorkerManager::UpdateWorkerSpecific(const std::shared_ptr<Worker> &worker,
                                          const std::vector<std::shared_ptr<TaskRunner>> &group) {
   for (auto &it : group) {
-    it->worker_ = worker;
+    it->SetWorker(worker);
     std::array<Worker::WorkerKey, Worker::kWorkerKeysMax> keys_array;
     worker->UpdateSpecificKeys(it->GetId(), std::move(keys_array));
     std::array<void *, Worker::kWorkerKeysMax> specific_array{};
@@ -0,0 +1,194 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2024 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "footstone/task_runner.h"
+#include "footstone/worker_manager.h"
+
+namespace footstone {
+inline namespace runner {
+inline namespace testing {
+
+using TimeDelta = time::TimeDelta;
+
+constexpr uint32_t kWorkerCount = 4;
+
+void BusyWait(std::chrono::microseconds duration) {
+  auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+class Countdown {
+ public:
+  explicit Countdown(uint32_t count) : count_(count) {}
+
+  void Done() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--count_ == 0) {
+      cv_.notify_all();
+    }
+  }
+
+  bool Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, std::chrono::seconds(60), [this]() { return count_ == 0; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint32_t count_;
+};
+
+// 同一个 TaskRunner 的任务在迁移后依然按顺序串行执行
+TEST(WorkerManagerTest, WorkStealingKeepsRunnerSerial) {
+  constexpr uint32_t kRunnerCount = 16;
+  constexpr uint32_t kTaskCount = 200;
+  auto worker_manager = std::make_shared<WorkerManager>(kWorkerCount, true);
+  EXPECT_TRUE(worker_manager->IsWorkStealing());
+  std::vector<std::shared_ptr<TaskRunner>> runners;
+  std::vector<std::vector<uint32_t>> orders(kRunnerCount);
+  std::vector<std::atomic<int32_t>> in_flight(kRunnerCount);
+  std::atomic<bool> has_overlap{false};
+  Countdown countdown(kRunnerCount * kTaskCount);
+  for (uint32_t i = 0; i < kRunnerCount; ++i) {
+    runners.push_back(worker_manager->CreateTaskRunner("steal_test_" + std::to_string(i)));
+  }
+  for (uint32_t t = 0; t < kTaskCount; ++t) {
+    for (uint32_t i = 0; i < kRunnerCount; ++i) {
+      runners[i]->PostTask([&, i, t]() {
+        if (in_flight[i].fetch_add(1) != 0) {
+          has_overlap = true;
+        }
+        orders[i].push_back(t);
+        // 让编号为 kWorkerCount 整数倍的 runner 明显更重，制造负载不均
+        BusyWait(std::chrono::microseconds(i % kWorkerCount == 0 ? 200 : 10));
+        in_flight[i].fetch_sub(1);
+        countdown.Done();
+      });
+    }
+  }
+  EXPECT_TRUE(countdown.Wait());
+  EXPECT_FALSE(has_overlap);
+  for (uint32_t i = 0; i < kRunnerCount; ++i) {
+    ASSERT_EQ(orders[i].size(), kTaskCount);
+    for (uint32_t t = 0; t < kTaskCount; ++t) {
+      ASSERT_EQ(orders[i][t], t);
+    }
+  }
+  EXPECT_GT(worker_manager->GetStealCount(), 0);
+  for (auto& runner : runners) {
+    worker_manager->RemoveTaskRunner(runner);
+  }
+  worker_manager->Terminate();
+}
+
+// 指定了 group_id 或不可调度的 TaskRunner 不会被窃取
+TEST(WorkerManagerTest, WorkStealingKeepsAffinity) {
+  constexpr uint32_t kTaskCount = 100;
+  auto worker_manager = std::make_shared<WorkerManager>(kWorkerCount, true);
+  auto grouped_runner = worker_manager->CreateTaskRunner(1, kDefaultPriority, true, "grouped");
+  auto unschedulable_runner = worker_manager->CreateTaskRunner(kDefaultGroupId, kDefaultPriority, false,
+                                                                "unschedulable");
+  worker_manager->AddTaskRunner(unschedulable_runner);
+  auto busy_runner = worker_manager->CreateTaskRunner("busy");
+  std::mutex mutex;
+  std::unordered_set<std::thread::id> grouped_threads;
+  std::unordered_set<std::thread::id> unschedulable_threads;
+  Countdown countdown(kTaskCount * 3);
+  for (uint32_t t = 0; t < kTaskCount; ++t) {
+    busy_runner->PostTask([&]() {
+      BusyWait(std::chrono::microseconds(100));
+      countdown.Done();
+    });
+    grouped_runner->PostTask([&]() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        grouped_threads.insert(std::this_thread::get_id());
+      }
+      BusyWait(std::chrono::microseconds(50));
+      countdown.Done();
+    });
+    unschedulable_runner->PostTask([&]() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        unschedulable_threads.insert(std::this_thread::get_id());
+      }
+      BusyWait(std::chrono::microseconds(50));
+      countdown.Done();
+    });
+  }
+  EXPECT_TRUE(countdown.Wait());
+  EXPECT_EQ(grouped_threads.size(), 1);
+  EXPECT_EQ(unschedulable_threads.size(), 1);
+  worker_manager->RemoveTaskRunner(grouped_runner);
+  worker_manager->RemoveTaskRunner(unschedulable_runner);
+  worker_manager->RemoveTaskRunner(busy_runner);
+  worker_manager->Terminate();
+}
+
+uint64_t RunSkewedLoad(bool is_work_stealing, uint32_t runner_count, uint32_t task_count) {
+  auto worker_manager = std::make_shared<WorkerManager>(kWorkerCount, is_work_stealing);
+  std::vector<std::shared_ptr<TaskRunner>> runners;
+  for (uint32_t i = 0; i < runner_count; ++i) {
+    runners.push_back(worker_manager->CreateTaskRunner("skewed_" + std::to_string(i)));
+  }
+  Countdown countdown(runner_count * task_count);
+  for (uint32_t t = 0; t < task_count; ++t) {
+    for (uint32_t i = 0; i < runner_count; ++i) {
+      // runner 按创建顺序轮流绑定到 Worker，只让第一个 Worker 上的 runner 承担负载
+      bool is_heavy = i % kWorkerCount == 0;
+      runners[i]->PostTask([&countdown, is_heavy]() {
+        if (is_heavy) {
+          std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        countdown.Done();
+      });
+    }
+  }
+  EXPECT_TRUE(countdown.Wait());
+  auto steal_count = worker_manager->GetStealCount();
+  for (auto& runner : runners) {
+    worker_manager->RemoveTaskRunner(runner);
+  }
+  worker_manager->Terminate();
+  return steal_count;
+}
+
+TEST(WorkerManagerTest, WorkStealingMovesSkewedLoad) {
+  constexpr uint32_t kRunnerCount = 64;
+  constexpr uint32_t kTaskCount = 20;
+  EXPECT_EQ(RunSkewedLoad(false, kRunnerCount, kTaskCount), 0);
+  EXPECT_GT(RunSkewedLoad(true, kRunnerCount, kTaskCount), 0);
+}
+
+}  // namespace testing
+}  // namespace runner
+}  // namespace footstone
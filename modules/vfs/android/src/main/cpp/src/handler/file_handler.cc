@@ -25,6 +25,7 @@
 #include "vfs/uri.h"
 
 constexpr char kRunnerName[] = "file_handler_runner";
+constexpr size_t kChunkSize = 64 * 1024;
 
 using Uri = hippy::Uri;
 
@@ -41,7 +42,13 @@ void FileHandler::RequestUntrustedContent(std::shared_ptr<RequestJob> request,
     response->SetRetCode(hippy::JobResponse::RetCode::PathError);
     return;
   }
-  bool ret = HippyFile::ReadFile(path, response->GetContent(), false);
+  bool ret;
+  auto& data_cb = request->GetDataCallback();
+  if (data_cb) {
+    ret = HippyFile::ReadFileInChunks(path, response->GetContent(), kChunkSize, data_cb);
+  } else {
+    ret = HippyFile::ReadFile(path, response->GetContent(), false);
+  }
   if (ret) {
     response->SetRetCode(UriHandler::RetCode::Success);
   } else {
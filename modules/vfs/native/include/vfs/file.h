@@ -26,6 +26,7 @@
 #include <unistd.h>
 
 #include <fstream>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -50,6 +51,11 @@ class HippyFile {
   static int CreateDir(const string_view& dir_path, mode_t mode);
   static int CheckDir(const string_view& dir_path, int mode);
   static uint64_t GetFileModifyTime(const string_view& file_path);
+  // 与 ReadFile 相同，但按 chunk_size 分块读取，每读完一块调用 on_chunk
+  static bool ReadFileInChunks(const string_view& file_path,
+                               std::string& bytes,
+                               size_t chunk_size,
+                               const std::function<void(const uint8_t* data, size_t length)>& on_chunk);
 
   template <typename CharType>
   static bool ReadFile(const string_view& file_path,
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <functional>
 #include <unordered_map>
 
 #include "footstone/string_view.h"
@@ -33,6 +34,7 @@ class RequestJob {
   using string_view = footstone::string_view;
   using WorkerManager = footstone::WorkerManager;
   using bytes = std::string;
+  using DataCallback = std::function<void(const uint8_t* data, size_t length)>;
 
   RequestJob(const string_view& uri, std::unordered_map<std::string, std::string> meta,
              std::unique_ptr<WorkerManager>& worker_manager);
@@ -66,12 +68,22 @@ class RequestJob {
     return buffer_;
   }
 
+  // 支持分块读取的 handler 每读到一块内容就回调一次，response 中仍是完整内容
+  inline void SetDataCallback(DataCallback data_cb) {
+    data_cb_ = std::move(data_cb);
+  }
+
+  inline auto& GetDataCallback() {
+    return data_cb_;
+  }
+
  private:
   string_view uri_;
   std::unordered_map<std::string, std::string> meta_;
   std::unique_ptr<WorkerManager>& worker_manager_;
   std::function<void(int64_t current, int64_t total)> progress_cb_;
   bytes buffer_; // request body buffer
+  DataCallback data_cb_;
 };
 
 }
@@ -66,6 +66,15 @@ class UriLoader: public std::enable_shared_from_this<UriLoader> {
       std::unordered_map<std::string, std::string>& rsp_meta,
       bytes& content);
 
+  // 同上，支持分块读取的 handler 在内容到达时通过 data_cb 逐块回调，适合边加载边处理的大文件
+  virtual void RequestUntrustedContent(
+      const string_view& uri,
+      const std::unordered_map<std::string, std::string>& req_meta,
+      const RequestJob::DataCallback& data_cb,
+      RetCode& code,
+      std::unordered_map<std::string, std::string>& rsp_meta,
+      bytes& content);
+
   virtual void RequestUntrustedContent(const std::shared_ptr<RequestJob>& request, std::shared_ptr<JobResponse> response);
   virtual void RequestUntrustedContent(const std::shared_ptr<RequestJob>& request, const std::function<void(std::shared_ptr<JobResponse>)>& cb);
 
@@ -24,6 +24,7 @@
 
 #include <dirent.h>
 #include <sys/stat.h>
+#include <algorithm>
 #include <iostream>
 
 namespace hippy {
@@ -130,5 +131,42 @@ uint64_t HippyFile::GetFileModifyTime(const string_view& file_path) {
   return modify_time;
 }
 
+bool HippyFile::ReadFileInChunks(const string_view& file_path,
+                                 std::string& bytes,
+                                 size_t chunk_size,
+                                 const std::function<void(const uint8_t* data, size_t length)>& on_chunk) {
+  auto path_str = StringViewUtils::ConvertEncoding(file_path, string_view::Encoding::Utf8).utf8_value();
+  std::ifstream file(reinterpret_cast<const char*>(path_str.c_str()), std::ios::binary);
+  if (file.fail() || chunk_size == 0) {
+    FOOTSTONE_DLOG(INFO) << "ReadFileInChunks fail, file_path = " << file_path;
+    return false;
+  }
+  file.seekg(0, std::ios_base::end);
+  std::streamsize size = file.tellg();
+  file.seekg(0, std::ios_base::beg);
+  size_t data_size;
+  if (size < 0 || !footstone::check::numeric_cast<std::streamsize, size_t>(size, data_size)) {
+    file.close();
+    return false;
+  }
+  bytes.resize(data_size);
+  size_t offset = 0;
+  while (offset < data_size) {
+    auto length = std::min(chunk_size, data_size - offset);
+    auto read_size = file.read(&bytes[offset],
+                               footstone::checked_numeric_cast<size_t, std::streamsize>(length)).gcount();
+    if (read_size <= 0) {
+      break;
+    }
+    on_chunk(reinterpret_cast<const uint8_t*>(&bytes[offset]), static_cast<size_t>(read_size));
+    offset += static_cast<size_t>(read_size);
+  }
+  bytes.resize(offset);
+  file.close();
+  FOOTSTONE_DLOG(INFO) << "ReadFileInChunks succ, file_path = " << file_path << ", size = " << size
+                       << ", read_size = " << offset;
+  return true;
+}
+
 } // namespace vfs
 } // namespace hippy
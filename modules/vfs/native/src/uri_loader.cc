@@ -82,6 +82,21 @@ void UriLoader::RequestUntrustedContent(const string_view& uri,
   content = response->ReleaseContent();
 }
 
+void UriLoader::RequestUntrustedContent(const string_view& uri,
+                                        const std::unordered_map<std::string, std::string>& req_meta,
+                                        const RequestJob::DataCallback& data_cb,
+                                        RetCode& code,
+                                        std::unordered_map<std::string, std::string>& rsp_meta,
+                                        bytes& content) {
+  auto request = std::make_shared<RequestJob>(uri, req_meta, worker_manager_);
+  request->SetDataCallback(data_cb);
+  auto response = std::make_shared<JobResponse>();
+  RequestUntrustedContent(request, response);
+  code = response->GetRetCode();
+  rsp_meta = response->GetMeta();
+  content = response->ReleaseContent();
+}
+
 void UriLoader::RequestUntrustedContent(const std::shared_ptr<RequestJob>& request, std::shared_ptr<JobResponse> response) {
   // performance start time
   auto start_time = TimePoint::SystemNow();
@@ -24,6 +24,7 @@
 #include "vfs/uri.h"
 
 constexpr char kRunnerName[] = "file_handler_runner";
+constexpr size_t kChunkSize = 64 * 1024;
 
 namespace hippy {
 inline namespace vfs {
@@ -38,7 +39,13 @@ void FileHandler::RequestUntrustedContent(std::shared_ptr<RequestJob> request,
     response->SetRetCode(hippy::JobResponse::RetCode::PathError);
     return;
   }
-  bool ret = HippyFile::ReadFile(path, response->GetContent(), false);
+  bool ret;
+  auto& data_cb = request->GetDataCallback();
+  if (data_cb) {
+    ret = HippyFile::ReadFileInChunks(path, response->GetContent(), kChunkSize, data_cb);
+  } else {
+    ret = HippyFile::ReadFile(path, response->GetContent(), false);
+  }
   if (ret) {
     response->SetRetCode(UriHandler::RetCode::Success);
   } else {
@@ -61,6 +61,8 @@ bool CreateJavaRenderManager(uint32_t id, std::shared_ptr<JavaRef>&j_render_mana
 
 float GetDensity(std::shared_ptr<JavaRef>&j_render_manager);
 
+float GetFontScale(std::shared_ptr<JavaRef>&j_render_manager);
+
 void GetPropsRegisterForRender(const std::shared_ptr<JavaRef>& j_render_manager,
                                std::unordered_set<std::string>& style_set);
 
@@ -24,14 +24,17 @@
 
 #include <atomic>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "dom/dom_node.h"
 #include "dom/render_manager.h"
+#include "dom/text_measure_cache.h"
 #include "footstone/persistent_object_map.h"
 #include "footstone/serializer.h"
 #include "footstone/macros.h"
 #include "jni/scoped_java_ref.h"
+#include "renderer/render_batch_staging.h"
 
 namespace hippy {
 inline namespace render {
@@ -95,6 +98,16 @@ class NativeRenderManager : public RenderManager, public std::enable_shared_from
   void ReceivedEvent(std::weak_ptr<RootNode> root_node, uint32_t dom_id, const std::string& event_name,
                      const std::shared_ptr<HippyValue>& params, bool capture, bool bubble);
 
+  /**
+   * @brief 释放 root 对应的批次暂存内存，root 销毁时调用
+   */
+  void ReleaseBatchStaging(uint32_t root_id);
+
+  /**
+   * @brief root 通过 JNI 传递的批次数据统计，root 不存在时返回 false
+   */
+  bool GetBatchStagingStats(uint32_t root_id, RenderBatchStaging::Stats& stats);
+
   void SetDomManager(std::weak_ptr<DomManager> dom_manager) { dom_manager_ = dom_manager; }
   std::shared_ptr<DomManager> GetDomManager() const { return dom_manager_.lock(); }
 
@@ -114,7 +127,11 @@ class NativeRenderManager : public RenderManager, public std::enable_shared_from
 
   inline float PxToDp(float px) const;
 
-  void CallNativeMethod(const std::string& method, uint32_t root_id, const std::pair<uint8_t*, size_t>& buffer);
+  std::shared_ptr<RenderBatchStaging> GetBatchStaging(const std::shared_ptr<RootNode>& root);
+
+  void CallNativeMethod(const std::string& method, uint32_t root_id, RenderBatchStaging& staging);
+
+  void CallNativeMethod(const std::string& method, uint32_t root_id, jobject j_buffer, size_t length);
 
   void CallNativeMethod(const std::string& method, uint32_t root_id);
 
@@ -140,7 +157,11 @@ class NativeRenderManager : public RenderManager, public std::enable_shared_from
   std::shared_ptr<JavaRef> j_render_manager_;
   std::shared_ptr<JavaRef> j_render_delegate_;
   std::shared_ptr<footstone::value::Serializer> serializer_;
+  std::unordered_map<uint32_t, std::shared_ptr<RenderBatchStaging>> batch_stagings_;
   std::map<uint32_t, std::vector<ListenerOp>> event_listener_ops_;
+  std::shared_ptr<TextMeasureCache> text_measure_cache_;
+  // text_measure_cache_ 中结果对应的字体缩放
+  float font_scale_ = 1.0f;
 
   std::weak_ptr<DomManager> dom_manager_;
   static std::atomic<uint32_t> unique_native_render_manager_id_;
@@ -0,0 +1,99 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <jni.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "dom/render_op_codec.h"
+#include "dom/root_node.h"
+
+namespace hippy {
+inline namespace render {
+inline namespace native {
+
+/**
+ * Per root staging memory of the render batches handed to Java. Batches are encoded into native memory that is
+ * kept across batches and exposed to Java as a direct ByteBuffer, so a batch is written once and crosses JNI
+ * without allocating and filling a byte[] on every call. The ByteBuffer is only recreated when the native memory
+ * is reallocated. Java decodes the batch synchronously inside the call and must not keep the ByteBuffer.
+ *
+ * Not thread-safe, the render manager uses it on the DOM thread only.
+ */
+class RenderBatchStaging {
+ public:
+  // 一帧结束后超过该容量的内存会被释放，避免首屏的大批次长期占用内存
+  static constexpr size_t kMaxRetainedCapacity = 256 * 1024;
+
+  struct Stats {
+    uint64_t batch_count = 0;
+    uint64_t total_bytes = 0;
+    uint64_t frame_bytes = 0;       // 当前帧（上一次 EndFrame 之后）传递的字节数
+    uint64_t last_frame_bytes = 0;  // 上一帧传递的字节数
+    uint32_t buffer_create_count = 0;
+    size_t capacity = 0;
+  };
+
+  explicit RenderBatchStaging(std::weak_ptr<RootNode> root_node) : root_node_(std::move(root_node)) {}
+  ~RenderBatchStaging();
+  RenderBatchStaging(const RenderBatchStaging&) = delete;
+  RenderBatchStaging& operator=(const RenderBatchStaging&) = delete;
+
+  inline RenderOpEncoder& GetEncoder() { return encoder_; }
+  inline bool IsRootAlive() const { return !root_node_.expired(); }
+  inline const Stats& GetStats() const { return stats_; }
+
+  /**
+   * @brief 暴露 encoder 当前批次的内存，返回的 ByteBuffer 为全局引用，由本对象管理
+   */
+  jobject StageEncoded(JNIEnv* j_env, size_t& length);
+
+  /**
+   * @brief 直接暴露一段外部内存，返回局部引用，调用方需在内存释放前用完并删除
+   */
+  jobject StageExternal(JNIEnv* j_env, const uint8_t* data, size_t length);
+
+  /**
+   * @brief 一帧（EndBatch）结束，统计并按需释放内存
+   */
+  void EndFrame(JNIEnv* j_env);
+
+  void Release(JNIEnv* j_env);
+
+ private:
+  void ReleaseBuffer(JNIEnv* j_env);
+
+  std::weak_ptr<RootNode> root_node_;
+  RenderOpEncoder encoder_;
+  // 当前 j_buffer_ 包装的 encoder 内存
+  const uint8_t* buffer_data_ = nullptr;
+  size_t buffer_capacity_ = 0;
+  jobject j_buffer_ = nullptr;
+  Stats stats_;
+};
+
+}  // namespace native
+}  // namespace render
+}  // namespace hippy
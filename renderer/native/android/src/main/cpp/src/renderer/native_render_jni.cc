@@ -54,6 +54,7 @@ static jclass j_render_manager_clazz;
 static jmethodID j_render_manager_init_method_id;
 static jmethodID j_render_manager_set_id_method_id;
 static jmethodID j_render_manager_get_density_method_id;
+static jmethodID j_render_manager_get_font_scale_method_id;
 static jmethodID j_render_manager_get_provider_method_id;
 static jmethodID j_render_manager_get_style_for_render_id;
 
@@ -85,6 +86,7 @@ static jint JNI_OnLoad(__unused JavaVM* j_vm, __unused void* reserved) {
   j_render_manager_init_method_id = j_env->GetMethodID(j_render_manager_clazz, "<init>", "()V");
   j_render_manager_set_id_method_id = j_env->GetMethodID(j_render_manager_clazz, "setId", "(I)V");
   j_render_manager_get_density_method_id = j_env->GetMethodID(j_render_manager_clazz, "getDensity", "()F");
+  j_render_manager_get_font_scale_method_id = j_env->GetMethodID(j_render_manager_clazz, "getFontScale", "()F");
   j_render_manager_get_provider_method_id = j_env->GetMethodID(j_render_manager_clazz,
                                                                "getRenderProvider",
                                                                "()Lcom/tencent/renderer/NativeRenderProvider;");
@@ -127,6 +129,14 @@ float GetDensity(std::shared_ptr<JavaRef>&j_render_manager) {
   return static_cast<float>(j_float);
 }
 
+float GetFontScale(std::shared_ptr<JavaRef>&j_render_manager) {
+  auto instance = JNIEnvironment::GetInstance();
+  auto j_env = instance->AttachCurrentThread();
+  auto j_float = j_env->CallFloatMethod(j_render_manager->GetObj(), j_render_manager_get_font_scale_method_id);
+  instance->ClearJEnvException(j_env);
+  return static_cast<float>(j_float);
+}
+
 void GetPropsRegisterForRender(const std::shared_ptr<JavaRef>& j_render_manager,
                                std::unordered_set<std::string>& style_set) {
   auto instance = JNIEnvironment::GetInstance();
@@ -34,15 +34,7 @@
 #include "renderer/native_render_jni.h"
 
 constexpr char kId[] = "id";
-constexpr char kPid[] = "pId";
-constexpr char kIndex[] = "index";
-constexpr char kName[] = "name";
-constexpr char kWidth[] = "width";
-constexpr char kHeight[] = "height";
-constexpr char kLeft[] = "left";
-constexpr char kTop[] = "top";
 constexpr char kProps[] = "props";
-constexpr char kDeleteProps[] = "deleteProps";
 constexpr char kFontStyle[] = "fontStyle";
 constexpr char kLetterSpacing[] = "letterSpacing";
 constexpr char kColor[] = "kColor";
@@ -63,7 +55,7 @@ constexpr char kNumberOfLines[] = "numberOfLines";
   do {                                                \
     FOOTSTONE_DCHECK(NODE != nullptr);                \
     if (STYLES->find(FIND_STYLE) != STYLES->end()) {  \
-      NODE->MarkDirty();                              \
+      NODE->MarkLayoutNodeDirty();                    \
       return;                                         \
     }                                                 \
   } while (0)
@@ -85,7 +77,8 @@ StyleFilter::StyleFilter(const std::shared_ptr<JavaRef>& j_render_manager) {
 }
 
 NativeRenderManager::NativeRenderManager() : RenderManager("NativeRenderManager"),
-      serializer_(std::make_shared<footstone::value::Serializer>()) {
+      serializer_(std::make_shared<footstone::value::Serializer>()),
+      text_measure_cache_(std::make_shared<TextMeasureCache>()) {
   id_ = unique_native_render_manager_id_.fetch_add(1);
 }
 
@@ -96,6 +89,10 @@ void NativeRenderManager::CreateRenderDelegate() {
 }
 
 void NativeRenderManager::DestroyRenderDelegate(JNIEnv* j_env) {
+  for (auto& [root_id, staging] : batch_stagings_) {
+    staging->Release(j_env);
+  }
+  batch_stagings_.clear();
   jobject j_object = j_render_manager_->GetObj();
   jclass j_class = j_env->GetObjectClass(j_object);
   if (!j_class) {
@@ -124,20 +121,15 @@ void NativeRenderManager::CreateRenderNode(std::weak_ptr<RootNode> root_node,
   }
   uint32_t root_id = root->GetId();
 
-  footstone::value::SerializerHelper::DestroyBuffer(serializer_->Release());
-  serializer_->WriteHeader();
-
+  auto style_filter = NativeRenderManager::GetStyleFilter(j_render_manager_);
+  RenderOpEncoder::StyleFilter filter = [&style_filter](const std::string& name) {
+    return style_filter->Enable(name);
+  };
+  auto staging = GetBatchStaging(root);
+  auto& encoder = staging->GetEncoder();
+  encoder.Begin(RenderOpType::kCreate);
   auto len = nodes.size();
-  footstone::value::HippyValue::HippyValueArrayType dom_node_array;
-  dom_node_array.resize(len);
   for (uint32_t i = 0; i < len; i++) {
-    const auto& render_info = nodes[i]->GetRenderInfo();
-    footstone::value::HippyValue::HippyValueObjectType dom_node;
-    dom_node[kId] = footstone::value::HippyValue(render_info.id);
-    dom_node[kPid] = footstone::value::HippyValue(render_info.pid);
-    dom_node[kIndex] = footstone::value::HippyValue(render_info.index);
-    dom_node[kName] = footstone::value::HippyValue(nodes[i]->GetViewName());
-
     if (IsMeasureNode(nodes[i]->GetViewName())) {
       int32_t id =  footstone::check::checked_numeric_cast<uint32_t, int32_t>(nodes[i]->GetId());
       MeasureFunction measure_function = [WEAK_THIS, root_id, id](float width, LayoutMeasureMode width_measure_mode,
@@ -155,35 +147,16 @@ void NativeRenderManager::CreateRenderNode(std::weak_ptr<RootNode> root_node,
         layout_result.height = self->PxToDp(static_cast<float>((int32_t)(0xFFFFFFFF & result)));
         return layout_result;
       };
-      nodes[i]->GetLayoutNode()->SetMeasureFunction(measure_function);
-    }
-
-    footstone::value::HippyValue::HippyValueObjectType props;
-    // 样式属性
-    auto style = nodes[i]->GetStyleMap();
-    auto iter = style->begin();
-    auto style_filter = NativeRenderManager::GetStyleFilter(j_render_manager_);
-    while (iter != style->end()) {
-      if (style_filter->Enable(iter->first)) {
-        props[iter->first] = *(iter->second);
+      // TextInput 的内容在 Java 侧编辑，不能按 DOM 内容缓存
+      if (nodes[i]->GetViewName() == "Text") {
+        measure_function = text_measure_cache_->Wrap(nodes[i], std::move(measure_function));
       }
-      iter++;
-    }
-    // 用户自定义属性
-    auto dom_ext = *nodes[i]->GetExtStyle();
-    iter = dom_ext.begin();
-    while (iter != dom_ext.end()) {
-      props[iter->first] = *(iter->second);
-      iter++;
+      nodes[i]->GetLayoutNode()->SetMeasureFunction(measure_function);
     }
-
-    dom_node[kProps] = props;
-    dom_node_array[i] = dom_node;
+    // 样式属性经过滤，用户自定义属性全部传递
+    encoder.AddCreate(nodes[i], filter);
   }
-  serializer_->WriteValue(HippyValue(dom_node_array));
-  std::pair<uint8_t*, size_t> buffer_pair = serializer_->Release();
-  CallNativeMethod("createNode", root->GetId(), buffer_pair);
-  footstone::value::SerializerHelper::DestroyBuffer(buffer_pair);
+  CallNativeMethod("createNode", root_id, *staging);
 }
 
 void NativeRenderManager::UpdateRenderNode(std::weak_ptr<RootNode> root_node,
@@ -201,49 +174,13 @@ void NativeRenderManager::UpdateRenderNode(std::weak_ptr<RootNode> root_node,
     }
   }
 
-  footstone::value::SerializerHelper::DestroyBuffer(serializer_->Release());
-  serializer_->WriteHeader();
-
-  auto len = nodes.size();
-  footstone::value::HippyValue::HippyValueArrayType dom_node_array;
-  dom_node_array.resize(len);
-  for (uint32_t i = 0; i < len; i++) {
-    const auto& render_info = nodes[i]->GetRenderInfo();
-    footstone::value::HippyValue::HippyValueObjectType dom_node;
-    dom_node[kId] = footstone::value::HippyValue(render_info.id);
-    dom_node[kPid] = footstone::value::HippyValue(render_info.pid);
-    dom_node[kIndex] = footstone::value::HippyValue(render_info.index);
-    dom_node[kName] = footstone::value::HippyValue(nodes[i]->GetViewName());
-
-    footstone::value::HippyValue::HippyValueObjectType diff_props;
-    footstone::value::HippyValue::HippyValueArrayType del_props;
-    auto diff = nodes[i]->GetDiffStyle();
-    if (diff) {
-      auto iter = diff->begin();
-      while (iter != diff->end()) {
-        FOOTSTONE_DCHECK(iter->second != nullptr);
-        if (iter->second) {
-          diff_props[iter->first] = *(iter->second);
-        }
-        iter++;
-      }
-    }
-    auto del = nodes[i]->GetDeleteProps();
-    if (del) {
-      auto iter = del->begin();
-      while (iter != del->end()) {
-        del_props.emplace_back(footstone::value::HippyValue(*iter));
-        iter++;
-      }
-    }
-    dom_node[kProps] = diff_props;
-    dom_node[kDeleteProps] = del_props;
-    dom_node_array[i] = dom_node;
+  auto staging = GetBatchStaging(root);
+  auto& encoder = staging->GetEncoder();
+  encoder.Begin(RenderOpType::kUpdate);
+  for (const auto& node : nodes) {
+    encoder.AddUpdate(node);
   }
-  serializer_->WriteValue(HippyValue(dom_node_array));
-  std::pair<uint8_t*, size_t> buffer_pair = serializer_->Release();
-  CallNativeMethod("updateNode", root->GetId(), buffer_pair);
-  footstone::value::SerializerHelper::DestroyBuffer(buffer_pair);
+  CallNativeMethod("updateNode", root->GetId(), *staging);
 }
 
 void NativeRenderManager::MoveRenderNode(std::weak_ptr<RootNode> root_node,
@@ -253,47 +190,13 @@ void NativeRenderManager::MoveRenderNode(std::weak_ptr<RootNode> root_node,
     return;
   }
 
-  footstone::value::SerializerHelper::DestroyBuffer(serializer_->Release());
-  serializer_->WriteHeader();
-
-  auto len = nodes.size();
-  footstone::value::HippyValue::HippyValueArrayType dom_node_array;
-  dom_node_array.resize(len);
-  for (uint32_t i = 0; i < len; i++) {
-    const auto& render_info = nodes[i]->GetRenderInfo();
-    footstone::value::HippyValue::HippyValueObjectType dom_node;
-    dom_node[kId] = footstone::value::HippyValue(render_info.id);
-    dom_node[kPid] = footstone::value::HippyValue(render_info.pid);
-    dom_node[kIndex] = footstone::value::HippyValue(render_info.index);
-    dom_node_array[i] = dom_node;
-  }
-  serializer_->WriteValue(HippyValue(dom_node_array));
-  std::pair<uint8_t*, size_t> buffer_pair = serializer_->Release();
-
-  std::shared_ptr<JNIEnvironment> instance = JNIEnvironment::GetInstance();
-  JNIEnv* j_env = instance->AttachCurrentThread();
-
-  jobject j_buffer;
-  auto j_size = footstone::check::checked_numeric_cast<size_t, jint>(buffer_pair.second);
-  j_buffer = j_env->NewByteArray(j_size);
-  j_env->SetByteArrayRegion(reinterpret_cast<jbyteArray>(j_buffer), 0, j_size,
-                            reinterpret_cast<const jbyte*>(buffer_pair.first));
-  jobject j_object = j_render_delegate_->GetObj();
-  jclass j_class = j_env->GetObjectClass(j_object);
-  if (!j_class) {
-    FOOTSTONE_LOG(ERROR) << "CallNativeMethod j_class error";
-    return;
-  }
-  jmethodID j_method_id = j_env->GetMethodID(j_class, "moveNode", "(I[B)V");
-  if (!j_method_id) {
-    FOOTSTONE_LOG(ERROR) << "moveNode" << " j_method_id error";
-    return;
+  auto staging = GetBatchStaging(root);
+  auto& encoder = staging->GetEncoder();
+  encoder.Begin(RenderOpType::kMove);
+  for (const auto& node : nodes) {
+    encoder.AddMove(node);
   }
-  j_env->CallVoidMethod(j_object, j_method_id, root->GetId(), j_buffer);
-  JNIEnvironment::ClearJEnvException(j_env);
-  j_env->DeleteLocalRef(j_buffer);
-  j_env->DeleteLocalRef(j_class);
-  footstone::value::SerializerHelper::DestroyBuffer(buffer_pair);
+  CallNativeMethod("moveNode", root->GetId(), *staging);
 }
 
 void NativeRenderManager::DeleteRenderNode(std::weak_ptr<RootNode> root_node,
@@ -342,32 +245,14 @@ void NativeRenderManager::UpdateLayout(std::weak_ptr<RootNode> root_node,
     return;
   }
 
-  footstone::value::SerializerHelper::DestroyBuffer(serializer_->Release());
-  serializer_->WriteHeader();
-
-  auto len = nodes.size();
-  footstone::value::HippyValue::HippyValueArrayType dom_node_array;
-  dom_node_array.resize(len);
-  for (uint32_t i = 0; i < len; i++) {
-    footstone::value::HippyValue::HippyValueObjectType dom_node;
-    dom_node[kId] = footstone::value::HippyValue(nodes[i]->GetId());
-    const auto& result = nodes[i]->GetRenderLayoutResult();
-    dom_node[kWidth] = footstone::value::HippyValue(DpToPx(result.width));
-    dom_node[kHeight] = footstone::value::HippyValue(DpToPx(result.height));
-    dom_node[kLeft] = footstone::value::HippyValue(DpToPx(result.left));
-    dom_node[kTop] = footstone::value::HippyValue(DpToPx(result.top));
-    if (IsMeasureNode(nodes[i]->GetViewName())) {
-      dom_node["paddingLeft"] = footstone::value::HippyValue(DpToPx(result.paddingLeft));
-      dom_node["paddingTop"] = footstone::value::HippyValue(DpToPx(result.paddingTop));
-      dom_node["paddingRight"] = footstone::value::HippyValue(DpToPx(result.paddingRight));
-      dom_node["paddingBottom"] = footstone::value::HippyValue(DpToPx(result.paddingBottom));
-    }
-    dom_node_array[i] = dom_node;
+  auto staging = GetBatchStaging(root);
+  auto& encoder = staging->GetEncoder();
+  encoder.Begin(RenderOpType::kLayout);
+  for (const auto& node : nodes) {
+    // 文本节点的 padding 在 Java 侧排版时需要
+    encoder.AddLayout(node->GetId(), node->GetRenderLayoutResult(), IsMeasureNode(node->GetViewName()), density_);
   }
-  serializer_->WriteValue(HippyValue(dom_node_array));
-  std::pair<uint8_t*, size_t> buffer_pair = serializer_->Release();
-  CallNativeMethod("updateLayout", root->GetId(), buffer_pair);
-  footstone::value::SerializerHelper::DestroyBuffer(buffer_pair);
+  CallNativeMethod("updateLayout", root->GetId(), *staging);
 }
 
 void NativeRenderManager::MoveRenderNode(std::weak_ptr<RootNode> root_node,
@@ -412,9 +297,35 @@ void NativeRenderManager::EndBatch(std::weak_ptr<RootNode> root_node) {
   if (root) {
     CallNativeMethod("endBatch", root->GetId());
   }
+
+  // 一帧结束，统计本帧传递的字节数，并回收已销毁 root 的暂存内存
+  std::shared_ptr<JNIEnvironment> instance = JNIEnvironment::GetInstance();
+  JNIEnv* j_env = instance->AttachCurrentThread();
+  for (auto it = batch_stagings_.begin(); it != batch_stagings_.end();) {
+    if (!it->second->IsRootAlive()) {
+      it->second->Release(j_env);
+      it = batch_stagings_.erase(it);
+      continue;
+    }
+    if (root && it->first == root->GetId()) {
+      it->second->EndFrame(j_env);
+      const auto& stats = it->second->GetStats();
+      FOOTSTONE_DLOG(INFO) << "EndBatch root " << it->first << ", frame bytes " << stats.last_frame_bytes
+                           << ", total bytes " << stats.total_bytes << ", capacity " << stats.capacity;
+    }
+    ++it;
+  }
 }
 
-void NativeRenderManager::BeforeLayout(std::weak_ptr<RootNode> root_node){}
+void NativeRenderManager::BeforeLayout(std::weak_ptr<RootNode> root_node) {
+  // 字体缩放由宿主的 FontAdapter 决定, 变化时 DOM 不变, 缓存的文本测量结果需全部丢弃.
+  // 字体 (Typeface) 加载后在 Java 侧常驻缓存, 不会在运行时变化
+  auto font_scale = hippy::GetFontScale(j_render_manager_);
+  if (font_scale != font_scale_) {
+    font_scale_ = font_scale;
+    text_measure_cache_->Clear();
+  }
+}
 
 void NativeRenderManager::AfterLayout(std::weak_ptr<RootNode> root_node) {
   // 更新布局信息前处理事件监听
@@ -518,16 +429,53 @@ float NativeRenderManager::DpToPx(float dp) const { return dp * density_; }
 
 float NativeRenderManager::PxToDp(float px) const { return px / density_; }
 
-void NativeRenderManager::CallNativeMethod(const std::string& method, uint32_t root_id, const std::pair<uint8_t*, size_t>& buffer) {
+std::shared_ptr<RenderBatchStaging> NativeRenderManager::GetBatchStaging(const std::shared_ptr<RootNode>& root) {
+  auto& staging = batch_stagings_[root->GetId()];
+  if (!staging) {
+    staging = std::make_shared<RenderBatchStaging>(root);
+  }
+  return staging;
+}
+
+void NativeRenderManager::ReleaseBatchStaging(uint32_t root_id) {
+  auto it = batch_stagings_.find(root_id);
+  if (it == batch_stagings_.end()) {
+    return;
+  }
   std::shared_ptr<JNIEnvironment> instance = JNIEnvironment::GetInstance();
   JNIEnv* j_env = instance->AttachCurrentThread();
+  it->second->Release(j_env);
+  batch_stagings_.erase(it);
+}
 
-  jobject j_buffer;
-  auto j_size = footstone::check::checked_numeric_cast<size_t, jint>(buffer.second);
-  j_buffer = j_env->NewByteArray(j_size);
-  j_env->SetByteArrayRegion(reinterpret_cast<jbyteArray>(j_buffer), 0, j_size,
-                            reinterpret_cast<const jbyte*>(buffer.first));
+bool NativeRenderManager::GetBatchStagingStats(uint32_t root_id, RenderBatchStaging::Stats& stats) {
+  auto it = batch_stagings_.find(root_id);
+  if (it == batch_stagings_.end()) {
+    return false;
+  }
+  stats = it->second->GetStats();
+  return true;
+}
+
+void NativeRenderManager::CallNativeMethod(const std::string& method, uint32_t root_id, RenderBatchStaging& staging) {
+  std::shared_ptr<JNIEnvironment> instance = JNIEnvironment::GetInstance();
+  JNIEnv* j_env = instance->AttachCurrentThread();
 
+  size_t length = 0;
+  jobject j_buffer = staging.StageEncoded(j_env, length);
+  if (!j_buffer) {
+    return;
+  }
+  // j_buffer 由 staging 持有全局引用，这里不需要删除
+  CallNativeMethod(method, root_id, j_buffer, length);
+}
+
+void NativeRenderManager::CallNativeMethod(const std::string& method, uint32_t root_id, jobject j_buffer,
+                                           size_t length) {
+  std::shared_ptr<JNIEnvironment> instance = JNIEnvironment::GetInstance();
+  JNIEnv* j_env = instance->AttachCurrentThread();
+
+  auto j_length = footstone::check::checked_numeric_cast<size_t, jint>(length);
   jobject j_object = j_render_delegate_->GetObj();
   jclass j_class = j_env->GetObjectClass(j_object);
   if (!j_class) {
@@ -535,15 +483,14 @@ void NativeRenderManager::CallNativeMethod(const std::string& method, uint32_t r
     return;
   }
 
-  jmethodID j_method_id = j_env->GetMethodID(j_class, method.c_str(), "(I[B)V");
+  jmethodID j_method_id = j_env->GetMethodID(j_class, method.c_str(), "(ILjava/nio/ByteBuffer;I)V");
   if (!j_method_id) {
     FOOTSTONE_LOG(ERROR) << method << " j_method_id error";
     return;
   }
 
-  j_env->CallVoidMethod(j_object, j_method_id, root_id, j_buffer);
+  j_env->CallVoidMethod(j_object, j_method_id, root_id, j_buffer, j_length);
   JNIEnvironment::ClearJEnvException(j_env);
-  j_env->DeleteLocalRef(j_buffer);
   j_env->DeleteLocalRef(j_class);
 }
 
@@ -640,7 +587,14 @@ void NativeRenderManager::HandleListenerOps(std::weak_ptr<RootNode> root_node,
   serializer_->WriteHeader();
   serializer_->WriteValue(HippyValue(event_listener_ops));
   std::pair<uint8_t*, size_t> buffer_pair = serializer_->Release();
-  CallNativeMethod(method_name, root->GetId(), buffer_pair);
+  // 序列化结果直接以 direct ByteBuffer 传给 Java，调用返回后再释放
+  std::shared_ptr<JNIEnvironment> instance = JNIEnvironment::GetInstance();
+  JNIEnv* j_env = instance->AttachCurrentThread();
+  jobject j_buffer = GetBatchStaging(root)->StageExternal(j_env, buffer_pair.first, buffer_pair.second);
+  if (j_buffer) {
+    CallNativeMethod(method_name, root->GetId(), j_buffer, buffer_pair.second);
+    j_env->DeleteLocalRef(j_buffer);
+  }
   footstone::value::SerializerHelper::DestroyBuffer(buffer_pair);
 }
 
@@ -653,21 +607,21 @@ void NativeRenderManager::MarkTextDirty(std::weak_ptr<RootNode> weak_root_node,
     if (node) {
       auto diff_style = node->GetDiffStyle();
       if (diff_style) {
-        MARK_DIRTY_PROPERTY(diff_style, kFontStyle, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kLetterSpacing, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kColor, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kFontSize, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kFontFamily, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kFontWeight, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kTextDecorationLine, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kTextShadowOffset, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kTextShadowRadius, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kTextShadowColor, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kLineHeight, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kTextAlign, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kText, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kEnableScale, node->GetLayoutNode());
-        MARK_DIRTY_PROPERTY(diff_style, kNumberOfLines, node->GetLayoutNode());
+        MARK_DIRTY_PROPERTY(diff_style, kFontStyle, node);
+        MARK_DIRTY_PROPERTY(diff_style, kLetterSpacing, node);
+        MARK_DIRTY_PROPERTY(diff_style, kColor, node);
+        MARK_DIRTY_PROPERTY(diff_style, kFontSize, node);
+        MARK_DIRTY_PROPERTY(diff_style, kFontFamily, node);
+        MARK_DIRTY_PROPERTY(diff_style, kFontWeight, node);
+        MARK_DIRTY_PROPERTY(diff_style, kTextDecorationLine, node);
+        MARK_DIRTY_PROPERTY(diff_style, kTextShadowOffset, node);
+        MARK_DIRTY_PROPERTY(diff_style, kTextShadowRadius, node);
+        MARK_DIRTY_PROPERTY(diff_style, kTextShadowColor, node);
+        MARK_DIRTY_PROPERTY(diff_style, kLineHeight, node);
+        MARK_DIRTY_PROPERTY(diff_style, kTextAlign, node);
+        MARK_DIRTY_PROPERTY(diff_style, kText, node);
+        MARK_DIRTY_PROPERTY(diff_style, kEnableScale, node);
+        MARK_DIRTY_PROPERTY(diff_style, kNumberOfLines, node);
       }
     }
   }
@@ -0,0 +1,103 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "renderer/render_batch_staging.h"
+
+#include "footstone/logging.h"
+#include "jni/jni_env.h"
+
+namespace hippy {
+inline namespace render {
+inline namespace native {
+
+RenderBatchStaging::~RenderBatchStaging() {
+  // 全局引用必须通过 Release 释放，这里只做检查
+  FOOTSTONE_DCHECK(j_buffer_ == nullptr);
+}
+
+jobject RenderBatchStaging::StageEncoded(JNIEnv* j_env, size_t& length) {
+  auto [data, size] = encoder_.Finish();
+  length = size;
+  stats_.batch_count++;
+  stats_.total_bytes += size;
+  stats_.frame_bytes += size;
+  auto capacity = encoder_.GetCapacity();
+  // encoder 内存没有重新分配时复用上一次包装的 ByteBuffer
+  if (j_buffer_ && buffer_data_ == data && buffer_capacity_ == capacity) {
+    return j_buffer_;
+  }
+  ReleaseBuffer(j_env);
+  jobject j_local = j_env->NewDirectByteBuffer(const_cast<uint8_t*>(data), static_cast<jlong>(capacity));
+  if (!j_local) {
+    JNIEnvironment::ClearJEnvException(j_env);
+    FOOTSTONE_LOG(ERROR) << "RenderBatchStaging NewDirectByteBuffer error, capacity = " << capacity;
+    return nullptr;
+  }
+  j_buffer_ = j_env->NewGlobalRef(j_local);
+  j_env->DeleteLocalRef(j_local);
+  buffer_data_ = data;
+  buffer_capacity_ = capacity;
+  stats_.buffer_create_count++;
+  stats_.capacity = capacity;
+  return j_buffer_;
+}
+
+jobject RenderBatchStaging::StageExternal(JNIEnv* j_env, const uint8_t* data, size_t length) {
+  stats_.batch_count++;
+  stats_.total_bytes += length;
+  stats_.frame_bytes += length;
+  jobject j_local = j_env->NewDirectByteBuffer(const_cast<uint8_t*>(data), static_cast<jlong>(length));
+  if (!j_local) {
+    JNIEnvironment::ClearJEnvException(j_env);
+    FOOTSTONE_LOG(ERROR) << "RenderBatchStaging NewDirectByteBuffer error, length = " << length;
+  }
+  return j_local;
+}
+
+void RenderBatchStaging::EndFrame(JNIEnv* j_env) {
+  stats_.last_frame_bytes = stats_.frame_bytes;
+  stats_.frame_bytes = 0;
+  if (encoder_.GetCapacity() > kMaxRetainedCapacity) {
+    ReleaseBuffer(j_env);
+    encoder_.ReleaseMemory();
+    stats_.capacity = 0;
+  }
+}
+
+void RenderBatchStaging::Release(JNIEnv* j_env) {
+  ReleaseBuffer(j_env);
+  encoder_.ReleaseMemory();
+  stats_.capacity = 0;
+}
+
+void RenderBatchStaging::ReleaseBuffer(JNIEnv* j_env) {
+  if (j_buffer_) {
+    j_env->DeleteGlobalRef(j_buffer_);
+    j_buffer_ = nullptr;
+  }
+  buffer_data_ = nullptr;
+  buffer_capacity_ = 0;
+}
+
+}  // namespace native
+}  // namespace render
+}  // namespace hippy
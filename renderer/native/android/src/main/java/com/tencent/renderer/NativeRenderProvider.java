@@ -21,6 +21,7 @@ import androidx.annotation.NonNull;
 import androidx.annotation.Nullable;
 
 import com.tencent.mtt.hippy.serialization.nio.reader.BinaryReader;
+import com.tencent.mtt.hippy.serialization.nio.reader.SafeDirectReader;
 import com.tencent.mtt.hippy.serialization.nio.reader.SafeHeapReader;
 import com.tencent.mtt.hippy.serialization.nio.writer.SafeHeapWriter;
 import com.tencent.mtt.hippy.serialization.string.InternalizedStringTable;
@@ -28,10 +29,12 @@ import com.tencent.mtt.hippy.utils.PixelUtil;
 import com.tencent.mtt.hippy.utils.UIThreadUtils;
 import com.tencent.renderer.annotation.CalledByNative;
 import com.tencent.renderer.serialization.Deserializer;
+import com.tencent.renderer.serialization.RenderOpDecoder;
 import com.tencent.renderer.serialization.Serializer;
 
 import java.lang.ref.WeakReference;
 import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.ArrayList;
 import java.util.List;
 
@@ -48,10 +51,14 @@ public class NativeRenderProvider {
     @NonNull
     private final Serializer mSerializer;
     @NonNull
+    private final RenderOpDecoder mRenderOpDecoder;
+    @NonNull
     private final WeakReference<NativeRenderDelegate> mRenderDelegateRef;
     @Nullable
     private BinaryReader mSafeHeapReader;
     @Nullable
+    private BinaryReader mSafeDirectReader;
+    @Nullable
     private SafeHeapWriter mSafeHeapWriter;
     private int mInstanceId;
 
@@ -59,6 +66,7 @@ public class NativeRenderProvider {
         mRenderDelegateRef = new WeakReference<>(renderDelegate);
         mSerializer = new Serializer();
         mDeserializer = new Deserializer(null, new InternalizedStringTable());
+        mRenderOpDecoder = new RenderOpDecoder();
     }
 
     public void setInstanceId(int instanceId) {
@@ -78,20 +86,29 @@ public class NativeRenderProvider {
     }
 
     /**
-     * Deserialize dom node data wrapped by ByteBuffer, just support heap buffer reader, direct
-     * buffer reader not fit for dom data
+     * Deserialize dom node data wrapped by ByteBuffer, the direct buffer staged by native (C++)
+     * render manager is read directly from native memory
      *
-     * @param buffer the byte array from native (C++) DOM wrapped by {@link ByteBuffer}
+     * @param buffer the byte array from native (C++) DOM wrapped by {@link ByteBuffer}, or the
+     * direct buffer of native memory
      * @return the result {@link ArrayList} of deserialize
      */
     @SuppressWarnings({"rawtypes", "unchecked"})
     @NonNull
     List<Object> bytesToArgument(ByteBuffer buffer) {
         final BinaryReader binaryReader;
-        if (mSafeHeapReader == null) {
-            mSafeHeapReader = new SafeHeapReader();
+        if (buffer.isDirect()) {
+            if (mSafeDirectReader == null) {
+                mSafeDirectReader = new SafeDirectReader();
+            }
+            buffer.order(ByteOrder.LITTLE_ENDIAN);
+            binaryReader = mSafeDirectReader;
+        } else {
+            if (mSafeHeapReader == null) {
+                mSafeHeapReader = new SafeHeapReader();
+            }
+            binaryReader = mSafeHeapReader;
         }
-        binaryReader = mSafeHeapReader;
         binaryReader.reset(buffer);
         mDeserializer.setReader(binaryReader);
         mDeserializer.reset();
@@ -100,6 +117,17 @@ public class NativeRenderProvider {
         return (paramsObj instanceof ArrayList) ? (ArrayList) paramsObj : new ArrayList<>();
     }
 
+    /**
+     * The direct buffer wraps the whole staging memory reused by native (C++) render manager,
+     * limit it to the current batch, all contents are decoded before return
+     */
+    @NonNull
+    private ByteBuffer stagedBuffer(@NonNull ByteBuffer buffer, int length) {
+        buffer.clear();
+        buffer.limit(length);
+        return buffer;
+    }
+
     /**
      * Serialize UI event params object, and use {@link ByteBuffer} to wrap the result, just support
      * heap buffer writer, direct buffer writer not fit for event data
@@ -126,15 +154,17 @@ public class NativeRenderProvider {
      * Call from native (C++) render manager to create render node
      *
      * @param rootId the root node id
-     * @param buffer The byte array serialize by native (C++)
+     * @param buffer the direct buffer of native (C++) staging memory, only valid during the call
+     * @param length the length of the batch in buffer
      */
     @CalledByNative
     @SuppressWarnings("unused")
-    public void createNode(int rootId, byte[] buffer) {
+    public void createNode(int rootId, ByteBuffer buffer, int length) {
         NativeRenderDelegate renderDelegate = mRenderDelegateRef.get();
         if (renderDelegate != null) {
             try {
-                final List<Object> list = bytesToArgument(ByteBuffer.wrap(buffer));
+                final List<Object> list = mRenderOpDecoder.decode(stagedBuffer(buffer, length),
+                        RenderOpDecoder.OP_CREATE);
                 renderDelegate.createNode(rootId, list);
             } catch (NativeRenderException e) {
                 renderDelegate.handleRenderException(e);
@@ -146,15 +176,17 @@ public class NativeRenderProvider {
      * Call from native (C++) render manager to update render node
      *
      * @param rootId the root node id
-     * @param buffer the byte array serialize by native (C++)
+     * @param buffer the direct buffer of native (C++) staging memory, only valid during the call
+     * @param length the length of the batch in buffer
      */
     @CalledByNative
     @SuppressWarnings("unused")
-    public void updateNode(int rootId, byte[] buffer) {
+    public void updateNode(int rootId, ByteBuffer buffer, int length) {
         NativeRenderDelegate renderDelegate = mRenderDelegateRef.get();
         if (renderDelegate != null) {
             try {
-                final List<Object> list = bytesToArgument(ByteBuffer.wrap(buffer));
+                final List<Object> list = mRenderOpDecoder.decode(stagedBuffer(buffer, length),
+                        RenderOpDecoder.OP_UPDATE);
                 renderDelegate.updateNode(rootId, list);
             } catch (NativeRenderException e) {
                 renderDelegate.handleRenderException(e);
@@ -213,15 +245,17 @@ public class NativeRenderProvider {
      * Adjust the order of child nodes under the same parent node </>
      *
      * @param rootId the root node id
-     * @param buffer the byte array serialize by native (C++)
+     * @param buffer the direct buffer of native (C++) staging memory, only valid during the call
+     * @param length the length of the batch in buffer
      */
     @CalledByNative
     @SuppressWarnings("unused")
-    public void moveNode(int rootId, byte[] buffer) {
+    public void moveNode(int rootId, ByteBuffer buffer, int length) {
         NativeRenderDelegate renderDelegate = mRenderDelegateRef.get();
         if (renderDelegate != null) {
             try {
-                final List<Object> list = bytesToArgument(ByteBuffer.wrap(buffer));
+                final List<Object> list = mRenderOpDecoder.decode(stagedBuffer(buffer, length),
+                        RenderOpDecoder.OP_MOVE);
                 renderDelegate.moveNode(rootId, list);
             } catch (NativeRenderException e) {
                 renderDelegate.handleRenderException(e);
@@ -233,15 +267,17 @@ public class NativeRenderProvider {
      * Call from native (C++) render manager to update layout of render node
      *
      * @param rootId the root node id
-     * @param buffer the byte array serialize by native (C++)
+     * @param buffer the direct buffer of native (C++) staging memory, only valid during the call
+     * @param length the length of the batch in buffer
      */
     @CalledByNative
     @SuppressWarnings("unused")
-    public void updateLayout(int rootId, byte[] buffer) {
+    public void updateLayout(int rootId, ByteBuffer buffer, int length) {
         NativeRenderDelegate renderDelegate = mRenderDelegateRef.get();
         if (renderDelegate != null) {
             try {
-                final List<Object> list = bytesToArgument(ByteBuffer.wrap(buffer));
+                final List<Object> list = mRenderOpDecoder.decode(stagedBuffer(buffer, length),
+                        RenderOpDecoder.OP_LAYOUT);
                 renderDelegate.updateLayout(rootId, list);
             } catch (NativeRenderException e) {
                 renderDelegate.handleRenderException(e);
@@ -253,15 +289,16 @@ public class NativeRenderProvider {
      * Call from native (C++) render manager to add or remove event listener
      *
      * @param rootId the root node id
-     * @param buffer the byte array serialize by native (C++)
+     * @param buffer the direct buffer of native (C++) staging memory, only valid during the call
+     * @param length the length of the batch in buffer
      */
     @CalledByNative
     @SuppressWarnings("unused")
-    public void updateEventListener(int rootId, byte[] buffer) {
+    public void updateEventListener(int rootId, ByteBuffer buffer, int length) {
         NativeRenderDelegate renderDelegate = mRenderDelegateRef.get();
         if (renderDelegate != null) {
             try {
-                final List<Object> list = bytesToArgument(ByteBuffer.wrap(buffer));
+                final List<Object> list = bytesToArgument(stagedBuffer(buffer, length));
                 renderDelegate.updateEventListener(rootId, list);
             } catch (NativeRenderException e) {
                 renderDelegate.handleRenderException(e);
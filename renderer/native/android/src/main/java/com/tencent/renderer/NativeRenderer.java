@@ -155,6 +155,11 @@ public class NativeRenderer extends Renderer implements NativeRender, NativeRend
         return PixelUtil.getDensity();
     }
 
+    public float getFontScale() {
+        FontAdapter fontAdapter = getFontAdapter();
+        return (fontAdapter != null) ? fontAdapter.getFontScale() : 1.0f;
+    }
+
     public NativeRenderProvider getRenderProvider() {
         return mRenderProvider;
     }
@@ -0,0 +1,285 @@
+/* Tencent is pleased to support the open source community by making Hippy available.
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.tencent.renderer.serialization;
+
+import static com.tencent.renderer.NativeRenderException.ExceptionCode.DESERIALIZE_NOT_SUPPORTED_ERR;
+import static com.tencent.renderer.NativeRenderException.ExceptionCode.DESERIALIZE_READ_LENGTH_ERR;
+
+import androidx.annotation.NonNull;
+import androidx.annotation.Nullable;
+import com.tencent.renderer.NativeRenderException;
+import java.nio.BufferUnderflowException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * Decoder of the flat render op batches written by the native (C++) RenderOpEncoder, see
+ * dom/include/dom/render_op_codec.h for the wire format. The result has the same shape as the
+ * batches previously serialized with {@link Deserializer}: a list of node maps with id, pId,
+ * index, name, props and deleteProps, or id, left, top, width, height and paddings for layout.
+ */
+public class RenderOpDecoder {
+
+    public static final String TAG = "RenderOpDecoder";
+    public static final int OP_CREATE = 1;
+    public static final int OP_UPDATE = 2;
+    public static final int OP_MOVE = 3;
+    public static final int OP_LAYOUT = 4;
+    private static final int MAGIC = 0x504F5248;
+    private static final int VERSION = 1;
+    private static final int LAYOUT_WITH_PADDING = 1;
+    private static final int MAX_DEPTH = 64;
+    private static final byte TAG_UNDEFINED = 0;
+    private static final byte TAG_NULL = 1;
+    private static final byte TAG_FALSE = 2;
+    private static final byte TAG_TRUE = 3;
+    private static final byte TAG_INT32 = 4;
+    private static final byte TAG_UINT32 = 5;
+    private static final byte TAG_DOUBLE = 6;
+    private static final byte TAG_STRING = 7;
+    private static final byte TAG_ARRAY = 8;
+    private static final byte TAG_OBJECT = 9;
+    private static final String NODE_ID = "id";
+    private static final String NODE_PID = "pId";
+    private static final String NODE_INDEX = "index";
+    private static final String NODE_NAME = "name";
+    private static final String NODE_PROPS = "props";
+    private static final String NODE_DELETE_PROPS = "deleteProps";
+    private static final String LAYOUT_LEFT = "left";
+    private static final String LAYOUT_TOP = "top";
+    private static final String LAYOUT_WIDTH = "width";
+    private static final String LAYOUT_HEIGHT = "height";
+    private static final String PADDING_LEFT = "paddingLeft";
+    private static final String PADDING_TOP = "paddingTop";
+    private static final String PADDING_RIGHT = "paddingRight";
+    private static final String PADDING_BOTTOM = "paddingBottom";
+    private final ArrayList<String> mKeys = new ArrayList<>();
+    @Nullable
+    private ByteBuffer mBuffer;
+
+    /**
+     * Decode a render op batch
+     *
+     * @param buffer the batch from native (C++) render manager
+     * @param expectedOp the op type the batch should contain
+     * @return the list of node map
+     * @throws NativeRenderException if the batch is malformed or the op type mismatch
+     */
+    @NonNull
+    public List<Object> decode(@NonNull ByteBuffer buffer, int expectedOp)
+            throws NativeRenderException {
+        mBuffer = buffer.order(ByteOrder.LITTLE_ENDIAN);
+        mKeys.clear();
+        try {
+            return decodeBatch(expectedOp);
+        } catch (BufferUnderflowException | IndexOutOfBoundsException e) {
+            throw new NativeRenderException(DESERIALIZE_READ_LENGTH_ERR, e);
+        } finally {
+            mBuffer = null;
+        }
+    }
+
+    @NonNull
+    private List<Object> decodeBatch(int expectedOp) {
+        assert mBuffer != null;
+        final int magic = mBuffer.getInt();
+        final int version = mBuffer.get();
+        final int op = mBuffer.get();
+        mBuffer.getShort();
+        final int nodeCount = mBuffer.getInt();
+        final int keyCount = mBuffer.getInt();
+        if (magic != MAGIC || version != VERSION || op != expectedOp || nodeCount < 0) {
+            throw new NativeRenderException(DESERIALIZE_NOT_SUPPORTED_ERR,
+                    TAG + ": decode: unexpected header, version " + version + ", op " + op);
+        }
+        mKeys.ensureCapacity(keyCount);
+        final List<Object> nodeList = new ArrayList<>(nodeCount);
+        for (int i = 0; i < nodeCount; i++) {
+            nodeList.add((op == OP_LAYOUT) ? readLayout() : readNode(op));
+        }
+        if (mKeys.size() != keyCount) {
+            throw new NativeRenderException(DESERIALIZE_READ_LENGTH_ERR,
+                    TAG + ": decode: unexpected number of keys");
+        }
+        return nodeList;
+    }
+
+    @NonNull
+    private Map<String, Object> readLayout() {
+        assert mBuffer != null;
+        final Map<String, Object> layout = new HashMap<>();
+        layout.put(NODE_ID, mBuffer.getInt());
+        final int flags = mBuffer.get();
+        layout.put(LAYOUT_LEFT, mBuffer.getFloat());
+        layout.put(LAYOUT_TOP, mBuffer.getFloat());
+        layout.put(LAYOUT_WIDTH, mBuffer.getFloat());
+        layout.put(LAYOUT_HEIGHT, mBuffer.getFloat());
+        if ((flags & LAYOUT_WITH_PADDING) != 0) {
+            layout.put(PADDING_LEFT, mBuffer.getFloat());
+            layout.put(PADDING_TOP, mBuffer.getFloat());
+            layout.put(PADDING_RIGHT, mBuffer.getFloat());
+            layout.put(PADDING_BOTTOM, mBuffer.getFloat());
+        }
+        return layout;
+    }
+
+    @NonNull
+    private Map<String, Object> readNode(int op) {
+        assert mBuffer != null;
+        final Map<String, Object> node = new HashMap<>();
+        node.put(NODE_ID, mBuffer.getInt());
+        node.put(NODE_PID, mBuffer.getInt());
+        node.put(NODE_INDEX, mBuffer.getInt());
+        if (op == OP_MOVE) {
+            return node;
+        }
+        node.put(NODE_NAME, readKey());
+        final int propCount = mBuffer.getInt();
+        if (propCount < 0) {
+            throw new NativeRenderException(DESERIALIZE_READ_LENGTH_ERR,
+                    TAG + ": readNode: invalid number of props");
+        }
+        final Map<String, Object> props = new HashMap<>();
+        for (int i = 0; i < propCount; i++) {
+            final String key = readKey();
+            props.put(key, readValue(0));
+        }
+        node.put(NODE_PROPS, props);
+        if (op == OP_UPDATE) {
+            final int deleteCount = readLength();
+            final List<Object> deleteProps = new ArrayList<>(deleteCount);
+            for (int i = 0; i < deleteCount; i++) {
+                deleteProps.add(readKey());
+            }
+            node.put(NODE_DELETE_PROPS, deleteProps);
+        }
+        return node;
+    }
+
+    private long readVarint() {
+        assert mBuffer != null;
+        long value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            final byte b = mBuffer.get();
+            value |= (long) (b & 0x7F) << shift;
+            if ((b & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw new NativeRenderException(DESERIALIZE_READ_LENGTH_ERR, TAG + ": invalid varint");
+    }
+
+    private int readLength() {
+        assert mBuffer != null;
+        final long length = readVarint();
+        if (length < 0 || length > mBuffer.remaining()) {
+            throw new NativeRenderException(DESERIALIZE_READ_LENGTH_ERR,
+                    TAG + ": invalid length " + length);
+        }
+        return (int) length;
+    }
+
+    @NonNull
+    private String readString() {
+        assert mBuffer != null;
+        final int length = readLength();
+        final String value;
+        if (mBuffer.hasArray()) {
+            value = new String(mBuffer.array(), mBuffer.arrayOffset() + mBuffer.position(), length,
+                    StandardCharsets.UTF_8);
+            mBuffer.position(mBuffer.position() + length);
+        } else {
+            final byte[] bytes = new byte[length];
+            mBuffer.get(bytes);
+            value = new String(bytes, StandardCharsets.UTF_8);
+        }
+        return value;
+    }
+
+    @NonNull
+    private String readKey() {
+        final long index = readVarint();
+        if (index == mKeys.size()) {
+            mKeys.add(readString());
+        } else if (index < 0 || index > mKeys.size()) {
+            throw new NativeRenderException(DESERIALIZE_READ_LENGTH_ERR,
+                    TAG + ": readKey: invalid key index " + index);
+        }
+        return mKeys.get((int) index);
+    }
+
+    @Nullable
+    private Object readValue(int depth) {
+        assert mBuffer != null;
+        if (depth > MAX_DEPTH) {
+            throw new NativeRenderException(DESERIALIZE_NOT_SUPPORTED_ERR,
+                    TAG + ": readValue: nesting too deep");
+        }
+        final byte tag = mBuffer.get();
+        switch (tag) {
+            case TAG_UNDEFINED:
+            case TAG_NULL:
+                return null;
+            case TAG_FALSE:
+                return Boolean.FALSE;
+            case TAG_TRUE:
+                return Boolean.TRUE;
+            case TAG_INT32: {
+                final long zigzag = readVarint();
+                return (int) ((zigzag >>> 1) ^ -(zigzag & 1));
+            }
+            case TAG_UINT32:
+                return readVarint();
+            case TAG_DOUBLE: {
+                // Keep the same number type as Deserializer, integral doubles are read as long
+                final double doubleValue = mBuffer.getDouble();
+                final long longValue = (long) doubleValue;
+                if (longValue == doubleValue) {
+                    return longValue;
+                }
+                return doubleValue;
+            }
+            case TAG_STRING:
+                return readString();
+            case TAG_ARRAY: {
+                final int count = readLength();
+                final List<Object> array = new ArrayList<>(count);
+                for (int i = 0; i < count; i++) {
+                    array.add(readValue(depth + 1));
+                }
+                return array;
+            }
+            case TAG_OBJECT: {
+                final int count = readLength();
+                final Map<String, Object> map = new HashMap<>();
+                for (int i = 0; i < count; i++) {
+                    final String key = readString();
+                    map.put(key, readValue(depth + 1));
+                }
+                return map;
+            }
+            default:
+                throw new NativeRenderException(DESERIALIZE_NOT_SUPPORTED_ERR,
+                        TAG + ": readValue: unknown tag " + tag);
+        }
+    }
+}
@@ -405,7 +405,7 @@ static void resetFontAttribute(NSTextStorage *textStorage) {
                 int32_t componentTag = [[strongSelf hippyTag] intValue];
                 auto domNode = strongDomManager->GetNode(strongSelf.rootNode, componentTag);
                 if (domNode) {
-                    domNode->GetLayoutNode()->MarkDirty();
+                    domNode->MarkLayoutNodeDirty();
                     if (needToDoLayout) {
                         strongDomManager->DoLayout(strongSelf.rootNode);
                         strongDomManager->EndBatch(strongSelf.rootNode);
@@ -1008,7 +1008,7 @@ NATIVE_RENDER_TEXT_PROPERTY(TextShadowColor, _textShadowColor, UIColor *);
         int32_t componentTag = [self.hippyTag intValue];
         auto node = domManager->GetNode(self.rootNode, componentTag);
         if (node) {
-            node->GetLayoutNode()->MarkDirty();
+            node->MarkLayoutNodeDirty();
         }
     }
 }
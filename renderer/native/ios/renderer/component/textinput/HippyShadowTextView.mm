@@ -135,7 +135,7 @@ static hippy::LayoutSize x5MeasureFunc(
                 if (strongSelf) {
                     auto domNode = domManager->GetNode(strongSelf.rootNode, componentTag);
                     if (domNode) {
-                        domNode->GetLayoutNode()->MarkDirty();
+                        domNode->MarkLayoutNodeDirty();
                         domManager->DoLayout(strongSelf.rootNode);
                         domManager->EndBatch(strongSelf.rootNode);
                     }
@@ -126,7 +126,7 @@ void TextViewNode::HandleTextStyleUpdate(std::shared_ptr<tdfcore::TextView> text
   SetEnableScale(dom_style, text_view);
   text_view->SetTextStyle(text_style);
   if (dom_node) {
-    dom_node->GetLayoutNode()->MarkDirty();
+    dom_node->MarkLayoutNodeDirty();
   }
 }
 
@@ -0,0 +1,95 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common_header.h"
+#include "encodable_value.h"
+#include "footstone/hippy_value.h"
+
+namespace voltron {
+
+/**
+ * Streaming writer of the StandardMessageCodec wire format, the same bytes as
+ * StandardMessageCodec::EncodeMessage, so Dart side decodes them with StandardMessageCodec as before.
+ * Values are appended to one growing buffer as render ops are produced, DomNode styles are written
+ * from HippyValue directly without building EncodableValue first.
+ *
+ * Container sizes must be known before their elements are written, except the one reserved by
+ * ReserveListSize which is filled in later with SetListSize.
+ */
+class RenderOpWriter {
+ public:
+  using HippyValue = footstone::value::HippyValue;
+
+  RenderOpWriter();
+  ~RenderOpWriter() = default;
+  RenderOpWriter(const RenderOpWriter&) = delete;
+  RenderOpWriter& operator=(const RenderOpWriter&) = delete;
+
+  void WriteNull();
+  void WriteBool(bool value);
+  // 在 int32 范围内写 int32，否则写 int64，Dart 侧都是 int
+  void WriteInt(int64_t value);
+  void WriteDouble(double value);
+  void WriteString(const std::string& value);
+  void WriteString(const char* value);
+  void WriteBytes(const std::vector<uint8_t>& value);
+  void WriteListHeader(size_t size);
+  void WriteMapHeader(size_t size);
+  void WriteValue(const EncodableValue& value);
+
+  /**
+   * @brief 写入 DomValue，与 EncodableValue 转换规则一致：null、undefined 的数组元素和对象属性被丢弃
+   */
+  void WriteDomValue(const HippyValue& value);
+  void WriteDomValueMap(const SpMap<HippyValue>& value_map);
+  static bool IsEncodableDomValue(const HippyValue& value);
+
+  /**
+   * @brief 写入一个数组头，长度占用固定 5 字节，返回其位置用于回填
+   */
+  size_t ReserveListSize();
+  void SetListSize(size_t offset, uint32_t size);
+
+  inline size_t GetSize() const { return buffer_->size(); }
+
+  /**
+   * @brief 交出已写入的数据，之后写入新的 buffer，预留 reserve 字节
+   */
+  std::unique_ptr<std::vector<uint8_t>> Release(size_t reserve);
+
+ private:
+  void WriteType(uint8_t type);
+  void WriteSize(size_t size);
+  void WriteAlignment(size_t alignment);
+  void WriteRaw(const void* data, size_t length);
+
+  std::unique_ptr<std::vector<uint8_t>> buffer_;
+};
+
+}  // namespace voltron
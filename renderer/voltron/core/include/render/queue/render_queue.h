@@ -26,14 +26,28 @@
 #include "render_task.h"
 
 namespace voltron {
+/**
+ * Render ops are encoded into the output buffer as soon as they are produced, ConsumeRenderOp only
+ * fills in the op count and hands the buffer over.
+ */
 class VoltronRenderQueue {
 public:
   VoltronRenderQueue() = default;
   ~VoltronRenderQueue();
   void ProduceRenderOp(const Sp<RenderTask> &task);
+
+  /**
+   * @brief 开始写一个 render op，写入 [type, node_id]，has_args 为 true 时调用方需紧接着写入参数 map
+   */
+  RenderOpWriter &BeginRenderOp(VoltronRenderOpType type, uint32_t node_id, bool has_args);
+
   std::unique_ptr<std::vector<uint8_t>> ConsumeRenderOp();
 
 private:
-  List<Sp<RenderTask>> queue_;
+  void CountRenderOp();
+
+  RenderOpWriter writer_;
+  size_t op_count_offset_ = 0;
+  uint32_t op_count_ = 0;
 };
 } // namespace voltron
@@ -26,6 +26,7 @@
 #include "encodable_value.h"
 #include "footstone/hippy_value.h"
 #include "render_op.h"
+#include "render_op_writer.h"
 
 namespace voltron {
 class RenderTask {
@@ -33,7 +34,7 @@ public:
   RenderTask(VoltronRenderOpType type, uint32_t node_id);
   RenderTask(VoltronRenderOpType type, uint32_t node_id, EncodableMap args);
 
-  EncodableValue Encode();
+  void Encode(RenderOpWriter &writer) const;
 
 private:
   VoltronRenderOpType type_;
@@ -67,8 +67,6 @@ public:
 
  private:
   void ConsumeQueue(uint32_t root_id);
-  static EncodableValue DecodeDomValueMap(const SpMap<HippyValue> &value_map);
-  static EncodableValue DecodeDomValue(const HippyValue &value);
   static HippyValue EncodeDomValue(const EncodableValue &value);
   void SetNodeCustomMeasure(uint32_t root_id, const Sp<DomNode> &dom_node) const;
   Sp<VoltronRenderQueue> queue(uint32_t root_id);
@@ -78,7 +78,7 @@ class VoltronRenderManager : public hippy::RenderManager,
   static void MarkDirtyProperty(std::shared_ptr<std::unordered_map<std::string,
                                                                    std::shared_ptr<HippyValue>>> diff_style,
                                 const char *prop_name,
-                                std::shared_ptr<LayoutNode> layout_node);
+                                const std::shared_ptr<DomNode>& dom_node);
 
 };
 
@@ -0,0 +1,269 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "render/queue/render_op_writer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "footstone/logging.h"
+
+namespace voltron {
+
+// StandardMessageCodec 的类型标记
+enum class CodecType : uint8_t {
+  kNull = 0,
+  kTrue = 1,
+  kFalse = 2,
+  kInt32 = 3,
+  kInt64 = 4,
+  kFloat64 = 6,
+  kString = 7,
+  kUInt8List = 8,
+  kInt32List = 9,
+  kInt64List = 10,
+  kFloat64List = 11,
+  kList = 12,
+  kMap = 13,
+};
+
+// 长度小于 254 时占 1 字节，254 后跟 uint16，255 后跟 uint32
+constexpr uint8_t kSizeUInt16 = 254;
+constexpr uint8_t kSizeUInt32 = 255;
+constexpr size_t kInitialCapacity = 4096;
+
+RenderOpWriter::RenderOpWriter() : buffer_(std::make_unique<std::vector<uint8_t>>()) {
+  buffer_->reserve(kInitialCapacity);
+}
+
+void RenderOpWriter::WriteNull() {
+  WriteType(static_cast<uint8_t>(CodecType::kNull));
+}
+
+void RenderOpWriter::WriteBool(bool value) {
+  WriteType(static_cast<uint8_t>(value ? CodecType::kTrue : CodecType::kFalse));
+}
+
+void RenderOpWriter::WriteInt(int64_t value) {
+  if (value >= std::numeric_limits<int32_t>::min() && value <= std::numeric_limits<int32_t>::max()) {
+    auto int32_value = static_cast<int32_t>(value);
+    WriteType(static_cast<uint8_t>(CodecType::kInt32));
+    WriteRaw(&int32_value, sizeof(int32_value));
+  } else {
+    WriteType(static_cast<uint8_t>(CodecType::kInt64));
+    WriteRaw(&value, sizeof(value));
+  }
+}
+
+void RenderOpWriter::WriteDouble(double value) {
+  WriteType(static_cast<uint8_t>(CodecType::kFloat64));
+  WriteAlignment(8);
+  WriteRaw(&value, sizeof(value));
+}
+
+void RenderOpWriter::WriteString(const std::string& value) {
+  WriteType(static_cast<uint8_t>(CodecType::kString));
+  WriteSize(value.size());
+  WriteRaw(value.data(), value.size());
+}
+
+void RenderOpWriter::WriteString(const char* value) {
+  auto length = strlen(value);
+  WriteType(static_cast<uint8_t>(CodecType::kString));
+  WriteSize(length);
+  WriteRaw(value, length);
+}
+
+void RenderOpWriter::WriteBytes(const std::vector<uint8_t>& value) {
+  WriteType(static_cast<uint8_t>(CodecType::kUInt8List));
+  WriteSize(value.size());
+  WriteRaw(value.data(), value.size());
+}
+
+void RenderOpWriter::WriteListHeader(size_t size) {
+  WriteType(static_cast<uint8_t>(CodecType::kList));
+  WriteSize(size);
+}
+
+void RenderOpWriter::WriteMapHeader(size_t size) {
+  WriteType(static_cast<uint8_t>(CodecType::kMap));
+  WriteSize(size);
+}
+
+void RenderOpWriter::WriteValue(const EncodableValue& value) {
+  if (auto bool_value = std::get_if<bool>(&value)) {
+    WriteBool(*bool_value);
+  } else if (auto int_value = std::get_if<int32_t>(&value)) {
+    WriteInt(*int_value);
+  } else if (auto long_value = std::get_if<int64_t>(&value)) {
+    // 与 StandardMessageCodec 一致，int64 保持 int64 类型
+    WriteType(static_cast<uint8_t>(CodecType::kInt64));
+    WriteRaw(long_value, sizeof(*long_value));
+  } else if (auto double_value = std::get_if<double>(&value)) {
+    WriteDouble(*double_value);
+  } else if (auto string_value = std::get_if<std::string>(&value)) {
+    WriteString(*string_value);
+  } else if (auto bytes_value = std::get_if<std::vector<uint8_t>>(&value)) {
+    WriteBytes(*bytes_value);
+  } else if (auto int_list = std::get_if<std::vector<int32_t>>(&value)) {
+    WriteType(static_cast<uint8_t>(CodecType::kInt32List));
+    WriteSize(int_list->size());
+    WriteAlignment(4);
+    WriteRaw(int_list->data(), int_list->size() * sizeof(int32_t));
+  } else if (auto long_list = std::get_if<std::vector<int64_t>>(&value)) {
+    WriteType(static_cast<uint8_t>(CodecType::kInt64List));
+    WriteSize(long_list->size());
+    WriteAlignment(8);
+    WriteRaw(long_list->data(), long_list->size() * sizeof(int64_t));
+  } else if (auto double_list = std::get_if<std::vector<double>>(&value)) {
+    WriteType(static_cast<uint8_t>(CodecType::kFloat64List));
+    WriteSize(double_list->size());
+    WriteAlignment(8);
+    WriteRaw(double_list->data(), double_list->size() * sizeof(double));
+  } else if (auto list_value = std::get_if<EncodableList>(&value)) {
+    WriteListHeader(list_value->size());
+    for (const auto& item : *list_value) {
+      WriteValue(item);
+    }
+  } else if (auto map_value = std::get_if<EncodableMap>(&value)) {
+    WriteMapHeader(map_value->size());
+    for (const auto& [key, item] : *map_value) {
+      WriteValue(key);
+      WriteValue(item);
+    }
+  } else {
+    WriteNull();
+  }
+}
+
+bool RenderOpWriter::IsEncodableDomValue(const HippyValue& value) {
+  return value.IsBoolean() || value.IsNumber() || value.IsString() || value.IsArray() || value.IsObject();
+}
+
+void RenderOpWriter::WriteDomValue(const HippyValue& value) {
+  if (value.IsBoolean()) {
+    WriteBool(value.ToBooleanChecked());
+  } else if (value.IsInt32()) {
+    WriteInt(value.ToInt32Checked());
+  } else if (value.IsUInt32()) {
+    WriteInt(value.ToUint32Checked());
+  } else if (value.IsDouble()) {
+    WriteDouble(value.ToDoubleChecked());
+  } else if (value.IsString()) {
+    WriteString(value.ToStringChecked());
+  } else if (value.IsArray()) {
+    const auto& array = value.ToArrayChecked();
+    size_t size = 0;
+    for (const auto& item : array) {
+      size += IsEncodableDomValue(item) ? 1 : 0;
+    }
+    WriteListHeader(size);
+    for (const auto& item : array) {
+      if (IsEncodableDomValue(item)) {
+        WriteDomValue(item);
+      }
+    }
+  } else if (value.IsObject()) {
+    const auto& object = value.ToObjectChecked();
+    size_t size = 0;
+    for (const auto& [key, item] : object) {
+      size += IsEncodableDomValue(item) ? 1 : 0;
+    }
+    WriteMapHeader(size);
+    for (const auto& [key, item] : object) {
+      if (IsEncodableDomValue(item)) {
+        WriteString(key);
+        WriteDomValue(item);
+      }
+    }
+  } else {
+    WriteNull();
+  }
+}
+
+void RenderOpWriter::WriteDomValueMap(const SpMap<HippyValue>& value_map) {
+  size_t size = 0;
+  for (const auto& [key, value] : value_map) {
+    size += (value && IsEncodableDomValue(*value)) ? 1 : 0;
+  }
+  WriteMapHeader(size);
+  for (const auto& [key, value] : value_map) {
+    if (value && IsEncodableDomValue(*value)) {
+      WriteString(key);
+      WriteDomValue(*value);
+    }
+  }
+}
+
+size_t RenderOpWriter::ReserveListSize() {
+  WriteType(static_cast<uint8_t>(CodecType::kList));
+  auto offset = buffer_->size();
+  WriteType(kSizeUInt32);
+  uint32_t size = 0;
+  WriteRaw(&size, sizeof(size));
+  return offset;
+}
+
+void RenderOpWriter::SetListSize(size_t offset, uint32_t size) {
+  FOOTSTONE_DCHECK(offset + 1 + sizeof(size) <= buffer_->size());
+  memcpy(buffer_->data() + offset + 1, &size, sizeof(size));
+}
+
+std::unique_ptr<std::vector<uint8_t>> RenderOpWriter::Release(size_t reserve) {
+  auto buffer = std::move(buffer_);
+  buffer_ = std::make_unique<std::vector<uint8_t>>();
+  buffer_->reserve(std::max(reserve, kInitialCapacity));
+  return buffer;
+}
+
+void RenderOpWriter::WriteType(uint8_t type) {
+  buffer_->push_back(type);
+}
+
+void RenderOpWriter::WriteSize(size_t size) {
+  if (size < kSizeUInt16) {
+    WriteType(static_cast<uint8_t>(size));
+  } else if (size <= std::numeric_limits<uint16_t>::max()) {
+    WriteType(kSizeUInt16);
+    auto uint16_size = static_cast<uint16_t>(size);
+    WriteRaw(&uint16_size, sizeof(uint16_size));
+  } else {
+    WriteType(kSizeUInt32);
+    auto uint32_size = static_cast<uint32_t>(size);
+    WriteRaw(&uint32_size, sizeof(uint32_size));
+  }
+}
+
+void RenderOpWriter::WriteAlignment(size_t alignment) {
+  auto mod = buffer_->size() % alignment;
+  if (mod) {
+    buffer_->insert(buffer_->end(), alignment - mod, 0);
+  }
+}
+
+void RenderOpWriter::WriteRaw(const void* data, size_t length) {
+  auto bytes = reinterpret_cast<const uint8_t*>(data);
+  buffer_->insert(buffer_->end(), bytes, bytes + length);
+}
+
+}  // namespace voltron
@@ -21,33 +21,41 @@
  */
 
 #include "render/queue/render_queue.h"
-#include "standard_message_codec.h"
 #include "footstone/logging.h"
 
 namespace voltron {
 
 std::unique_ptr<std::vector<uint8_t>> VoltronRenderQueue::ConsumeRenderOp() {
-  auto op_list = EncodableList();
-  if (!queue_.empty()) {
-    for (const auto &task : queue_) {
-      op_list.push_back(task->Encode());
-    }
-    queue_.clear();
-  }
-
-  if (op_list.empty()) {
+  if (op_count_ == 0) {
     return nullptr;
   }
-  return StandardMessageCodec::GetInstance().EncodeMessage(
-      EncodableValue(op_list));
+  writer_.SetListSize(op_count_offset_, op_count_);
+  op_count_ = 0;
+  // 下一批次按本批次大小预留，避免首屏大批次反复扩容
+  return writer_.Release(writer_.GetSize());
 }
 
-VoltronRenderQueue::~VoltronRenderQueue() {
-  queue_.clear();
-}
+VoltronRenderQueue::~VoltronRenderQueue() = default;
 
 void VoltronRenderQueue::ProduceRenderOp(const Sp<RenderTask> &task) {
-  queue_.push_back(task);
+  CountRenderOp();
+  task->Encode(writer_);
+}
+
+RenderOpWriter &VoltronRenderQueue::BeginRenderOp(VoltronRenderOpType type, uint32_t node_id, bool has_args) {
+  CountRenderOp();
+  writer_.WriteListHeader(has_args ? 3 : 2);
+  writer_.WriteInt(type);
+  writer_.WriteInt(node_id);
+  return writer_;
+}
+
+void VoltronRenderQueue::CountRenderOp() {
+  // 批次的 op 数量在 Consume 时才确定，先占位
+  if (op_count_ == 0) {
+    op_count_offset_ = writer_.ReserveListSize();
+  }
+  ++op_count_;
 }
 
 } // namespace voltron
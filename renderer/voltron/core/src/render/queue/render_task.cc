@@ -23,7 +23,6 @@
 #include "render/queue/render_task.h"
 
 #include <utility>
-#include "standard_message_codec.h"
 
 namespace voltron {
 
@@ -32,14 +31,17 @@ RenderTask::RenderTask(VoltronRenderOpType type, uint32_t node_id) : type_(type)
 RenderTask::RenderTask(VoltronRenderOpType type, uint32_t node_id, EncodableMap args)
     : type_(type), node_id_(node_id), args_(std::move(args)) {}
 
-EncodableValue RenderTask::Encode() {
-  auto encode_task = EncodableList();
-  encode_task.emplace_back(type_);
-  encode_task.emplace_back(node_id_);
+void RenderTask::Encode(RenderOpWriter &writer) const {
+  writer.WriteListHeader(args_.empty() ? 2 : 3);
+  writer.WriteInt(type_);
+  writer.WriteInt(node_id_);
   if (!args_.empty()) {
-    encode_task.emplace_back(std::move(args_));
+    writer.WriteMapHeader(args_.size());
+    for (const auto &[key, value] : args_) {
+      writer.WriteValue(key);
+      writer.WriteValue(value);
+    }
   }
-  return EncodableValue(std::move(encode_task));
 }
 
 }  // namespace voltron
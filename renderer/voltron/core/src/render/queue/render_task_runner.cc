@@ -47,82 +47,69 @@ void VoltronRenderTaskRunner::RunCreateDomNode(uint32_t root_id, const Sp<DomNod
   if (view_name == "Text") {
     SetNodeCustomMeasure(root_id, node);
   }
-  auto args_map = EncodableMap();
   auto render_info = node->GetRenderInfo();
-  args_map[EncodableValue(kChildIndexKey)] = EncodableValue(render_info.index);
-  args_map[EncodableValue(kClassNameKey)] = EncodableValue(view_name);
-  args_map[EncodableValue(kParentNodeIdKey)] = EncodableValue(render_info.pid);
-  if (!node->GetStyleMap()->empty()) {
-    auto style_map = node->GetStyleMap();
-    if (style_map) {
-      args_map[EncodableValue(kStylesKey)] =
-          DecodeDomValueMap(*style_map);
-    }
+  auto style_map = node->GetStyleMap();
+  auto ext_style = node->GetExtStyle();
+  auto has_style = style_map && !style_map->empty();
+  auto has_ext_style = ext_style && !ext_style->empty();
+  // 样式直接从 DomValue 写入输出 buffer，不再转换成 EncodableMap
+  auto &writer = queue(root_id)->BeginRenderOp(VoltronRenderOpType::ADD_NODE, node->GetId(), true);
+  writer.WriteMapHeader(3 + (has_style ? 1 : 0) + (has_ext_style ? 1 : 0));
+  writer.WriteString(kChildIndexKey);
+  writer.WriteInt(render_info.index);
+  writer.WriteString(kClassNameKey);
+  writer.WriteString(view_name);
+  writer.WriteString(kParentNodeIdKey);
+  writer.WriteInt(render_info.pid);
+  if (has_style) {
+    writer.WriteString(kStylesKey);
+    writer.WriteDomValueMap(*style_map);
   }
-  if (!node->GetExtStyle()->empty()) {
-    auto ext_style = node->GetExtStyle();
-    if (ext_style) {
-      args_map[EncodableValue(kPropsKey)] =
-          DecodeDomValueMap(*ext_style);
-    }
+  if (has_ext_style) {
+    writer.WriteString(kPropsKey);
+    writer.WriteDomValueMap(*ext_style);
   }
-
-  auto create_task = std::make_shared<RenderTask>(VoltronRenderOpType::ADD_NODE,
-                                                  node->GetId(), args_map);
-  queue(root_id)->ProduceRenderOp(create_task);
 }
 
 void VoltronRenderTaskRunner::RunDeleteDomNode(uint32_t root_id, const Sp<DomNode> &node) {
   FOOTSTONE_DLOG(INFO) << "RunDeleteDomNode id" << node->GetId();
-  auto delete_task = std::make_shared<RenderTask>(
-      VoltronRenderOpType::DELETE_NODE, node->GetId());
-  queue(root_id)->ProduceRenderOp(delete_task);
+  queue(root_id)->BeginRenderOp(VoltronRenderOpType::DELETE_NODE, node->GetId(), false);
 }
 
 void VoltronRenderTaskRunner::RunUpdateDomNode(uint32_t root_id, const Sp<DomNode> &node) {
   FOOTSTONE_DLOG(INFO) << "RunUpdateDomNode id" << node->GetId();
-  auto args_map = EncodableMap();
   auto diff_style = node->GetDiffStyle();
   if (diff_style && !diff_style->empty()) {
-    args_map[EncodableValue(kPropsKey)] =
-        DecodeDomValueMap(*diff_style);
-    auto update_task = std::make_shared<RenderTask>(
-        VoltronRenderOpType::UPDATE_NODE, node->GetId(), args_map);
-    queue(root_id)->ProduceRenderOp(update_task);
+    auto &writer = queue(root_id)->BeginRenderOp(VoltronRenderOpType::UPDATE_NODE, node->GetId(), true);
+    writer.WriteMapHeader(1);
+    writer.WriteString(kPropsKey);
+    writer.WriteDomValueMap(*diff_style);
   }
 }
 
 void VoltronRenderTaskRunner::RunUpdateLayout(uint32_t root_id, const SpList<DomNode> &nodes) {
   if (!nodes.empty()) {
-    auto args_map = EncodableMap();
-    auto render_node_list = EncodableList();
+    auto &writer = queue(root_id)->BeginRenderOp(VoltronRenderOpType::UPDATE_LAYOUT, 0, true);
+    writer.WriteMapHeader(1);
+    writer.WriteString(kLayoutNodesKey);
+    writer.WriteListHeader(nodes.size());
     for (const auto &node: nodes) {
       FOOTSTONE_DLOG(INFO) << "RunUpdateLayout id" << node->GetId();
       const auto &result = node->GetRenderLayoutResult();
-      auto node_layout_prop_list = EncodableList();
-      node_layout_prop_list.emplace_back(node->GetId());
-      // x
-      node_layout_prop_list.emplace_back(result.left);
-      // y
-      node_layout_prop_list.emplace_back(result.top);
-      // w
-      node_layout_prop_list.emplace_back(result.width);
-      // h
-      node_layout_prop_list.emplace_back(result.height);
-      if (node->GetViewName() == "Text") {
-        node_layout_prop_list.emplace_back(result.paddingLeft);
-        node_layout_prop_list.emplace_back(result.paddingTop);
-        node_layout_prop_list.emplace_back(result.paddingRight);
-        node_layout_prop_list.emplace_back(result.paddingBottom);
+      auto is_text = node->GetViewName() == "Text";
+      writer.WriteListHeader(is_text ? 9 : 5);
+      writer.WriteInt(node->GetId());
+      // x, y, w, h
+      writer.WriteDouble(result.left);
+      writer.WriteDouble(result.top);
+      writer.WriteDouble(result.width);
+      writer.WriteDouble(result.height);
+      if (is_text) {
+        writer.WriteDouble(result.paddingLeft);
+        writer.WriteDouble(result.paddingTop);
+        writer.WriteDouble(result.paddingRight);
+        writer.WriteDouble(result.paddingBottom);
       }
-      render_node_list.emplace_back(std::move(node_layout_prop_list));
-    }
-    if (!render_node_list.empty()) {
-      args_map[EncodableValue(kLayoutNodesKey)] =
-          EncodableValue(std::move(render_node_list));
-      auto update_task = std::make_shared<RenderTask>(
-          VoltronRenderOpType::UPDATE_LAYOUT, 0, args_map);
-      queue(root_id)->ProduceRenderOp(update_task);
     }
   }
 }
@@ -147,19 +134,19 @@ void VoltronRenderTaskRunner::RunRecombineDomNode(uint32_t root_id, std::vector<
 
 void VoltronRenderTaskRunner::RunMoveDomNode(uint32_t root_id, const Sp<DomNode> &node) {
   FOOTSTONE_DLOG(INFO) << "RunMoveDomNode id" << node->GetId();
-  auto args_map = EncodableMap();
   auto render_info = node->GetRenderInfo();
-  args_map[EncodableValue(kNodeIdKey)] = EncodableValue(render_info.id);
-  args_map[EncodableValue(kParentNodeIdKey)] = EncodableValue(render_info.pid);
-  args_map[EncodableValue(kChildIndexKey)] = EncodableValue(render_info.index);
-  auto update_task = std::make_shared<RenderTask>(
-    VoltronRenderOpType::MOVE_NODE, node->GetId(), args_map);
-  queue(root_id)->ProduceRenderOp(update_task);
+  auto &writer = queue(root_id)->BeginRenderOp(VoltronRenderOpType::MOVE_NODE, node->GetId(), true);
+  writer.WriteMapHeader(3);
+  writer.WriteString(kNodeIdKey);
+  writer.WriteInt(render_info.id);
+  writer.WriteString(kParentNodeIdKey);
+  writer.WriteInt(render_info.pid);
+  writer.WriteString(kChildIndexKey);
+  writer.WriteInt(render_info.index);
 }
 
 void VoltronRenderTaskRunner::RunBatch(uint32_t root_id) {
-  auto batch_task = std::make_shared<RenderTask>(VoltronRenderOpType::BATCH, 0);
-  queue(root_id)->ProduceRenderOp(batch_task);
+  queue(root_id)->BeginRenderOp(VoltronRenderOpType::BATCH, 0, false);
   ConsumeQueue(root_id);
 }
 
@@ -171,42 +158,6 @@ void VoltronRenderTaskRunner::RunLayoutFinish(uint32_t root_id) {
   // empty
 }
 
-EncodableValue VoltronRenderTaskRunner::DecodeDomValue(const HippyValue &value) {
-  if (value.IsBoolean()) {
-    return EncodableValue(value.ToBooleanChecked());
-  } else if (value.IsInt32()) {
-    return EncodableValue(value.ToInt32Checked());
-  } else if (value.IsUInt32()) {
-    return EncodableValue(static_cast<int64_t>(value.ToUint32Checked()));
-  } else if (value.IsDouble()) {
-    return EncodableValue(value.ToDoubleChecked());
-  } else if (value.IsString()) {
-    return EncodableValue(value.ToStringChecked());
-  } else if (value.IsArray()) {
-    auto parse_list = EncodableList();
-    for (const auto &item: value.ToArrayChecked()) {
-      auto parse_item_value = DecodeDomValue(item);
-      if (!parse_item_value.IsNull()) {
-        parse_list.emplace_back(parse_item_value);
-      }
-    }
-    return EncodableValue(std::move(parse_list));
-  } else if (value.IsObject()) {
-    auto parse_map = EncodableMap();
-    for (const auto &entry: value.ToObjectChecked()) {
-      auto encode_entry_value = DecodeDomValue(entry.second);
-      if (!encode_entry_value.IsNull()) {
-        auto encode_entry_key = EncodableValue(entry.first);
-        parse_map[encode_entry_key] = encode_entry_value;
-      }
-    }
-
-    return EncodableValue(std::move(parse_map));
-  } else {
-    return EncodableValue(std::monostate{});
-  }
-}
-
 VoltronRenderTaskRunner::HippyValue VoltronRenderTaskRunner::EncodeDomValue(const EncodableValue &value) {
   auto bool_value = std::get_if<bool>(&value);
   if (bool_value) {
@@ -265,22 +216,6 @@ VoltronRenderTaskRunner::HippyValue VoltronRenderTaskRunner::EncodeDomValue(cons
   return VoltronRenderTaskRunner::HippyValue::Null();
 }
 
-EncodableValue
-VoltronRenderTaskRunner::DecodeDomValueMap(const SpMap<HippyValue> &value_map) {
-  auto encode_map = EncodableMap();
-
-  for (const auto &entry: value_map) {
-    if (!entry.second) continue;
-    auto encode_entry_value = DecodeDomValue(*entry.second);
-    if (!encode_entry_value.IsNull()) {
-      auto encode_entry_key = EncodableValue(entry.first);
-      encode_map[encode_entry_key] = std::move(encode_entry_value);
-    }
-  }
-
-  return EncodableValue(std::move(encode_map));
-}
-
 void VoltronRenderTaskRunner::ConsumeQueue(uint32_t root_id) {
   auto bridge_manager = BridgeManager::Find(engine_id_);
   if (!bridge_manager) {
@@ -370,23 +305,20 @@ void VoltronRenderTaskRunner::RunCallEvent(
 
 void VoltronRenderTaskRunner::RunAddEventListener(uint32_t root_id, const uint32_t &node_id,
                                                   const String &event_name) {
-  auto args_map = EncodableMap();
-  args_map[EncodableValue(kFuncNameKey)] = event_name;
-
-  auto update_task = std::make_shared<RenderTask>(
-      VoltronRenderOpType::ADD_EVENT, node_id, args_map);
-  queue(root_id)->ProduceRenderOp(update_task);
+  auto &writer = queue(root_id)->BeginRenderOp(VoltronRenderOpType::ADD_EVENT, node_id, true);
+  writer.WriteMapHeader(1);
+  writer.WriteString(kFuncNameKey);
+  writer.WriteString(event_name);
 }
 
 void VoltronRenderTaskRunner::RunRemoveEventListener(uint32_t root_id, const uint32_t &node_id,
                                                      const String &event_name) {
   auto bridge_manager = BridgeManager::Find(engine_id_);
   if (bridge_manager) {
-    auto args_map = EncodableMap();
-    args_map[EncodableValue(kFuncNameKey)] = event_name;
-    auto update_task = std::make_shared<RenderTask>(
-        VoltronRenderOpType::REMOVE_EVENT, node_id, args_map);
-    queue(root_id)->ProduceRenderOp(update_task);
+    auto &writer = queue(root_id)->BeginRenderOp(VoltronRenderOpType::REMOVE_EVENT, node_id, true);
+    writer.WriteMapHeader(1);
+    writer.WriteString(kFuncNameKey);
+    writer.WriteString(event_name);
   }
 }
 
@@ -73,21 +73,21 @@ void VoltronRenderManager::MarkTextDirty(const std::weak_ptr<RootNode> &root_nod
     if (node) {
       auto diff_style = node->GetDiffStyle();
       if (diff_style) {
-        MarkDirtyProperty(diff_style, hippy::dom::kFontStyle, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kLetterSpacing, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kColor, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kFontSize, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kFontFamily, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kFontWeight, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kTextDecorationLine, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kTextShadowOffset, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kTextShadowRadius, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kTextShadowColor, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kLineHeight, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kTextAlign, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kText, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, kEnableScale, node->GetLayoutNode());
-        MarkDirtyProperty(diff_style, hippy::dom::kNumberOfLines, node->GetLayoutNode());
+        MarkDirtyProperty(diff_style, hippy::dom::kFontStyle, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kLetterSpacing, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kColor, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kFontSize, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kFontFamily, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kFontWeight, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kTextDecorationLine, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kTextShadowOffset, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kTextShadowRadius, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kTextShadowColor, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kLineHeight, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kTextAlign, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kText, node);
+        MarkDirtyProperty(diff_style, kEnableScale, node);
+        MarkDirtyProperty(diff_style, hippy::dom::kNumberOfLines, node);
       }
     }
   }
@@ -97,10 +97,10 @@ void VoltronRenderManager::MarkDirtyProperty(std::shared_ptr<std::unordered_map<
                                                                                 std::shared_ptr<
                                                                                     HippyValue>>> diff_style,
                                              const char *prop_name,
-                                             std::shared_ptr<LayoutNode> layout_node) {
-  FOOTSTONE_DCHECK(layout_node != nullptr);
+                                             const std::shared_ptr<DomNode>& dom_node) {
+  FOOTSTONE_DCHECK(dom_node != nullptr);
   if (diff_style->find(prop_name) != diff_style->end()) {
-    layout_node->MarkDirty();
+    dom_node->MarkLayoutNodeDirty();
     return;
   }
 }